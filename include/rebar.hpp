@@ -10,13 +10,33 @@
 
 #include "rebar/array.hpp"
 #include "rebar/array_impl.hpp"
+#include "rebar/bytecode.hpp"
+#include "rebar/bytecode_provider.hpp"
+#include "rebar/bytecode_provider_impl.hpp"
+#include "rebar/collector.hpp"
+#include "rebar/collector_impl.hpp"
+#include "rebar/compile_cache.hpp"
+#include "rebar/compiler.hpp"
+#include "rebar/compiler_impl.hpp"
 #include "rebar/definitions.hpp"
 #include "rebar/environment.hpp"
+#include "rebar/environment_pool.hpp"
+#include "rebar/flat_ast.hpp"
 #include "rebar/function.hpp"
 #include "rebar/function_impl.hpp"
+#include "rebar/global_scope.hpp"
+#include "rebar/image.hpp"
 #include "rebar/interpreter.hpp"
 #include "rebar/interpreter_impl.hpp"
+#include "rebar/jit_assembler.hpp"
+#include "rebar/jit_compiler.hpp"
+#include "rebar/jit_compiler_impl.hpp"
+#include "rebar/jit_provider.hpp"
+#include "rebar/jit_provider_impl.hpp"
 #include "rebar/lexer.hpp"
+#include "rebar/lru_cache.hpp"
+#include "rebar/native_class.hpp"
+#include "rebar/native_function.hpp"
 #include "rebar/native_object.hpp"
 #include "rebar/native_object_impl.hpp"
 #include "rebar/object.hpp"
@@ -26,11 +46,14 @@
 #include "rebar/parser.hpp"
 #include "rebar/preprocess.hpp"
 #include "rebar/provider.hpp"
+#include "rebar/shape.hpp"
 #include "rebar/span.hpp"
 #include "rebar/string.hpp"
 #include "rebar/string_impl.hpp"
+#include "rebar/string_interner.hpp"
 #include "rebar/table.hpp"
 #include "rebar/token.hpp"
+#include "rebar/typed_array.hpp"
 #include "rebar/utility.hpp"
 
 #endif // #ifndef INCLUDE_REBAR_H
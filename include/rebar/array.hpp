@@ -8,10 +8,13 @@
 #include <cstdlib>
 #include <vector>
 
+#include "collector.hpp"
 #include "definitions.hpp"
 
 namespace rebar {
     struct array {
+        friend class cycle_collector;
+
         enum class type : enum_base {
             managed,
             view
@@ -22,6 +25,7 @@ namespace rebar {
 
         // type = managed (array_type)
         // reference_count (size_t)
+        // collector_link (collector_link)
         // objects (vector<object>)
         //
         // type = view (array_type)
@@ -33,7 +37,7 @@ namespace rebar {
         constexpr size_t structure_size(type a_type) {
             switch (a_type) {
                 case type::managed:
-                    return (2 * sizeof(size_t)) + sizeof(std::vector<object>);
+                    return (2 * sizeof(size_t)) + sizeof(collector_link) + sizeof(std::vector<object>);
                 case type::view:
                     return 5 * sizeof(size_t);
                 default:
@@ -49,10 +53,14 @@ namespace rebar {
             return *(reinterpret_cast<size_t*>(m_root_pointer) + 1);
         }
 
+        [[nodiscard]] inline collector_link& collector_link_reference() const noexcept {
+            return *reinterpret_cast<collector_link*>(reinterpret_cast<size_t*>(m_root_pointer) + 2);
+        }
+
         [[nodiscard]] inline std::vector<object>& vector_reference() noexcept {
             switch (get_type()) {
                 case type::managed:
-                    return *(reinterpret_cast<std::vector<object>*>(reinterpret_cast<size_t*>(m_root_pointer) + 2));
+                    return *(reinterpret_cast<std::vector<object>*>(&collector_link_reference() + 1));
                 case type::view:
                     return (reinterpret_cast<array*>(m_root_pointer) + 2)->vector_reference();
             }
@@ -61,7 +69,7 @@ namespace rebar {
         [[nodiscard]] const std::vector<object>& vector_reference() const noexcept {
             switch (get_type()) {
                 case type::managed:
-                    return *(reinterpret_cast<std::vector<object>*>(reinterpret_cast<size_t*>(m_root_pointer) + 2));
+                    return *(reinterpret_cast<std::vector<object>*>(&collector_link_reference() + 1));
                 case type::view:
                     return (reinterpret_cast<array*>(m_root_pointer) + 2)->vector_reference();
             }
@@ -7,6 +7,7 @@
 
 #include "array.hpp"
 
+#include "collector.hpp"
 #include "object.hpp"
 
 namespace rebar {
@@ -16,7 +17,8 @@ namespace rebar {
         type_reference() = a_type;
 
         if (a_type == type::managed) {
-            new (reinterpret_cast<std::vector<object>*>(reinterpret_cast<size_t*>(m_root_pointer) + 2)) std::vector<object>();
+            new (&collector_link_reference()) collector_link();
+            new (&vector_reference()) std::vector<object>();
             vector_reference().reserve(a_capacity);
         }
 
@@ -95,6 +97,10 @@ namespace rebar {
 
         if (--reference_count_reference() == 0) {
             if (arr_type == type::managed) {
+                if (cycle_collector* collector = collector_link_reference().m_collector) {
+                    collector->untrack_array(m_root_pointer);
+                }
+
                 vector_reference().~vector();
             }
 
@@ -0,0 +1,360 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_BYTECODE_HPP
+#define REBAR_BYTECODE_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "definitions.hpp"
+#include "object.hpp"
+
+namespace rebar {
+    enum class opcode : uint8_t {
+        push_null,
+        push_true,
+        push_false,
+        push_constant,
+        pop,
+        duplicate,
+        load_local,
+        store_local,
+        load_global,
+        store_global,
+        get_member,
+        set_member,
+        get_index,
+        set_index,
+        get_range,
+        update_local,
+        update_global,
+        update_member,
+        update_index,
+        add,
+        subtract,
+        multiply,
+        divide,
+        modulus,
+        exponentiate,
+        equals,
+        not_equals,
+        greater,
+        lesser,
+        greater_equal,
+        lesser_equal,
+        bitwise_or,
+        bitwise_xor,
+        bitwise_and,
+        shift_left,
+        shift_right,
+        logical_not,
+        bitwise_not,
+        length,
+        or_jump,
+        and_jump,
+        logical_or,
+        logical_and,
+        jump,
+        jump_if_false,
+        load_method,
+        call,
+        new_object,
+        new_table,
+        new_array,
+        return_value
+    };
+
+    [[nodiscard]] constexpr std::string_view opcode_to_string(const opcode a_opcode) noexcept {
+        using namespace std::string_view_literals;
+
+        constexpr std::string_view opcode_strings[] {
+                "PUSH_NULL"sv,
+                "PUSH_TRUE"sv,
+                "PUSH_FALSE"sv,
+                "PUSH_CONSTANT"sv,
+                "POP"sv,
+                "DUPLICATE"sv,
+                "LOAD_LOCAL"sv,
+                "STORE_LOCAL"sv,
+                "LOAD_GLOBAL"sv,
+                "STORE_GLOBAL"sv,
+                "GET_MEMBER"sv,
+                "SET_MEMBER"sv,
+                "GET_INDEX"sv,
+                "SET_INDEX"sv,
+                "GET_RANGE"sv,
+                "UPDATE_LOCAL"sv,
+                "UPDATE_GLOBAL"sv,
+                "UPDATE_MEMBER"sv,
+                "UPDATE_INDEX"sv,
+                "ADD"sv,
+                "SUBTRACT"sv,
+                "MULTIPLY"sv,
+                "DIVIDE"sv,
+                "MODULUS"sv,
+                "EXPONENTIATE"sv,
+                "EQUALS"sv,
+                "NOT_EQUALS"sv,
+                "GREATER"sv,
+                "LESSER"sv,
+                "GREATER_EQUAL"sv,
+                "LESSER_EQUAL"sv,
+                "BITWISE_OR"sv,
+                "BITWISE_XOR"sv,
+                "BITWISE_AND"sv,
+                "SHIFT_LEFT"sv,
+                "SHIFT_RIGHT"sv,
+                "LOGICAL_NOT"sv,
+                "BITWISE_NOT"sv,
+                "LENGTH"sv,
+                "OR_JUMP"sv,
+                "AND_JUMP"sv,
+                "LOGICAL_OR"sv,
+                "LOGICAL_AND"sv,
+                "JUMP"sv,
+                "JUMP_IF_FALSE"sv,
+                "LOAD_METHOD"sv,
+                "CALL"sv,
+                "NEW_OBJECT"sv,
+                "NEW_TABLE"sv,
+                "NEW_ARRAY"sv,
+                "RETURN_VALUE"sv
+        };
+
+        return opcode_strings[static_cast<size_t>(a_opcode)];
+    }
+
+    // Instructions are fixed-width. m_operand holds a constant index, a frame slot or a jump target; m_count holds
+    // an argument/element count, the inline cache of a member instruction or, for update instructions, the
+    // separator of the compound operation.
+    struct instruction {
+        opcode m_opcode;
+        uint8_t m_flags;
+        uint16_t m_count;
+        uint32_t m_operand;
+
+        constexpr instruction(const opcode a_opcode, const uint32_t a_operand = 0, const uint16_t a_count = 0) noexcept :
+                m_opcode(a_opcode), m_flags(0), m_count(a_count), m_operand(a_operand) {}
+    };
+
+    static_assert(sizeof(instruction) == 8, "Instructions are expected to be 8 bytes wide.");
+
+    // Whether an update instruction (compound assignment, increment, decrement) consumes a right-hand operand.
+    [[nodiscard]] constexpr bool update_takes_operand(const separator a_operation) noexcept {
+        switch (a_operation) {
+            case separator::operation_prefix_increment:
+            case separator::operation_postfix_increment:
+            case separator::operation_prefix_decrement:
+            case separator::operation_postfix_decrement:
+                return false;
+            default:
+                return true;
+        }
+    }
+
+    // Binary operation an update instruction applies to its variable. Increments and decrements add or subtract one.
+    [[nodiscard]] constexpr opcode compound_opcode(const separator a_operation) noexcept {
+        switch (a_operation) {
+            case separator::addition_assignment:
+            case separator::operation_prefix_increment:
+            case separator::operation_postfix_increment:
+                return opcode::add;
+            case separator::subtraction_assignment:
+            case separator::operation_prefix_decrement:
+            case separator::operation_postfix_decrement:
+                return opcode::subtract;
+            case separator::multiplication_assignment:
+                return opcode::multiply;
+            case separator::division_assignment:
+                return opcode::divide;
+            case separator::modulus_assignment:
+                return opcode::modulus;
+            case separator::exponent_assignment:
+                return opcode::exponentiate;
+            case separator::bitwise_or_assignment:
+                return opcode::bitwise_or;
+            case separator::bitwise_xor_assignment:
+                return opcode::bitwise_xor;
+            case separator::bitwise_and_assignment:
+                return opcode::bitwise_and;
+            case separator::shift_left_assignment:
+                return opcode::shift_left;
+            case separator::shift_right_assignment:
+                return opcode::shift_right;
+            default:
+                return opcode::pop;
+        }
+    }
+
+    // Net change in operand stack height caused by executing an instruction.
+    [[nodiscard]] constexpr int stack_effect(const instruction a_instruction) noexcept {
+        switch (a_instruction.m_opcode) {
+            case opcode::push_null:
+            case opcode::push_true:
+            case opcode::push_false:
+            case opcode::push_constant:
+            case opcode::duplicate:
+            case opcode::load_local:
+            case opcode::load_global:
+            case opcode::load_method:
+                return 1;
+            case opcode::pop:
+            case opcode::set_member:
+            case opcode::get_index:
+            case opcode::add:
+            case opcode::subtract:
+            case opcode::multiply:
+            case opcode::divide:
+            case opcode::modulus:
+            case opcode::exponentiate:
+            case opcode::equals:
+            case opcode::not_equals:
+            case opcode::greater:
+            case opcode::lesser:
+            case opcode::greater_equal:
+            case opcode::lesser_equal:
+            case opcode::bitwise_or:
+            case opcode::bitwise_xor:
+            case opcode::bitwise_and:
+            case opcode::shift_left:
+            case opcode::shift_right:
+            case opcode::logical_or:
+            case opcode::logical_and:
+            case opcode::jump_if_false:
+            case opcode::return_value:
+                return -1;
+            case opcode::set_index:
+            case opcode::get_range:
+                return -2;
+            case opcode::update_local:
+            case opcode::update_global:
+                return update_takes_operand(static_cast<separator>(a_instruction.m_count)) ? 0 : 1;
+            case opcode::update_member:
+                return update_takes_operand(static_cast<separator>(a_instruction.m_count)) ? -1 : 0;
+            case opcode::update_index:
+                return update_takes_operand(static_cast<separator>(a_instruction.m_count)) ? -2 : -1;
+            case opcode::call:
+            case opcode::new_object:
+                return -static_cast<int>(a_instruction.m_count);
+            case opcode::new_table:
+                return 1 - 2 * static_cast<int>(a_instruction.m_count);
+            case opcode::new_array:
+                return 1 - static_cast<int>(a_instruction.m_count);
+            default:
+                return 0;
+        }
+    }
+
+    // Memory of how a member access site resolved its key for the last few receivers. Entries are keyed on the
+    // receiver's shape, which fixes the slot, or on the method table that was consulted, whose entry address stays
+    // valid for as long as the table's layout version does not change.
+    struct inline_cache {
+        // Receivers remembered before the site is considered megamorphic and stops caching.
+        static constexpr size_t max_entries = 4;
+
+        struct entry {
+            const void* m_key = nullptr;
+            size_t m_version = 0;
+            size_t m_slot = 0;
+            object* m_value = nullptr;
+        };
+
+        std::array<entry, max_entries> m_entries;
+        size_t m_size = 0;
+    };
+
+    // Count operand of member instructions that did not get an inline cache.
+    static constexpr uint16_t no_inline_cache = 0xFFFF;
+
+    // Execution counters and tier data that providers attach to a prototype at runtime.
+    struct prototype_runtime {
+        uint32_t m_call_count = 0;
+        uint32_t m_back_edge_count = 0;
+        void* m_tier_data = nullptr;
+    };
+
+    // A compiled function body. Prototypes own their constants and are immutable once compiled.
+    // A frame holds m_local_count slots, the first m_parameter_count of which receive the arguments,
+    // followed by at most m_max_stack operand stack entries.
+    struct prototype {
+        std::vector<instruction> m_code;
+        std::vector<object> m_constants;
+        size_t m_parameter_count = 0;
+        size_t m_local_count = 0;
+        size_t m_max_stack = 0;
+        mutable prototype_runtime m_runtime;
+
+        // Indexed by the count operand of get_member, set_member and load_method.
+        mutable std::vector<inline_cache> m_inline_caches;
+
+        [[nodiscard]] std::string to_string() const {
+            std::string string;
+
+            for (size_t i = 0; i < m_code.size(); ++i) {
+                const auto& instr = m_code[i];
+
+                string += std::to_string(i);
+                string += '\t';
+                string += opcode_to_string(instr.m_opcode);
+
+                switch (instr.m_opcode) {
+                    case opcode::load_local:
+                    case opcode::store_local:
+                        string += " #";
+                        string += std::to_string(instr.m_operand);
+                        break;
+                    case opcode::push_constant:
+                    case opcode::load_global:
+                    case opcode::store_global:
+                    case opcode::get_member:
+                    case opcode::set_member:
+                    case opcode::load_method:
+                        string += ' ';
+                        string += object(m_constants[instr.m_operand]).to_string();
+                        break;
+                    case opcode::update_local:
+                        string += " #";
+                        string += std::to_string(instr.m_operand);
+                        string += ' ';
+                        string += separator_to_string(static_cast<separator>(instr.m_count));
+                        break;
+                    case opcode::update_global:
+                    case opcode::update_member:
+                        string += ' ';
+                        string += object(m_constants[instr.m_operand]).to_string();
+                        [[fallthrough]];
+                    case opcode::update_index:
+                        string += ' ';
+                        string += separator_to_string(static_cast<separator>(instr.m_count));
+                        break;
+                    case opcode::or_jump:
+                    case opcode::and_jump:
+                    case opcode::jump:
+                    case opcode::jump_if_false:
+                        string += " -> ";
+                        string += std::to_string(instr.m_operand);
+                        break;
+                    case opcode::call:
+                    case opcode::new_object:
+                    case opcode::new_table:
+                    case opcode::new_array:
+                        string += ' ';
+                        string += std::to_string(instr.m_count);
+                        break;
+                    default:
+                        break;
+                }
+
+                string += '\n';
+            }
+
+            return string;
+        }
+    };
+}
+
+#endif //REBAR_BYTECODE_HPP
@@ -0,0 +1,156 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_BYTECODE_PROVIDER_HPP
+#define REBAR_BYTECODE_PROVIDER_HPP
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "provider.hpp"
+#include "bytecode.hpp"
+#include "object.hpp"
+#include "table.hpp"
+
+namespace rebar {
+    class environment;
+
+    // Execution provider that compiles parse units to bytecode and runs them on a stack-based virtual machine.
+    struct bytecode_provider : public provider {
+        class function_source {
+        protected:
+            environment& m_environment;
+
+        public:
+            explicit function_source(environment& a_environment) noexcept : m_environment(a_environment) {}
+
+            virtual ~function_source() = default;
+
+            [[nodiscard]] environment& env() noexcept {
+                return m_environment;
+            }
+
+            virtual object internal_call() = 0;
+        };
+
+        class bytecode_function_source : public function_source {
+            bytecode_provider& m_provider;
+            const prototype& m_prototype;
+
+        public:
+            bytecode_function_source(environment& a_environment, bytecode_provider& a_provider, const prototype& a_prototype) noexcept :
+                    function_source(a_environment),
+                    m_provider(a_provider),
+                    m_prototype(a_prototype) {}
+
+            [[nodiscard]] const prototype& get_prototype() const noexcept {
+                return m_prototype;
+            }
+
+        protected:
+            object internal_call() override;
+        };
+
+        // Number of object slots in each segment of the operand stack.
+        static constexpr size_t default_stack_size = 1 << 14;
+
+        // Most object slots the operand stack may allocate. Calls nested deeper throw std::runtime_error.
+        static constexpr size_t default_stack_limit = 1 << 24;
+
+        // Number of backward jumps taken in a prototype between offers of the running loop to enter_loop.
+        static constexpr uint32_t back_edge_check_interval = 1 << 10;
+
+        explicit bytecode_provider(environment& a_environment) :
+                m_environment(a_environment),
+                m_stack_segment(0),
+                m_stack_top(0),
+                m_stack_limit(default_stack_limit) {
+            m_stack.push_back({ std::make_unique<object[]>(default_stack_size), default_stack_size });
+        }
+
+        [[nodiscard]] function compile(std::shared_ptr<const parse_unit> a_unit) override;
+
+        [[nodiscard]] function bind(callable a_function) override {
+            m_native_functions.push_back(a_function);
+            return { m_environment, function::native_data(&m_native_functions.back()) };
+        }
+
+        [[nodiscard]] object call(const void* a_data) override {
+            auto* func = const_cast<function_source*>(reinterpret_cast<const function_source*>(a_data));
+
+            return func->internal_call();
+        }
+
+        [[nodiscard]] prototype& create_prototype() {
+            m_prototypes.push_back(std::make_unique<prototype>());
+            return *m_prototypes.back();
+        }
+
+        [[nodiscard]] function create_function(const prototype& a_prototype) {
+            m_function_sources.emplace_back(std::make_unique<bytecode_function_source>(m_environment, *this, a_prototype));
+            return { m_environment, m_function_sources.back().get() };
+        }
+
+        [[nodiscard]] object execute(const prototype& a_prototype, span<object> a_arguments);
+
+        // Bounds the slots the operand stack may allocate; segments allocated already are kept.
+        void set_stack_limit(const size_t a_limit) noexcept {
+            m_stack_limit = a_limit;
+        }
+
+        [[nodiscard]] size_t stack_limit() const noexcept {
+            return m_stack_limit;
+        }
+
+    protected:
+        // Tiering hooks. enter_frame runs a freshly set up frame of a_prototype whose parameter slots are filled.
+        // enter_loop is offered a frame that is about to jump back to a_loop_header; returning true means the
+        // remainder of the call was executed elsewhere and a_result holds its return value.
+        [[nodiscard]] virtual object enter_frame(const prototype& a_prototype, object* a_locals);
+        [[nodiscard]] virtual bool enter_loop(const prototype& a_prototype, const instruction* a_loop_header, object* a_locals, object* a_sp, object& a_result);
+
+        // Interprets a_prototype from a_ip with the given frame. A single step executes exactly one
+        // non-branching instruction and returns, which lets compiled code defer generic operations to the VM.
+        template <bool t_single_step>
+        object run(const prototype& a_prototype, object* a_locals, const instruction* a_ip, object* a_sp);
+
+        [[nodiscard]] environment& env() noexcept {
+            return m_environment;
+        }
+
+    private:
+        struct stack_segment {
+            std::unique_ptr<object[]> m_slots;
+            size_t m_size;
+        };
+
+        environment& m_environment;
+
+        // Operand stack of all active frames. Frames keep pointers into it, so it grows by segments that never
+        // move: a frame that does not fit the rest of the innermost frame's segment starts the next one.
+        std::vector<stack_segment> m_stack;
+        size_t m_stack_segment;
+        size_t m_stack_top;
+        size_t m_stack_limit;
+        std::vector<std::unique_ptr<prototype>> m_prototypes;
+        std::vector<std::unique_ptr<function_source>> m_function_sources;
+
+        // Bound native functions, referenced by address from the functions encoding them.
+        std::deque<callable> m_native_functions;
+
+        // Segment after the innermost frame's one, made to hold at least a_frame_size slots.
+        [[nodiscard]] size_t next_stack_segment(size_t a_frame_size);
+
+        [[nodiscard]] object update(object& a_assignee, separator a_operation, const object& a_value);
+
+        // Member reads and writes through a site's inline cache. Receivers the caches do not cover take the generic path.
+        [[nodiscard]] object select_member(const prototype& a_prototype, instruction a_instruction, object& a_receiver);
+        [[nodiscard]] object& index_member(const prototype& a_prototype, instruction a_instruction, object& a_receiver);
+        [[nodiscard]] static object* cached_shape_slot(inline_cache& a_cache, table& a_table, const object& a_key);
+        [[nodiscard]] static object* cached_method(inline_cache& a_cache, table& a_methods, const object& a_key);
+    };
+}
+
+#endif //REBAR_BYTECODE_PROVIDER_HPP
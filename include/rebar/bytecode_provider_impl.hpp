@@ -0,0 +1,717 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_BYTECODE_PROVIDER_IMPL_HPP
+#define REBAR_BYTECODE_PROVIDER_IMPL_HPP
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "bytecode_provider.hpp"
+
+#include "compiler.hpp"
+#include "compiler_impl.hpp"
+#include "environment.hpp"
+
+namespace rebar {
+    object bytecode_provider::bytecode_function_source::internal_call() {
+        return m_provider.execute(m_prototype, m_environment.get_args());
+    }
+
+    function bytecode_provider::compile(const std::shared_ptr<const parse_unit> a_unit) {
+        compiler unit_compiler(m_environment, *this);
+        return create_function(unit_compiler.compile(*a_unit));
+    }
+
+    object bytecode_provider::update(object& a_assignee, const separator a_operation, const object& a_value) {
+        // Unassignable targets resolve to the environment's null slot, which takes no updates.
+        if (&a_assignee == &m_environment.null_slot()) {
+            return null;
+        }
+
+        if (a_assignee.is_native_object()) {
+            native_object assignee = a_assignee.get_native_object();
+
+            switch (a_operation) {
+                case separator::addition_assignment:
+                    assignee.overload_addition_assignment(m_environment, a_value);
+                    break;
+                case separator::subtraction_assignment:
+                    assignee.overload_subtraction_assignment(m_environment, a_value);
+                    break;
+                case separator::multiplication_assignment:
+                    assignee.overload_multiplication_assignment(m_environment, a_value);
+                    break;
+                case separator::division_assignment:
+                    assignee.overload_division_assignment(m_environment, a_value);
+                    break;
+                case separator::modulus_assignment:
+                    assignee.overload_modulus_assignment(m_environment, a_value);
+                    break;
+                case separator::exponent_assignment:
+                    assignee.overload_exponent_assignment(m_environment, a_value);
+                    break;
+                case separator::bitwise_or_assignment:
+                    assignee.overload_bitwise_or_assignment(m_environment, a_value);
+                    break;
+                case separator::bitwise_xor_assignment:
+                    assignee.overload_bitwise_xor_assignment(m_environment, a_value);
+                    break;
+                case separator::bitwise_and_assignment:
+                    assignee.overload_bitwise_and_assignment(m_environment, a_value);
+                    break;
+                case separator::shift_left_assignment:
+                    assignee.overload_shift_left_assignment(m_environment, a_value);
+                    break;
+                case separator::shift_right_assignment:
+                    assignee.overload_shift_right_assignment(m_environment, a_value);
+                    break;
+                case separator::operation_prefix_increment:
+                    assignee.overload_prefix_increment(m_environment);
+                    break;
+                case separator::operation_prefix_decrement:
+                    assignee.overload_prefix_decrement(m_environment);
+                    break;
+                case separator::operation_postfix_increment:
+                    return assignee.overload_postfix_increment(m_environment);
+                case separator::operation_postfix_decrement:
+                    return assignee.overload_postfix_decrement(m_environment);
+                default:
+                    break;
+            }
+
+            return a_assignee;
+        }
+
+        switch (a_operation) {
+            case separator::addition_assignment:
+                a_assignee = object::add(m_environment, a_assignee, a_value);
+                break;
+            case separator::subtraction_assignment:
+                a_assignee = object::subtract(m_environment, a_assignee, a_value);
+                break;
+            case separator::multiplication_assignment:
+                a_assignee = object::multiply(m_environment, a_assignee, a_value);
+                break;
+            case separator::division_assignment:
+                a_assignee = object::divide(m_environment, a_assignee, a_value);
+                break;
+            case separator::modulus_assignment:
+                a_assignee = object::modulus(m_environment, a_assignee, a_value);
+                break;
+            case separator::exponent_assignment:
+                a_assignee = object::exponentiate(m_environment, a_assignee, a_value);
+                break;
+            case separator::bitwise_or_assignment:
+                a_assignee = object::bitwise_or(m_environment, a_assignee, a_value);
+                break;
+            case separator::bitwise_xor_assignment:
+                a_assignee = object::bitwise_xor(m_environment, a_assignee, a_value);
+                break;
+            case separator::bitwise_and_assignment:
+                a_assignee = object::bitwise_and(m_environment, a_assignee, a_value);
+                break;
+            case separator::shift_left_assignment:
+                a_assignee = object::shift_left(m_environment, a_assignee, a_value);
+                break;
+            case separator::shift_right_assignment:
+                a_assignee = object::shift_right(m_environment, a_assignee, a_value);
+                break;
+            case separator::operation_prefix_increment:
+                a_assignee = object::add(m_environment, a_assignee, 1);
+                break;
+            case separator::operation_prefix_decrement:
+                a_assignee = object::subtract(m_environment, a_assignee, 1);
+                break;
+            case separator::operation_postfix_increment: {
+                object initial = a_assignee;
+                a_assignee = object::add(m_environment, initial, 1);
+                return initial;
+            }
+            case separator::operation_postfix_decrement: {
+                object initial = a_assignee;
+                a_assignee = object::subtract(m_environment, initial, 1);
+                return initial;
+            }
+            default:
+                break;
+        }
+
+        return a_assignee;
+    }
+
+    object bytecode_provider::select_member(const prototype& a_prototype, const instruction a_instruction, object& a_receiver) {
+        const object& key = a_prototype.m_constants[a_instruction.m_operand];
+
+        if (a_instruction.m_count != no_inline_cache) {
+            inline_cache& cache = a_prototype.m_inline_caches[a_instruction.m_count];
+            const object* found = nullptr;
+
+            switch (a_receiver.object_type()) {
+                case type::table:
+                    found = cached_shape_slot(cache, a_receiver.get_table(), key);
+                    break;
+                case type::string:
+                    found = cached_method(cache, m_environment.get_string_virtual_table(), key);
+                    break;
+                case type::native_object: {
+                    virtual_table& methods = a_receiver.get_native_object().get_virtual_table();
+
+                    // A custom select overload takes precedence over the virtual table and cannot be cached.
+                    if (methods.overload_operation_select == virtual_table::null_of_1) {
+                        found = cached_method(cache, methods, key);
+                    }
+
+                    break;
+                }
+                default:
+                    break;
+            }
+
+            if (found != nullptr) {
+                return *found;
+            }
+        }
+
+        return a_receiver.select(m_environment, key);
+    }
+
+    object& bytecode_provider::index_member(const prototype& a_prototype, const instruction a_instruction, object& a_receiver) {
+        const object& key = a_prototype.m_constants[a_instruction.m_operand];
+
+        if (a_instruction.m_count != no_inline_cache && a_receiver.is_table()) {
+            if (object* found = cached_shape_slot(a_prototype.m_inline_caches[a_instruction.m_count], a_receiver.get_table(), key)) {
+                return *found;
+            }
+        }
+
+        return a_receiver.index(m_environment, key);
+    }
+
+    object* bytecode_provider::cached_shape_slot(inline_cache& a_cache, table& a_table, const object& a_key) {
+        const shape* table_shape = a_table.get_shape();
+
+        if (table_shape == nullptr) {
+            return nullptr;
+        }
+
+        for (size_t i = 0; i < a_cache.m_size; ++i) {
+            if (a_cache.m_entries[i].m_key == table_shape) {
+                return &a_table.slot(a_cache.m_entries[i].m_slot);
+            }
+        }
+
+        const size_t slot = table_shape->find(a_key);
+
+        if (slot == shape::npos) {
+            return nullptr;
+        }
+
+        if (a_cache.m_size < inline_cache::max_entries) {
+            a_cache.m_entries[a_cache.m_size++] = { table_shape, 0, slot, nullptr };
+        }
+
+        return &a_table.slot(slot);
+    }
+
+    object* bytecode_provider::cached_method(inline_cache& a_cache, table& a_methods, const object& a_key) {
+        inline_cache::entry* stale = nullptr;
+
+        for (size_t i = 0; i < a_cache.m_size; ++i) {
+            inline_cache::entry& entry = a_cache.m_entries[i];
+
+            if (entry.m_key == &a_methods) {
+                if (entry.m_version == a_methods.layout_version()) {
+                    return entry.m_value;
+                }
+
+                stale = &entry;
+                break;
+            }
+        }
+
+        object* found = a_methods.find(a_key);
+
+        if (found == nullptr) {
+            return nullptr;
+        }
+
+        if (stale != nullptr) {
+            *stale = { &a_methods, a_methods.layout_version(), 0, found };
+        } else if (a_cache.m_size < inline_cache::max_entries) {
+            a_cache.m_entries[a_cache.m_size++] = { &a_methods, a_methods.layout_version(), 0, found };
+        }
+
+        return found;
+    }
+
+    object bytecode_provider::execute(const prototype& a_prototype, const span<object> a_arguments) {
+        const size_t frame_size = a_prototype.m_local_count + a_prototype.m_max_stack;
+        size_t segment = m_stack_segment;
+        size_t base = m_stack_top;
+
+        if (base + frame_size > m_stack[segment].m_size) {
+            segment = next_stack_segment(frame_size);
+            base = 0;
+        }
+
+        // Releases every slot of the frame and the frame's stack reservation, including on unwind.
+        struct frame_guard {
+            bytecode_provider& m_provider;
+            object* m_slots;
+            size_t m_size;
+            size_t m_previous_segment;
+            size_t m_previous_top;
+
+            ~frame_guard() {
+                for (size_t i = 0; i < m_size; ++i) {
+                    m_slots[i] = null;
+                }
+
+                m_provider.m_stack_segment = m_previous_segment;
+                m_provider.m_stack_top = m_previous_top;
+            }
+        } guard{ *this, m_stack[segment].m_slots.get() + base, frame_size, m_stack_segment, m_stack_top };
+
+        m_stack_segment = segment;
+        m_stack_top = base + frame_size;
+
+        object* const locals = guard.m_slots;
+        const size_t argument_count = std::min(a_prototype.m_parameter_count, a_arguments.size());
+
+        for (size_t i = 0; i < argument_count; ++i) {
+            locals[i] = a_arguments[i];
+        }
+
+        return enter_frame(a_prototype, locals);
+    }
+
+    size_t bytecode_provider::next_stack_segment(const size_t a_frame_size) {
+        const size_t next = m_stack_segment + 1;
+
+        if (next < m_stack.size() && m_stack[next].m_size >= a_frame_size) {
+            return next;
+        }
+
+        // Segments past the innermost frame's one are unused, so a segment too small can be replaced.
+        const size_t size = std::max(default_stack_size, a_frame_size);
+        size_t allocated = size;
+
+        for (size_t i = 0; i < std::min(next, m_stack.size()); ++i) {
+            allocated += m_stack[i].m_size;
+        }
+
+        if (allocated > m_stack_limit) {
+            throw std::runtime_error("Rebar bytecode stack overflow.");
+        }
+
+        stack_segment created{ std::make_unique<object[]>(size), size };
+
+        if (next < m_stack.size()) {
+            m_stack[next] = std::move(created);
+        } else {
+            m_stack.push_back(std::move(created));
+        }
+
+        return next;
+    }
+
+    object bytecode_provider::enter_frame(const prototype& a_prototype, object* a_locals) {
+        return run<false>(a_prototype, a_locals, a_prototype.m_code.data(), a_locals + a_prototype.m_local_count);
+    }
+
+    bool bytecode_provider::enter_loop(const prototype&, const instruction*, object*, object*, object&) {
+        return false;
+    }
+
+    template <bool t_single_step>
+    object bytecode_provider::run(const prototype& a_prototype, object* const a_locals, const instruction* a_ip, object* a_sp) {
+        environment& env = m_environment;
+        global_scope& globals = env.global_table();
+        const instruction* const code = a_prototype.m_code.data();
+        const object* const constants = a_prototype.m_constants.data();
+
+        object* const locals = a_locals;
+        const instruction* ip = a_ip;
+        object* sp = a_sp;
+
+        const auto pop = [&sp]() noexcept -> object {
+            object value = sp[-1];
+            *--sp = null;
+            return value;
+        };
+
+        for (;;) {
+            const instruction instr = *ip++;
+
+            switch (instr.m_opcode) {
+                case opcode::push_null:
+                    ++sp;
+                    break;
+                case opcode::push_true:
+                    *sp++ = object(true);
+                    break;
+                case opcode::push_false:
+                    *sp++ = object(false);
+                    break;
+                case opcode::push_constant:
+                    *sp++ = constants[instr.m_operand];
+                    break;
+                case opcode::pop:
+                    *--sp = null;
+                    break;
+                case opcode::duplicate:
+                    *sp = sp[-1];
+                    ++sp;
+                    break;
+                case opcode::load_local:
+                    *sp++ = locals[instr.m_operand];
+                    break;
+                case opcode::store_local:
+                    locals[instr.m_operand] = sp[-1];
+                    break;
+                case opcode::load_global:
+                    *sp++ = globals.index(constants[instr.m_operand]);
+                    break;
+                case opcode::store_global:
+                    globals[constants[instr.m_operand]] = sp[-1];
+                    break;
+                case opcode::get_member:
+                    sp[-1] = select_member(a_prototype, instr, sp[-1]);
+                    break;
+                case opcode::set_member: {
+                    object value = pop();
+                    object target = sp[-1];
+                    index_member(a_prototype, instr, target) = value;
+                    sp[-1] = value;
+                    break;
+                }
+                case opcode::get_index: {
+                    object key = pop();
+                    sp[-1] = sp[-1].select(env, key);
+                    break;
+                }
+                case opcode::set_index: {
+                    object value = pop();
+                    object key = pop();
+                    object target = sp[-1];
+                    target.index(env, key) = value;
+                    sp[-1] = value;
+                    break;
+                }
+                case opcode::get_range: {
+                    object upper = pop();
+                    object lower = pop();
+                    sp[-1] = sp[-1].select(env, lower, upper);
+                    break;
+                }
+                case opcode::update_local:
+                case opcode::update_global: {
+                    const auto operation = static_cast<separator>(instr.m_count);
+                    object& variable = instr.m_opcode == opcode::update_local ? locals[instr.m_operand] : globals[constants[instr.m_operand]];
+
+                    // Integer counters are the common case in loops; skip the generic operator dispatch.
+                    if (variable.is_integer() && operation == separator::operation_prefix_increment) {
+                        variable = variable.get_integer() + 1;
+                        *sp++ = variable;
+                    } else if (variable.is_integer() && operation == separator::operation_postfix_increment) {
+                        *sp++ = variable;
+                        variable = variable.get_integer() + 1;
+                    } else if (variable.is_integer() && operation == separator::addition_assignment && sp[-1].is_integer()) {
+                        variable = variable.get_integer() + sp[-1].get_integer();
+                        sp[-1] = variable;
+                    } else if (update_takes_operand(operation)) {
+                        object value = sp[-1];
+                        sp[-1] = update(variable, operation, value);
+                    } else {
+                        *sp = update(variable, operation, null);
+                        ++sp;
+                    }
+
+                    break;
+                }
+                case opcode::update_member: {
+                    const auto operation = static_cast<separator>(instr.m_count);
+                    object value = update_takes_operand(operation) ? pop() : null;
+                    object target = sp[-1];
+                    sp[-1] = update(target.index(env, constants[instr.m_operand]), operation, value);
+                    break;
+                }
+                case opcode::update_index: {
+                    const auto operation = static_cast<separator>(instr.m_count);
+                    object value = update_takes_operand(operation) ? pop() : null;
+                    object key = pop();
+                    object target = sp[-1];
+                    sp[-1] = update(target.index(env, key), operation, value);
+                    break;
+                }
+                case opcode::add: {
+                    object& lhs = sp[-2];
+                    const object& rhs = sp[-1];
+
+                    if (lhs.is_integer() && rhs.is_integer()) {
+                        lhs = lhs.get_integer() + rhs.get_integer();
+                    } else if (lhs.is_number() && rhs.is_number()) {
+                        lhs = lhs.get_number() + rhs.get_number();
+                    } else {
+                        lhs = object::add(env, lhs, rhs);
+                    }
+
+                    *--sp = null;
+                    break;
+                }
+                case opcode::subtract: {
+                    object& lhs = sp[-2];
+                    const object& rhs = sp[-1];
+
+                    if (lhs.is_integer() && rhs.is_integer()) {
+                        lhs = lhs.get_integer() - rhs.get_integer();
+                    } else if (lhs.is_number() && rhs.is_number()) {
+                        lhs = lhs.get_number() - rhs.get_number();
+                    } else {
+                        lhs = object::subtract(env, lhs, rhs);
+                    }
+
+                    *--sp = null;
+                    break;
+                }
+                case opcode::multiply: {
+                    object& lhs = sp[-2];
+                    const object& rhs = sp[-1];
+
+                    if (lhs.is_integer() && rhs.is_integer()) {
+                        lhs = lhs.get_integer() * rhs.get_integer();
+                    } else if (lhs.is_number() && rhs.is_number()) {
+                        lhs = lhs.get_number() * rhs.get_number();
+                    } else {
+                        lhs = object::multiply(env, lhs, rhs);
+                    }
+
+                    *--sp = null;
+                    break;
+                }
+                case opcode::divide:
+                    sp[-2] = object::divide(env, sp[-2], sp[-1]);
+                    *--sp = null;
+                    break;
+                case opcode::modulus:
+                    sp[-2] = object::modulus(env, sp[-2], sp[-1]);
+                    *--sp = null;
+                    break;
+                case opcode::exponentiate:
+                    sp[-2] = object::exponentiate(env, sp[-2], sp[-1]);
+                    *--sp = null;
+                    break;
+                case opcode::equals:
+                    sp[-2] = object::equals(env, sp[-2], sp[-1]);
+                    *--sp = null;
+                    break;
+                case opcode::not_equals:
+                    sp[-2] = object::not_equals(env, sp[-2], sp[-1]);
+                    *--sp = null;
+                    break;
+                case opcode::greater: {
+                    // Integer comparisons skip the dispatch of the generic operations and yield the same 1 or 0.
+                    object& lhs = sp[-2];
+                    const object& rhs = sp[-1];
+
+                    if (lhs.is_integer() && rhs.is_integer()) {
+                        lhs = static_cast<integer>(lhs.get_integer() > rhs.get_integer());
+                    } else {
+                        lhs = object::greater_than(env, lhs, rhs);
+                    }
+
+                    *--sp = null;
+                    break;
+                }
+                case opcode::lesser: {
+                    object& lhs = sp[-2];
+                    const object& rhs = sp[-1];
+
+                    if (lhs.is_integer() && rhs.is_integer()) {
+                        lhs = static_cast<integer>(lhs.get_integer() < rhs.get_integer());
+                    } else {
+                        lhs = object::lesser_than(env, lhs, rhs);
+                    }
+
+                    *--sp = null;
+                    break;
+                }
+                case opcode::greater_equal: {
+                    object& lhs = sp[-2];
+                    const object& rhs = sp[-1];
+
+                    if (lhs.is_integer() && rhs.is_integer()) {
+                        lhs = static_cast<integer>(lhs.get_integer() >= rhs.get_integer());
+                    } else {
+                        lhs = object::greater_than_equal_to(env, lhs, rhs);
+                    }
+
+                    *--sp = null;
+                    break;
+                }
+                case opcode::lesser_equal: {
+                    object& lhs = sp[-2];
+                    const object& rhs = sp[-1];
+
+                    if (lhs.is_integer() && rhs.is_integer()) {
+                        lhs = static_cast<integer>(lhs.get_integer() <= rhs.get_integer());
+                    } else {
+                        lhs = object::lesser_than_equal_to(env, lhs, rhs);
+                    }
+
+                    *--sp = null;
+                    break;
+                }
+                case opcode::bitwise_or:
+                    sp[-2] = object::bitwise_or(env, sp[-2], sp[-1]);
+                    *--sp = null;
+                    break;
+                case opcode::bitwise_xor:
+                    sp[-2] = object::bitwise_xor(env, sp[-2], sp[-1]);
+                    *--sp = null;
+                    break;
+                case opcode::bitwise_and:
+                    sp[-2] = object::bitwise_and(env, sp[-2], sp[-1]);
+                    *--sp = null;
+                    break;
+                case opcode::shift_left:
+                    sp[-2] = object::shift_left(env, sp[-2], sp[-1]);
+                    *--sp = null;
+                    break;
+                case opcode::shift_right:
+                    sp[-2] = object::shift_right(env, sp[-2], sp[-1]);
+                    *--sp = null;
+                    break;
+                case opcode::logical_not:
+                    sp[-1] = object::logical_not(env, sp[-1]);
+                    break;
+                case opcode::bitwise_not:
+                    sp[-1] = object::bitwise_not(env, sp[-1]);
+                    break;
+                case opcode::length:
+                    sp[-1] = sp[-1].length(env);
+                    break;
+                case opcode::or_jump:
+                    if (!sp[-1].is_native_object() && sp[-1].boolean_evaluate()) {
+                        ip = code + instr.m_operand;
+                    }
+
+                    break;
+                case opcode::and_jump:
+                    if (!sp[-1].is_native_object() && !sp[-1].boolean_evaluate()) {
+                        sp[-1] = object(false);
+                        ip = code + instr.m_operand;
+                    }
+
+                    break;
+                case opcode::logical_or:
+                    // Reached only when the left operand did not short-circuit.
+                    if (sp[-2].is_native_object()) {
+                        sp[-2] = sp[-2].get_native_object().overload_logical_or(env, sp[-1]);
+                    } else {
+                        sp[-2] = sp[-1];
+                    }
+
+                    *--sp = null;
+                    break;
+                case opcode::logical_and:
+                    if (sp[-2].is_native_object()) {
+                        sp[-2] = sp[-2].get_native_object().overload_logical_and(env, sp[-1]);
+                    } else {
+                        sp[-2] = sp[-1];
+                    }
+
+                    *--sp = null;
+                    break;
+                case opcode::jump:
+                    // Backward jumps close loops; periodically offer hot loops to a higher execution tier.
+                    if (instr.m_operand < static_cast<size_t>(ip - code) && (++a_prototype.m_runtime.m_back_edge_count % back_edge_check_interval) == 0) {
+                        object result;
+
+                        if (enter_loop(a_prototype, code + instr.m_operand, locals, sp, result)) {
+                            return result;
+                        }
+                    }
+
+                    ip = code + instr.m_operand;
+                    break;
+                case opcode::jump_if_false:
+                    if (!pop().boolean_evaluate()) {
+                        ip = code + instr.m_operand;
+                    }
+
+                    break;
+                case opcode::load_method: {
+                    object receiver = sp[-1];
+                    sp[-1] = select_member(a_prototype, instr, receiver);
+                    *sp++ = receiver;
+                    break;
+                }
+                case opcode::call: {
+                    object* callee = sp - instr.m_count - 1;
+                    object result = callee->call(env, span<object>(callee + 1, instr.m_count));
+
+                    while (sp != callee + 1) {
+                        *--sp = null;
+                    }
+
+                    *callee = result;
+                    break;
+                }
+                case opcode::new_object: {
+                    object* type_object = sp - instr.m_count - 1;
+                    object result = type_object->new_object(env, span<object>(type_object + 1, instr.m_count));
+
+                    while (sp != type_object + 1) {
+                        *--sp = null;
+                    }
+
+                    *type_object = result;
+                    break;
+                }
+                case opcode::new_table: {
+                    table* tbl = env.create_table();
+                    object* entries = sp - 2 * instr.m_count;
+
+                    for (size_t i = 0; i < instr.m_count; ++i) {
+                        (*tbl)[entries[i * 2]] = entries[i * 2 + 1];
+                    }
+
+                    while (sp != entries) {
+                        *--sp = null;
+                    }
+
+                    *sp++ = tbl;
+                    break;
+                }
+                case opcode::new_array: {
+                    array arr(instr.m_count);
+                    env.collector().track(arr);
+
+                    object* elements = sp - instr.m_count;
+
+                    for (size_t i = 0; i < instr.m_count; ++i) {
+                        arr.push_back(elements[i]);
+                    }
+
+                    while (sp != elements) {
+                        *--sp = null;
+                    }
+
+                    *sp++ = arr;
+                    break;
+                }
+                case opcode::return_value:
+                    return pop();
+            }
+
+            if constexpr (t_single_step) {
+                return null;
+            }
+        }
+    }
+}
+
+#endif //REBAR_BYTECODE_PROVIDER_IMPL_HPP
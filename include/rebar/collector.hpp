@@ -0,0 +1,89 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_COLLECTOR_HPP
+#define REBAR_COLLECTOR_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "definitions.hpp"
+
+namespace rebar {
+    struct table;
+    struct array;
+    class cycle_collector;
+
+    // Registration of a container with a cycle collector. Copies of a container are never registered.
+    struct collector_link {
+        cycle_collector* m_collector = nullptr;
+        size_t m_index = 0;
+
+        collector_link() noexcept = default;
+        collector_link(const collector_link&) noexcept {}
+
+        collector_link& operator = (const collector_link&) noexcept {
+            return *this;
+        }
+    };
+
+    // Backup to reference counting that reclaims cyclic garbage among the script tables and arrays of an
+    // environment. A collection performs trial deletion over every tracked container: references between
+    // tracked containers are subtracted from their reference counts, whatever remains must come from outside
+    // (the stack, globals, native code), and everything not reachable from such externally referenced
+    // containers is garbage. Garbage is emptied first, which breaks its cycles, and then released.
+    //
+    // Collections run when the number of tracked containers reaches a threshold, and on demand via collect().
+    class cycle_collector {
+    public:
+        // Tracked containers at which the first automatic collection runs.
+        static constexpr size_t default_threshold = 1 << 12;
+
+        cycle_collector() = default;
+
+        cycle_collector(const cycle_collector&) = delete;
+        cycle_collector(cycle_collector&&) = delete;
+
+        cycle_collector& operator = (const cycle_collector&) = delete;
+        cycle_collector& operator = (cycle_collector&&) = delete;
+
+        ~cycle_collector();
+
+        // Starts tracking a container, first collecting if the threshold has been reached. The container being
+        // tracked is not part of that collection. Array views are not tracked.
+        void track(table& a_table);
+        void track(array& a_array);
+
+        void untrack(table& a_table) noexcept;
+        void untrack_array(void* a_root) noexcept;
+
+        // Reclaims unreachable cycles and returns the number of containers freed.
+        size_t collect();
+
+        [[nodiscard]] size_t tracked_count() const noexcept {
+            return m_tables.size() + m_arrays.size();
+        }
+
+        // Tracked containers at which automatic collections start. Zero disables them.
+        void set_threshold(const size_t a_threshold) noexcept {
+            m_threshold = a_threshold;
+            m_next_collection = a_threshold;
+        }
+
+    private:
+        std::vector<table*> m_tables;
+        std::vector<void*> m_arrays;
+        size_t m_threshold = default_threshold;
+        size_t m_next_collection = default_threshold;
+        bool m_collecting = false;
+
+        void maybe_collect();
+
+        // Accessors of a managed array given its root pointer, without touching its reference count.
+        [[nodiscard]] static array& array_at(void*& a_root) noexcept;
+        [[nodiscard]] static collector_link& array_link(void* a_root) noexcept;
+    };
+}
+
+#endif //REBAR_COLLECTOR_HPP
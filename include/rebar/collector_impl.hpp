@@ -0,0 +1,244 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_COLLECTOR_IMPL_HPP
+#define REBAR_COLLECTOR_IMPL_HPP
+
+#include <algorithm>
+
+#include "collector.hpp"
+
+#include "array.hpp"
+#include "object.hpp"
+#include "table.hpp"
+
+namespace rebar {
+    cycle_collector::~cycle_collector() {
+        for (table* tracked : m_tables) {
+            tracked->m_collector_link.m_collector = nullptr;
+        }
+
+        for (void* root : m_arrays) {
+            array_link(root).m_collector = nullptr;
+        }
+    }
+
+    void cycle_collector::track(table& a_table) {
+        maybe_collect();
+
+        a_table.m_collector_link.m_collector = this;
+        a_table.m_collector_link.m_index = m_tables.size();
+        m_tables.push_back(&a_table);
+    }
+
+    void cycle_collector::track(array& a_array) {
+        if (a_array.get_type() != array::type::managed) {
+            return;
+        }
+
+        maybe_collect();
+
+        collector_link& link = a_array.collector_link_reference();
+        link.m_collector = this;
+        link.m_index = m_arrays.size();
+        m_arrays.push_back(a_array.m_root_pointer);
+    }
+
+    void cycle_collector::untrack(table& a_table) noexcept {
+        const size_t index = a_table.m_collector_link.m_index;
+
+        m_tables[index] = m_tables.back();
+        m_tables[index]->m_collector_link.m_index = index;
+        m_tables.pop_back();
+
+        a_table.m_collector_link.m_collector = nullptr;
+    }
+
+    void cycle_collector::untrack_array(void* a_root) noexcept {
+        const size_t index = array_link(a_root).m_index;
+
+        m_arrays[index] = m_arrays.back();
+        array_link(m_arrays[index]).m_index = index;
+        m_arrays.pop_back();
+
+        array_link(a_root).m_collector = nullptr;
+    }
+
+    size_t cycle_collector::collect() {
+        if (m_collecting) {
+            return 0;
+        }
+
+        m_collecting = true;
+
+        // Nodes are numbered tables first, then arrays.
+        const size_t table_count = m_tables.size();
+        const size_t node_count = tracked_count();
+        constexpr size_t not_tracked = static_cast<size_t>(-1);
+
+        const auto node_of = [this, table_count](const object& a_object) noexcept -> size_t {
+            if (a_object.is_table()) {
+                const collector_link& link = a_object.get_table().m_collector_link;
+                return link.m_collector == this ? link.m_index : not_tracked;
+            }
+
+            if (a_object.is_array()) {
+                auto* root = reinterpret_cast<void*>(a_object.data());
+
+                if (array_at(root).get_type() == array::type::managed) {
+                    const collector_link& link = array_link(root);
+                    return link.m_collector == this ? table_count + link.m_index : not_tracked;
+                }
+            }
+
+            return not_tracked;
+        };
+
+        const auto for_each_child = [this, table_count, &node_of](const size_t a_node, auto&& a_function) {
+            if (a_node < table_count) {
+                m_tables[a_node]->for_each([&node_of, &a_function](const object& a_key, const object& a_value) {
+                    if (const size_t child = node_of(a_key); child != not_tracked) {
+                        a_function(child);
+                    }
+
+                    if (const size_t child = node_of(a_value); child != not_tracked) {
+                        a_function(child);
+                    }
+                });
+            } else {
+                for (const object& element : array_at(m_arrays[a_node - table_count]).vector_reference()) {
+                    if (const size_t child = node_of(element); child != not_tracked) {
+                        a_function(child);
+                    }
+                }
+            }
+        };
+
+        // Trial deletion: whatever part of a reference count is not explained by other tracked containers
+        // belongs to an external holder.
+        std::vector<size_t> counts(node_count);
+
+        for (size_t i = 0; i < table_count; ++i) {
+            counts[i] = m_tables[i]->m_reference_count;
+        }
+
+        for (size_t i = table_count; i < node_count; ++i) {
+            counts[i] = array_at(m_arrays[i - table_count]).reference_count_reference();
+        }
+
+        for (size_t i = 0; i < node_count; ++i) {
+            for_each_child(i, [&counts](const size_t a_child) {
+                --counts[a_child];
+            });
+        }
+
+        std::vector<bool> reachable(node_count);
+        std::vector<size_t> pending;
+
+        for (size_t i = 0; i < node_count; ++i) {
+            if (counts[i] != 0) {
+                reachable[i] = true;
+                pending.push_back(i);
+            }
+        }
+
+        while (!pending.empty()) {
+            const size_t node = pending.back();
+            pending.pop_back();
+
+            for_each_child(node, [&reachable, &pending](const size_t a_child) {
+                if (!reachable[a_child]) {
+                    reachable[a_child] = true;
+                    pending.push_back(a_child);
+                }
+            });
+        }
+
+        // Hold every garbage container so that none of them is freed while the others are being emptied, and
+        // stop tracking them before their destructors run.
+        std::vector<object> garbage;
+        std::vector<table*> live_tables;
+        std::vector<void*> live_arrays;
+
+        for (size_t i = 0; i < node_count; ++i) {
+            if (reachable[i]) {
+                continue;
+            }
+
+            if (i < table_count) {
+                garbage.emplace_back(m_tables[i]);
+            } else {
+                garbage.emplace_back(array_at(m_arrays[i - table_count]));
+            }
+        }
+
+        if (garbage.empty()) {
+            m_collecting = false;
+            m_next_collection = std::max(m_threshold, 2 * tracked_count());
+            return 0;
+        }
+
+        for (size_t i = 0; i < table_count; ++i) {
+            if (reachable[i]) {
+                m_tables[i]->m_collector_link.m_index = live_tables.size();
+                live_tables.push_back(m_tables[i]);
+            } else {
+                m_tables[i]->m_collector_link.m_collector = nullptr;
+            }
+        }
+
+        for (size_t i = table_count; i < node_count; ++i) {
+            void* root = m_arrays[i - table_count];
+
+            if (reachable[i]) {
+                array_link(root).m_index = live_arrays.size();
+                live_arrays.push_back(root);
+            } else {
+                array_link(root).m_collector = nullptr;
+            }
+        }
+
+        m_tables.swap(live_tables);
+        m_arrays.swap(live_arrays);
+
+        for (object& held : garbage) {
+            if (held.is_table()) {
+                held.get_table().clear();
+            } else {
+                auto* root = reinterpret_cast<void*>(held.data());
+                std::vector<object>().swap(array_at(root).vector_reference());
+            }
+        }
+
+        const size_t freed = garbage.size();
+        garbage.clear();
+
+        m_collecting = false;
+        m_next_collection = std::max(m_threshold, 2 * tracked_count());
+
+        return freed;
+    }
+
+    void cycle_collector::maybe_collect() {
+        if (m_threshold != 0 && !m_collecting && tracked_count() >= m_next_collection) {
+            static_cast<void>(collect());
+        }
+    }
+
+    array& cycle_collector::array_at(void*& a_root) noexcept {
+        return *reinterpret_cast<array*>(&a_root);
+    }
+
+    collector_link& cycle_collector::array_link(void* a_root) noexcept {
+        return array_at(a_root).collector_link_reference();
+    }
+
+    table::~table() {
+        if (cycle_collector* collector = m_collector_link.m_collector) {
+            collector->untrack(*this);
+        }
+    }
+}
+
+#endif //REBAR_COLLECTOR_IMPL_HPP
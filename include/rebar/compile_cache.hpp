@@ -0,0 +1,85 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_COMPILE_CACHE_HPP
+#define REBAR_COMPILE_CACHE_HPP
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "lexer.hpp"
+#include "lru_cache.hpp"
+#include "preprocess.hpp"
+
+namespace rebar {
+    // Parse units shared between environments, keyed by the xxhash of their source text. Lexing and parsing a
+    // source that any environment using the cache has seen before is skipped; each environment still compiles
+    // the shared unit itself, as compiled code refers to the environment's strings and tables.
+    //
+    // Units are parsed with the lexer of the first environment that compiles their source, so a cache should
+    // only be shared by environments with the same symbol map. The cache holds the default_capacity most recently
+    // used units unless told otherwise, and is safe to use from several threads.
+    class compile_cache {
+    public:
+        static constexpr size_t default_capacity = 1024;
+
+        explicit compile_cache(const size_t a_capacity = default_capacity) : m_units(a_capacity) {}
+
+        compile_cache(const compile_cache&) = delete;
+        compile_cache& operator = (const compile_cache&) = delete;
+
+        // Parse unit of a_source, parsed with a_lexer if the cache does not hold it yet.
+        [[nodiscard]] std::shared_ptr<const parse_unit> get(lexer& a_lexer, const std::string_view a_source) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                if (auto* found = m_units.find(a_source)) {
+                    return *found;
+                }
+            }
+
+            // Parsed outside the lock; if another thread parsed the same source meanwhile, its unit is kept.
+            auto unit = std::make_shared<const parse_unit>(parse(a_lexer, std::string(a_source)));
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (auto* found = m_units.find(a_source)) {
+                return *found;
+            }
+
+            m_units.insert(std::string(a_source), unit);
+            return unit;
+        }
+
+        [[nodiscard]] size_t size() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_units.size();
+        }
+
+        [[nodiscard]] size_t capacity() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_units.capacity();
+        }
+
+        // Evicts the least recently used units beyond a_capacity. Zero disables the cache.
+        void set_capacity(const size_t a_capacity) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_units.set_capacity(a_capacity);
+        }
+
+        // Releases the cache's references; environments keep the units they have compiled.
+        void clear() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_units.clear();
+        }
+
+    private:
+        mutable std::mutex m_mutex;
+        lru_cache<std::shared_ptr<const parse_unit>> m_units;
+    };
+}
+
+#endif //REBAR_COMPILE_CACHE_HPP
@@ -0,0 +1,115 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_COMPILER_HPP
+#define REBAR_COMPILER_HPP
+
+#include <functional>
+#include <limits>
+#include <unordered_map>
+
+#include "bytecode.hpp"
+#include "flat_ast.hpp"
+#include "preprocess.hpp"
+
+namespace rebar {
+    class environment;
+    struct bytecode_provider;
+
+    // Lowers a parse unit into bytecode prototypes owned by a bytecode_provider.
+    class compiler {
+    public:
+        compiler(environment& a_environment, bytecode_provider& a_provider) noexcept : m_environment(a_environment), m_provider(a_provider) {}
+
+        [[nodiscard]] prototype& compile(const parse_unit& a_unit);
+
+    private:
+        // Sentinel slot for identifiers that do not resolve to a local and are looked up in the global table.
+        static constexpr uint32_t global_slot = std::numeric_limits<uint32_t>::max();
+
+        struct loop_state {
+            std::vector<size_t> m_breaks;
+            std::vector<size_t> m_continues;
+        };
+
+        struct function_state {
+            prototype& m_prototype;
+            std::unordered_map<object, uint32_t> m_constant_indices;
+            int m_stack_depth = 0;
+
+            // Locals visible at the current point of compilation; a local's frame slot is its index.
+            std::vector<object> m_locals;
+            std::vector<size_t> m_scopes;
+            std::vector<loop_state> m_loops;
+
+            explicit function_state(prototype& a_prototype) noexcept : m_prototype(a_prototype) {}
+        };
+
+        enum class target_type : enum_base {
+            none,
+            local,
+            global,
+            local_declaration,
+            member,
+            index
+        };
+
+        struct target {
+            target_type m_type = target_type::none;
+            object m_key;
+            uint32_t m_slot = global_slot;
+            flat_node m_object;
+            flat_node m_index;
+        };
+
+        environment& m_environment;
+        bytecode_provider& m_provider;
+        function_state* m_function = nullptr;
+
+        size_t emit(instruction a_instruction);
+        size_t emit(opcode a_opcode, uint32_t a_operand = 0, uint16_t a_count = 0);
+
+        // Allocates an inline cache for a member access site in the current function.
+        [[nodiscard]] uint16_t inline_cache_index();
+        void patch(size_t a_instruction_index) noexcept;
+        void patch(size_t a_instruction_index, size_t a_target) noexcept;
+        [[nodiscard]] size_t position() const noexcept;
+        void set_stack_depth(int a_depth) noexcept;
+
+        [[nodiscard]] uint32_t constant(object a_object);
+        [[nodiscard]] object identifier(const token& a_token);
+
+        void compile_function(prototype& a_prototype, flat_range a_parameters, flat_range a_body);
+
+        void begin_scope();
+        void end_scope();
+        [[nodiscard]] uint32_t declare_local(object a_name);
+        [[nodiscard]] uint32_t resolve_local(object a_name) const noexcept;
+
+        void compile_block(flat_range a_block);
+        void compile_scoped_block(flat_range a_block);
+        void compile_if_chain(flat_range a_block, size_t& a_index);
+        void compile_for(flat_node a_declaration);
+        void compile_while(flat_node a_declaration);
+        void compile_function_declaration(flat_node a_declaration);
+        void compile_loop_exit(bool a_break);
+
+        void compile_node(flat_node a_node);
+        void compile_key(flat_node a_node);
+        void compile_expression(flat_node a_expression);
+        void compile_space(flat_node a_expression);
+        void compile_binary(flat_node a_expression, opcode a_opcode);
+        void compile_unary(flat_node a_expression, opcode a_opcode);
+        void compile_call(flat_node a_expression);
+        void compile_new(flat_node a_expression);
+        size_t compile_arguments(flat_range a_arguments);
+
+        [[nodiscard]] target resolve_target(flat_node a_node);
+        [[nodiscard]] target resolve_target_expression(flat_node a_expression);
+        void compile_store(const target& a_target, const std::function<void ()>& a_value);
+        void compile_update(const target& a_target, separator a_operation, const flat_node* a_value);
+    };
+}
+
+#endif //REBAR_COMPILER_HPP
@@ -0,0 +1,885 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_COMPILER_IMPL_HPP
+#define REBAR_COMPILER_IMPL_HPP
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "compiler.hpp"
+
+#include "bytecode_provider.hpp"
+#include "environment.hpp"
+
+namespace rebar {
+    namespace detail {
+        // Sets a_opcode to the instruction of a binary operator that evaluates both operands, left first.
+        [[nodiscard]] constexpr bool binary_opcode(const separator a_operation, opcode& a_opcode) noexcept {
+            switch (a_operation) {
+                case separator::addition:
+                    a_opcode = opcode::add;
+                    return true;
+                case separator::subtraction:
+                    a_opcode = opcode::subtract;
+                    return true;
+                case separator::multiplication:
+                    a_opcode = opcode::multiply;
+                    return true;
+                case separator::division:
+                    a_opcode = opcode::divide;
+                    return true;
+                case separator::modulus:
+                    a_opcode = opcode::modulus;
+                    return true;
+                case separator::exponent:
+                    a_opcode = opcode::exponentiate;
+                    return true;
+                case separator::equality:
+                    a_opcode = opcode::equals;
+                    return true;
+                case separator::inverse_equality:
+                    a_opcode = opcode::not_equals;
+                    return true;
+                case separator::greater:
+                    a_opcode = opcode::greater;
+                    return true;
+                case separator::lesser:
+                    a_opcode = opcode::lesser;
+                    return true;
+                case separator::greater_equality:
+                    a_opcode = opcode::greater_equal;
+                    return true;
+                case separator::lesser_equality:
+                    a_opcode = opcode::lesser_equal;
+                    return true;
+                case separator::bitwise_or:
+                    a_opcode = opcode::bitwise_or;
+                    return true;
+                case separator::bitwise_xor:
+                    a_opcode = opcode::bitwise_xor;
+                    return true;
+                case separator::bitwise_and:
+                    a_opcode = opcode::bitwise_and;
+                    return true;
+                case separator::shift_left:
+                    a_opcode = opcode::shift_left;
+                    return true;
+                case separator::shift_right:
+                    a_opcode = opcode::shift_right;
+                    return true;
+                default:
+                    return false;
+            }
+        }
+    }
+
+    prototype& compiler::compile(const parse_unit& a_unit) {
+        prototype& unit_prototype = m_provider.create_prototype();
+        compile_function(unit_prototype, {}, a_unit.m_ast.statements());
+        return unit_prototype;
+    }
+
+    size_t compiler::emit(const instruction a_instruction) {
+        auto& code = m_function->m_prototype.m_code;
+        code.push_back(a_instruction);
+
+        m_function->m_stack_depth += stack_effect(a_instruction);
+
+        if (m_function->m_stack_depth > static_cast<int>(m_function->m_prototype.m_max_stack)) {
+            m_function->m_prototype.m_max_stack = static_cast<size_t>(m_function->m_stack_depth);
+        }
+
+        return code.size() - 1;
+    }
+
+    size_t compiler::emit(const opcode a_opcode, const uint32_t a_operand, const uint16_t a_count) {
+        return emit(instruction(a_opcode, a_operand, a_count));
+    }
+
+    uint16_t compiler::inline_cache_index() {
+        auto& caches = m_function->m_prototype.m_inline_caches;
+
+        if (caches.size() >= no_inline_cache) {
+            return no_inline_cache;
+        }
+
+        caches.emplace_back();
+        return static_cast<uint16_t>(caches.size() - 1);
+    }
+
+    void compiler::patch(const size_t a_instruction_index) noexcept {
+        patch(a_instruction_index, position());
+    }
+
+    void compiler::patch(const size_t a_instruction_index, const size_t a_target) noexcept {
+        m_function->m_prototype.m_code[a_instruction_index].m_operand = static_cast<uint32_t>(a_target);
+    }
+
+    size_t compiler::position() const noexcept {
+        return m_function->m_prototype.m_code.size();
+    }
+
+    void compiler::set_stack_depth(const int a_depth) noexcept {
+        m_function->m_stack_depth = a_depth;
+    }
+
+    uint32_t compiler::constant(const object a_object) {
+        auto found = m_function->m_constant_indices.find(a_object);
+
+        if (found != m_function->m_constant_indices.cend()) {
+            return found->second;
+        }
+
+        auto& constants = m_function->m_prototype.m_constants;
+        const auto index = static_cast<uint32_t>(constants.size());
+
+        constants.push_back(a_object);
+        m_function->m_constant_indices.emplace(a_object, index);
+
+        return index;
+    }
+
+    object compiler::identifier(const token& a_token) {
+        return m_environment.str(a_token.get_identifier());
+    }
+
+    void compiler::compile_function(prototype& a_prototype, const flat_range a_parameters, const flat_range a_body) {
+        function_state state(a_prototype);
+        function_state* enclosing = m_function;
+        m_function = &state;
+
+        // Parameters occupy the leading frame slots in declaration order.
+        for (const flat_node parameter : a_parameters) {
+            if (parameter.empty()) {
+                continue;
+            }
+
+            const flat_node parameter_identifier = parameter.get_operands().back();
+
+            if (parameter_identifier.is_token() && parameter_identifier.get_token().is_identifier()) {
+                static_cast<void>(declare_local(identifier(parameter_identifier.get_token())));
+            } else {
+                static_cast<void>(declare_local(null));
+            }
+        }
+
+        a_prototype.m_parameter_count = state.m_locals.size();
+
+        compile_block(a_body);
+
+        emit(opcode::push_null);
+        emit(opcode::return_value);
+
+        m_function = enclosing;
+    }
+
+    void compiler::begin_scope() {
+        m_function->m_scopes.push_back(m_function->m_locals.size());
+    }
+
+    void compiler::end_scope() {
+        // Slots of the closed scope are reused by later declarations; no instructions are needed.
+        m_function->m_locals.resize(m_function->m_scopes.back());
+        m_function->m_scopes.pop_back();
+    }
+
+    uint32_t compiler::declare_local(const object a_name) {
+        auto& locals = m_function->m_locals;
+        const auto slot = static_cast<uint32_t>(locals.size());
+
+        locals.push_back(a_name);
+
+        if (locals.size() > m_function->m_prototype.m_local_count) {
+            m_function->m_prototype.m_local_count = locals.size();
+        }
+
+        return slot;
+    }
+
+    uint32_t compiler::resolve_local(const object a_name) const noexcept {
+        const auto& locals = m_function->m_locals;
+
+        for (size_t i = locals.size(); i >= 1; --i) {
+            if (!locals[i - 1].is_null() && locals[i - 1] == a_name) {
+                return static_cast<uint32_t>(i - 1);
+            }
+        }
+
+        return global_slot;
+    }
+
+    void compiler::compile_block(const flat_range a_block) {
+        for (size_t i = 0; i < a_block.size(); ++i) {
+            const flat_node n = a_block[i];
+
+            switch (n.get_type()) {
+                case node::type::expression:
+                    compile_expression(n);
+                    emit(opcode::pop);
+                    break;
+                case node::type::block:
+                    compile_scoped_block(n.get_operands());
+                    break;
+                case node::type::if_declaration:
+                    compile_if_chain(a_block, i);
+                    break;
+                case node::type::for_declaration:
+                    compile_for(n);
+                    break;
+                case node::type::while_declaration:
+                    compile_while(n);
+                    break;
+                case node::type::function_declaration:
+                    compile_function_declaration(n);
+                    break;
+                case node::type::return_statement:
+                    compile_expression(n);
+                    emit(opcode::return_value);
+                    break;
+                case node::type::break_statement:
+                    compile_loop_exit(true);
+                    break;
+                case node::type::continue_statement:
+                    compile_loop_exit(false);
+                    break;
+                default:
+                    // Orphaned else/else-if branches, do, switch and class declarations are not executable.
+                    break;
+            }
+        }
+    }
+
+    void compiler::compile_scoped_block(const flat_range a_block) {
+        begin_scope();
+        compile_block(a_block);
+        end_scope();
+    }
+
+    void compiler::compile_if_chain(const flat_range a_block, size_t& a_index) {
+        const flat_node if_decl = a_block[a_index];
+
+        std::vector<size_t> exits;
+
+        compile_expression(if_decl.get_conditional());
+        size_t skip = emit(opcode::jump_if_false);
+        bool has_skip = true;
+
+        compile_scoped_block(if_decl.get_body());
+
+        while (a_index + 1 < a_block.size()) {
+            const flat_node next = a_block[a_index + 1];
+
+            if (next.is_else_if_declaration()) {
+                exits.push_back(emit(opcode::jump));
+                patch(skip);
+
+                compile_expression(next.get_conditional());
+                skip = emit(opcode::jump_if_false);
+
+                compile_scoped_block(next.get_body());
+            } else if (next.is_else_declaration()) {
+                exits.push_back(emit(opcode::jump));
+                patch(skip);
+                has_skip = false;
+
+                compile_scoped_block(next.get_operands());
+
+                ++a_index;
+                break;
+            } else {
+                break;
+            }
+
+            ++a_index;
+        }
+
+        if (has_skip) {
+            patch(skip);
+        }
+
+        for (const auto exit : exits) {
+            patch(exit);
+        }
+    }
+
+    void compiler::compile_for(const flat_node a_declaration) {
+        begin_scope();
+
+        if (!a_declaration.get_initialization().empty()) {
+            compile_expression(a_declaration.get_initialization());
+            emit(opcode::pop);
+        }
+
+        const size_t loop_start = position();
+        size_t exit_jump = 0;
+        const bool has_condition = !a_declaration.get_conditional().empty();
+
+        if (has_condition) {
+            compile_expression(a_declaration.get_conditional());
+            exit_jump = emit(opcode::jump_if_false);
+        }
+
+        m_function->m_loops.emplace_back();
+
+        compile_scoped_block(a_declaration.get_body());
+
+        loop_state loop = std::move(m_function->m_loops.back());
+        m_function->m_loops.pop_back();
+
+        for (const auto continue_jump : loop.m_continues) {
+            patch(continue_jump);
+        }
+
+        if (!a_declaration.get_iteration().empty()) {
+            compile_expression(a_declaration.get_iteration());
+            emit(opcode::pop);
+        }
+
+        emit(opcode::jump, static_cast<uint32_t>(loop_start));
+
+        if (has_condition) {
+            patch(exit_jump);
+        }
+
+        for (const auto break_jump : loop.m_breaks) {
+            patch(break_jump);
+        }
+
+        end_scope();
+    }
+
+    void compiler::compile_while(const flat_node a_declaration) {
+        const size_t loop_start = position();
+
+        compile_expression(a_declaration.get_conditional());
+        const size_t exit_jump = emit(opcode::jump_if_false);
+
+        m_function->m_loops.emplace_back();
+
+        compile_scoped_block(a_declaration.get_body());
+
+        loop_state loop = std::move(m_function->m_loops.back());
+        m_function->m_loops.pop_back();
+
+        for (const auto continue_jump : loop.m_continues) {
+            patch(continue_jump, loop_start);
+        }
+
+        emit(opcode::jump, static_cast<uint32_t>(loop_start));
+
+        patch(exit_jump);
+
+        for (const auto break_jump : loop.m_breaks) {
+            patch(break_jump);
+        }
+    }
+
+    void compiler::compile_loop_exit(const bool a_break) {
+        if (m_function->m_loops.empty()) {
+            // TODO: Throw break/continue outside of loop error.
+            return;
+        }
+
+        auto& loop = m_function->m_loops.back();
+        const size_t jump = emit(opcode::jump);
+        (a_break ? loop.m_breaks : loop.m_continues).push_back(jump);
+    }
+
+    void compiler::compile_function_declaration(const flat_node a_declaration) {
+        prototype& function_prototype = m_provider.create_prototype();
+        compile_function(function_prototype, a_declaration.get_parameters(), a_declaration.get_body());
+
+        const object function_object = m_provider.create_function(function_prototype);
+
+        compile_store(resolve_target_expression(a_declaration.get_identifier()), [this, &function_object]() {
+            emit(opcode::push_constant, constant(function_object));
+        });
+
+        emit(opcode::pop);
+    }
+
+    void compiler::compile_node(const flat_node a_node) {
+        if (a_node.is_token()) {
+            const token& tok = a_node.get_token();
+
+            switch (tok.token_type()) {
+                case token::type::identifier: {
+                    const object name = identifier(tok);
+                    const uint32_t slot = resolve_local(name);
+
+                    if (slot != global_slot) {
+                        emit(opcode::load_local, slot);
+                    } else {
+                        emit(opcode::load_global, constant(name));
+                    }
+
+                    return;
+                }
+                case token::type::string_literal:
+                    emit(opcode::push_constant, constant(m_environment.str(tok.get_string_literal())));
+                    return;
+                case token::type::integer_literal:
+                    emit(opcode::push_constant, constant(tok.get_integer_literal()));
+                    return;
+                case token::type::number_literal:
+                    emit(opcode::push_constant, constant(tok.get_number_literal()));
+                    return;
+                case token::type::keyword:
+                    switch (tok.get_keyword()) {
+                        case keyword::literal_true:
+                            emit(opcode::push_true);
+                            return;
+                        case keyword::literal_false:
+                            emit(opcode::push_false);
+                            return;
+                        default:
+                            break;
+                    }
+                default:
+                    break;
+            }
+        } else if (a_node.is_group() || a_node.is_expression()) {
+            compile_expression(a_node);
+            return;
+        } else if (a_node.is_immediate_table()) {
+            for (size_t i = 0; i < a_node.entry_count(); ++i) {
+                compile_key(a_node.get_key(i));
+                compile_expression(a_node.get_value(i));
+            }
+
+            emit(opcode::new_table, 0, static_cast<uint16_t>(a_node.entry_count()));
+            return;
+        } else if (a_node.is_selector()) {
+            compile_expression(a_node);
+            emit(opcode::new_array, 0, 1);
+            return;
+        } else if (a_node.is_immediate_array()) {
+            for (const flat_node n : a_node.get_operands()) {
+                compile_node(n);
+            }
+
+            emit(opcode::new_array, 0, static_cast<uint16_t>(a_node.count()));
+            return;
+        }
+
+        emit(opcode::push_null);
+    }
+
+    void compiler::compile_key(const flat_node a_node) {
+        if (a_node.is_token() && a_node.get_token().is_identifier()) {
+            emit(opcode::push_constant, constant(identifier(a_node.get_token())));
+        } else {
+            compile_node(a_node);
+        }
+    }
+
+    void compiler::compile_expression(const flat_node a_expression) {
+        if (a_expression.empty()) {
+            emit(opcode::push_null);
+            return;
+        }
+
+        if (opcode binary; detail::binary_opcode(a_expression.get_operation(), binary)) {
+            compile_binary(a_expression, binary);
+            return;
+        }
+
+        switch (a_expression.get_operation()) {
+            case separator::space:
+                compile_space(a_expression);
+                return;
+            case separator::assignment: {
+                const flat_node value = a_expression.get_operand(1);
+
+                compile_store(resolve_target(a_expression.get_operand(0)), [this, value]() {
+                    compile_node(value);
+                });
+
+                return;
+            }
+            case separator::logical_not:
+                compile_unary(a_expression, opcode::logical_not);
+                return;
+            case separator::bitwise_not:
+                compile_unary(a_expression, opcode::bitwise_not);
+                return;
+            case separator::length:
+                compile_unary(a_expression, opcode::length);
+                return;
+            case separator::addition_assignment:
+            case separator::subtraction_assignment:
+            case separator::multiplication_assignment:
+            case separator::division_assignment:
+            case separator::modulus_assignment:
+            case separator::exponent_assignment:
+            case separator::bitwise_or_assignment:
+            case separator::bitwise_xor_assignment:
+            case separator::bitwise_and_assignment:
+            case separator::shift_left_assignment:
+            case separator::shift_right_assignment: {
+                const flat_node value = a_expression.get_operand(1);
+
+                compile_update(resolve_target(a_expression.get_operand(0)), a_expression.get_operation(), &value);
+                return;
+            }
+            case separator::operation_prefix_increment:
+            case separator::operation_postfix_increment:
+            case separator::operation_prefix_decrement:
+            case separator::operation_postfix_decrement:
+                compile_update(resolve_target(a_expression.get_operand(0)), a_expression.get_operation(), nullptr);
+                return;
+            case separator::increment:
+            case separator::decrement:
+                // Increments applied to compound operands are left untagged by the parser; treat them as prefix.
+                if (a_expression.count() == 1) {
+                    const auto operation = a_expression.get_operation() == separator::increment ? separator::operation_prefix_increment : separator::operation_prefix_decrement;
+                    compile_update(resolve_target(a_expression.get_operand(0)), operation, nullptr);
+                    return;
+                }
+
+                break;
+            case separator::logical_or:
+            case separator::logical_and: {
+                const bool is_or = a_expression.get_operation() == separator::logical_or;
+
+                compile_node(a_expression.get_operand(0));
+                const size_t short_circuit = emit(is_or ? opcode::or_jump : opcode::and_jump);
+
+                compile_node(a_expression.get_operand(1));
+                emit(is_or ? opcode::logical_or : opcode::logical_and);
+
+                patch(short_circuit);
+                return;
+            }
+            case separator::ternary: {
+                compile_node(a_expression.get_operand(0));
+                const size_t else_jump = emit(opcode::jump_if_false);
+                const int depth = m_function->m_stack_depth;
+
+                compile_node(a_expression.get_operand(1));
+                const size_t exit_jump = emit(opcode::jump);
+
+                set_stack_depth(depth);
+                patch(else_jump);
+
+                compile_node(a_expression.get_operand(2));
+                patch(exit_jump);
+                return;
+            }
+            case separator::namespace_index:
+            case separator::direct:
+            case separator::dot:
+                if (a_expression.count() == 2) {
+                    const flat_node member = a_expression.get_operand(1);
+
+                    compile_node(a_expression.get_operand(0));
+
+                    if (member.is_token() && member.get_token().is_identifier()) {
+                        emit(opcode::get_member, constant(identifier(member.get_token())), inline_cache_index());
+                    } else {
+                        compile_node(member);
+                        emit(opcode::get_index);
+                    }
+
+                    return;
+                }
+
+                break;
+            case separator::operation_index:
+                if (a_expression.count() == 2) {
+                    compile_node(a_expression.get_operand(0));
+                    compile_node(a_expression.get_operand(1));
+                    emit(opcode::get_index);
+                    return;
+                } else if (a_expression.count() > 2) {
+                    compile_node(a_expression.get_operand(0));
+                    compile_node(a_expression.get_operand(1));
+                    compile_node(a_expression.get_operand(2));
+                    emit(opcode::get_range);
+                    return;
+                }
+
+                break;
+            case separator::operation_call:
+                compile_call(a_expression);
+                return;
+            case separator::new_object:
+                compile_new(a_expression);
+                return;
+            default:
+                break;
+        }
+
+        emit(opcode::push_null);
+    }
+
+    void compiler::compile_space(const flat_node a_expression) {
+        if (a_expression.count() == 1) {
+            compile_node(a_expression.get_operand(0));
+            return;
+        }
+
+        // Leading keywords (local, const, function) qualify the final operand.
+        bool flag_local = false;
+
+        for (size_t i = 0; i + 1 < a_expression.count(); ++i) {
+            const flat_node qualifier = a_expression.get_operand(i);
+
+            if (qualifier.is_token() && qualifier.get_token().is_keyword() && qualifier.get_token().get_keyword() == keyword::local) {
+                flag_local = true;
+            }
+        }
+
+        const flat_node operand = a_expression.get_operands().back();
+
+        if (flag_local && operand.is_token() && operand.get_token().is_identifier()) {
+            emit(opcode::push_null);
+            emit(opcode::store_local, declare_local(identifier(operand.get_token())));
+            return;
+        }
+
+        compile_node(operand);
+    }
+
+    void compiler::compile_binary(const flat_node a_expression, const opcode a_opcode) {
+        // Generated code nests long chains such as "a + b + c + ..." to the left. Their left spine is walked
+        // down and compiled back up in a loop, so its length does not count against the native stack.
+        std::vector<std::pair<flat_node, opcode>> chain{ { a_expression, a_opcode } };
+        flat_node lhs = a_expression.get_operand(0);
+
+        for (opcode binary; (lhs.is_expression() || lhs.is_group()) && lhs.count() == 2 && detail::binary_opcode(lhs.get_operation(), binary); lhs = lhs.get_operand(0)) {
+            chain.emplace_back(lhs, binary);
+        }
+
+        compile_node(lhs);
+
+        for (size_t i = chain.size(); i >= 1; --i) {
+            compile_node(chain[i - 1].first.get_operand(1));
+            emit(chain[i - 1].second);
+        }
+    }
+
+    void compiler::compile_unary(const flat_node a_expression, const opcode a_opcode) {
+        compile_node(a_expression.get_operand(0));
+        emit(a_opcode);
+    }
+
+    void compiler::compile_call(const flat_node a_expression) {
+        const flat_node callable_node = a_expression.get_operand(0);
+        size_t argument_count = 0;
+
+        if (callable_node.is_expression() || callable_node.is_group()) {
+            const flat_node expr = callable_node;
+
+            if (expr.get_operation() == separator::dot && expr.count() == 2 && expr.get_operand(1).is_token() && expr.get_operand(1).get_token().is_identifier()) {
+                // Method call: the receiver is passed as the first argument.
+                compile_node(expr.get_operand(0));
+                emit(opcode::load_method, constant(identifier(expr.get_operand(1).get_token())), inline_cache_index());
+                argument_count = 1;
+            } else {
+                compile_node(callable_node);
+            }
+        } else {
+            compile_node(callable_node);
+        }
+
+        argument_count += compile_arguments(a_expression.get_operands().subrange(1));
+
+        emit(opcode::call, 0, static_cast<uint16_t>(argument_count));
+    }
+
+    void compiler::compile_new(const flat_node a_expression) {
+        const flat_node operand = a_expression.get_operand(0);
+
+        // "new Type(args)" parses as a call nested in the new operation.
+        if ((operand.is_expression() || operand.is_group()) && operand.get_operation() == separator::operation_call && a_expression.count() == 1) {
+            compile_node(operand.get_operand(0));
+            const size_t argument_count = compile_arguments(operand.get_operands().subrange(1));
+
+            emit(opcode::new_object, 0, static_cast<uint16_t>(argument_count));
+            return;
+        }
+
+        compile_node(operand);
+        const size_t argument_count = compile_arguments(a_expression.get_operands().subrange(1));
+
+        emit(opcode::new_object, 0, static_cast<uint16_t>(argument_count));
+    }
+
+    size_t compiler::compile_arguments(const flat_range a_arguments) {
+        // An empty argument group, i.e. "f()", parses as a single empty expression.
+        if (a_arguments.size() == 1 && (a_arguments[0].is_expression() || a_arguments[0].is_group()) && a_arguments[0].empty()) {
+            return 0;
+        }
+
+        for (const flat_node argument : a_arguments) {
+            compile_node(argument);
+        }
+
+        return a_arguments.size();
+    }
+
+    compiler::target compiler::resolve_target(const flat_node a_node) {
+        if (a_node.is_token()) {
+            const token& tok = a_node.get_token();
+
+            if (tok.is_identifier()) {
+                const object name = identifier(tok);
+                const uint32_t slot = resolve_local(name);
+
+                return { slot != global_slot ? target_type::local : target_type::global, name, slot, flat_node(), flat_node() };
+            }
+        } else if (a_node.is_group() || a_node.is_selector() || a_node.is_expression()) {
+            return resolve_target_expression(a_node);
+        }
+
+        return {};
+    }
+
+    compiler::target compiler::resolve_target_expression(const flat_node a_expression) {
+        if (a_expression.empty()) {
+            return {};
+        }
+
+        switch (a_expression.get_operation()) {
+            case separator::space: {
+                bool flag_local = false;
+
+                for (size_t i = 0; i + 1 < a_expression.count(); ++i) {
+                    const flat_node qualifier = a_expression.get_operand(i);
+
+                    if (qualifier.is_token() && qualifier.get_token().is_keyword() && qualifier.get_token().get_keyword() == keyword::local) {
+                        flag_local = true;
+                    }
+                }
+
+                const flat_node assignee = a_expression.get_operands().back();
+
+                if (flag_local && assignee.is_token() && assignee.get_token().is_identifier()) {
+                    return { target_type::local_declaration, identifier(assignee.get_token()), global_slot, flat_node(), flat_node() };
+                }
+
+                return resolve_target(assignee);
+            }
+            case separator::namespace_index:
+            case separator::direct:
+            case separator::dot:
+                if (a_expression.count() == 2) {
+                    const flat_node member = a_expression.get_operand(1);
+
+                    if (member.is_token() && member.get_token().is_identifier()) {
+                        return { target_type::member, identifier(member.get_token()), global_slot, a_expression.get_operand(0), flat_node() };
+                    }
+
+                    return { target_type::index, {}, global_slot, a_expression.get_operand(0), member };
+                }
+
+                break;
+            case separator::operation_index:
+                if (a_expression.count() == 2) {
+                    return { target_type::index, {}, global_slot, a_expression.get_operand(0), a_expression.get_operand(1) };
+                }
+
+                break;
+            default:
+                break;
+        }
+
+        // TODO: Throw unassignable expression error.
+        return {};
+    }
+
+    void compiler::compile_store(const target& a_target, const std::function<void ()>& a_value) {
+        switch (a_target.m_type) {
+            case target_type::local:
+                a_value();
+                emit(opcode::store_local, a_target.m_slot);
+                break;
+            case target_type::global:
+                a_value();
+                emit(opcode::store_global, constant(a_target.m_key));
+                break;
+            case target_type::local_declaration:
+                // The value is compiled first so that it still sees any outer variable of the same name.
+                a_value();
+                emit(opcode::store_local, declare_local(a_target.m_key));
+                break;
+            case target_type::member:
+                compile_node(a_target.m_object);
+                a_value();
+                emit(opcode::set_member, constant(a_target.m_key), inline_cache_index());
+                break;
+            case target_type::index:
+                compile_node(a_target.m_object);
+                compile_node(a_target.m_index);
+                a_value();
+                emit(opcode::set_index);
+                break;
+            default:
+                a_value();
+                break;
+        }
+    }
+
+    void compiler::compile_update(const target& a_target, const separator a_operation, const flat_node* a_value) {
+        const auto operation = static_cast<uint16_t>(a_operation);
+
+        switch (a_target.m_type) {
+            case target_type::local:
+                if (a_value != nullptr) {
+                    compile_node(*a_value);
+                }
+
+                emit(opcode::update_local, a_target.m_slot, operation);
+                break;
+            case target_type::global:
+                if (a_value != nullptr) {
+                    compile_node(*a_value);
+                }
+
+                emit(opcode::update_global, constant(a_target.m_key), operation);
+                break;
+            case target_type::local_declaration: {
+                // Compound operations cannot declare; resolve the name as an ordinary reference instead.
+                target resolved = a_target;
+                resolved.m_slot = resolve_local(a_target.m_key);
+                resolved.m_type = resolved.m_slot != global_slot ? target_type::local : target_type::global;
+
+                compile_update(resolved, a_operation, a_value);
+                break;
+            }
+            case target_type::member:
+                compile_node(a_target.m_object);
+
+                if (a_value != nullptr) {
+                    compile_node(*a_value);
+                }
+
+                emit(opcode::update_member, constant(a_target.m_key), operation);
+                break;
+            case target_type::index:
+                compile_node(a_target.m_object);
+                compile_node(a_target.m_index);
+
+                if (a_value != nullptr) {
+                    compile_node(*a_value);
+                }
+
+                emit(opcode::update_index, 0, operation);
+                break;
+            default:
+                if (a_value != nullptr) {
+                    compile_node(*a_value);
+                } else {
+                    emit(opcode::push_null);
+                }
+
+                break;
+        }
+    }
+}
+
+#endif //REBAR_COMPILER_IMPL_HPP
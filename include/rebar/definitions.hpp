@@ -6,6 +6,8 @@
 #define REBAR_DEFINITIONS_HPP
 
 #include <type_traits>
+#include <limits>
+#include <memory>
 #include <string_view>
 
 namespace rebar {
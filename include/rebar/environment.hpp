@@ -5,11 +5,22 @@
 #ifndef REBAR_ENVIRONMENT_HPP
 #define REBAR_ENVIRONMENT_HPP
 
-#include <array>
-
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "collector.hpp"
+#include "compile_cache.hpp"
+#include "global_scope.hpp"
+#include "image.hpp"
+#include "lru_cache.hpp"
 #include "object.hpp"
 #include "preprocess.hpp"
 #include "interpreter.hpp"
+#include "string_interner.hpp"
 #include "table.hpp"
 #include "native_object_impl.hpp"
 
@@ -25,57 +36,135 @@ namespace rebar {
 
     using default_provider = interpreter;
 
+    template <typename t_object>
+    class native_class;
+
+    template <auto v_function>
+    object native_thunk(environment* a_environment);
+
+    // Growth policy of an environment's argument stack.
+    struct argument_stack_options {
+        // Slots reserved up front. Pushing arguments only checks for room once these are used.
+        size_t m_reserve = 256;
+
+        // Most slots the arguments of all active calls may take together. Pushing beyond throws
+        // std::runtime_error, which bounds the stack under runaway recursion.
+        size_t m_limit = 1 << 24;
+    };
+
+    // Environments are isolated and thread-confined. An environment, together with every object, function and
+    // native object it created, must be used by one thread at a time, while separate environments may run
+    // concurrently on different threads. Environments share no mutable state, apart from a compile_cache or a
+    // string_interner that is shared explicitly and synchronizes itself. Reference counts are not atomic, so objects
+    // must never be passed from one environment to another; copy plain data across instead. The one exception is
+    // strings of a string_interner the environments share.
     class environment {
         friend class function;
+        friend class argument_frame;
+
+    public:
+        // Loads a library into an environment, returning its exports.
+        using library_loader = std::function<object(environment&)>;
+
+    private:
+        // Declared first, as every other member may hold its strings.
+        std::shared_ptr<string_interner> m_string_interner;
 
-        size_t m_argument_count;
-        std::array<object, 16> m_arguments;
+        // Arguments of every active call. A call's arguments are pushed above those of its caller and popped on
+        // return; the current call's arguments start at m_argument_frame.
+        std::vector<object> m_argument_stack;
+        size_t m_argument_frame = 0;
+        size_t m_argument_count = 0;
+        argument_stack_options m_argument_stack_options;
 
+        // Keyed by the text of each string and its cached hash, so growing the table hashes nothing again.
         ska::detailv3::sherwood_v3_table<
-        std::pair<std::string_view, string>,
-        std::string_view,
-        xxh_string_view_hash,
-        ska::detailv3::KeyOrValueHasher<std::string_view, std::pair<std::string_view, string>, xxh_string_view_hash>,
-        std::equal_to<std::string_view>,
-        ska::detailv3::KeyOrValueEquality<std::string_view, std::pair<std::string_view, string>, std::equal_to<std::string_view>>,
-        std::allocator<std::pair<std::string_view, string>>,
-        typename std::allocator_traits<std::allocator<std::pair<std::string_view, string>>>::template rebind_alloc<ska::detailv3::sherwood_v3_entry<std::pair<std::string_view, string>>>
+        std::pair<hashed_string_view, string>,
+        hashed_string_view,
+        hashed_string_view_hash,
+        ska::detailv3::KeyOrValueHasher<hashed_string_view, std::pair<hashed_string_view, string>, hashed_string_view_hash>,
+        std::equal_to<hashed_string_view>,
+        ska::detailv3::KeyOrValueEquality<hashed_string_view, std::pair<hashed_string_view, string>, std::equal_to<hashed_string_view>>,
+        std::allocator<std::pair<hashed_string_view, string>>,
+        typename std::allocator_traits<std::allocator<std::pair<hashed_string_view, string>>>::template rebind_alloc<ska::detailv3::sherwood_v3_entry<std::pair<hashed_string_view, string>>>
         > m_string_table; // I don't like it any more than you do.
 
+        // Set by the first call to str(), after which the strings' home (table or interner) is fixed.
+        bool m_created_strings = false;
+
+        shape m_root_shape;
+        cycle_collector m_collector;
+
         table m_string_virtual_table;
 
         ska::detailv3::sherwood_v3_table<
-        std::pair<object, virtual_table>,
+        std::pair<object, std::unique_ptr<virtual_table>>,
         object,
         std::hash<object>,
-        ska::detailv3::KeyOrValueHasher<object, std::pair<object, virtual_table>, std::hash<object>>,
+        ska::detailv3::KeyOrValueHasher<object, std::pair<object, std::unique_ptr<virtual_table>>, std::hash<object>>,
         std::equal_to<object>,
-        ska::detailv3::KeyOrValueEquality<object, std::pair<object, virtual_table>, std::equal_to<object>>,
-        std::allocator<std::pair<object, virtual_table>>,
-        typename std::allocator_traits<std::allocator<std::pair<object, virtual_table>>>::template rebind_alloc<ska::detailv3::sherwood_v3_entry<std::pair<object, virtual_table>>>
-        > m_native_class_table; // Ditto.
+        ska::detailv3::KeyOrValueEquality<object, std::pair<object, std::unique_ptr<virtual_table>>, std::equal_to<object>>,
+        std::allocator<std::pair<object, std::unique_ptr<virtual_table>>>,
+        typename std::allocator_traits<std::allocator<std::pair<object, std::unique_ptr<virtual_table>>>>::template rebind_alloc<ska::detailv3::sherwood_v3_entry<std::pair<object, std::unique_ptr<virtual_table>>>>
+        > m_native_class_table; // Ditto. Boxed, as native objects point to their virtual table.
 
         lexer m_lexer;
         std::vector<function> m_functions;
-        table m_global_table;
+
+        // Functions recently returned by compile_string(), by source text.
+        lru_cache<function> m_compiled_sources{ default_compiled_source_capacity };
+        std::shared_ptr<compile_cache> m_compile_cache;
+        global_scope m_global_table;
+        object m_null_slot;
+
+        struct library_entry {
+            library_loader m_loader;
+            object m_exports;
+            bool m_loaded = false;
+        };
+
+        std::unordered_map<std::string, library_entry> m_libraries;
         std::unique_ptr<provider> m_provider;
 
     public:
-        environment() noexcept : m_provider(std::make_unique<default_provider>(*this)) {}
+        // Distinct source texts compile_string() remembers unless told otherwise.
+        static constexpr size_t default_compiled_source_capacity = 256;
+
+        environment() noexcept : m_provider(std::make_unique<default_provider>(*this)) {
+            m_argument_stack.reserve(m_argument_stack_options.m_reserve);
+        }
 
         template <typename t_provider>
-        explicit environment(const use_provider_t<t_provider>) noexcept : m_provider(std::make_unique<t_provider>(*this)) {};
+        explicit environment(const use_provider_t<t_provider>) noexcept : m_provider(std::make_unique<t_provider>(*this)) {
+            m_argument_stack.reserve(m_argument_stack_options.m_reserve);
+        };
 
         environment(const environment&) = delete;
         environment(environment&&) = delete;
 
+        ~environment() {
+            m_argument_stack.clear();
+
+            // Whatever the globals and libraries kept alive in cycles is garbage once they are gone.
+            m_global_table.clear();
+            m_libraries.clear();
+            m_collector.collect();
+        }
+
         [[nodiscard]] string str(const std::string_view a_string) {
-            auto found = m_string_table.find(a_string);
+            m_created_strings = true;
+
+            if (m_string_interner != nullptr) {
+                return m_string_interner->intern(a_string);
+            }
+
+            const hashed_string_view key(a_string);
+            auto found = m_string_table.find(key);
 
             if (found == m_string_table.cend()) {
-                string created_string(a_string);
+                string created_string(a_string, key.m_hash);
 
-                m_string_table.emplace(created_string.to_string_view(), std::move(created_string));
+                m_string_table.emplace(hashed_string_view(created_string.to_string_view(), key.m_hash), std::move(created_string));
 
                 return created_string;
             }
@@ -83,28 +172,45 @@ namespace rebar {
             return found->second;
         }
 
+        // Interns the strings of this environment in a_interner, which may be shared with other environments, instead
+        // of in a table of its own. Must be set before the environment creates its first string.
+        void set_string_interner(std::shared_ptr<string_interner> a_interner) {
+            if (m_created_strings) {
+                throw std::runtime_error("String interner set after the environment created strings.");
+            }
+
+            m_string_interner = std::move(a_interner);
+        }
+
+        [[nodiscard]] const std::shared_ptr<string_interner>& get_string_interner() const noexcept {
+            return m_string_interner;
+        }
+
         [[nodiscard]] table& get_string_virtual_table() noexcept {
             return m_string_virtual_table;
         }
 
         virtual_table& register_native_class(const object a_identifier, virtual_table a_table = {}) {
-            auto iterator_pair = m_native_class_table.emplace(a_identifier, std::move(a_table));
-            return iterator_pair.first->second;
+            auto iterator_pair = m_native_class_table.emplace(a_identifier, std::make_unique<virtual_table>(std::move(a_table)));
+            return *iterator_pair.first->second;
         }
 
         virtual_table& register_native_class(const std::string_view a_identifier, virtual_table a_table = {}) {
-            auto iterator_pair = m_native_class_table.emplace(str(a_identifier), std::move(a_table));
-            return iterator_pair.first->second;
+            auto iterator_pair = m_native_class_table.emplace(str(a_identifier), std::make_unique<virtual_table>(std::move(a_table)));
+            return *iterator_pair.first->second;
         }
 
-        template <class t_class>
-        virtual_table& register_native_class(const object a_identifier, t_class& a_class) {
-            // TODO: Implement.
+        // Binds the members described by a_class (see native_class.hpp) into the virtual table of a_identifier.
+        template <typename t_object>
+        virtual_table& register_native_class(const object a_identifier, const native_class<t_object>& a_class) {
+            virtual_table& created = register_native_class(a_identifier);
+            a_class.install(*this, created);
+            return created;
         }
 
-        template <class t_class>
-        virtual_table& register_native_class(const std::string_view a_identifier, t_class& a_class) {
-            // TODO: Implement.
+        template <typename t_object>
+        virtual_table& register_native_class(const std::string_view a_identifier, const native_class<t_object>& a_class) {
+            return register_native_class(str(a_identifier), a_class);
         }
 
         [[nodiscard]] virtual_table& get_native_class(const object a_identifier) {
@@ -114,7 +220,7 @@ namespace rebar {
                 throw std::out_of_range("Identifier passed to get_native_class() was not registered.");
             }
 
-            return found->second;
+            return *found->second;
         }
 
         [[nodiscard]] virtual_table& get_native_class(const std::string_view a_identifier) {
@@ -124,7 +230,7 @@ namespace rebar {
                 throw std::out_of_range("Identifier passed to get_native_class() was not registered.");
             }
 
-            return found->second;
+            return *found->second;
         }
 
         template <typename t_object>
@@ -172,42 +278,135 @@ namespace rebar {
             return native_object::create<t_object>(get_native_class(a_identifier), a_in_place, std::forward<t_args>(a_args)...);
         }
 
+        // Compiling one of the last compiled_source_capacity() distinct source texts again returns the same
+        // function. Other sources are compiled anew.
         [[nodiscard]] function compile_string(std::string a_string) {
-            return m_provider->compile(parse(m_lexer, std::move(a_string)));
+            if (function* found = m_compiled_sources.find(a_string)) {
+                return *found;
+            }
+
+            std::shared_ptr<const parse_unit> unit = m_compile_cache != nullptr
+                    ? m_compile_cache->get(m_lexer, a_string)
+                    : std::make_shared<const parse_unit>(parse(m_lexer, a_string));
+
+            const function compiled = m_provider->compile(std::move(unit));
+            m_compiled_sources.insert(std::move(a_string), compiled);
+
+            return compiled;
+        }
+
+        // Compiles the parse unit stored in a_image by write_image(), without lexing or parsing it.
+        [[nodiscard]] function compile_image(const std::string_view a_image) {
+            return m_provider->compile(std::make_shared<const parse_unit>(read_image(a_image)));
+        }
+
+        // Shares parse results with the other environments using a_cache. Null stops sharing.
+        void set_compile_cache(std::shared_ptr<compile_cache> a_cache) noexcept {
+            m_compile_cache = std::move(a_cache);
+        }
+
+        [[nodiscard]] const std::shared_ptr<compile_cache>& get_compile_cache() const noexcept {
+            return m_compile_cache;
+        }
+
+        // Makes compile_string() compile every source anew, e.g. after the lexer's symbol map changed. Functions
+        // compiled before stay valid.
+        void clear_compiled_sources() noexcept {
+            m_compiled_sources.clear();
+        }
+
+        [[nodiscard]] size_t compiled_source_capacity() const noexcept {
+            return m_compiled_sources.capacity();
+        }
+
+        // Forgets the least recently compiled sources beyond a_capacity. Zero makes compile_string() always compile.
+        void set_compiled_source_capacity(const size_t a_capacity) {
+            m_compiled_sources.set_capacity(a_capacity);
         }
 
         [[nodiscard]] object bind(callable a_function) {
             return m_provider->bind(a_function);
         }
 
+        // Binds a function with typed parameters, e.g. integer(*)(std::string_view, integer). Arguments are checked
+        // and unboxed, and the result boxed, by a callable generated for v_function; see native_argument().
+        template <auto v_function>
+        [[nodiscard]] object bind() {
+            return bind(native_thunk<v_function>);
+        }
+
         // FUNCTION PARAMETERS
 
         [[nodiscard]] size_t arg_count() const noexcept {
             return m_argument_count;
         }
 
+        // Arguments the caller did not pass read as null.
         [[nodiscard]] object arg(const size_t a_index) const noexcept {
-            return m_arguments[a_index];
+            return a_index < m_argument_count ? m_argument_stack[m_argument_frame + a_index] : null;
         }
 
+        // Appends an argument to the current frame, which must be the innermost one (i.e. not while a call made
+        // from it is running).
         void push_arg(const object a_object) {
-            m_arguments[m_argument_count] = a_object;
+            reserve_args(1);
+            m_argument_stack.push_back(a_object);
             ++m_argument_count;
         }
 
+        // Replaces the arguments of the current frame, which must be the innermost one. a_objects must not view
+        // the argument stack.
         void set_args(const span<object> a_objects) {
-            std::copy_n(a_objects.begin(), a_objects.size(), m_arguments.begin());
+            clear_args();
+            reserve_args(a_objects.size());
+            m_argument_stack.insert(m_argument_stack.cend(), a_objects.begin(), a_objects.end());
             m_argument_count = a_objects.size();
         }
 
-        [[nodiscard]] auto& get_args() const noexcept {
-            return m_arguments;
+        // Arguments of the current call. The view is invalidated by the next call, which may grow the stack.
+        [[nodiscard]] span<object> get_args() noexcept {
+            return { m_argument_stack.data() + m_argument_frame, m_argument_count };
         }
 
         void clear_args() noexcept {
+            m_argument_stack.erase(m_argument_stack.cbegin() + static_cast<std::ptrdiff_t>(m_argument_frame), m_argument_stack.cend());
             m_argument_count = 0;
         }
 
+        // Takes effect for the stack's next growth; a larger reserve is allocated immediately. A limit below the
+        // current capacity reallocates the stack to the limit, as only growth checks the limit.
+        void set_argument_stack_options(const argument_stack_options a_options) {
+            m_argument_stack_options = a_options;
+
+            if (m_argument_stack.capacity() > a_options.m_limit && m_argument_stack.size() <= a_options.m_limit) {
+                std::vector<object> bounded;
+                bounded.reserve(a_options.m_limit);
+                bounded.insert(bounded.cend(), m_argument_stack.cbegin(), m_argument_stack.cend());
+                m_argument_stack.swap(bounded);
+            } else if (a_options.m_reserve > m_argument_stack.capacity()) {
+                m_argument_stack.reserve(std::min(a_options.m_reserve, a_options.m_limit));
+            }
+        }
+
+        [[nodiscard]] const argument_stack_options& get_argument_stack_options() const noexcept {
+            return m_argument_stack_options;
+        }
+
+        // Makes room for a_count more arguments, growing the stack geometrically up to its limit.
+        void reserve_args(const size_t a_count) {
+            const size_t required = m_argument_stack.size() + a_count;
+
+            if (required <= m_argument_stack.capacity()) {
+                return;
+            }
+
+            if (required > m_argument_stack_options.m_limit) {
+                throw std::runtime_error("Rebar argument stack overflow.");
+            }
+
+            m_argument_stack.reserve(std::min(std::max(required, 2 * m_argument_stack.capacity()), m_argument_stack_options.m_limit));
+        }
+
         // - FUNCTION PARAMETERS
 
         /*
@@ -224,7 +423,31 @@ namespace rebar {
         }
         */
 
-        [[nodiscard]] table& global_table() noexcept {
+        // Root of the shape tree shared by the script tables of this environment.
+        [[nodiscard]] shape& root_shape() noexcept {
+            return m_root_shape;
+        }
+
+        [[nodiscard]] cycle_collector& collector() noexcept {
+            return m_collector;
+        }
+
+        // Allocates a script table using the root shape and tracked by the cycle collector.
+        [[nodiscard]] table* create_table() {
+            auto* created = new table(m_root_shape);
+            m_collector.track(*created);
+            return created;
+        }
+
+        // Writable null handed out where an assignable object is required but there is none, e.g. when indexing null.
+        // Whatever is written to it is discarded by the next use.
+        [[nodiscard]] object& null_slot() noexcept {
+            m_null_slot = null;
+            return m_null_slot;
+        }
+
+        // Globals of the environment; see global_scope.
+        [[nodiscard]] global_scope& global_table() noexcept {
             return m_global_table;
         }
 
@@ -235,6 +458,105 @@ namespace rebar {
         [[nodiscard]] provider& execution_provider() noexcept {
             return *m_provider;
         }
+
+        // LIBRARIES
+
+        // Makes a library available to load_library() in this environment only. Redefining an identifier replaces
+        // its loader and forgets its exports.
+        void define_library(const std::string_view a_identifier, library_loader a_loader) {
+            m_libraries.insert_or_assign(std::string(a_identifier), library_entry{ std::move(a_loader), null, false });
+        }
+
+        [[nodiscard]] bool has_library(const std::string_view a_identifier) const {
+            return m_libraries.find(std::string(a_identifier)) != m_libraries.cend();
+        }
+
+        // Exports of a library, running its loader on the first load in this environment.
+        object load_library(const std::string_view a_identifier) {
+            auto found = m_libraries.find(std::string(a_identifier));
+
+            if (found == m_libraries.cend()) {
+                throw std::out_of_range("Identifier passed to load_library() was not defined.");
+            }
+
+            library_entry& entry = found->second;
+
+            if (!entry.m_loaded) {
+                entry.m_exports = entry.m_loader(*this);
+                entry.m_loaded = true;
+            }
+
+            return entry.m_exports;
+        }
+    };
+
+    // A call's arguments on the environment's argument stack. Arguments are pushed above those of the enclosing
+    // calls, become the current arguments once the frame is entered, and are popped when the frame is destroyed.
+    // Only the call's own arguments are copied; the enclosing frames are left untouched.
+    class argument_frame {
+    public:
+        explicit argument_frame(environment& a_environment) noexcept :
+                m_environment(a_environment),
+                m_base(a_environment.m_argument_stack.size()),
+                m_previous_frame(a_environment.m_argument_frame),
+                m_previous_count(a_environment.m_argument_count) {}
+
+        argument_frame(environment& a_environment, const span<object> a_objects) : argument_frame(a_environment) {
+            push(a_objects);
+            enter();
+        }
+
+        argument_frame(const argument_frame&) = delete;
+        argument_frame& operator = (const argument_frame&) = delete;
+
+        ~argument_frame() {
+            auto& stack = m_environment.m_argument_stack;
+            stack.erase(stack.cbegin() + static_cast<std::ptrdiff_t>(m_base), stack.cend());
+
+            m_environment.m_argument_frame = m_previous_frame;
+            m_environment.m_argument_count = m_previous_count;
+        }
+
+        void push(const object a_object) {
+            auto& stack = m_environment.m_argument_stack;
+
+            if (stack.size() == stack.capacity()) {
+                m_environment.reserve_args(1);
+            }
+
+            stack.push_back(a_object);
+        }
+
+        void push(const span<object> a_objects) {
+            auto& stack = m_environment.m_argument_stack;
+            const object* source = a_objects.data();
+
+            // a_objects may view the arguments of an enclosing frame, which growing the stack moves.
+            const bool on_stack = source >= stack.data() && source < stack.data() + stack.size();
+            const size_t offset = on_stack ? static_cast<size_t>(source - stack.data()) : 0;
+
+            m_environment.reserve_args(a_objects.size());
+
+            if (on_stack) {
+                source = stack.data() + offset;
+            }
+
+            for (size_t i = 0; i < a_objects.size(); ++i) {
+                stack.push_back(source[i]);
+            }
+        }
+
+        // Makes the pushed arguments those of the current call.
+        void enter() noexcept {
+            m_environment.m_argument_frame = m_base;
+            m_environment.m_argument_count = m_environment.m_argument_stack.size() - m_base;
+        }
+
+    private:
+        environment& m_environment;
+        size_t m_base;
+        size_t m_previous_frame;
+        size_t m_previous_count;
     };
 }
 
@@ -0,0 +1,318 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_ENVIRONMENT_POOL_HPP
+#define REBAR_ENVIRONMENT_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "compile_cache.hpp"
+#include "environment.hpp"
+
+namespace rebar {
+    // Initial state of an environment, from which initialized environments are cloned. A snapshot records the
+    // provider and the initialization steps (loading libraries, registering native classes, running startup
+    // scripts) and checks them once on a prototype environment.
+    //
+    // A clone is not a copy: clone() builds a fresh environment and replays every step on it. Compiled code,
+    // tables and native objects refer to the environment that created them, so there is no cheaper way to
+    // produce an initialized environment. Clones share the snapshot's compile cache, so a startup script is
+    // lexed and parsed only once, but each clone compiles and runs it again. A clone therefore costs about as
+    // much as initializing an environment by hand. The globals the steps define are frozen as the base of each
+    // clone's global_scope, so global_table().reset() returns a clone to its initial bindings.
+    //
+    // A snapshot is immutable once shared and may be cloned from several threads at once.
+    class environment_snapshot {
+    public:
+        using initializer = std::function<void(environment&)>;
+
+        environment_snapshot() : environment_snapshot(use_provider<default_provider>) {}
+
+        template <typename t_provider>
+        explicit environment_snapshot(const use_provider_t<t_provider>) :
+                m_factory([]() { return std::make_unique<environment>(use_provider<t_provider>); }),
+                m_compile_cache(std::make_shared<compile_cache>()) {}
+
+        environment_snapshot(const environment_snapshot&) = delete;
+        environment_snapshot& operator = (const environment_snapshot&) = delete;
+
+        // Appends a step, e.g. standard::load_implicit_libraries. Steps run in the order they were added and must
+        // not depend on state outside the environment they are given.
+        environment_snapshot& add_initializer(initializer a_initializer) {
+            m_initializers.push_back(std::move(a_initializer));
+            return *this;
+        }
+
+        // Appends a step compiling and running a_source, e.g. a script defining globals.
+        environment_snapshot& add_script(std::string a_source) {
+            return add_initializer([source = std::move(a_source)](environment& a_environment) {
+                a_environment.compile_string(source)();
+            });
+        }
+
+        // Runs the steps on a prototype environment, which warms the compile cache and surfaces errors of the
+        // steps before any clone is made.
+        void prepare() {
+            std::unique_ptr<environment> prototype = clone();
+        }
+
+        // A fresh environment in the state the steps leave it in.
+        [[nodiscard]] std::unique_ptr<environment> clone() const {
+            m_cloned.store(true, std::memory_order_relaxed);
+
+            std::unique_ptr<environment> created = m_factory();
+            created->set_compile_cache(m_compile_cache);
+            created->set_string_interner(m_string_interner);
+
+            for (const initializer& step : m_initializers) {
+                step(*created);
+            }
+
+            created->global_table().freeze();
+            return created;
+        }
+
+        [[nodiscard]] const std::shared_ptr<compile_cache>& get_compile_cache() const noexcept {
+            return m_compile_cache;
+        }
+
+        // Makes clones intern their strings in a_interner. Null gives each clone its own string table. Must be set
+        // before the first clone (including the one prepare() makes), so that every clone shares the same strings.
+        void set_string_interner(std::shared_ptr<string_interner> a_interner) {
+            if (m_cloned.load(std::memory_order_relaxed)) {
+                throw std::runtime_error("String interner set after the snapshot was cloned.");
+            }
+
+            m_string_interner = std::move(a_interner);
+        }
+
+        [[nodiscard]] const std::shared_ptr<string_interner>& get_string_interner() const noexcept {
+            return m_string_interner;
+        }
+
+    private:
+        std::function<std::unique_ptr<environment>()> m_factory;
+        std::vector<initializer> m_initializers;
+        std::shared_ptr<compile_cache> m_compile_cache;
+        std::shared_ptr<string_interner> m_string_interner;
+        mutable std::atomic<bool> m_cloned{ false };
+    };
+
+    // Environments cloned ahead of time from a snapshot, for sandboxes acquired at the rate of incoming requests.
+    // A warming thread keeps up to m_capacity clones ready, so acquiring a ready clone only takes a lock and a pop.
+    // If the pool runs dry, acquire() clones on the calling thread, at the full cost of a clone.
+    //
+    // The pool does not make clones cheaper; it moves them off the acquiring thread. That only pays off with a
+    // core to spare for the warming thread. On a single core, the clone that refills the pool after an
+    // acquisition competes with the acquiring thread, which then waits for about as long as a clone takes.
+    //
+    // Released environments are destroyed, not reused, so no state leaks from one sandbox to the next. The pool
+    // may be used from any number of threads. An acquired environment belongs to the acquiring thread until it is
+    // released (see environment).
+    class environment_pool {
+    public:
+        // Returns its environment to the pool when destroyed.
+        class lease {
+        public:
+            lease(environment_pool& a_pool, std::unique_ptr<environment> a_environment) noexcept : m_pool(&a_pool), m_environment(std::move(a_environment)) {}
+
+            lease(lease&& a_lease) noexcept : m_pool(a_lease.m_pool), m_environment(std::move(a_lease.m_environment)) {}
+
+            lease& operator = (lease&& a_lease) noexcept {
+                if (this != &a_lease) {
+                    release();
+                    m_pool = a_lease.m_pool;
+                    m_environment = std::move(a_lease.m_environment);
+                }
+
+                return *this;
+            }
+
+            lease(const lease&) = delete;
+            lease& operator = (const lease&) = delete;
+
+            ~lease() {
+                release();
+            }
+
+            [[nodiscard]] environment& get() const noexcept {
+                return *m_environment;
+            }
+
+            environment& operator * () const noexcept {
+                return *m_environment;
+            }
+
+            environment* operator -> () const noexcept {
+                return m_environment.get();
+            }
+
+            // Destroys the environment early, on the calling thread.
+            void release() noexcept {
+                if (m_environment != nullptr) {
+                    m_pool->released();
+                    m_environment.reset();
+                }
+            }
+
+        private:
+            environment_pool* m_pool;
+            std::unique_ptr<environment> m_environment;
+        };
+
+        // Starts warming a_capacity clones of a_snapshot, which is prepared first.
+        environment_pool(std::shared_ptr<environment_snapshot> a_snapshot, const size_t a_capacity) :
+                m_snapshot(std::move(a_snapshot)),
+                m_capacity(a_capacity) {
+            m_snapshot->prepare();
+            m_ready.reserve(a_capacity);
+            m_warmer = std::thread(&environment_pool::warm, this);
+        }
+
+        environment_pool(const environment_pool&) = delete;
+        environment_pool& operator = (const environment_pool&) = delete;
+
+        // Leases must be released before the pool is destroyed.
+        ~environment_pool() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+
+            m_wake.notify_all();
+            m_warmer.join();
+        }
+
+        [[nodiscard]] lease acquire() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                ++m_leased;
+
+                if (!m_ready.empty()) {
+                    std::unique_ptr<environment> ready = std::move(m_ready.back());
+                    m_ready.pop_back();
+                    m_wake.notify_one();
+
+                    return { *this, std::move(ready) };
+                }
+
+                ++m_misses;
+            }
+
+            m_wake.notify_one();
+
+            try {
+                return { *this, m_snapshot->clone() };
+            } catch (...) {
+                released();
+                throw;
+            }
+        }
+
+        // Blocks until a_count clones are ready, or as many as the capacity allows.
+        void wait_until_ready(const size_t a_count) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            m_warmed.wait(lock, [this, a_count]() {
+                return m_ready.size() >= std::min(a_count, m_capacity) || m_failure != nullptr;
+            });
+
+            if (m_failure != nullptr) {
+                std::rethrow_exception(m_failure);
+            }
+        }
+
+        [[nodiscard]] size_t ready_count() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_ready.size();
+        }
+
+        [[nodiscard]] size_t leased_count() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_leased;
+        }
+
+        // Acquisitions that found no clone ready and cloned on the acquiring thread.
+        [[nodiscard]] size_t miss_count() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_misses;
+        }
+
+        [[nodiscard]] const environment_snapshot& snapshot() const noexcept {
+            return *m_snapshot;
+        }
+
+    private:
+        std::shared_ptr<environment_snapshot> m_snapshot;
+        size_t m_capacity;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_warmed;
+        std::vector<std::unique_ptr<environment>> m_ready;
+        size_t m_leased = 0;
+        size_t m_misses = 0;
+        bool m_stopping = false;
+        std::exception_ptr m_failure;
+        std::thread m_warmer;
+
+        void released() noexcept {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_leased;
+        }
+
+        // Body of the warming thread. Clones outside the lock, so acquisitions never wait for a clone to finish.
+        void warm() {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            while (true) {
+                m_wake.wait(lock, [this]() {
+                    return m_stopping || (m_ready.size() < m_capacity && m_failure == nullptr);
+                });
+
+                if (m_stopping) {
+                    break;
+                }
+
+                lock.unlock();
+
+                std::unique_ptr<environment> created;
+                std::exception_ptr failure;
+
+                try {
+                    created = m_snapshot->clone();
+                } catch (...) {
+                    failure = std::current_exception();
+                }
+
+                lock.lock();
+
+                if (failure != nullptr) {
+                    m_failure = failure;
+                } else {
+                    m_ready.push_back(std::move(created));
+                }
+
+                m_warmed.notify_all();
+            }
+
+            // Destroyed outside the lock, as destroying environments runs the cycle collector.
+            std::vector<std::unique_ptr<environment>> remaining = std::move(m_ready);
+            lock.unlock();
+        }
+    };
+}
+
+#endif //REBAR_ENVIRONMENT_POOL_HPP
@@ -0,0 +1,647 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_FLAT_AST_HPP
+#define REBAR_FLAT_AST_HPP
+
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "definitions.hpp"
+#include "parser.hpp"
+#include "span.hpp"
+#include "token.hpp"
+
+namespace rebar {
+    class flat_ast;
+    class flat_range;
+
+    // A node of a flat_ast.
+    struct flat_entry {
+        uint8_t m_type;
+        uint8_t m_operation;
+        uint8_t m_tags;
+        uint32_t m_first;  // First child, or the token index of a token node.
+        uint32_t m_count;  // Number of children.
+    };
+
+    static_assert(sizeof(flat_entry) == 12, "Flat AST entries are expected to be 12 bytes wide.");
+
+    // Read-only view of a node in a flat_ast. Views are two words wide and are passed by value.
+    //
+    // Expressions, groups, selectors and return statements expose their operands through get_operand() and
+    // get_operands(). Blocks, else declarations, argument lists and immediate arrays expose their elements the
+    // same way. Declarations expose their parts through the named accessors.
+    class flat_node {
+    public:
+        using index = uint32_t;
+
+        flat_node() noexcept = default;
+        flat_node(const flat_ast& a_ast, index a_index) noexcept;
+
+        [[nodiscard]] node::type get_type() const noexcept {
+            return static_cast<node::type>(m_entry->m_type);
+        }
+
+        [[nodiscard]] bool is_token() const noexcept {
+            return get_type() == node::type::token;
+        }
+
+        [[nodiscard]] bool is_expression() const noexcept {
+            return get_type() == node::type::expression;
+        }
+
+        [[nodiscard]] bool is_group() const noexcept {
+            return get_type() == node::type::group;
+        }
+
+        [[nodiscard]] bool is_selector() const noexcept {
+            return get_type() == node::type::selector;
+        }
+
+        [[nodiscard]] bool is_else_if_declaration() const noexcept {
+            return get_type() == node::type::else_if_declaration;
+        }
+
+        [[nodiscard]] bool is_else_declaration() const noexcept {
+            return get_type() == node::type::else_declaration;
+        }
+
+        [[nodiscard]] bool is_immediate_table() const noexcept {
+            return get_type() == node::type::immediate_table;
+        }
+
+        [[nodiscard]] bool is_immediate_array() const noexcept {
+            return get_type() == node::type::immediate_array;
+        }
+
+        [[nodiscard]] const token& get_token() const noexcept;
+
+        [[nodiscard]] separator get_operation() const noexcept {
+            return static_cast<separator>(m_entry->m_operation);
+        }
+
+        [[nodiscard]] size_t count() const noexcept {
+            return m_entry->m_count;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return count() == 0;
+        }
+
+        [[nodiscard]] flat_node get_operand(size_t a_index) const noexcept;
+        [[nodiscard]] flat_range get_operands() const noexcept;
+
+        // If, else if and while declarations.
+        [[nodiscard]] flat_node get_conditional() const noexcept;
+
+        // For declarations.
+        [[nodiscard]] flat_node get_initialization() const noexcept;
+        [[nodiscard]] flat_node get_iteration() const noexcept;
+
+        // Function declarations.
+        [[nodiscard]] flat_node get_identifier() const noexcept;
+        [[nodiscard]] function_tags get_tags() const noexcept;
+        [[nodiscard]] flat_range get_parameters() const noexcept;
+
+        // Statements of the body of an if, else if, while, for or function declaration.
+        [[nodiscard]] flat_range get_body() const noexcept;
+
+        // Immediate tables. Keys are nodes, values are expressions.
+        [[nodiscard]] size_t entry_count() const noexcept;
+        [[nodiscard]] flat_node get_key(size_t a_entry) const noexcept;
+        [[nodiscard]] flat_node get_value(size_t a_entry) const noexcept;
+
+        // Same output as node::to_string() on the node this one was flattened from.
+        [[nodiscard]] std::string to_string() const;
+
+        // Same output as node::expression::to_string(), for nodes that hold an expression.
+        [[nodiscard]] std::string expression_string() const;
+
+    private:
+        const flat_ast* m_ast = nullptr;
+        const flat_entry* m_entry = nullptr;
+    };
+
+    // Consecutive sibling nodes of a flat_ast: the children of a node or a trailing part of them.
+    class flat_range {
+    public:
+        using index = flat_node::index;
+
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = flat_node;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = flat_node;
+
+            iterator(const flat_ast* a_ast, const index a_index) noexcept : m_ast(a_ast), m_index(a_index) {}
+
+            [[nodiscard]] flat_node operator*() const noexcept {
+                return { *m_ast, m_index };
+            }
+
+            iterator& operator++() noexcept {
+                ++m_index;
+                return *this;
+            }
+
+            [[nodiscard]] bool operator==(const iterator& a_rhs) const noexcept {
+                return m_index == a_rhs.m_index;
+            }
+
+            [[nodiscard]] bool operator!=(const iterator& a_rhs) const noexcept {
+                return m_index != a_rhs.m_index;
+            }
+
+        private:
+            const flat_ast* m_ast;
+            index m_index;
+        };
+
+        flat_range() noexcept = default;
+        flat_range(const flat_ast& a_ast, const index a_first, const index a_count) noexcept : m_ast(&a_ast), m_first(a_first), m_count(a_count) {}
+
+        [[nodiscard]] size_t size() const noexcept {
+            return m_count;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return m_count == 0;
+        }
+
+        [[nodiscard]] flat_node operator[](const size_t a_index) const noexcept {
+            return { *m_ast, static_cast<index>(m_first + a_index) };
+        }
+
+        [[nodiscard]] flat_node back() const noexcept {
+            return (*this)[m_count - 1];
+        }
+
+        [[nodiscard]] flat_range subrange(const size_t a_offset) const noexcept {
+            flat_range range = *this;
+            range.m_first += static_cast<index>(a_offset);
+            range.m_count -= static_cast<index>(a_offset);
+
+            return range;
+        }
+
+        [[nodiscard]] iterator begin() const noexcept {
+            return { m_ast, m_first };
+        }
+
+        [[nodiscard]] iterator end() const noexcept {
+            return { m_ast, m_first + m_count };
+        }
+
+    private:
+        const flat_ast* m_ast = nullptr;
+        index m_first = 0;
+        index m_count = 0;
+    };
+
+    // Syntax tree of a parse unit stored in a single buffer. Every node is one 12-byte entry, and the children
+    // of a node are consecutive entries located by the 32-bit index of the first one. Tokens are referenced by
+    // their 32-bit index in the lex unit, so the whole tree is freed in one deallocation and walking it touches
+    // contiguous memory.
+    //
+    // Children of each node, in order:
+    //   expression, group, selector, return statement: the operands of the expression.
+    //   block, else declaration: the statements.
+    //   argument list: the arguments, as expressions.
+    //   immediate array: the elements.
+    //   ranged selector: the two bound expressions.
+    //   if, else if, while, do declaration: the conditional expression, then the statements of the body.
+    //   for declaration: the initialization, conditional and iteration expressions, then the body statements.
+    //   function declaration: the identifier expression, an argument list of parameters, then the body statements.
+    //   immediate table: alternating keys and value expressions.
+    //
+    // The parser does not produce switch and class declarations yet; they are flattened without children.
+    class flat_ast {
+    public:
+        using index = flat_node::index;
+
+        using entry = flat_entry;
+
+        flat_ast() noexcept = default;
+
+        // Flattens a_block, which references a_tokens. Entry 0 is a block holding its statements.
+        flat_ast(span<token> a_tokens, const node::block& a_block);
+
+        // Adopts entries flattened earlier (e.g. restored from an image), whose token indices refer to a_tokens.
+        flat_ast(span<token> a_tokens, std::vector<entry> a_entries) noexcept;
+
+        flat_ast(const flat_ast&) = delete;
+        flat_ast(flat_ast&&) noexcept = default;
+
+        flat_ast& operator = (const flat_ast&) = delete;
+        flat_ast& operator = (flat_ast&&) noexcept = default;
+
+        [[nodiscard]] flat_node root() const noexcept {
+            return { *this, 0 };
+        }
+
+        [[nodiscard]] flat_range statements() const noexcept {
+            return m_entries.empty() ? flat_range() : root().get_operands();
+        }
+
+        [[nodiscard]] size_t size() const noexcept {
+            return m_entries.size();
+        }
+
+        [[nodiscard]] const entry& at(const index a_index) const noexcept {
+            return m_entries[a_index];
+        }
+
+        [[nodiscard]] const entry* data() const noexcept {
+            return m_entries.data();
+        }
+
+        // Number of tokens referenced by index, including those synthesized by the parser.
+        [[nodiscard]] size_t token_count() const noexcept {
+            return m_token_count + m_foreign_tokens.size();
+        }
+
+        [[nodiscard]] const token& token_at(const index a_index) const noexcept {
+            return a_index < m_token_count ? m_tokens[a_index] : *m_foreign_tokens[a_index - m_token_count];
+        }
+
+    private:
+        const token* m_tokens = nullptr;
+        size_t m_token_count = 0;
+        std::vector<entry> m_entries;
+
+        // Tokens synthesized by the parser (e.g. the implicit "this" parameter), which are not part of the lex
+        // unit. They are indexed after its tokens.
+        std::vector<const token*> m_foreign_tokens;
+
+        [[nodiscard]] index allocate(size_t a_count);
+        [[nodiscard]] index token_index(const token& a_token);
+
+        void assign(index a_index, node::type a_type, index a_first, size_t a_count, separator a_operation = separator::space, function_tags a_tags = function_tags::basic) noexcept;
+
+        void flatten(index a_index, const node& a_node);
+        void flatten(index a_index, node::type a_type, const node::expression& a_expression);
+        void flatten_nodes(index a_index, node::type a_type, const std::vector<node>& a_nodes);
+        void flatten_expressions(index a_index, const node::argument_list& a_expressions);
+        void flatten_declaration(index a_index, node::type a_type, std::initializer_list<const node::expression*> a_expressions, const node::block& a_body);
+    };
+
+    // FLAT AST
+
+    flat_ast::flat_ast(const span<token> a_tokens, const node::block& a_block) : m_tokens(a_tokens.data()), m_token_count(a_tokens.size()) {
+        flatten_nodes(allocate(1), node::type::block, a_block);
+        m_entries.shrink_to_fit();
+    }
+
+    flat_ast::flat_ast(const span<token> a_tokens, std::vector<entry> a_entries) noexcept : m_tokens(a_tokens.data()), m_token_count(a_tokens.size()), m_entries(std::move(a_entries)) {}
+
+    flat_ast::index flat_ast::allocate(const size_t a_count) {
+        const auto first = static_cast<index>(m_entries.size());
+        m_entries.resize(m_entries.size() + a_count);
+
+        return first;
+    }
+
+    flat_ast::index flat_ast::token_index(const token& a_token) {
+        if (&a_token >= m_tokens && &a_token < m_tokens + m_token_count) {
+            return static_cast<index>(&a_token - m_tokens);
+        }
+
+        m_foreign_tokens.push_back(&a_token);
+        return static_cast<index>(m_token_count + m_foreign_tokens.size() - 1);
+    }
+
+    void flat_ast::assign(const index a_index, const node::type a_type, const index a_first, const size_t a_count, const separator a_operation, const function_tags a_tags) noexcept {
+        entry& e = m_entries[a_index];
+
+        e.m_type = static_cast<uint8_t>(a_type);
+        e.m_operation = static_cast<uint8_t>(a_operation);
+        e.m_tags = static_cast<uint8_t>(a_tags);
+        e.m_first = a_first;
+        e.m_count = static_cast<index>(a_count);
+    }
+
+    // Children are allocated as one run before any of them is flattened, so that each node's children stay
+    // consecutive; grandchildren are appended after them.
+    void flat_ast::flatten(const index a_index, const node& a_node) {
+        switch (a_node.m_type) {
+            case node::type::token:
+                assign(a_index, node::type::token, token_index(a_node.get_token()), 0);
+                break;
+            case node::type::expression:
+            case node::type::group:
+            case node::type::selector:
+            case node::type::return_statement:
+                flatten(a_index, a_node.m_type, a_node.get_expression());
+                break;
+            case node::type::block:
+            case node::type::else_declaration:
+            case node::type::immediate_array:
+                flatten_nodes(a_index, a_node.m_type, a_node.get_block());
+                break;
+            case node::type::argument_list:
+                flatten_expressions(a_index, a_node.get_argument_list());
+                break;
+            case node::type::ranged_selector: {
+                const auto& range = a_node.get_ranged_selector();
+                const index first = allocate(2);
+
+                assign(a_index, node::type::ranged_selector, first, 2);
+                flatten(first, node::type::expression, range.first);
+                flatten(first + 1, node::type::expression, range.second);
+                break;
+            }
+            case node::type::if_declaration:
+            case node::type::else_if_declaration:
+            case node::type::while_declaration:
+            case node::type::do_declaration: {
+                const auto& declaration = a_node.get_if_declaration();
+                flatten_declaration(a_index, a_node.m_type, { &declaration.m_conditional }, declaration.m_body);
+                break;
+            }
+            case node::type::for_declaration: {
+                const auto& declaration = a_node.get_for_declaration();
+                flatten_declaration(a_index, node::type::for_declaration, { &declaration.m_initialization, &declaration.m_conditional, &declaration.m_iteration }, declaration.m_body);
+                break;
+            }
+            case node::type::function_declaration: {
+                const auto& declaration = a_node.get_function_declaration();
+                const size_t count = 2 + declaration.m_body.size();
+                const index first = allocate(count);
+
+                assign(a_index, node::type::function_declaration, first, count, separator::space, declaration.m_tags);
+                flatten(first, node::type::expression, declaration.m_identifier);
+                flatten_expressions(first + 1, declaration.m_parameters);
+
+                for (size_t i = 0; i < declaration.m_body.size(); ++i) {
+                    flatten(static_cast<index>(first + 2 + i), declaration.m_body[i]);
+                }
+
+                break;
+            }
+            case node::type::immediate_table: {
+                const auto& entries = a_node.get_immediate_table().m_entries;
+                const index first = allocate(2 * entries.size());
+
+                assign(a_index, node::type::immediate_table, first, 2 * entries.size());
+
+                for (size_t i = 0; i < entries.size(); ++i) {
+                    flatten(static_cast<index>(first + 2 * i), entries[i].first);
+                    flatten(static_cast<index>(first + 2 * i + 1), node::type::expression, entries[i].second);
+                }
+
+                break;
+            }
+            default:
+                assign(a_index, a_node.m_type, 0, 0);
+                break;
+        }
+    }
+
+    // Long operator chains nest to the left, so the first operand of each expression is flattened by the loop
+    // rather than by recursion.
+    void flat_ast::flatten(index a_index, node::type a_type, const node::expression& a_expression) {
+        for (const node::expression* expression = &a_expression; expression != nullptr;) {
+            const auto operands = expression->get_operands();
+            const index first = allocate(operands.size());
+
+            assign(a_index, a_type, first, operands.size(), expression->get_operation());
+            expression = nullptr;
+
+            for (size_t i = 0; i < operands.size(); ++i) {
+                if (i == 0 && (operands[0].m_type == node::type::expression || operands[0].m_type == node::type::group)) {
+                    expression = &operands[0].get_expression();
+                    a_index = first;
+                    a_type = operands[0].m_type;
+                } else {
+                    flatten(static_cast<index>(first + i), operands[i]);
+                }
+            }
+        }
+    }
+
+    void flat_ast::flatten_nodes(const index a_index, const node::type a_type, const std::vector<node>& a_nodes) {
+        const index first = allocate(a_nodes.size());
+
+        assign(a_index, a_type, first, a_nodes.size());
+
+        for (size_t i = 0; i < a_nodes.size(); ++i) {
+            flatten(static_cast<index>(first + i), a_nodes[i]);
+        }
+    }
+
+    void flat_ast::flatten_expressions(const index a_index, const node::argument_list& a_expressions) {
+        const index first = allocate(a_expressions.size());
+
+        assign(a_index, node::type::argument_list, first, a_expressions.size());
+
+        for (size_t i = 0; i < a_expressions.size(); ++i) {
+            flatten(static_cast<index>(first + i), node::type::expression, a_expressions[i]);
+        }
+    }
+
+    void flat_ast::flatten_declaration(const index a_index, const node::type a_type, std::initializer_list<const node::expression*> a_expressions, const node::block& a_body) {
+        const size_t count = a_expressions.size() + a_body.size();
+        const index first = allocate(count);
+
+        assign(a_index, a_type, first, count);
+
+        index current = first;
+
+        for (const node::expression* expression : a_expressions) {
+            flatten(current++, node::type::expression, *expression);
+        }
+
+        for (size_t i = 0; i < a_body.size(); ++i) {
+            flatten(static_cast<index>(first + a_expressions.size() + i), a_body[i]);
+        }
+    }
+
+    // FLAT NODE
+
+    flat_node::flat_node(const flat_ast& a_ast, const index a_index) noexcept : m_ast(&a_ast), m_entry(&a_ast.at(a_index)) {}
+
+    const token& flat_node::get_token() const noexcept {
+        return m_ast->token_at(m_entry->m_first);
+    }
+
+    flat_node flat_node::get_operand(const size_t a_index) const noexcept {
+        return { *m_ast, static_cast<index>(m_entry->m_first + a_index) };
+    }
+
+    flat_range flat_node::get_operands() const noexcept {
+        return { *m_ast, m_entry->m_first, m_entry->m_count };
+    }
+
+    flat_node flat_node::get_conditional() const noexcept {
+        return get_operand(get_type() == node::type::for_declaration ? 1 : 0);
+    }
+
+    flat_node flat_node::get_initialization() const noexcept {
+        return get_operand(0);
+    }
+
+    flat_node flat_node::get_iteration() const noexcept {
+        return get_operand(2);
+    }
+
+    flat_node flat_node::get_identifier() const noexcept {
+        return get_operand(0);
+    }
+
+    function_tags flat_node::get_tags() const noexcept {
+        return static_cast<function_tags>(m_entry->m_tags);
+    }
+
+    flat_range flat_node::get_parameters() const noexcept {
+        return get_operand(1).get_operands();
+    }
+
+    flat_range flat_node::get_body() const noexcept {
+        switch (get_type()) {
+            case node::type::for_declaration:
+                return get_operands().subrange(3);
+            case node::type::function_declaration:
+                return get_operands().subrange(2);
+            default:
+                return get_operands().subrange(1);
+        }
+    }
+
+    size_t flat_node::entry_count() const noexcept {
+        return count() / 2;
+    }
+
+    flat_node flat_node::get_key(const size_t a_entry) const noexcept {
+        return get_operand(2 * a_entry);
+    }
+
+    flat_node flat_node::get_value(const size_t a_entry) const noexcept {
+        return get_operand(2 * a_entry + 1);
+    }
+
+    std::string flat_node::expression_string() const {
+        std::string string;
+
+        if (get_operation() != separator::space) {
+            string += separator_to_string(get_operation());
+            string += " ( ";
+        }
+
+        for (const flat_node operand : get_operands()) {
+            string += operand.to_string();
+        }
+
+        return get_operation() != separator::space ? string + "); " : string;
+    }
+
+    std::string flat_node::to_string() const {
+        const auto statements_string = [](const flat_range a_statements) {
+            std::string string;
+
+            for (const flat_node statement : a_statements) {
+                string += statement.to_string();
+            }
+
+            return string;
+        };
+
+        switch (get_type()) {
+            case node::type::empty:
+                return "EMPTY; ";
+            case node::type::token:
+                return get_token().to_string();
+            case node::type::expression:
+            case node::type::group:
+                return std::string{ "EXPRESSION { " } + expression_string() + "}; ";
+            case node::type::block:
+                return std::string{ "BLOCK { " } + statements_string(get_operands()) + "}; ";
+            case node::type::selector:
+                return std::string{ "SELECTOR { " } + expression_string() + "}; ";
+            case node::type::ranged_selector:
+                return std::string{ "RANGED SELECTOR { " } + get_operand(0).expression_string() + get_operand(1).expression_string() + "}; ";
+            case node::type::argument_list: {
+                std::string string{ "ARGUMENT LIST { " };
+
+                for (const flat_node argument : get_operands()) {
+                    string += "ARGUMENT GROUP { ";
+                    string += argument.expression_string();
+                    string += "}; ";
+                }
+
+                return string + "}; ";
+            }
+            case node::type::if_declaration:
+                return std::string{ "IF DECLARATION { CONDITIONAL GROUP { " } + get_conditional().expression_string() + "}; BODY BLOCK { " + statements_string(get_body()) + "}; }; ";
+            case node::type::else_if_declaration:
+                return std::string{ "ELSE IF DECLARATION { CONDITIONAL GROUP { " } + get_conditional().expression_string() + "}; BODY BLOCK { " + statements_string(get_body()) + "}; }; ";
+            case node::type::else_declaration:
+                return std::string{ "ELSE DECLARATION { " } + statements_string(get_operands()) + "}; ";
+            case node::type::for_declaration: {
+                std::string string{ "FOR DECLARATION { INITIALIZATION GROUP { " };
+                string += get_initialization().expression_string();
+                string += "}; CONDITIONAL GROUP { ";
+                string += get_conditional().expression_string();
+                string += "}; ITERATION GROUP { ";
+                string += get_iteration().expression_string();
+                string += "}; BODY BLOCK { ";
+                string += statements_string(get_body());
+
+                return string + "}; }; ";
+            }
+            case node::type::function_declaration: {
+                std::string string{ "FUNCTION DECLARATION { IDENTIFIER GROUP { " };
+                string += get_identifier().expression_string();
+                string += "}; FUNCTION TAGS: ";
+                string += function_tags_to_string(get_tags());
+                string += "; PARAMETER LIST { ";
+
+                for (const flat_node parameter : get_parameters()) {
+                    string += "PARAMETER GROUP { ";
+                    string += parameter.expression_string();
+                    string += "}; ";
+                }
+
+                string += "}; BODY BLOCK { ";
+                string += statements_string(get_body());
+
+                return string + "}; }; ";
+            }
+            case node::type::while_declaration:
+                return std::string{ "WHILE DECLARATION { CONDITIONAL GROUP { " } + get_conditional().expression_string() + "}; BODY BLOCK { " + statements_string(get_body()) + "}; }; ";
+            case node::type::do_declaration:
+                return std::string{ "DO DECLARATION { CONDITIONAL GROUP { " } + get_conditional().expression_string() + "}; BODY BLOCK { " + statements_string(get_body()) + "}; }; ";
+            case node::type::return_statement:
+                return std::string{ "RETURN EXPRESSION { " } + expression_string() + "}; ";
+            case node::type::immediate_table: {
+                std::string string{ "IMMEDIATE TABLE { " };
+
+                for (size_t i = 0; i < entry_count(); ++i) {
+                    string += "ENTRY { KEY { ";
+                    string += get_key(i).to_string();
+                    string += "}; VALUE { ";
+                    string += get_value(i).expression_string();
+                    string += "}; ";
+                }
+
+                return string + "}; ";
+            }
+            case node::type::immediate_array:
+                return std::string{ "IMMEDIATE ARRAY { " } + statements_string(get_operands()) + "}; ";
+            case node::type::break_statement:
+                return "BREAK; ";
+            case node::type::continue_statement:
+                return "CONTINUE; ";
+            default:
+                return "";
+        }
+    }
+}
+
+#endif //REBAR_FLAT_AST_HPP
@@ -7,6 +7,7 @@
 
 #include <type_traits>
 
+#include "definitions.hpp"
 #include "span.hpp"
 
 namespace rebar {
@@ -21,10 +22,29 @@ namespace rebar {
     public:
         function(environment& a_environment, const void* a_data) noexcept : m_environment(a_environment), m_data(a_data) {}
 
+        // Native functions are encoded as a pointer to their callable with the low bit set, so calling them skips
+        // the provider. Provider data is at least 2-byte aligned and never carries the tag.
+        static constexpr size_t native_tag = 1;
+
+        [[nodiscard]] static const void* native_data(const callable* a_function) noexcept {
+            return reinterpret_cast<const void*>(reinterpret_cast<size_t>(a_function) | native_tag);
+        }
+
+        [[nodiscard]] bool is_native() const noexcept {
+            return (reinterpret_cast<size_t>(m_data) & native_tag) != 0;
+        }
+
+        [[nodiscard]] callable native_callable() const noexcept {
+            return *reinterpret_cast<const callable*>(reinterpret_cast<size_t>(m_data) & ~native_tag);
+        }
+
         template <typename... t_objects>
         object call(t_objects&&... a_objects);
         object call(const span<object> a_objects);
 
+        // Calls the function with the arguments of the environment's current frame (see argument_frame).
+        object invoke();
+
         template <typename... t_objects>
         auto operator () (t_objects&&... a_objects) {
             return call(std::forward<t_objects>(a_objects)...);
@@ -5,8 +5,6 @@
 #ifndef REBAR_FUNCTION_IMPL_HPP
 #define REBAR_FUNCTION_IMPL_HPP
 
-#include <array>
-
 #include "function.hpp"
 
 #include "object.hpp"
@@ -15,30 +13,24 @@
 namespace rebar {
     template <typename... t_objects>
     object function::call(t_objects&&... a_objects) {
-        std::array<object, 16> temp = m_environment.get_args();
-
-        if constexpr (sizeof...(a_objects) > 0) {
-            std::vector<object> args{{ std::forward<t_objects>(a_objects)... }};
-            m_environment.set_args(args);
-        }
-
-        object res = m_environment.m_provider->call(m_data);
-
-        m_environment.set_args(temp);
+        argument_frame frame(m_environment);
+        (frame.push(std::forward<t_objects>(a_objects)), ...);
+        frame.enter();
 
-        return res;
+        return invoke();
     }
 
     object function::call(const span<object> a_objects) {
-        std::array<object, 16> temp = m_environment.get_args();
-
-        m_environment.set_args(a_objects);
-
-        object res = m_environment.m_provider->call(m_data);
+        argument_frame frame(m_environment, a_objects);
+        return invoke();
+    }
 
-        m_environment.set_args(temp);
+    object function::invoke() {
+        if (is_native()) {
+            return native_callable()(&m_environment);
+        }
 
-        return res;
+        return m_environment.m_provider->call(m_data);
     }
 }
 
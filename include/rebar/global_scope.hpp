@@ -0,0 +1,96 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_GLOBAL_SCOPE_HPP
+#define REBAR_GLOBAL_SCOPE_HPP
+
+#include "object.hpp"
+#include "table.hpp"
+
+namespace rebar {
+    // Global variables of an environment, in two layers. The base holds the bindings the environment was
+    // initialized with and is only changed by freeze(); the overlay receives every other assignment. Lookups check
+    // the overlay, then the base. Taking an assignable reference to a base binding first copies it into the
+    // overlay, so scripts never rebind a base global and reset() returns the bindings to their frozen state.
+    //
+    // Only bindings are layered. A table bound in the base is the same table in the overlay, so changes to its
+    // entries survive reset(). The base is not shared with other environments either: its objects refer to the
+    // environment that created them and are reference counted without synchronization. Every clone of a snapshot
+    // holds a full base of its own, so layering saves no memory.
+    //
+    // Until the first freeze() the base is empty and the scope behaves like a single table.
+    class global_scope {
+    public:
+        global_scope() = default;
+
+        global_scope(const global_scope&) = delete;
+        global_scope& operator = (const global_scope&) = delete;
+
+        // Value of a_key, or null. Never copies into the overlay.
+        [[nodiscard]] object index(const object a_key) const {
+            if (const object* found = find(a_key)) {
+                return *found;
+            }
+
+            return null;
+        }
+
+        // Read-only pointer to the value of a_key, or nullptr.
+        [[nodiscard]] const object* find(const object& a_key) const noexcept {
+            if (const object* found = m_overlay.find(a_key)) {
+                return found;
+            }
+
+            return m_base.find(a_key);
+        }
+
+        // Assignable value of a_key in the overlay, copied from the base if only the base binds it.
+        [[nodiscard]] object& operator[](const object a_key) {
+            if (object* found = m_overlay.find(a_key)) {
+                return *found;
+            }
+
+            object& created = m_overlay[a_key];
+
+            if (const object* inherited = m_base.find(a_key)) {
+                created = *inherited;
+            }
+
+            return created;
+        }
+
+        // Makes the current globals the base: overlay bindings replace those of the base and the overlay is emptied.
+        void freeze() {
+            m_overlay.for_each([this](const object& a_key, const object& a_value) {
+                m_base[a_key] = a_value;
+            });
+
+            m_overlay.clear();
+        }
+
+        // Discards every assignment made since the last freeze().
+        void reset() noexcept {
+            m_overlay.clear();
+        }
+
+        void clear() noexcept {
+            m_overlay.clear();
+            m_base.clear();
+        }
+
+        [[nodiscard]] const table& base() const noexcept {
+            return m_base;
+        }
+
+        [[nodiscard]] const table& overlay() const noexcept {
+            return m_overlay;
+        }
+
+    private:
+        table m_base;
+        table m_overlay;
+    };
+}
+
+#endif //REBAR_GLOBAL_SCOPE_HPP
@@ -0,0 +1,340 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_IMAGE_HPP
+#define REBAR_IMAGE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "definitions.hpp"
+#include "flat_ast.hpp"
+#include "lexer.hpp"
+#include "preprocess.hpp"
+
+namespace rebar {
+    // Binary image of a parse unit, from which the unit is restored without lexing or parsing. Images are
+    // produced by write_image() and read by read_image(), which accepts any byte range: a file read into memory
+    // or a file mapped with mmap/MapViewOfFile. Restoring copies the flat AST with a single memcpy and rebuilds
+    // the tokens from fixed-size records.
+    //
+    // Layout, in host byte order (images are not portable between byte orders or word sizes):
+    //   header           image_header
+    //   AST entries      entry_count flat_ast::entry records
+    //   tokens           token_count image_token records; parser-synthesized tokens follow the lexed ones
+    //   string pool      the distinct identifier and string literal texts
+    //   plaintext        the source text
+    //
+    // image_version changes whenever the layout, the token enumerations or the AST encoding change; images of
+    // another version are rejected.
+    constexpr uint32_t image_version = 1;
+
+    struct image_header {
+        char m_magic[4];
+        uint32_t m_version;
+        uint32_t m_byte_order;
+        uint32_t m_integer_size;
+        uint64_t m_entry_count;
+        uint64_t m_token_count;
+        uint64_t m_string_pool_size;
+        uint64_t m_plaintext_size;
+    };
+
+    struct image_token {
+        uint32_t m_type;
+        uint32_t m_row;
+        uint32_t m_column;
+        uint32_t m_length;  // Length of the string of identifiers and string literals.
+        uint64_t m_value;   // Separator, keyword, literal bits, or string pool offset.
+    };
+
+    static_assert(sizeof(image_header) == 48, "Image headers are expected to be 48 bytes wide.");
+    static_assert(sizeof(image_token) == 24, "Image token records are expected to be 24 bytes wide.");
+
+    namespace detail {
+        constexpr char image_magic[4] = { 'R', 'B', 'R', 'I' };
+        constexpr uint32_t image_byte_order = 0x01020304;
+
+        template <typename t_type>
+        void append_bytes(std::string& a_image, const t_type& a_value) {
+            a_image.append(reinterpret_cast<const char*>(&a_value), sizeof(t_type));
+        }
+
+        template <typename t_type>
+        [[nodiscard]] uint64_t to_bits(const t_type a_value) noexcept {
+            uint64_t bits = 0;
+            std::memcpy(&bits, &a_value, sizeof(t_type));
+            return bits;
+        }
+
+        template <typename t_type>
+        [[nodiscard]] t_type from_bits(const uint64_t a_bits) noexcept {
+            t_type value;
+            std::memcpy(&value, &a_bits, sizeof(t_type));
+            return value;
+        }
+
+        // Reads consecutive sections of an image, checking that each lies within it.
+        class image_reader {
+        public:
+            explicit image_reader(const std::string_view a_image) noexcept : m_image(a_image) {}
+
+            [[nodiscard]] const char* take(const uint64_t a_count, const uint64_t a_size) {
+                if (a_size != 0 && a_count > (m_image.size() - m_offset) / a_size) {
+                    throw std::runtime_error("Truncated rebar image.");
+                }
+
+                const char* section = m_image.data() + m_offset;
+                m_offset += static_cast<size_t>(a_count * a_size);
+
+                return section;
+            }
+
+        private:
+            std::string_view m_image;
+            size_t m_offset = 0;
+        };
+
+        // Fewest operands the providers read from an expression of a_operation that has any.
+        [[nodiscard]] constexpr size_t minimum_operands(const separator a_operation) noexcept {
+            switch (a_operation) {
+                case separator::space:
+                case separator::increment:
+                case separator::decrement:
+                case separator::logical_not:
+                case separator::bitwise_not:
+                case separator::length:
+                case separator::new_object:
+                case separator::operation_prefix_increment:
+                case separator::operation_postfix_increment:
+                case separator::operation_prefix_decrement:
+                case separator::operation_postfix_decrement:
+                case separator::operation_call:
+                    return 1;
+                case separator::ternary:
+                    return 3;
+                default:
+                    return 2;
+            }
+        }
+
+        // Whether the children of a_entry, which lie within a_entries, are as many and of the types that
+        // flat_node and the providers expect of a node of its type (see flat_ast).
+        [[nodiscard]] bool has_valid_shape(const std::vector<flat_ast::entry>& a_entries, const flat_ast::entry& a_entry) noexcept {
+            const auto is_expression = [&a_entries, &a_entry](const size_t a_child) noexcept {
+                return a_entries[a_entry.m_first + a_child].m_type == static_cast<uint8_t>(node::type::expression);
+            };
+
+            const auto are_expressions = [&](size_t a_child, const size_t a_step) noexcept {
+                for (; a_child < a_entry.m_count; a_child += a_step) {
+                    if (!is_expression(a_child)) {
+                        return false;
+                    }
+                }
+
+                return true;
+            };
+
+            switch (static_cast<node::type>(a_entry.m_type)) {
+                case node::type::expression:
+                case node::type::group:
+                case node::type::selector:
+                case node::type::return_statement:
+                    return a_entry.m_operation <= static_cast<uint8_t>(separator::operation_call)
+                            && (a_entry.m_count == 0 || a_entry.m_count >= minimum_operands(static_cast<separator>(a_entry.m_operation)));
+                case node::type::argument_list:
+                    return are_expressions(0, 1);
+                case node::type::ranged_selector:
+                    return a_entry.m_count == 2 && are_expressions(0, 1);
+                case node::type::if_declaration:
+                case node::type::else_if_declaration:
+                case node::type::while_declaration:
+                case node::type::do_declaration:
+                    return a_entry.m_count >= 1 && is_expression(0);
+                case node::type::for_declaration:
+                    return a_entry.m_count >= 3 && is_expression(0) && is_expression(1) && is_expression(2);
+                case node::type::function_declaration:
+                    return a_entry.m_count >= 2 && is_expression(0) && a_entries[a_entry.m_first + 1].m_type == static_cast<uint8_t>(node::type::argument_list);
+                case node::type::immediate_table:
+                    return a_entry.m_count % 2 == 0 && are_expressions(1, 2);
+                default:
+                    return true;
+            }
+        }
+    }
+
+    [[nodiscard]] std::string write_image(const parse_unit& a_unit) {
+        const flat_ast& ast = a_unit.m_ast;
+        const auto& positions = a_unit.m_lex_unit.source_positions();
+
+        std::string string_pool;
+        std::unordered_map<std::string_view, uint32_t> pooled;
+        std::vector<image_token> records(ast.token_count());
+
+        for (size_t i = 0; i < records.size(); ++i) {
+            const token& tok = ast.token_at(static_cast<flat_ast::index>(i));
+            image_token& record = records[i];
+
+            record = { static_cast<uint32_t>(tok.token_type()), 0, 0, 0, 0 };
+
+            if (i < positions.size()) {
+                record.m_row = static_cast<uint32_t>(positions[i].row());
+                record.m_column = static_cast<uint32_t>(positions[i].column());
+            }
+
+            switch (tok.token_type()) {
+                case token::type::separator:
+                    record.m_value = static_cast<uint64_t>(tok.get_separator());
+                    break;
+                case token::type::keyword:
+                    record.m_value = static_cast<uint64_t>(tok.get_keyword());
+                    break;
+                case token::type::string_literal:
+                case token::type::identifier: {
+                    const std::string_view text = std::get<std::string>(tok.m_data);
+                    auto [position, inserted] = pooled.emplace(text, static_cast<uint32_t>(string_pool.size()));
+
+                    if (inserted) {
+                        string_pool += text;
+                    }
+
+                    record.m_value = position->second;
+                    record.m_length = static_cast<uint32_t>(text.size());
+                    break;
+                }
+                case token::type::integer_literal:
+                    record.m_value = detail::to_bits(tok.get_integer_literal());
+                    break;
+                case token::type::number_literal:
+                    record.m_value = detail::to_bits(tok.get_number_literal());
+                    break;
+            }
+        }
+
+        image_header header{};
+        std::memcpy(header.m_magic, detail::image_magic, sizeof(header.m_magic));
+        header.m_version = image_version;
+        header.m_byte_order = detail::image_byte_order;
+        header.m_integer_size = sizeof(integer);
+        header.m_entry_count = ast.size();
+        header.m_token_count = records.size();
+        header.m_string_pool_size = string_pool.size();
+        header.m_plaintext_size = a_unit.m_plaintext.size();
+
+        std::string image;
+        image.reserve(sizeof(header) + ast.size() * sizeof(flat_ast::entry) + records.size() * sizeof(image_token) + string_pool.size() + a_unit.m_plaintext.size());
+
+        detail::append_bytes(image, header);
+        image.append(reinterpret_cast<const char*>(ast.data()), ast.size() * sizeof(flat_ast::entry));
+        image.append(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(image_token));
+        image += string_pool;
+        image += a_unit.m_plaintext;
+
+        return image;
+    }
+
+    // Restores a parse unit from an image. Throws std::runtime_error if a_image is not a valid image of this
+    // version.
+    [[nodiscard]] parse_unit read_image(const std::string_view a_image) {
+        detail::image_reader reader(a_image);
+
+        image_header header;
+        std::memcpy(&header, reader.take(1, sizeof(image_header)), sizeof(image_header));
+
+        if (std::memcmp(header.m_magic, detail::image_magic, sizeof(header.m_magic)) != 0) {
+            throw std::runtime_error("Not a rebar image.");
+        }
+
+        if (header.m_version != image_version || header.m_byte_order != detail::image_byte_order || header.m_integer_size != sizeof(integer)) {
+            throw std::runtime_error("Incompatible rebar image.");
+        }
+
+        if (header.m_entry_count == 0 || header.m_entry_count > std::numeric_limits<flat_ast::index>::max() || header.m_token_count > std::numeric_limits<flat_ast::index>::max()) {
+            throw std::runtime_error("Malformed rebar image.");
+        }
+
+        const char* entry_bytes = reader.take(header.m_entry_count, sizeof(flat_ast::entry));
+        const char* token_bytes = reader.take(header.m_token_count, sizeof(image_token));
+        const std::string_view string_pool(reader.take(header.m_string_pool_size, 1), static_cast<size_t>(header.m_string_pool_size));
+        const std::string_view plaintext(reader.take(header.m_plaintext_size, 1), static_cast<size_t>(header.m_plaintext_size));
+
+        std::vector<flat_ast::entry> entries(static_cast<size_t>(header.m_entry_count));
+        std::memcpy(entries.data(), entry_bytes, entries.size() * sizeof(flat_ast::entry));
+
+        // Children always follow their parent, which also rules out cycles. Every node has the children its type
+        // is read with, so a damaged image is rejected here rather than read out of bounds later.
+        for (size_t i = 0; i < entries.size(); ++i) {
+            const flat_ast::entry& e = entries[i];
+
+            if (e.m_type > static_cast<uint8_t>(node::type::immediate_array)) {
+                throw std::runtime_error("Malformed rebar image.");
+            }
+
+            const bool valid = static_cast<node::type>(e.m_type) == node::type::token
+                    ? e.m_first < header.m_token_count && e.m_count == 0
+                    : e.m_count == 0 || (e.m_first > i && e.m_first + uint64_t{ e.m_count } <= entries.size());
+
+            if (!valid || !detail::has_valid_shape(entries, e)) {
+                throw std::runtime_error("Malformed rebar image.");
+            }
+        }
+
+        parse_unit unit;
+        unit.m_plaintext = plaintext;
+        unit.m_lex_unit.tokens().reserve(static_cast<size_t>(header.m_token_count));
+        unit.m_lex_unit.source_positions().reserve(static_cast<size_t>(header.m_token_count));
+
+        for (size_t i = 0; i < header.m_token_count; ++i) {
+            image_token record;
+            std::memcpy(&record, token_bytes + i * sizeof(image_token), sizeof(image_token));
+
+            const source_position position(record.m_row, record.m_column);
+
+            switch (static_cast<token::type>(record.m_type)) {
+                case token::type::separator:
+                    if (record.m_value > static_cast<uint64_t>(separator::operation_call)) {
+                        throw std::runtime_error("Malformed rebar image.");
+                    }
+
+                    unit.m_lex_unit.add_token(position, token::type::separator, std::in_place_type<separator>, static_cast<separator>(record.m_value));
+                    break;
+                case token::type::keyword:
+                    if (record.m_value > static_cast<uint64_t>(keyword::literal_null)) {
+                        throw std::runtime_error("Malformed rebar image.");
+                    }
+
+                    unit.m_lex_unit.add_token(position, token::type::keyword, std::in_place_type<keyword>, static_cast<keyword>(record.m_value));
+                    break;
+                case token::type::string_literal:
+                case token::type::identifier:
+                    if (record.m_value > string_pool.size() || record.m_length > string_pool.size() - record.m_value) {
+                        throw std::runtime_error("Malformed rebar image.");
+                    }
+
+                    unit.m_lex_unit.add_token(position, static_cast<token::type>(record.m_type), std::in_place_type<std::string>, string_pool.substr(static_cast<size_t>(record.m_value), record.m_length));
+                    break;
+                case token::type::integer_literal:
+                    unit.m_lex_unit.add_token(position, token::type::integer_literal, std::in_place_type<integer>, detail::from_bits<integer>(record.m_value));
+                    break;
+                case token::type::number_literal:
+                    unit.m_lex_unit.add_token(position, token::type::number_literal, std::in_place_type<number>, detail::from_bits<number>(record.m_value));
+                    break;
+                default:
+                    throw std::runtime_error("Malformed rebar image.");
+            }
+        }
+
+        unit.m_ast = flat_ast(span<token>(unit.m_lex_unit.tokens()), std::move(entries));
+
+        return unit;
+    }
+}
+
+#endif //REBAR_IMAGE_HPP
@@ -5,6 +5,8 @@
 #ifndef REBAR_INTERPRETER_HPP
 #define REBAR_INTERPRETER_HPP
 
+#include <deque>
+
 #include "provider.hpp"
 #include "object.hpp"
 #include "table.hpp"
@@ -20,6 +22,8 @@ namespace rebar {
         public:
             explicit function_source(environment& a_environment) noexcept : m_environment(a_environment) {}
 
+            virtual ~function_source() = default;
+
             [[nodiscard]] environment& env() noexcept {
                 return m_environment;
             }
@@ -27,28 +31,28 @@ namespace rebar {
             virtual object internal_call() = 0;
         };
 
-        class native_function_source : public function_source {
-            callable m_function;
+        // A parse unit along with the interned strings of its identifier and string literal tokens, which are
+        // resolved once at compile time and looked up by token position during evaluation.
+        struct compiled_unit {
+            environment& m_environment;
+            std::shared_ptr<const parse_unit> m_unit;
+            std::vector<object> m_strings;
 
-        public:
-            native_function_source(environment& a_environment, callable a_callable) noexcept :
-                    function_source(a_environment),
-                    m_function(a_callable) {}
+            compiled_unit(environment& a_environment, std::shared_ptr<const parse_unit> a_unit);
 
-        protected:
-            object internal_call() override {
-                return m_function(&m_environment);
-            }
+            [[nodiscard]] object string(const token& a_token) const;
         };
 
         class interpreted_function_source : public function_source {
-            node::argument_list m_arguments;
-            const node::block& m_body;
+            const compiled_unit& m_unit;
+            flat_range m_arguments;
+            flat_range m_body;
 
         public:
-            interpreted_function_source(environment& a_environment, node::argument_list a_arguments, const node::block& a_body) noexcept :
+            interpreted_function_source(environment& a_environment, const compiled_unit& a_unit, const flat_range a_arguments, const flat_range a_body) noexcept :
                     function_source(a_environment),
-                    m_arguments(std::move(a_arguments)),
+                    m_unit(a_unit),
+                    m_arguments(a_arguments),
                     m_body(a_body) {}
 
         protected:
@@ -57,15 +61,17 @@ namespace rebar {
 
         explicit interpreter(environment& a_environment) noexcept : m_environment(a_environment), m_arguments(1) {}
 
-        [[nodiscard]] function compile(parse_unit a_unit) override {
-            m_parse_units.push_back(std::make_unique<parse_unit>(std::move(a_unit)));
-            m_function_sources.emplace_back(dynamic_cast<function_source*>(new interpreted_function_source(m_environment, node::argument_list(), m_parse_units.back()->m_block)));
+        [[nodiscard]] function compile(std::shared_ptr<const parse_unit> a_unit) override {
+            m_compiled_units.push_back(std::make_unique<compiled_unit>(m_environment, std::move(a_unit)));
+
+            const compiled_unit& unit = *m_compiled_units.back();
+            m_function_sources.emplace_back(dynamic_cast<function_source*>(new interpreted_function_source(m_environment, unit, flat_range(), unit.m_unit->m_ast.statements())));
             return { m_environment, m_function_sources.back().get() };
         }
 
         [[nodiscard]] function bind(callable a_function) override {
-            m_function_sources.emplace_back(dynamic_cast<function_source*>(new native_function_source(m_environment, a_function)));
-            return { m_environment, m_function_sources.back().get() };
+            m_native_functions.push_back(a_function);
+            return { m_environment, function::native_data(&m_native_functions.back()) };
         }
 
         [[nodiscard]] object call(const void* a_data) override {
@@ -79,8 +85,11 @@ namespace rebar {
         environment& m_environment;
         size_t m_argument_stack_position = 0;
         std::vector<std::vector<object>> m_arguments;
-        std::vector<std::unique_ptr<parse_unit>> m_parse_units;
+        std::vector<std::unique_ptr<compiled_unit>> m_compiled_units;
         std::vector<std::unique_ptr<function_source>> m_function_sources;
+
+        // Bound native functions, referenced by address from the functions encoding them.
+        std::deque<callable> m_native_functions;
     };
 }
 
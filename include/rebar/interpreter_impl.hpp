@@ -10,6 +10,97 @@
 #include "environment.hpp"
 
 namespace rebar {
+    namespace detail {
+        // Binary operators that evaluate both operands, left first, and nothing else.
+        [[nodiscard]] constexpr bool is_eager_binary(const separator a_operation) noexcept {
+            switch (a_operation) {
+                case separator::addition:
+                case separator::subtraction:
+                case separator::multiplication:
+                case separator::division:
+                case separator::modulus:
+                case separator::exponent:
+                case separator::equality:
+                case separator::inverse_equality:
+                case separator::greater:
+                case separator::lesser:
+                case separator::greater_equality:
+                case separator::lesser_equality:
+                case separator::bitwise_or:
+                case separator::bitwise_xor:
+                case separator::bitwise_and:
+                case separator::shift_right:
+                case separator::shift_left:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        // a_operation must be an eager binary operator.
+        object evaluate_binary(environment& a_environment, const separator a_operation, const object& lhs, const object& rhs) {
+            switch (a_operation) {
+                case separator::addition:
+                    return object::add(a_environment, lhs, rhs);
+                case separator::subtraction:
+                    return object::subtract(a_environment, lhs, rhs);
+                case separator::multiplication:
+                    return object::multiply(a_environment, lhs, rhs);
+                case separator::division:
+                    return object::divide(a_environment, lhs, rhs);
+                case separator::modulus:
+                    return object::modulus(a_environment, lhs, rhs);
+                case separator::exponent:
+                    return object::exponentiate(a_environment, lhs, rhs);
+                case separator::equality:
+                    return object::equals(a_environment, lhs, rhs);
+                case separator::inverse_equality:
+                    return object::not_equals(a_environment, lhs, rhs);
+                case separator::greater:
+                    return object::greater_than(a_environment, lhs, rhs);
+                case separator::lesser:
+                    return object::lesser_than(a_environment, lhs, rhs);
+                case separator::greater_equality:
+                    return object::greater_than_equal_to(a_environment, lhs, rhs);
+                case separator::lesser_equality:
+                    return object::lesser_than_equal_to(a_environment, lhs, rhs);
+                case separator::bitwise_or:
+                case separator::bitwise_xor:
+                    return object::bitwise_or(a_environment, lhs, rhs);
+                case separator::bitwise_and:
+                    return object::bitwise_and(a_environment, lhs, rhs);
+                case separator::shift_right:
+                    return object::shift_right(a_environment, lhs, rhs);
+                case separator::shift_left:
+                    return object::shift_left(a_environment, lhs, rhs);
+                default:
+                    return null;
+            }
+        }
+    }
+
+    interpreter::compiled_unit::compiled_unit(environment& a_environment, std::shared_ptr<const parse_unit> a_unit) : m_environment(a_environment), m_unit(std::move(a_unit)) {
+        const auto& tokens = m_unit->m_lex_unit.tokens();
+        m_strings.resize(tokens.size());
+
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            if (tokens[i].is_identifier() || tokens[i].is_string_literal()) {
+                m_strings[i] = a_environment.str(std::get<std::string>(tokens[i].m_data));
+            }
+        }
+    }
+
+    object interpreter::compiled_unit::string(const token& a_token) const {
+        const auto& tokens = m_unit->m_lex_unit.tokens();
+
+        // Tokens synthesized by the parser (e.g. the implicit "this" parameter) live outside of the lex unit.
+        if (&a_token < tokens.data() || &a_token >= tokens.data() + tokens.size()) {
+            return m_environment.str(std::get<std::string>(a_token.m_data));
+        }
+
+        return m_strings[static_cast<size_t>(&a_token - tokens.data())];
+    }
+
     object interpreter::interpreted_function_source::internal_call() {
         enum class node_tags : enum_base {
             none,
@@ -20,29 +111,38 @@ namespace rebar {
 
         const auto find_variable = [this, &local_tables](const object a_key) -> object& {
             for (size_t i = local_tables.size(); i >= 1; --i) {
-                auto found = local_tables[i - 1].find(a_key);
-
-                if (found != local_tables[i - 1].cend()) {
-                    return found->second;
+                if (object* found = local_tables[i - 1].find(a_key)) {
+                    return *found;
                 }
             }
 
             return m_environment.global_table()[a_key];
         };
 
-        std::function<object (const node::expression&)> evaluate_expression;
-        std::function<object (const node&, const node_tags)> detail_resolve_node;
+        // Like find_variable, without making the global assignable, which would copy it out of the frozen globals.
+        const auto lookup_variable = [this, &local_tables](const object a_key) -> object {
+            for (size_t i = local_tables.size(); i >= 1; --i) {
+                if (const object* found = local_tables[i - 1].find(a_key)) {
+                    return *found;
+                }
+            }
+
+            return m_environment.global_table().index(a_key);
+        };
+
+        std::function<object (flat_node)> evaluate_expression;
+        std::function<object (flat_node, const node_tags)> detail_resolve_node;
 
-        std::function<object (const node&)> resolve_node = [this, &evaluate_expression, &find_variable, &resolve_node, &detail_resolve_node](const node& a_node, const node_tags a_nodes = node_tags::none) -> object {
+        std::function<object (flat_node)> resolve_node = [this, &evaluate_expression, &lookup_variable, &resolve_node, &detail_resolve_node](const flat_node a_node) -> object {
             if (a_node.is_token()) {
                 const token& tok = a_node.get_token();
 
                 switch (tok.token_type()) {
                     case token::type::identifier:
-                        return find_variable(m_environment.str(tok.get_identifier()));
+                        return lookup_variable(m_unit.string(tok));
                         break;
                     case token::type::string_literal:
-                        return m_environment.str(tok.get_string_literal());
+                        return m_unit.string(tok);
                         break;
                     case token::type::integer_literal:
                         return tok.get_integer_literal();
@@ -65,30 +165,27 @@ namespace rebar {
                         break;
                 }
             } else if (a_node.is_group() || a_node.is_expression()) {
-                return evaluate_expression(a_node.get_expression());
+                return evaluate_expression(a_node);
             } else if (a_node.is_immediate_table()) {
-                const auto& immediate = a_node.get_immediate_table();
-
-                auto* tbl = new table;
+                // Held from the start so that a collection while the entries are evaluated sees a live table.
+                object tbl = m_environment.create_table();
 
-                for (const auto& entry : immediate.m_entries) {
-                    (*tbl)[detail_resolve_node(entry.first, node_tags::identifier_as_string)] = evaluate_expression(entry.second);
+                for (size_t i = 0; i < a_node.entry_count(); ++i) {
+                    tbl.get_table()[detail_resolve_node(a_node.get_key(i), node_tags::identifier_as_string)] = evaluate_expression(a_node.get_value(i));
                 }
 
                 return tbl;
             } else if (a_node.is_selector()) {
-                const auto& sel = a_node.get_selector();
-
                 array arr(1); // Size = 1.
-                arr.push_back(evaluate_expression(sel));
+                m_environment.collector().track(arr);
+                arr.push_back(evaluate_expression(a_node));
 
                 return arr;
             } else if (a_node.is_immediate_array()) {
-                const auto& immediate = a_node.get_immediate_array();
-
-                array arr(immediate.size());
+                array arr(a_node.count());
+                m_environment.collector().track(arr);
 
-                for (const auto& n : immediate) {
+                for (const flat_node n : a_node.get_operands()) {
                     arr.push_back(resolve_node(n));
                 }
 
@@ -98,14 +195,14 @@ namespace rebar {
             return null;
         };
 
-        detail_resolve_node = [this, &resolve_node](const node& a_node, const node_tags a_tags) -> object {
+        detail_resolve_node = [this, &resolve_node](const flat_node a_node, const node_tags a_tags) -> object {
             switch (a_tags) {
                 case node_tags::identifier_as_string:
                     if (a_node.is_token()) {
                         const token &tok = a_node.get_token();
 
                         if (tok.is_identifier()) {
-                            return m_environment.str(tok.get_identifier());
+                            return m_unit.string(tok);
                         }
                     }
                 default:
@@ -113,33 +210,23 @@ namespace rebar {
             }
         };
 
-        std::function<object& (const node&)> resolve_assignable;
+        std::function<object& (flat_node)> resolve_assignable;
 
-        std::function<object& (const node::expression&)> resolve_assignable_expression = [this, &local_tables, &resolve_assignable, &resolve_node, &detail_resolve_node](const node::expression& a_expression) -> object& {
+        std::function<object& (flat_node)> resolve_assignable_expression = [this, &local_tables, &resolve_assignable, &resolve_node, &detail_resolve_node](const flat_node a_expression) -> object& {
             switch (a_expression.get_operation()) {
                 case separator::space: {
+                    // Constness is not enforced, so "local" is the only qualifier that matters here.
                     bool flag_local = false;
-                    bool flag_constant = false;
 
-                    if (a_expression.count() > 1) {
-                        for (auto it = a_expression.get_operands().begin(); it != a_expression.get_operands().end() - 1; ++it) {
-                            if (it->is_token()) {
-                                const auto& tok = it->get_token();
+                    for (size_t i = 0; i + 1 < a_expression.count(); ++i) {
+                        const flat_node qualifier = a_expression.get_operand(i);
 
-                                if (tok.is_keyword()) {
-                                    const auto kw = tok.get_keyword();
-
-                                    if (kw == keyword::local) {
-                                        flag_local = true;
-                                    } else if (kw == keyword::constant) {
-                                        flag_constant = true;
-                                    }
-                                }
-                            }
+                        if (qualifier.is_token() && qualifier.get_token() == keyword::local) {
+                            flag_local = true;
                         }
                     }
 
-                    const auto assignee_op = *(a_expression.get_operands().end() - 1);
+                    const flat_node assignee_op = a_expression.get_operands().back();
 
                     if (flag_local) {
                         if (assignee_op.is_token()) {
@@ -148,7 +235,7 @@ namespace rebar {
                             if (tok.is_identifier()) {
                                 auto& tb = local_tables.back();
 
-                                return tb[m_environment.str(tok.get_identifier())];
+                                return tb[m_unit.string(tok)];
                             }
                         }
                     }
@@ -309,29 +396,29 @@ namespace rebar {
                         return resolve_node(a_expression.get_operand(0)).index(m_environment, resolve_node(a_expression.get_operand(1)));
                     }
                 default:
-                    return null;
+                    return m_environment.null_slot();
                     // TODO: Throw unassignable expression error.
             }
 
             // TODO: Throw unassignable error.
-            return null;
+            return m_environment.null_slot();
         };
 
-        resolve_assignable = [this, &resolve_assignable_expression, &find_variable](const node& a_node) -> object& {
+        resolve_assignable = [this, &resolve_assignable_expression, &find_variable](const flat_node a_node) -> object& {
             if (a_node.is_token()) {
                 const token& tok = a_node.get_token();
 
                 if (tok.is_identifier()) {
-                    return find_variable(m_environment.str(tok.get_identifier()));
+                    return find_variable(m_unit.string(tok));
                 }
             } else if (a_node.is_group() || a_node.is_selector() || a_node.is_expression()) {
-                return resolve_assignable_expression(a_node.get_expression());
+                return resolve_assignable_expression(a_node);
             }
 
-            return null;
+            return m_environment.null_slot();
         };
 
-        evaluate_expression = [this, &resolve_node, &resolve_assignable, &detail_resolve_node](const node::expression& a_expression) -> object {
+        evaluate_expression = [this, &resolve_node, &resolve_assignable, &detail_resolve_node](const flat_node a_expression) -> object {
             if (a_expression.empty()) {
                 return null;
             }
@@ -339,14 +426,42 @@ namespace rebar {
             switch (a_expression.get_operation()) {
                 case separator::space:
                     return resolve_node(a_expression.get_operand(0));
+                case separator::addition:
+                case separator::subtraction:
+                case separator::multiplication:
+                case separator::division:
+                case separator::modulus:
+                case separator::exponent:
+                case separator::equality:
+                case separator::inverse_equality:
+                case separator::greater:
+                case separator::lesser:
+                case separator::greater_equality:
+                case separator::lesser_equality:
+                case separator::bitwise_or:
+                case separator::bitwise_xor:
+                case separator::bitwise_and:
+                case separator::shift_right:
+                case separator::shift_left: {
+                    // Generated code nests long chains such as "a + b + c + ..." to the left. The chain is walked
+                    // down and folded back up in a loop, so its length does not count against the native stack.
+                    std::vector<flat_node> chain{ a_expression };
+
+                    for (flat_node lhs = a_expression.get_operand(0); (lhs.is_expression() || lhs.is_group()) && lhs.count() == 2 && detail::is_eager_binary(lhs.get_operation()); lhs = lhs.get_operand(0)) {
+                        chain.push_back(lhs);
+                    }
+
+                    object result = resolve_node(chain.back().get_operand(0));
+
+                    for (size_t i = chain.size(); i >= 1; --i) {
+                        const flat_node link = chain[i - 1];
+                        result = detail::evaluate_binary(m_environment, link.get_operation(), result, resolve_node(link.get_operand(1)));
+                    }
+
+                    return result;
+                }
                 case separator::assignment:
                     return resolve_assignable(a_expression.get_operand(0)) = resolve_node(a_expression.get_operand(1));
-                case separator::addition:
-                    return object::add(
-                            m_environment,
-                            resolve_node(a_expression.get_operand(0)),
-                            resolve_node(a_expression.get_operand(1))
-                    );
                 case separator::addition_assignment: {
                     object& assignee = resolve_assignable(a_expression.get_operand(0));
 
@@ -358,12 +473,6 @@ namespace rebar {
 
                     return assignee;
                 }
-                case separator::multiplication:
-                    return object::multiply(
-                            m_environment,
-                            resolve_node(a_expression.get_operand(0)),
-                            resolve_node(a_expression.get_operand(1))
-                    );
                 case separator::multiplication_assignment: {
                     object& assignee = resolve_assignable(a_expression.get_operand(0));
 
@@ -375,12 +484,6 @@ namespace rebar {
 
                     return assignee;
                 }
-                case separator::division:
-                    return object::divide(
-                            m_environment,
-                            resolve_node(a_expression.get_operand(0)),
-                            resolve_node(a_expression.get_operand(1))
-                    );
                 case separator::division_assignment: {
                     object& assignee = resolve_assignable(a_expression.get_operand(0));
 
@@ -392,12 +495,6 @@ namespace rebar {
 
                     return assignee;
                 }
-                case separator::subtraction:
-                    return object::subtract(
-                            m_environment,
-                            resolve_node(a_expression.get_operand(0)),
-                            resolve_node(a_expression.get_operand(1))
-                    );
                 case separator::subtraction_assignment: {
                     object& assignee = resolve_assignable(a_expression.get_operand(0));
 
@@ -417,18 +514,6 @@ namespace rebar {
                     //case separator::selector_close:
                     //case separator::scope_open:
                     //case separator::scope_close:
-                case separator::equality:
-                    return object::equals(m_environment, resolve_node(a_expression.get_operand(0)), resolve_node(a_expression.get_operand(1)));
-                case separator::inverse_equality:
-                    return object::not_equals(m_environment, resolve_node(a_expression.get_operand(0)), resolve_node(a_expression.get_operand(1)));
-                case separator::greater:
-                    return object::greater_than(m_environment, resolve_node(a_expression.get_operand(0)), resolve_node(a_expression.get_operand(1)));
-                case separator::lesser:
-                    return object::lesser_than(m_environment, resolve_node(a_expression.get_operand(0)), resolve_node(a_expression.get_operand(1)));
-                case separator::greater_equality:
-                    return object::greater_than_equal_to(m_environment, resolve_node(a_expression.get_operand(0)), resolve_node(a_expression.get_operand(1)));
-                case separator::lesser_equality:
-                    return object::lesser_than_equal_to(m_environment, resolve_node(a_expression.get_operand(0)), resolve_node(a_expression.get_operand(1)));
                 case separator::logical_or: {
                     auto lhs = resolve_node(a_expression.get_operand(0));
 
@@ -449,8 +534,6 @@ namespace rebar {
                 }
                 case separator::logical_not:
                     return object::logical_not(m_environment, resolve_node(a_expression.get_operand(0)));
-                case separator::bitwise_or:
-                    return object::bitwise_or(m_environment, resolve_node(a_expression.get_operand(0)), resolve_node(a_expression.get_operand(1)));
                 case separator::bitwise_or_assignment: {
                     object& assignee = resolve_assignable(a_expression.get_operand(0));
 
@@ -462,8 +545,6 @@ namespace rebar {
 
                     return assignee;
                 }
-                case separator::bitwise_xor:
-                    return object::bitwise_or(m_environment, resolve_node(a_expression.get_operand(0)), resolve_node(a_expression.get_operand(1)));
                 case separator::bitwise_xor_assignment: {
                     object& assignee = resolve_assignable(a_expression.get_operand(0));
 
@@ -475,8 +556,6 @@ namespace rebar {
 
                     return assignee;
                 }
-                case separator::bitwise_and:
-                    return object::bitwise_and(m_environment, resolve_node(a_expression.get_operand(0)), resolve_node(a_expression.get_operand(1)));
                 case separator::bitwise_and_assignment: {
                     object& assignee = resolve_assignable(a_expression.get_operand(0));
 
@@ -490,8 +569,6 @@ namespace rebar {
                 }
                 case separator::bitwise_not:
                     return object::bitwise_not(m_environment, resolve_node(a_expression.get_operand(0)));
-                case separator::shift_right:
-                    return object::shift_right(m_environment, resolve_node(a_expression.get_operand(0)), resolve_node(a_expression.get_operand(1)));
                 case separator::shift_right_assignment: {
                     object& assignee = resolve_assignable(a_expression.get_operand(0));
 
@@ -503,8 +580,6 @@ namespace rebar {
 
                     return assignee;
                 }
-                case separator::shift_left:
-                    return object::shift_left(m_environment, resolve_node(a_expression.get_operand(0)), resolve_node(a_expression.get_operand(1)));
                 case separator::shift_left_assignment: {
                     object& assignee = resolve_assignable(a_expression.get_operand(0));
 
@@ -516,8 +591,6 @@ namespace rebar {
 
                     return assignee;
                 }
-                case separator::exponent:
-                    return object::exponentiate(m_environment, resolve_node(a_expression.get_operand(0)), resolve_node(a_expression.get_operand(1)));
                 case separator::exponent_assignment: {
                     object& assignee = resolve_assignable(a_expression.get_operand(0));
 
@@ -529,8 +602,6 @@ namespace rebar {
 
                     return assignee;
                 }
-                case separator::modulus:
-                    return object::modulus(m_environment, resolve_node(a_expression.get_operand(0)), resolve_node(a_expression.get_operand(1)));
                 case separator::modulus_assignment: {
                     object& assignee = resolve_assignable(a_expression.get_operand(0));
 
@@ -549,7 +620,11 @@ namespace rebar {
                 case separator::direct:
                 case separator::dot:
                     if (a_expression.count() == 2) {
-                        return resolve_assignable(a_expression.get_operand(0)).index(m_environment, detail_resolve_node(a_expression.get_operand(1), node_tags::identifier_as_string));
+                        object& lhs = resolve_assignable(a_expression.get_operand(0));
+                        const object key = detail_resolve_node(a_expression.get_operand(1), node_tags::identifier_as_string);
+
+                        // Members of native objects are bound fields and methods, read as the VM does.
+                        return lhs.is_native_object() ? lhs.select(m_environment, key) : lhs.index(m_environment, key);
                     }
                     //case separator::list:
                 case separator::length:
@@ -615,40 +690,64 @@ namespace rebar {
                         );
                     }
                 case separator::operation_call: {
-                    const auto& callable_node = a_expression.get_operand(0);
+                    const flat_node callable_node = a_expression.get_operand(0);
                     auto callee = null;
-                    std::vector<object> args;
+
+                    // Arguments are evaluated straight onto the argument stack; calls made while evaluating them
+                    // push and pop their own frames above.
+                    argument_frame args(m_environment);
 
                     if (callable_node.is_expression() || callable_node.is_group()) {
-                        const auto& expr = callable_node.get_expression();
+                        const flat_node expr = callable_node;
 
                         if (expr.get_operation() == separator::dot) {
                             auto this_object = resolve_node(expr.get_operand(0));
                             callee = this_object.select(m_environment, detail_resolve_node(expr.get_operand(1), node_tags::identifier_as_string));
-                            args.push_back(this_object);
+                            args.push(this_object);
                         }
                     } else {
                         callee = resolve_node(callable_node);
                     }
 
-                    for (auto it = a_expression.get_operands().begin() + 1; it != a_expression.get_operands().cend(); ++it) {
-                        args.push_back(resolve_node(*it));
+                    for (const flat_node argument : a_expression.get_operands().subrange(1)) {
+                        // An empty argument group, i.e. "f()", parses as a single empty expression.
+                        if (a_expression.count() == 2 && (argument.is_expression() || argument.is_group()) && argument.empty()) {
+                            break;
+                        }
+
+                        args.push(resolve_node(argument));
                     }
 
-                    return callee.call(m_environment, args);
+                    args.enter();
+
+                    return callee.invoke(m_environment);
                 }
-                case separator::new_object:
-                    if (a_expression.count() > 1) {
-                        std::vector<object> args;
+                case separator::new_object: {
+                    flat_node operand = a_expression.get_operand(0);
+                    flat_range arguments = a_expression.get_operands().subrange(1);
+
+                    // "new Type(args)" parses as a call nested in the new operation.
+                    if ((operand.is_expression() || operand.is_group()) && operand.get_operation() == separator::operation_call && a_expression.count() == 1) {
+                        arguments = operand.get_operands().subrange(1);
+                        operand = operand.get_operand(0);
+                    }
+
+                    object type_object = resolve_node(operand);
+                    argument_frame args(m_environment);
 
-                        for (auto it = a_expression.get_operands().begin() + 1; it != a_expression.get_operands().cend(); ++it) {
-                            args.push_back(resolve_node(*it));
+                    for (const flat_node argument : arguments) {
+                        // An empty argument group, i.e. "new Type()", parses as a single empty expression.
+                        if (arguments.size() == 1 && (argument.is_expression() || argument.is_group()) && argument.empty()) {
+                            break;
                         }
 
-                        return resolve_node(a_expression.get_operand(0)).new_object(m_environment, args);
-                    } else {
-                        return resolve_node(a_expression.get_operand(0)).new_object(m_environment);
+                        args.push(resolve_node(argument));
                     }
+
+                    args.enter();
+
+                    return type_object.invoke_new(m_environment);
+                }
                 default:
                     return null;
             }
@@ -666,19 +765,19 @@ namespace rebar {
             object result = null;
         };
 
-        std::function<return_state (const span<node>)> evaluate_block = [this, &local_tables, &evaluate_expression, &evaluate_block, &resolve_assignable_expression](const span<node> a_block) -> return_state {
+        std::function<return_state (flat_range)> evaluate_block = [this, &local_tables, &evaluate_expression, &evaluate_block, &resolve_assignable_expression](const flat_range a_block) -> return_state {
             local_tables.emplace_back();
             table& local_table = local_tables.back();
 
             bool prior_eval = true;
 
-            for (const node& n : a_block) {
-                switch (n.m_type) {
+            for (const flat_node n : a_block) {
+                switch (n.get_type()) {
                     case node::type::expression:
-                        evaluate_expression(n.get_expression());
+                        evaluate_expression(n);
                         break;
                     case node::type::block: {
-                        return_state state{ evaluate_block(n.get_block()) };
+                        return_state state{ evaluate_block(n.get_operands()) };
 
                         if (state.status != return_status::normal) {
                             return state;
@@ -687,12 +786,10 @@ namespace rebar {
                         break;
                     }
                     case node::type::if_declaration: {
-                        const auto& decl = n.get_if_declaration();
-
-                        prior_eval = evaluate_expression(decl.m_conditional).boolean_evaluate();
+                        prior_eval = evaluate_expression(n.get_conditional()).boolean_evaluate();
 
                         if (prior_eval) {
-                            return_state state{ evaluate_block(decl.m_body) };
+                            return_state state{ evaluate_block(n.get_body()) };
 
                             if (state.status != return_status::normal) {
                                 return state;
@@ -702,13 +799,11 @@ namespace rebar {
                         break;
                     }
                     case node::type::else_if_declaration: {
-                        const auto& decl = n.get_else_if_declaration();
-
                         if (!prior_eval) {
-                            prior_eval = evaluate_expression(decl.m_conditional).boolean_evaluate();
+                            prior_eval = evaluate_expression(n.get_conditional()).boolean_evaluate();
 
                             if (prior_eval) {
-                                return_state state{ evaluate_block(decl.m_body) };
+                                return_state state{ evaluate_block(n.get_body()) };
 
                                 if (state.status != return_status::normal) {
                                     return state;
@@ -719,10 +814,8 @@ namespace rebar {
                         break;
                     }
                     case node::type::else_declaration: {
-                        const auto& decl = n.get_else_declaration();
-
                         if (!prior_eval) {
-                            return_state state{ evaluate_block(decl) };
+                            return_state state{ evaluate_block(n.get_operands()) };
 
                             if (state.status != return_status::normal) {
                                 return state;
@@ -732,16 +825,14 @@ namespace rebar {
                         break;
                     }
                     case node::type::for_declaration: {
-                        const auto& decl = n.get_for_declaration();
-
                         local_tables.emplace_back();
                         auto& tbl = local_tables.back();
 
-                        evaluate_expression(decl.m_initialization);
+                        evaluate_expression(n.get_initialization());
 
-                        while (evaluate_expression(decl.m_conditional).boolean_evaluate()) {
-                            evaluate_block(decl.m_body);
-                            evaluate_expression(decl.m_iteration);
+                        while (evaluate_expression(n.get_conditional()).boolean_evaluate()) {
+                            evaluate_block(n.get_body());
+                            evaluate_expression(n.get_iteration());
                         }
 
                         local_tables.pop_back();
@@ -749,23 +840,19 @@ namespace rebar {
                         break;
                     }
                     case node::type::function_declaration: {
-                        const auto& decl = n.get_function_declaration();
-
-                        object& assignee = resolve_assignable_expression(decl.m_identifier);
+                        object& assignee = resolve_assignable_expression(n.get_identifier());
 
                         auto& env_interpreter = dynamic_cast<interpreter&>(m_environment.execution_provider());
 
-                        env_interpreter.m_function_sources.emplace_back(dynamic_cast<function_source*>(new interpreted_function_source(m_environment, decl.m_parameters, decl.m_body)));
+                        env_interpreter.m_function_sources.emplace_back(dynamic_cast<function_source*>(new interpreted_function_source(m_environment, m_unit, n.get_parameters(), n.get_body())));
 
                         assignee = function(m_environment, reinterpret_cast<void*>(env_interpreter.m_function_sources.back().get()));
 
                         break;
                     }
                     case node::type::while_declaration: {
-                        const auto& decl = n.get_while_declaration();
-
-                        while (evaluate_expression(decl.m_conditional).boolean_evaluate()) {
-                            return_state state{ evaluate_block(decl.m_body) };
+                        while (evaluate_expression(n.get_conditional()).boolean_evaluate()) {
+                            return_state state{ evaluate_block(n.get_body()) };
 
                             if (state.status == return_status::function_return) {
                                 return state;
@@ -783,7 +870,7 @@ namespace rebar {
                     case node::type::class_declaration:
                         break;
                     case node::type::return_statement:
-                        return { return_status::function_return, evaluate_expression(n.get_return_statement()) };
+                        return { return_status::function_return, evaluate_expression(n) };
                     case node::type::break_statement:
                         return { return_status::loop_break, null };
                     case node::type::continue_statement:
@@ -803,14 +890,14 @@ namespace rebar {
         auto& arg_table = local_tables.back();
 
         for (size_t i = 0; i < m_arguments.size(); ++i) {
-            const auto& arg = m_arguments[i];
-            const auto& identifier = *(arg.get_operands().end() - 1);
+            const flat_node arg = m_arguments[i];
+            const flat_node identifier = arg.get_operands().back();
 
             if (identifier.is_token()) {
                 const auto& tok = identifier.get_token();
 
                 if (tok.is_identifier()) {
-                    arg_table[m_environment.str(tok.get_identifier())] = m_environment.arg(i);
+                    arg_table[m_unit.string(tok)] = m_environment.arg(i);
                 }
             }
         }
@@ -0,0 +1,389 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_JIT_ASSEMBLER_HPP
+#define REBAR_JIT_ASSEMBLER_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Generated code addresses the default two-word object layout directly, so the JIT is off for NaN-boxed objects.
+#if defined(__x86_64__) && !defined(_WIN32) && !defined(REBAR_NAN_BOXING)
+#define REBAR_JIT_X86_64
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "definitions.hpp"
+
+namespace rebar {
+    // Page-aligned memory holding generated machine code. Code is copied in while the pages are writable,
+    // after which they are remapped read/execute only.
+    class executable_memory {
+        void* m_data = nullptr;
+        size_t m_size = 0;
+
+    public:
+        executable_memory() noexcept = default;
+
+        explicit executable_memory(const std::vector<uint8_t>& a_code) {
+#ifdef REBAR_JIT_X86_64
+            const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            const size_t size = (a_code.size() + page_size - 1) / page_size * page_size;
+
+            void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+            if (data == MAP_FAILED) {
+                return;
+            }
+
+            std::memcpy(data, a_code.data(), a_code.size());
+
+            if (mprotect(data, size, PROT_READ | PROT_EXEC) != 0) {
+                munmap(data, size);
+                return;
+            }
+
+            m_data = data;
+            m_size = size;
+#else
+            static_cast<void>(a_code);
+#endif
+        }
+
+        executable_memory(const executable_memory&) = delete;
+
+        executable_memory(executable_memory&& a_memory) noexcept : m_data(a_memory.m_data), m_size(a_memory.m_size) {
+            a_memory.m_data = nullptr;
+            a_memory.m_size = 0;
+        }
+
+        executable_memory& operator=(const executable_memory&) = delete;
+
+        executable_memory& operator=(executable_memory&& a_memory) noexcept {
+            std::swap(m_data, a_memory.m_data);
+            std::swap(m_size, a_memory.m_size);
+            return *this;
+        }
+
+        ~executable_memory() {
+#ifdef REBAR_JIT_X86_64
+            if (m_data != nullptr) {
+                munmap(m_data, m_size);
+            }
+#endif
+        }
+
+        [[nodiscard]] const void* data() const noexcept {
+            return m_data;
+        }
+
+        [[nodiscard]] bool valid() const noexcept {
+            return m_data != nullptr;
+        }
+    };
+
+    // Minimal x86-64 encoder covering the instructions emitted by the JIT. Memory operands are always
+    // [base + disp32] with a base register other than rsp/r12, so no SIB byte is ever required.
+    class x86_64_assembler {
+    public:
+        enum class reg : uint8_t {
+            rax, rcx, rdx, rbx, rsp, rbp, rsi, rdi,
+            r8, r9, r10, r11, r12, r13, r14, r15
+        };
+
+        enum class xmm : uint8_t {
+            xmm0, xmm1
+        };
+
+        enum class condition : uint8_t {
+            overflow, no_overflow, below, above_equal, equal, not_equal, below_equal, above,
+            sign, no_sign, parity, no_parity, less, greater_equal, less_equal, greater
+        };
+
+        struct memory {
+            reg m_base;
+            int32_t m_displacement;
+        };
+
+        using label = size_t;
+
+    private:
+        std::vector<uint8_t> m_code;
+        std::vector<size_t> m_labels;
+        std::vector<std::pair<size_t, label>> m_fixups;
+
+        static constexpr size_t unbound = static_cast<size_t>(-1);
+
+        [[nodiscard]] static constexpr uint8_t code(const reg a_reg) noexcept {
+            return static_cast<uint8_t>(a_reg);
+        }
+
+        [[nodiscard]] static constexpr uint8_t code(const xmm a_reg) noexcept {
+            return static_cast<uint8_t>(a_reg);
+        }
+
+        void byte(const uint8_t a_byte) {
+            m_code.push_back(a_byte);
+        }
+
+        void dword(const uint32_t a_dword) {
+            for (size_t i = 0; i < 4; ++i) {
+                byte(static_cast<uint8_t>(a_dword >> (i * 8)));
+            }
+        }
+
+        void qword(const uint64_t a_qword) {
+            for (size_t i = 0; i < 8; ++i) {
+                byte(static_cast<uint8_t>(a_qword >> (i * 8)));
+            }
+        }
+
+        void rex(const bool a_wide, const uint8_t a_reg, const uint8_t a_base) {
+            const auto prefix = static_cast<uint8_t>(0x40 | (a_wide ? 0x08 : 0) | ((a_reg >> 3) << 2) | (a_base >> 3));
+
+            if (prefix != 0x40) {
+                byte(prefix);
+            }
+        }
+
+        void modrm(const uint8_t a_reg, const memory a_memory) {
+            byte(static_cast<uint8_t>(0x80 | ((a_reg & 7) << 3) | (code(a_memory.m_base) & 7)));
+            dword(static_cast<uint32_t>(a_memory.m_displacement));
+        }
+
+        void modrm(const uint8_t a_reg, const uint8_t a_rm) {
+            byte(static_cast<uint8_t>(0xC0 | ((a_reg & 7) << 3) | (a_rm & 7)));
+        }
+
+        // REX.W <opcode> /r with a memory operand.
+        void wide_memory(const uint8_t a_opcode, const uint8_t a_reg, const memory a_memory) {
+            rex(true, a_reg, code(a_memory.m_base));
+            byte(a_opcode);
+            modrm(a_reg, a_memory);
+        }
+
+        // <prefix> [REX] 0F <opcode> /r with a memory operand, used by the SSE2 scalar double instructions.
+        void sse_memory(const uint8_t a_prefix, const bool a_wide, const uint8_t a_opcode, const xmm a_reg, const memory a_memory) {
+            byte(a_prefix);
+            rex(a_wide, code(a_reg), code(a_memory.m_base));
+            byte(0x0F);
+            byte(a_opcode);
+            modrm(code(a_reg), a_memory);
+        }
+
+        void sse_register(const uint8_t a_prefix, const uint8_t a_opcode, const xmm a_dst, const xmm a_src) {
+            byte(a_prefix);
+            byte(0x0F);
+            byte(a_opcode);
+            modrm(code(a_dst), code(a_src));
+        }
+
+    public:
+        [[nodiscard]] const std::vector<uint8_t>& machine_code() const noexcept {
+            return m_code;
+        }
+
+        [[nodiscard]] label create_label() {
+            m_labels.push_back(unbound);
+            return m_labels.size() - 1;
+        }
+
+        void bind(const label a_label) noexcept {
+            m_labels[a_label] = m_code.size();
+        }
+
+        // Resolves every jump to its label. Must be called once all labels are bound.
+        void finalize() noexcept {
+            for (const auto& [position, target] : m_fixups) {
+                const auto relative = static_cast<int32_t>(static_cast<int64_t>(m_labels[target]) - static_cast<int64_t>(position + 4));
+                std::memcpy(m_code.data() + position, &relative, sizeof(relative));
+            }
+
+            m_fixups.clear();
+        }
+
+        // mov r64, [mem]
+        void mov(const reg a_dst, const memory a_src) {
+            wide_memory(0x8B, code(a_dst), a_src);
+        }
+
+        // mov [mem], r64
+        void mov(const memory a_dst, const reg a_src) {
+            wide_memory(0x89, code(a_src), a_dst);
+        }
+
+        // mov qword [mem], imm32 (sign extended)
+        void mov(const memory a_dst, const int32_t a_immediate) {
+            wide_memory(0xC7, 0, a_dst);
+            dword(static_cast<uint32_t>(a_immediate));
+        }
+
+        // mov r64, r64
+        void mov(const reg a_dst, const reg a_src) {
+            rex(true, code(a_src), code(a_dst));
+            byte(0x89);
+            modrm(code(a_src), code(a_dst));
+        }
+
+        // movabs r64, imm64
+        void mov(const reg a_dst, const uint64_t a_immediate) {
+            rex(true, 0, code(a_dst));
+            byte(static_cast<uint8_t>(0xB8 + (code(a_dst) & 7)));
+            qword(a_immediate);
+        }
+
+        // lea r64, [mem]
+        void lea(const reg a_dst, const memory a_src) {
+            wide_memory(0x8D, code(a_dst), a_src);
+        }
+
+        void add(const reg a_dst, const memory a_src) {
+            wide_memory(0x03, code(a_dst), a_src);
+        }
+
+        void sub(const reg a_dst, const memory a_src) {
+            wide_memory(0x2B, code(a_dst), a_src);
+        }
+
+        void cmp(const reg a_lhs, const memory a_rhs) {
+            wide_memory(0x3B, code(a_lhs), a_rhs);
+        }
+
+        // cmp qword [mem], imm32 (sign extended)
+        void cmp(const memory a_lhs, const int32_t a_immediate) {
+            wide_memory(0x81, 7, a_lhs);
+            dword(static_cast<uint32_t>(a_immediate));
+        }
+
+        // add r64, imm32 (sign extended)
+        void add(const reg a_dst, const int32_t a_immediate) {
+            rex(true, 0, code(a_dst));
+            byte(0x81);
+            modrm(0, code(a_dst));
+            dword(static_cast<uint32_t>(a_immediate));
+        }
+
+        void imul(const reg a_dst, const memory a_src) {
+            rex(true, code(a_dst), code(a_src.m_base));
+            byte(0x0F);
+            byte(0xAF);
+            modrm(code(a_dst), a_src);
+        }
+
+        // Sign extends rax into rdx:rax.
+        void cqo() {
+            byte(0x48);
+            byte(0x99);
+        }
+
+        // Signed divide of rdx:rax by a qword in memory; quotient in rax, remainder in rdx.
+        void idiv(const memory a_divisor) {
+            wide_memory(0xF7, 7, a_divisor);
+        }
+
+        void test(const reg a_lhs, const reg a_rhs) {
+            rex(true, code(a_rhs), code(a_lhs));
+            byte(0x85);
+            modrm(code(a_rhs), code(a_lhs));
+        }
+
+        // test eax, eax
+        void test32(const reg a_reg) {
+            rex(false, code(a_reg), code(a_reg));
+            byte(0x85);
+            modrm(code(a_reg), code(a_reg));
+        }
+
+        // setcc al; movzx eax, al
+        void set_rax(const condition a_condition) {
+            byte(0x0F);
+            byte(static_cast<uint8_t>(0x90 + static_cast<uint8_t>(a_condition)));
+            byte(0xC0);
+            byte(0x0F);
+            byte(0xB6);
+            byte(0xC0);
+        }
+
+        void jump(const label a_label) {
+            byte(0xE9);
+            m_fixups.emplace_back(m_code.size(), a_label);
+            dword(0);
+        }
+
+        void jump(const condition a_condition, const label a_label) {
+            byte(0x0F);
+            byte(static_cast<uint8_t>(0x80 + static_cast<uint8_t>(a_condition)));
+            m_fixups.emplace_back(m_code.size(), a_label);
+            dword(0);
+        }
+
+        void call(const reg a_target) {
+            rex(false, 0, code(a_target));
+            byte(0xFF);
+            modrm(2, code(a_target));
+        }
+
+        void push(const reg a_reg) {
+            rex(false, 0, code(a_reg));
+            byte(static_cast<uint8_t>(0x50 + (code(a_reg) & 7)));
+        }
+
+        void pop(const reg a_reg) {
+            rex(false, 0, code(a_reg));
+            byte(static_cast<uint8_t>(0x58 + (code(a_reg) & 7)));
+        }
+
+        void ret() {
+            byte(0xC3);
+        }
+
+        // movsd xmm, qword [mem]
+        void movsd(const xmm a_dst, const memory a_src) {
+            sse_memory(0xF2, false, 0x10, a_dst, a_src);
+        }
+
+        // movsd qword [mem], xmm
+        void movsd(const memory a_dst, const xmm a_src) {
+            sse_memory(0xF2, false, 0x11, a_src, a_dst);
+        }
+
+        // cvtsi2sd xmm, qword [mem]
+        void cvtsi2sd(const xmm a_dst, const memory a_src) {
+            sse_memory(0xF2, true, 0x2A, a_dst, a_src);
+        }
+
+        // movq xmm, r64
+        void movq(const xmm a_dst, const reg a_src) {
+            byte(0x66);
+            rex(true, code(a_dst), code(a_src));
+            byte(0x0F);
+            byte(0x6E);
+            modrm(code(a_dst), code(a_src));
+        }
+
+        void addsd(const xmm a_dst, const xmm a_src) {
+            sse_register(0xF2, 0x58, a_dst, a_src);
+        }
+
+        void mulsd(const xmm a_dst, const xmm a_src) {
+            sse_register(0xF2, 0x59, a_dst, a_src);
+        }
+
+        void subsd(const xmm a_dst, const xmm a_src) {
+            sse_register(0xF2, 0x5C, a_dst, a_src);
+        }
+
+        void divsd(const xmm a_dst, const xmm a_src) {
+            sse_register(0xF2, 0x5E, a_dst, a_src);
+        }
+
+        void ucomisd(const xmm a_lhs, const xmm a_rhs) {
+            sse_register(0x66, 0x2E, a_lhs, a_rhs);
+        }
+    };
+}
+
+#endif //REBAR_JIT_ASSEMBLER_HPP
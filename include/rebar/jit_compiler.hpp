@@ -0,0 +1,123 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_JIT_COMPILER_HPP
+#define REBAR_JIT_COMPILER_HPP
+
+#include <vector>
+
+#include "bytecode.hpp"
+#include "jit_assembler.hpp"
+#include "object.hpp"
+
+namespace rebar {
+    struct jit_provider;
+
+    // Static knowledge about the contents of a frame slot at some point of a prototype.
+    enum class jit_type : uint8_t {
+        unset,
+        null_type,
+        boolean_type,
+        integer_type,
+        number_type,
+        any
+    };
+
+    [[nodiscard]] constexpr bool is_simple(const jit_type a_type) noexcept {
+        return a_type != jit_type::any && a_type != jit_type::unset;
+    }
+
+    [[nodiscard]] constexpr bool is_numeric(const jit_type a_type) noexcept {
+        return a_type == jit_type::integer_type || a_type == jit_type::number_type;
+    }
+
+    [[nodiscard]] constexpr jit_type join(const jit_type a_lhs, const jit_type a_rhs) noexcept {
+        if (a_lhs == jit_type::unset) {
+            return a_rhs;
+        }
+
+        if (a_rhs == jit_type::unset || a_lhs == a_rhs) {
+            return a_lhs;
+        }
+
+        return jit_type::any;
+    }
+
+    [[nodiscard]] inline jit_type jit_type_of(const object& a_object) noexcept {
+        switch (a_object.object_type()) {
+            case object::type::null:
+                return jit_type::null_type;
+            case object::type::boolean:
+                return jit_type::boolean_type;
+            case object::type::integer:
+                return jit_type::integer_type;
+            case object::type::number:
+                return jit_type::number_type;
+            default:
+                return jit_type::any;
+        }
+    }
+
+    // Translates a prototype into x86-64 machine code that operates on the virtual machine's own frame layout.
+    //
+    // A forward dataflow pass first infers the type of every local and operand stack slot at each reachable
+    // instruction, starting from the types observed at the entry point. Arithmetic, comparisons, local
+    // variable traffic and control flow on statically known integers, numbers and booleans are emitted
+    // inline. Values of unknown type get an inline integer guard where that pays off; everything else, and
+    // every guard failure, executes the instruction through a single step of the virtual machine on the
+    // very same frame. Slots therefore always hold valid, tagged objects.
+    class jit_compiler {
+    public:
+        // Signature of generated code. Returns the slot holding the return value, or nullptr if a
+        // VM step raised an exception that the provider holds on to.
+        using entry_point = object* (*)(object* a_locals, jit_provider* a_provider);
+
+        jit_compiler(jit_provider& a_provider, const prototype& a_prototype) noexcept : m_provider(a_provider), m_prototype(a_prototype) {}
+
+        // Compiles code entered at instruction a_entry with the given slot types, one per local and
+        // live operand stack entry. The returned memory is invalid if compilation is not possible.
+        [[nodiscard]] executable_memory compile(size_t a_entry, const std::vector<jit_type>& a_entry_types);
+
+    private:
+        using assembler = x86_64_assembler;
+        using reg = assembler::reg;
+        using xmm = assembler::xmm;
+        using condition = assembler::condition;
+        using memory = assembler::memory;
+
+        jit_provider& m_provider;
+        const prototype& m_prototype;
+
+        size_t m_width = 0;
+        std::vector<jit_type> m_states;
+        std::vector<int> m_depths;
+
+        assembler m_assembler;
+        std::vector<assembler::label> m_labels;
+        assembler::label m_epilogue = 0;
+        assembler::label m_exception = 0;
+
+        [[nodiscard]] jit_type* state(size_t a_index) noexcept;
+        [[nodiscard]] bool analyze(size_t a_entry, const std::vector<jit_type>& a_entry_types);
+        [[nodiscard]] bool merge(size_t a_target, const jit_type* a_state, int a_depth);
+        void transfer(const instruction& a_instruction, jit_type* a_state, int& a_depth) const;
+
+        [[nodiscard]] static jit_type arithmetic_type(opcode a_opcode, jit_type a_lhs, jit_type a_rhs) noexcept;
+
+        [[nodiscard]] static memory tag(size_t a_slot) noexcept;
+        [[nodiscard]] static memory data(size_t a_slot) noexcept;
+
+        void emit_instruction(size_t a_index);
+        void emit_step(size_t a_index, int a_depth);
+        void emit_helper(uint64_t a_helper, size_t a_slot);
+        void emit_set_tag(size_t a_slot, object::type a_type);
+        void emit_clear(size_t a_slot);
+        void emit_copy(size_t a_dst, size_t a_src);
+        void emit_load_number(xmm a_dst, size_t a_slot, jit_type a_type);
+        void emit_arithmetic(opcode a_opcode, size_t a_lhs, jit_type a_lhs_type, size_t a_rhs, jit_type a_rhs_type, size_t a_dst);
+        void emit_guarded_binary(size_t a_index, opcode a_opcode, jit_type a_lhs_type, jit_type a_rhs_type, int a_depth);
+    };
+}
+
+#endif //REBAR_JIT_COMPILER_HPP
@@ -0,0 +1,830 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_JIT_COMPILER_IMPL_HPP
+#define REBAR_JIT_COMPILER_IMPL_HPP
+
+#include "jit_compiler.hpp"
+
+#include "jit_provider.hpp"
+
+namespace rebar {
+#ifdef REBAR_JIT_X86_64
+    static_assert(sizeof(object) == 2 * sizeof(size_t), "Generated code expects objects to be a type tag followed by a payload.");
+#endif
+
+    jit_type* jit_compiler::state(const size_t a_index) noexcept {
+        return m_states.data() + a_index * m_width;
+    }
+
+    executable_memory jit_compiler::compile(const size_t a_entry, const std::vector<jit_type>& a_entry_types) {
+#ifdef REBAR_JIT_X86_64
+        if (m_prototype.m_code.size() > jit_provider::max_compiled_instructions || !analyze(a_entry, a_entry_types)) {
+            return {};
+        }
+
+        m_labels.clear();
+
+        for (size_t i = 0; i < m_prototype.m_code.size(); ++i) {
+            m_labels.push_back(m_assembler.create_label());
+        }
+
+        m_epilogue = m_assembler.create_label();
+        m_exception = m_assembler.create_label();
+
+        // rbx holds the frame and r12 the provider. Three pushes leave the stack 16-byte aligned for helper calls.
+        m_assembler.push(reg::rbx);
+        m_assembler.push(reg::r12);
+        m_assembler.push(reg::rbp);
+        m_assembler.mov(reg::rbx, reg::rdi);
+        m_assembler.mov(reg::r12, reg::rsi);
+        m_assembler.jump(m_labels[a_entry]);
+
+        for (size_t i = 0; i < m_prototype.m_code.size(); ++i) {
+            if (m_depths[i] < 0) {
+                continue;
+            }
+
+            m_assembler.bind(m_labels[i]);
+            emit_instruction(i);
+        }
+
+        m_assembler.bind(m_exception);
+        m_assembler.mov(reg::rax, static_cast<uint64_t>(0));
+
+        m_assembler.bind(m_epilogue);
+        m_assembler.pop(reg::rbp);
+        m_assembler.pop(reg::r12);
+        m_assembler.pop(reg::rbx);
+        m_assembler.ret();
+
+        m_assembler.finalize();
+
+        return executable_memory(m_assembler.machine_code());
+#else
+        static_cast<void>(a_entry);
+        static_cast<void>(a_entry_types);
+
+        return {};
+#endif
+    }
+
+    bool jit_compiler::analyze(const size_t a_entry, const std::vector<jit_type>& a_entry_types) {
+        const auto& code = m_prototype.m_code;
+        const size_t local_count = m_prototype.m_local_count;
+
+        m_width = local_count + m_prototype.m_max_stack;
+
+        if (a_entry_types.size() < local_count || a_entry_types.size() > m_width || a_entry >= code.size()) {
+            return false;
+        }
+
+        m_states.assign(code.size() * m_width, jit_type::unset);
+        m_depths.assign(code.size(), -1);
+
+        std::vector<jit_type> current(m_width, jit_type::null_type);
+        std::copy(a_entry_types.begin(), a_entry_types.end(), current.begin());
+
+        std::vector<size_t> worklist;
+        const auto enqueue = [this, &worklist](const size_t a_target, const jit_type* a_state, const int a_depth) -> bool {
+            if (a_target >= m_depths.size() || (m_depths[a_target] >= 0 && m_depths[a_target] != a_depth)) {
+                return false;
+            }
+
+            if (merge(a_target, a_state, a_depth)) {
+                worklist.push_back(a_target);
+            }
+
+            return true;
+        };
+
+        if (!enqueue(a_entry, current.data(), static_cast<int>(a_entry_types.size() - local_count))) {
+            return false;
+        }
+
+        while (!worklist.empty()) {
+            const size_t index = worklist.back();
+            worklist.pop_back();
+
+            const instruction& instr = code[index];
+            int depth = m_depths[index];
+
+            std::copy(state(index), state(index) + m_width, current.begin());
+
+            switch (instr.m_opcode) {
+                case opcode::jump:
+                    if (!enqueue(instr.m_operand, current.data(), depth)) {
+                        return false;
+                    }
+
+                    continue;
+                case opcode::or_jump:
+                    if (!enqueue(instr.m_operand, current.data(), depth) || !enqueue(index + 1, current.data(), depth)) {
+                        return false;
+                    }
+
+                    continue;
+                case opcode::and_jump: {
+                    if (!enqueue(index + 1, current.data(), depth)) {
+                        return false;
+                    }
+
+                    // The short-circuited value is replaced with false.
+                    current[local_count + static_cast<size_t>(depth) - 1] = jit_type::boolean_type;
+
+                    if (!enqueue(instr.m_operand, current.data(), depth)) {
+                        return false;
+                    }
+
+                    continue;
+                }
+                case opcode::return_value:
+                    continue;
+                default:
+                    break;
+            }
+
+            transfer(instr, current.data(), depth);
+
+            if (depth < 0 || static_cast<size_t>(depth) > m_prototype.m_max_stack) {
+                return false;
+            }
+
+            if (instr.m_opcode == opcode::jump_if_false && !enqueue(instr.m_operand, current.data(), depth)) {
+                return false;
+            }
+
+            if (!enqueue(index + 1, current.data(), depth)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool jit_compiler::merge(const size_t a_target, const jit_type* a_state, const int a_depth) {
+        jit_type* target = state(a_target);
+        bool changed = m_depths[a_target] < 0;
+
+        m_depths[a_target] = a_depth;
+
+        for (size_t i = 0; i < m_width; ++i) {
+            const jit_type joined = join(target[i], a_state[i]);
+
+            if (joined != target[i]) {
+                target[i] = joined;
+                changed = true;
+            }
+        }
+
+        return changed;
+    }
+
+    void jit_compiler::transfer(const instruction& a_instruction, jit_type* a_state, int& a_depth) const {
+        const size_t local_count = m_prototype.m_local_count;
+
+        const auto slot = [local_count, &a_depth](const int a_offset) noexcept -> size_t {
+            return local_count + static_cast<size_t>(a_depth + a_offset);
+        };
+
+        const auto push = [&a_state, &a_depth, &slot](const jit_type a_type) noexcept {
+            a_state[slot(0)] = a_type;
+            ++a_depth;
+        };
+
+        const auto drop = [&a_state, &a_depth, &slot](const size_t a_count) noexcept {
+            for (size_t i = 0; i < a_count; ++i) {
+                --a_depth;
+                a_state[slot(0)] = jit_type::null_type;
+            }
+        };
+
+        switch (a_instruction.m_opcode) {
+            case opcode::push_null:
+                push(jit_type::null_type);
+                break;
+            case opcode::push_true:
+            case opcode::push_false:
+                push(jit_type::boolean_type);
+                break;
+            case opcode::push_constant:
+                push(jit_type_of(m_prototype.m_constants[a_instruction.m_operand]));
+                break;
+            case opcode::pop:
+            case opcode::jump_if_false:
+            case opcode::return_value:
+                drop(1);
+                break;
+            case opcode::duplicate:
+                push(a_state[slot(-1)]);
+                break;
+            case opcode::load_local:
+                push(a_state[a_instruction.m_operand]);
+                break;
+            case opcode::store_local:
+                a_state[a_instruction.m_operand] = a_state[slot(-1)];
+                break;
+            case opcode::load_global:
+                push(jit_type::any);
+                break;
+            case opcode::store_global:
+                break;
+            case opcode::get_member:
+            case opcode::bitwise_not:
+            case opcode::length:
+                a_state[slot(-1)] = jit_type::any;
+                break;
+            case opcode::set_member:
+            case opcode::get_index:
+                drop(1);
+                a_state[slot(-1)] = jit_type::any;
+                break;
+            case opcode::set_index:
+            case opcode::get_range:
+                drop(2);
+                a_state[slot(-1)] = jit_type::any;
+                break;
+            case opcode::update_local: {
+                const auto operation = static_cast<separator>(a_instruction.m_count);
+                jit_type& local = a_state[a_instruction.m_operand];
+
+                if (update_takes_operand(operation)) {
+                    jit_type result = is_simple(local) && is_simple(a_state[slot(-1)]) ? arithmetic_type(compound_opcode(operation), local, a_state[slot(-1)]) : jit_type::any;
+
+                    if (!is_numeric(result)) {
+                        result = jit_type::any;
+                    }
+
+                    local = result;
+                    a_state[slot(-1)] = result;
+                } else {
+                    local = is_numeric(local) ? local : jit_type::any;
+                    push(local);
+                }
+
+                break;
+            }
+            case opcode::update_global:
+                if (update_takes_operand(static_cast<separator>(a_instruction.m_count))) {
+                    a_state[slot(-1)] = jit_type::any;
+                } else {
+                    push(jit_type::any);
+                }
+
+                break;
+            case opcode::update_member:
+                if (update_takes_operand(static_cast<separator>(a_instruction.m_count))) {
+                    drop(1);
+                }
+
+                a_state[slot(-1)] = jit_type::any;
+                break;
+            case opcode::update_index:
+                if (update_takes_operand(static_cast<separator>(a_instruction.m_count))) {
+                    drop(1);
+                }
+
+                drop(1);
+                a_state[slot(-1)] = jit_type::any;
+                break;
+            case opcode::add:
+            case opcode::subtract:
+            case opcode::multiply:
+            case opcode::divide:
+            case opcode::modulus:
+            case opcode::exponentiate:
+            case opcode::equals:
+            case opcode::not_equals:
+            case opcode::greater:
+            case opcode::lesser:
+            case opcode::greater_equal:
+            case opcode::lesser_equal:
+            case opcode::bitwise_or:
+            case opcode::bitwise_xor:
+            case opcode::bitwise_and:
+            case opcode::shift_left:
+            case opcode::shift_right: {
+                const jit_type lhs = a_state[slot(-2)];
+                const jit_type rhs = a_state[slot(-1)];
+
+                drop(1);
+                a_state[slot(-1)] = is_simple(lhs) && is_simple(rhs) ? arithmetic_type(a_instruction.m_opcode, lhs, rhs) : jit_type::any;
+                break;
+            }
+            case opcode::logical_not:
+                a_state[slot(-1)] = is_simple(a_state[slot(-1)]) ? jit_type::integer_type : jit_type::any;
+                break;
+            case opcode::logical_or:
+            case opcode::logical_and: {
+                const jit_type lhs = a_state[slot(-2)];
+                const jit_type rhs = a_state[slot(-1)];
+
+                drop(1);
+                a_state[slot(-1)] = is_simple(lhs) ? rhs : jit_type::any;
+                break;
+            }
+            case opcode::load_method:
+                a_state[slot(-1)] = jit_type::any;
+                push(jit_type::any);
+                break;
+            case opcode::call:
+            case opcode::new_object:
+                drop(a_instruction.m_count);
+                a_state[slot(-1)] = jit_type::any;
+                break;
+            case opcode::new_table:
+                drop(2 * static_cast<size_t>(a_instruction.m_count));
+                push(jit_type::any);
+                break;
+            case opcode::new_array:
+                drop(a_instruction.m_count);
+                push(jit_type::any);
+                break;
+            case opcode::or_jump:
+            case opcode::and_jump:
+            case opcode::jump:
+                break;
+        }
+    }
+
+    jit_type jit_compiler::arithmetic_type(const opcode a_opcode, const jit_type a_lhs, const jit_type a_rhs) noexcept {
+        const bool integers = a_lhs == jit_type::integer_type && a_rhs == jit_type::integer_type;
+        const bool numbers = is_numeric(a_lhs) && is_numeric(a_rhs);
+
+        switch (a_opcode) {
+            case opcode::add:
+            case opcode::subtract:
+            case opcode::multiply:
+                return integers ? jit_type::integer_type : (numbers ? jit_type::number_type : jit_type::any);
+            case opcode::divide:
+                return numbers ? jit_type::number_type : jit_type::any;
+            case opcode::modulus:
+                return integers ? jit_type::integer_type : jit_type::any;
+            // Comparisons yield the integers 1 and 0, like the generic operations of the virtual machine.
+            case opcode::greater:
+            case opcode::lesser:
+                return numbers ? jit_type::integer_type : jit_type::any;
+            case opcode::greater_equal:
+            case opcode::lesser_equal:
+                // Only the integer forms have a dedicated path in the virtual machine.
+                return integers ? jit_type::integer_type : jit_type::any;
+            case opcode::equals:
+            case opcode::not_equals:
+                return is_simple(a_lhs) && is_simple(a_rhs) ? jit_type::integer_type : jit_type::any;
+            default:
+                return jit_type::any;
+        }
+    }
+
+    jit_compiler::memory jit_compiler::tag(const size_t a_slot) noexcept {
+        return { reg::rbx, static_cast<int32_t>(a_slot * sizeof(object)) };
+    }
+
+    jit_compiler::memory jit_compiler::data(const size_t a_slot) noexcept {
+        return { reg::rbx, static_cast<int32_t>(a_slot * sizeof(object) + sizeof(size_t)) };
+    }
+
+    void jit_compiler::emit_step(const size_t a_index, const int a_depth) {
+        m_assembler.mov(reg::rdi, reg::r12);
+        m_assembler.mov(reg::rsi, reg::rbx);
+        m_assembler.mov(reg::rdx, reinterpret_cast<uint64_t>(m_prototype.m_code.data() + a_index));
+        m_assembler.lea(reg::rcx, tag(m_prototype.m_local_count + static_cast<size_t>(a_depth)));
+        m_assembler.mov(reg::r8, reinterpret_cast<uint64_t>(&m_prototype));
+        m_assembler.mov(reg::rax, reinterpret_cast<uint64_t>(&jit_provider::step));
+        m_assembler.call(reg::rax);
+        m_assembler.test32(reg::rax);
+        m_assembler.jump(condition::not_equal, m_exception);
+    }
+
+    void jit_compiler::emit_helper(const uint64_t a_helper, const size_t a_slot) {
+        m_assembler.mov(reg::rdi, reg::r12);
+        m_assembler.lea(reg::rsi, tag(a_slot));
+        m_assembler.mov(reg::rax, a_helper);
+        m_assembler.call(reg::rax);
+        m_assembler.test32(reg::rax);
+    }
+
+    void jit_compiler::emit_set_tag(const size_t a_slot, const object::type a_type) {
+        m_assembler.mov(tag(a_slot), static_cast<int32_t>(a_type));
+    }
+
+    void jit_compiler::emit_clear(const size_t a_slot) {
+        m_assembler.mov(tag(a_slot), 0);
+        m_assembler.mov(data(a_slot), 0);
+    }
+
+    void jit_compiler::emit_copy(const size_t a_dst, const size_t a_src) {
+        m_assembler.mov(reg::rax, tag(a_src));
+        m_assembler.mov(tag(a_dst), reg::rax);
+        m_assembler.mov(reg::rax, data(a_src));
+        m_assembler.mov(data(a_dst), reg::rax);
+    }
+
+    void jit_compiler::emit_load_number(const xmm a_dst, const size_t a_slot, const jit_type a_type) {
+        if (a_type == jit_type::integer_type) {
+            m_assembler.cvtsi2sd(a_dst, data(a_slot));
+        } else {
+            m_assembler.movsd(a_dst, data(a_slot));
+        }
+    }
+
+    void jit_compiler::emit_arithmetic(const opcode a_opcode, const size_t a_lhs, const jit_type a_lhs_type, const size_t a_rhs, const jit_type a_rhs_type, const size_t a_dst) {
+        const auto emit_compare = [this, a_lhs, a_rhs, a_dst](const condition a_condition) {
+            m_assembler.mov(reg::rax, data(a_lhs));
+            m_assembler.cmp(reg::rax, data(a_rhs));
+            m_assembler.set_rax(a_condition);
+            m_assembler.mov(data(a_dst), reg::rax);
+            emit_set_tag(a_dst, object::type::integer);
+        };
+
+        const auto emit_constant = [this, a_dst](const bool a_value) {
+            m_assembler.mov(data(a_dst), a_value ? 1 : 0);
+            emit_set_tag(a_dst, object::type::integer);
+        };
+
+        if (a_lhs_type == jit_type::integer_type && a_rhs_type == jit_type::integer_type) {
+            switch (a_opcode) {
+                case opcode::add:
+                case opcode::subtract:
+                case opcode::multiply:
+                    m_assembler.mov(reg::rax, data(a_lhs));
+
+                    if (a_opcode == opcode::add) {
+                        m_assembler.add(reg::rax, data(a_rhs));
+                    } else if (a_opcode == opcode::subtract) {
+                        m_assembler.sub(reg::rax, data(a_rhs));
+                    } else {
+                        m_assembler.imul(reg::rax, data(a_rhs));
+                    }
+
+                    m_assembler.mov(data(a_dst), reg::rax);
+                    emit_set_tag(a_dst, object::type::integer);
+                    return;
+                case opcode::modulus:
+                    m_assembler.mov(reg::rax, data(a_lhs));
+                    m_assembler.cqo();
+                    m_assembler.idiv(data(a_rhs));
+                    m_assembler.mov(data(a_dst), reg::rdx);
+                    emit_set_tag(a_dst, object::type::integer);
+                    return;
+                case opcode::divide:
+                    m_assembler.cvtsi2sd(xmm::xmm0, data(a_lhs));
+                    m_assembler.cvtsi2sd(xmm::xmm1, data(a_rhs));
+                    m_assembler.divsd(xmm::xmm0, xmm::xmm1);
+                    m_assembler.movsd(data(a_dst), xmm::xmm0);
+                    emit_set_tag(a_dst, object::type::number);
+                    return;
+                case opcode::greater:
+                    emit_compare(condition::greater);
+                    return;
+                case opcode::lesser:
+                    emit_compare(condition::less);
+                    return;
+                case opcode::greater_equal:
+                    emit_compare(condition::greater_equal);
+                    return;
+                case opcode::lesser_equal:
+                    emit_compare(condition::less_equal);
+                    return;
+                case opcode::equals:
+                    emit_compare(condition::equal);
+                    return;
+                case opcode::not_equals:
+                    emit_compare(condition::not_equal);
+                    return;
+                default:
+                    return;
+            }
+        }
+
+        if (a_opcode == opcode::equals || a_opcode == opcode::not_equals) {
+            // Simple objects are equal when both their types and their payloads are.
+            if (a_lhs_type == a_rhs_type) {
+                emit_compare(a_opcode == opcode::equals ? condition::equal : condition::not_equal);
+            } else {
+                emit_constant(a_opcode == opcode::not_equals);
+            }
+
+            return;
+        }
+
+        emit_load_number(xmm::xmm0, a_lhs, a_lhs_type);
+        emit_load_number(xmm::xmm1, a_rhs, a_rhs_type);
+
+        switch (a_opcode) {
+            case opcode::add:
+                m_assembler.addsd(xmm::xmm0, xmm::xmm1);
+                break;
+            case opcode::subtract:
+                m_assembler.subsd(xmm::xmm0, xmm::xmm1);
+                break;
+            case opcode::multiply:
+                m_assembler.mulsd(xmm::xmm0, xmm::xmm1);
+                break;
+            case opcode::divide:
+                m_assembler.divsd(xmm::xmm0, xmm::xmm1);
+                break;
+            case opcode::greater:
+            case opcode::lesser:
+                // "above" is false for unordered operands, matching the C++ comparison on NaN.
+                if (a_opcode == opcode::greater) {
+                    m_assembler.ucomisd(xmm::xmm0, xmm::xmm1);
+                } else {
+                    m_assembler.ucomisd(xmm::xmm1, xmm::xmm0);
+                }
+
+                m_assembler.set_rax(condition::above);
+                m_assembler.mov(data(a_dst), reg::rax);
+                emit_set_tag(a_dst, object::type::integer);
+                return;
+            default:
+                return;
+        }
+
+        m_assembler.movsd(data(a_dst), xmm::xmm0);
+        emit_set_tag(a_dst, object::type::number);
+    }
+
+    void jit_compiler::emit_guarded_binary(const size_t a_index, const opcode a_opcode, const jit_type a_lhs_type, const jit_type a_rhs_type, const int a_depth) {
+        switch (a_opcode) {
+            case opcode::add:
+            case opcode::subtract:
+            case opcode::multiply:
+            case opcode::modulus:
+            case opcode::equals:
+            case opcode::not_equals:
+            case opcode::greater:
+            case opcode::lesser:
+            case opcode::greater_equal:
+            case opcode::lesser_equal:
+                break;
+            default:
+                emit_step(a_index, a_depth);
+                return;
+        }
+
+        if ((a_lhs_type != jit_type::any && a_lhs_type != jit_type::integer_type) || (a_rhs_type != jit_type::any && a_rhs_type != jit_type::integer_type)) {
+            emit_step(a_index, a_depth);
+            return;
+        }
+
+        const size_t lhs = m_prototype.m_local_count + static_cast<size_t>(a_depth) - 2;
+        const size_t rhs = lhs + 1;
+
+        const auto slow = m_assembler.create_label();
+        const auto done = m_assembler.create_label();
+
+        // Speculate on integers; anything else takes the generic path through the virtual machine.
+        if (a_lhs_type == jit_type::any) {
+            m_assembler.cmp(tag(lhs), static_cast<int32_t>(object::type::integer));
+            m_assembler.jump(condition::not_equal, slow);
+        }
+
+        if (a_rhs_type == jit_type::any) {
+            m_assembler.cmp(tag(rhs), static_cast<int32_t>(object::type::integer));
+            m_assembler.jump(condition::not_equal, slow);
+        }
+
+        emit_arithmetic(a_opcode, lhs, jit_type::integer_type, rhs, jit_type::integer_type, lhs);
+        emit_clear(rhs);
+        m_assembler.jump(done);
+
+        m_assembler.bind(slow);
+        emit_step(a_index, a_depth);
+
+        m_assembler.bind(done);
+    }
+
+    void jit_compiler::emit_instruction(const size_t a_index) {
+        const instruction& instr = m_prototype.m_code[a_index];
+        const jit_type* types = state(a_index);
+        const int depth = m_depths[a_index];
+        const size_t next = m_prototype.m_local_count + static_cast<size_t>(depth);
+        const size_t top = next - 1;
+
+        switch (instr.m_opcode) {
+            case opcode::push_null:
+                emit_clear(next);
+                return;
+            case opcode::push_true:
+            case opcode::push_false:
+                m_assembler.mov(data(next), instr.m_opcode == opcode::push_true ? 1 : 0);
+                emit_set_tag(next, object::type::boolean);
+                return;
+            case opcode::push_constant: {
+                const object& constant = m_prototype.m_constants[instr.m_operand];
+
+                if (is_simple(jit_type_of(constant))) {
+                    m_assembler.mov(reg::rax, static_cast<uint64_t>(constant.data()));
+                    m_assembler.mov(data(next), reg::rax);
+                    emit_set_tag(next, constant.object_type());
+                    return;
+                }
+
+                break;
+            }
+            case opcode::pop:
+                if (is_simple(types[top])) {
+                    emit_clear(top);
+                    return;
+                }
+
+                break;
+            case opcode::duplicate:
+                if (is_simple(types[top])) {
+                    emit_copy(next, top);
+                    return;
+                }
+
+                break;
+            case opcode::load_local:
+                if (is_simple(types[instr.m_operand])) {
+                    emit_copy(next, instr.m_operand);
+                    return;
+                }
+
+                break;
+            case opcode::store_local:
+                if (is_simple(types[top]) && is_simple(types[instr.m_operand])) {
+                    emit_copy(instr.m_operand, top);
+                    return;
+                }
+
+                break;
+            case opcode::update_local: {
+                const auto operation = static_cast<separator>(instr.m_count);
+                const size_t local = instr.m_operand;
+                const jit_type local_type = types[local];
+
+                if (update_takes_operand(operation)) {
+                    const opcode arithmetic = compound_opcode(operation);
+
+                    if (is_simple(local_type) && is_simple(types[top]) && is_numeric(arithmetic_type(arithmetic, local_type, types[top]))) {
+                        emit_arithmetic(arithmetic, local, local_type, top, types[top], local);
+                        emit_copy(top, local);
+                        return;
+                    }
+
+                    break;
+                }
+
+                const bool increment = operation == separator::operation_prefix_increment || operation == separator::operation_postfix_increment;
+                const bool prefix = operation == separator::operation_prefix_increment || operation == separator::operation_prefix_decrement;
+
+                if (local_type == jit_type::integer_type) {
+                    m_assembler.mov(reg::rax, data(local));
+
+                    if (!prefix) {
+                        m_assembler.mov(data(next), reg::rax);
+                    }
+
+                    m_assembler.add(reg::rax, increment ? 1 : -1);
+                    m_assembler.mov(data(local), reg::rax);
+
+                    if (prefix) {
+                        m_assembler.mov(data(next), reg::rax);
+                    }
+
+                    emit_set_tag(next, object::type::integer);
+                    return;
+                } else if (local_type == jit_type::number_type) {
+                    const number one = 1.0;
+                    uint64_t one_bits;
+                    std::memcpy(&one_bits, &one, sizeof(one_bits));
+
+                    m_assembler.movsd(xmm::xmm0, data(local));
+
+                    if (!prefix) {
+                        m_assembler.movsd(data(next), xmm::xmm0);
+                    }
+
+                    m_assembler.mov(reg::rax, one_bits);
+                    m_assembler.movq(xmm::xmm1, reg::rax);
+
+                    if (increment) {
+                        m_assembler.addsd(xmm::xmm0, xmm::xmm1);
+                    } else {
+                        m_assembler.subsd(xmm::xmm0, xmm::xmm1);
+                    }
+
+                    m_assembler.movsd(data(local), xmm::xmm0);
+
+                    if (prefix) {
+                        m_assembler.movsd(data(next), xmm::xmm0);
+                    }
+
+                    emit_set_tag(next, object::type::number);
+                    return;
+                }
+
+                break;
+            }
+            case opcode::add:
+            case opcode::subtract:
+            case opcode::multiply:
+            case opcode::divide:
+            case opcode::modulus:
+            case opcode::exponentiate:
+            case opcode::equals:
+            case opcode::not_equals:
+            case opcode::greater:
+            case opcode::lesser:
+            case opcode::greater_equal:
+            case opcode::lesser_equal:
+            case opcode::bitwise_or:
+            case opcode::bitwise_xor:
+            case opcode::bitwise_and:
+            case opcode::shift_left:
+            case opcode::shift_right: {
+                const jit_type lhs_type = types[top - 1];
+                const jit_type rhs_type = types[top];
+
+                if (is_simple(lhs_type) && is_simple(rhs_type)) {
+                    if (arithmetic_type(instr.m_opcode, lhs_type, rhs_type) != jit_type::any) {
+                        emit_arithmetic(instr.m_opcode, top - 1, lhs_type, top, rhs_type, top - 1);
+                        emit_clear(top);
+                        return;
+                    }
+
+                    break;
+                }
+
+                emit_guarded_binary(a_index, instr.m_opcode, lhs_type, rhs_type, depth);
+                return;
+            }
+            case opcode::logical_not:
+                if (is_simple(types[top])) {
+                    m_assembler.mov(reg::rax, data(top));
+                    m_assembler.test(reg::rax, reg::rax);
+                    m_assembler.set_rax(condition::equal);
+                    m_assembler.mov(data(top), reg::rax);
+                    emit_set_tag(top, object::type::integer);
+                    return;
+                }
+
+                break;
+            case opcode::or_jump:
+                if (is_simple(types[top])) {
+                    m_assembler.mov(reg::rax, data(top));
+                    m_assembler.test(reg::rax, reg::rax);
+                } else {
+                    emit_helper(reinterpret_cast<uint64_t>(&jit_provider::or_jump), top);
+                }
+
+                m_assembler.jump(condition::not_equal, m_labels[instr.m_operand]);
+                return;
+            case opcode::and_jump:
+                if (is_simple(types[top])) {
+                    const auto skip = m_assembler.create_label();
+
+                    m_assembler.mov(reg::rax, data(top));
+                    m_assembler.test(reg::rax, reg::rax);
+                    m_assembler.jump(condition::not_equal, skip);
+                    m_assembler.mov(data(top), 0);
+                    emit_set_tag(top, object::type::boolean);
+                    m_assembler.jump(m_labels[instr.m_operand]);
+                    m_assembler.bind(skip);
+                } else {
+                    emit_helper(reinterpret_cast<uint64_t>(&jit_provider::and_jump), top);
+                    m_assembler.jump(condition::not_equal, m_labels[instr.m_operand]);
+                }
+
+                return;
+            case opcode::logical_or:
+            case opcode::logical_and:
+                // A simple left operand that did not short-circuit yields the right operand, which is moved down.
+                if (is_simple(types[top - 1])) {
+                    emit_copy(top - 1, top);
+                    emit_clear(top);
+                    return;
+                }
+
+                break;
+            case opcode::jump:
+                m_assembler.jump(m_labels[instr.m_operand]);
+                return;
+            case opcode::jump_if_false:
+                if (is_simple(types[top])) {
+                    m_assembler.mov(reg::rax, data(top));
+                    emit_clear(top);
+                    m_assembler.test(reg::rax, reg::rax);
+                } else {
+                    emit_helper(reinterpret_cast<uint64_t>(&jit_provider::pop_truth), top);
+                }
+
+                m_assembler.jump(condition::equal, m_labels[instr.m_operand]);
+                return;
+            case opcode::return_value:
+                m_assembler.lea(reg::rax, tag(top));
+                m_assembler.jump(m_epilogue);
+                return;
+            default:
+                break;
+        }
+
+        emit_step(a_index, depth);
+    }
+}
+
+#endif //REBAR_JIT_COMPILER_IMPL_HPP
@@ -0,0 +1,67 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_JIT_PROVIDER_HPP
+#define REBAR_JIT_PROVIDER_HPP
+
+#include <exception>
+#include <memory>
+#include <vector>
+
+#include "bytecode_provider.hpp"
+#include "jit_assembler.hpp"
+#include "jit_compiler.hpp"
+
+namespace rebar {
+    // Tiered execution provider. Functions start out on the bytecode virtual machine, which counts calls and
+    // loop back-edges. Once a function or one of its loops becomes hot, it is compiled to x86-64 machine code
+    // specialized for the slot types observed at that moment. Later entries whose argument types do not match
+    // any specialization are guarded out and keep running on the virtual machine.
+    //
+    // On targets other than x86-64 System V this behaves exactly like bytecode_provider.
+    struct jit_provider : public bytecode_provider {
+        friend class jit_compiler;
+
+        // Calls to a function before it is compiled.
+        static constexpr uint32_t call_threshold = 1 << 10;
+
+        // Specializations kept per prototype and entry point before giving up on compiling it further.
+        static constexpr size_t max_specializations = 4;
+
+        // Prototypes larger than this many instructions are left to the virtual machine.
+        static constexpr size_t max_compiled_instructions = 1 << 14;
+
+        explicit jit_provider(environment& a_environment) : bytecode_provider(a_environment) {}
+
+    protected:
+        [[nodiscard]] object enter_frame(const prototype& a_prototype, object* a_locals) override;
+        [[nodiscard]] bool enter_loop(const prototype& a_prototype, const instruction* a_loop_header, object* a_locals, object* a_sp, object& a_result) override;
+
+    private:
+        struct specialization {
+            size_t m_entry;
+            std::vector<jit_type> m_entry_types;
+            executable_memory m_code;
+        };
+
+        struct tier_data {
+            std::vector<specialization> m_specializations;
+        };
+
+        std::vector<std::unique_ptr<tier_data>> m_tier_data;
+        std::exception_ptr m_pending_exception;
+
+        [[nodiscard]] tier_data& tier(const prototype& a_prototype);
+        [[nodiscard]] const specialization* specialize(const prototype& a_prototype, size_t a_entry, const object* a_locals, size_t a_slot_count);
+        [[nodiscard]] object invoke(const specialization& a_specialization, object* a_locals);
+
+        // Entry points called from generated code.
+        static int32_t step(jit_provider* a_provider, object* a_locals, const instruction* a_instruction, object* a_sp, const prototype* a_prototype) noexcept;
+        static int32_t pop_truth(jit_provider* a_provider, object* a_slot) noexcept;
+        static int32_t or_jump(jit_provider* a_provider, object* a_slot) noexcept;
+        static int32_t and_jump(jit_provider* a_provider, object* a_slot) noexcept;
+    };
+}
+
+#endif //REBAR_JIT_PROVIDER_HPP
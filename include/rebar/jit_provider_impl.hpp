@@ -0,0 +1,139 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_JIT_PROVIDER_IMPL_HPP
+#define REBAR_JIT_PROVIDER_IMPL_HPP
+
+#include "jit_provider.hpp"
+
+#include "bytecode_provider_impl.hpp"
+#include "jit_compiler_impl.hpp"
+
+namespace rebar {
+    object jit_provider::enter_frame(const prototype& a_prototype, object* a_locals) {
+#ifdef REBAR_JIT_X86_64
+        if (a_prototype.m_runtime.m_call_count >= call_threshold) {
+            if (const specialization* compiled = specialize(a_prototype, 0, a_locals, a_prototype.m_local_count)) {
+                return invoke(*compiled, a_locals);
+            }
+        } else {
+            ++a_prototype.m_runtime.m_call_count;
+        }
+#endif
+
+        return bytecode_provider::enter_frame(a_prototype, a_locals);
+    }
+
+    bool jit_provider::enter_loop(const prototype& a_prototype, const instruction* a_loop_header, object* a_locals, object* a_sp, object& a_result) {
+#ifdef REBAR_JIT_X86_64
+        const auto entry = static_cast<size_t>(a_loop_header - a_prototype.m_code.data());
+
+        if (const specialization* compiled = specialize(a_prototype, entry, a_locals, static_cast<size_t>(a_sp - a_locals))) {
+            a_result = invoke(*compiled, a_locals);
+            return true;
+        }
+#else
+        static_cast<void>(a_prototype);
+        static_cast<void>(a_loop_header);
+        static_cast<void>(a_locals);
+        static_cast<void>(a_sp);
+        static_cast<void>(a_result);
+#endif
+
+        return false;
+    }
+
+    jit_provider::tier_data& jit_provider::tier(const prototype& a_prototype) {
+        if (a_prototype.m_runtime.m_tier_data == nullptr) {
+            m_tier_data.push_back(std::make_unique<tier_data>());
+            a_prototype.m_runtime.m_tier_data = m_tier_data.back().get();
+        }
+
+        return *static_cast<tier_data*>(a_prototype.m_runtime.m_tier_data);
+    }
+
+    const jit_provider::specialization* jit_provider::specialize(const prototype& a_prototype, const size_t a_entry, const object* a_locals, const size_t a_slot_count) {
+        tier_data& data = tier(a_prototype);
+        size_t entry_specializations = 0;
+
+        for (const specialization& candidate : data.m_specializations) {
+            if (candidate.m_entry != a_entry || candidate.m_entry_types.size() != a_slot_count) {
+                continue;
+            }
+
+            ++entry_specializations;
+
+            bool matches = true;
+
+            for (size_t i = 0; i < a_slot_count && matches; ++i) {
+                matches = candidate.m_entry_types[i] == jit_type::any || candidate.m_entry_types[i] == jit_type_of(a_locals[i]);
+            }
+
+            if (matches) {
+                // Failed compilations are remembered as well so that they are not retried.
+                return candidate.m_code.valid() ? &candidate : nullptr;
+            }
+        }
+
+        if (entry_specializations >= max_specializations) {
+            return nullptr;
+        }
+
+        std::vector<jit_type> entry_types(a_slot_count);
+
+        for (size_t i = 0; i < a_slot_count; ++i) {
+            entry_types[i] = jit_type_of(a_locals[i]);
+        }
+
+        executable_memory code = jit_compiler(*this, a_prototype).compile(a_entry, entry_types);
+        data.m_specializations.push_back({ a_entry, std::move(entry_types), std::move(code) });
+
+        const specialization& compiled = data.m_specializations.back();
+        return compiled.m_code.valid() ? &compiled : nullptr;
+    }
+
+    object jit_provider::invoke(const specialization& a_specialization, object* a_locals) {
+        const auto entry = reinterpret_cast<jit_compiler::entry_point>(const_cast<void*>(a_specialization.m_code.data()));
+        const object* result = entry(a_locals, this);
+
+        if (result == nullptr) {
+            std::exception_ptr exception = std::move(m_pending_exception);
+            m_pending_exception = nullptr;
+            std::rethrow_exception(exception);
+        }
+
+        return *result;
+    }
+
+    int32_t jit_provider::step(jit_provider* a_provider, object* a_locals, const instruction* a_instruction, object* a_sp, const prototype* a_prototype) noexcept {
+        try {
+            static_cast<void>(a_provider->run<true>(*a_prototype, a_locals, a_instruction, a_sp));
+            return 0;
+        } catch (...) {
+            a_provider->m_pending_exception = std::current_exception();
+            return 1;
+        }
+    }
+
+    int32_t jit_provider::pop_truth(jit_provider*, object* a_slot) noexcept {
+        const bool truth = a_slot->boolean_evaluate();
+        *a_slot = null;
+        return truth;
+    }
+
+    int32_t jit_provider::or_jump(jit_provider*, object* a_slot) noexcept {
+        return !a_slot->is_native_object() && a_slot->boolean_evaluate();
+    }
+
+    int32_t jit_provider::and_jump(jit_provider*, object* a_slot) noexcept {
+        if (!a_slot->is_native_object() && !a_slot->boolean_evaluate()) {
+            *a_slot = object(false);
+            return 1;
+        }
+
+        return 0;
+    }
+}
+
+#endif //REBAR_JIT_PROVIDER_IMPL_HPP
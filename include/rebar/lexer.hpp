@@ -5,6 +5,8 @@
 #ifndef REBAR_LEXER_HPP
 #define REBAR_LEXER_HPP
 
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <variant>
 #include <string>
@@ -164,6 +166,97 @@ namespace rebar {
         }
     };
 
+    // Longest-match automaton over the symbols of a symbol_map. The first character is dispatched through a
+    // dense table and deeper characters through small sorted child lists, so matching costs one step per
+    // character of the longest symbol sharing a prefix with the text. Entries point into the source map,
+    // which must outlive the trie and stay unmodified while it is in use.
+    class symbol_trie {
+    public:
+        using entry = symbol_map::value_type;
+
+        symbol_trie() noexcept = default;
+
+        explicit symbol_trie(const symbol_map& a_map) {
+            m_nodes.emplace_back();
+
+            for (const entry& symbol : a_map) {
+                if (symbol.first.empty()) {
+                    continue;
+                }
+
+                uint32_t index = 0;
+
+                for (const char character : symbol.first) {
+                    index = child_or_insert(index, static_cast<unsigned char>(character));
+                }
+
+                m_nodes[index].m_symbol = &symbol;
+            }
+
+            for (const auto& [character, child] : m_nodes.front().m_children) {
+                m_root[character] = child;
+            }
+        }
+
+        // The longest symbol a_text starts with, or nullptr.
+        [[nodiscard]] const entry* match(const std::string_view a_text) const noexcept {
+            if (a_text.empty()) {
+                return nullptr;
+            }
+
+            uint32_t index = m_root[static_cast<unsigned char>(a_text.front())];
+            const entry* longest = nullptr;
+
+            for (size_t i = 1; index != 0; ++i) {
+                const node& current = m_nodes[index];
+
+                if (current.m_symbol != nullptr) {
+                    longest = current.m_symbol;
+                }
+
+                if (i == a_text.size()) {
+                    break;
+                }
+
+                index = child(current, static_cast<unsigned char>(a_text[i]));
+            }
+
+            return longest;
+        }
+
+    private:
+        struct node {
+            const entry* m_symbol = nullptr;
+            std::vector<std::pair<unsigned char, uint32_t>> m_children;
+        };
+
+        // Node indices; zero, the root, doubles as "no transition".
+        std::array<uint32_t, 256> m_root{};
+        std::vector<node> m_nodes;
+
+        [[nodiscard]] static uint32_t child(const node& a_node, const unsigned char a_character) noexcept {
+            for (const auto& [character, index] : a_node.m_children) {
+                if (character == a_character) {
+                    return index;
+                }
+            }
+
+            return 0;
+        }
+
+        uint32_t child_or_insert(const uint32_t a_index, const unsigned char a_character) {
+            if (const uint32_t existing = child(m_nodes[a_index], a_character); existing != 0) {
+                return existing;
+            }
+
+            const auto created = static_cast<uint32_t>(m_nodes.size());
+            m_nodes.emplace_back();
+            m_nodes[a_index].m_children.emplace_back(a_character, created);
+
+            return created;
+        }
+    };
+
     class source_position {
         size_t m_row;
         size_t m_column;
@@ -210,33 +303,62 @@ namespace rebar {
             return m_tokens;
         }
 
+        [[nodiscard]] const std::vector<token>& tokens() const noexcept {
+            return m_tokens;
+        }
+
         [[nodiscard]] std::vector<source_position>& source_positions() noexcept {
             return m_source_positions;
         }
+
+        [[nodiscard]] const std::vector<source_position>& source_positions() const noexcept {
+            return m_source_positions;
+        }
     };
 
     class lexer {
         symbol_map m_map;
 
+        // Built from m_map on the first lex() after the map was handed out or replaced.
+        symbol_trie m_trie;
+        bool m_trie_valid = false;
+
     public:
         lexer() noexcept : m_map(symbol_map::get_default()) {}
         explicit lexer(symbol_map a_map) noexcept : m_map(std::move(a_map)) {}
 
+        lexer(const lexer& a_lexer) : m_map(a_lexer.m_map) {}
+
+        lexer& operator = (const lexer& a_lexer) {
+            m_map = a_lexer.m_map;
+            m_trie_valid = false;
+
+            return *this;
+        }
+
         [[maybe_unused]] void set_symbol_map(symbol_map a_map) noexcept {
             m_map = std::move(a_map);
+            m_trie_valid = false;
         }
 
+        // The map may be modified through the returned reference until the next call to lex().
         [[maybe_unused]] [[nodiscard]] symbol_map& token_symbol_map() noexcept {
+            m_trie_valid = false;
             return m_map;
         }
 
         // Lexical analysis / tokenizer.
         // TODO: Add row/column indices.
         [[nodiscard]] lex_unit lex(const std::string_view a_string) {
+            if (!m_trie_valid) {
+                m_trie = symbol_trie(m_map);
+                m_trie_valid = true;
+            }
+
             lex_unit unit;
 
             bool string_mode = false;
-            bool identifier_mode = true;
+            bool identifier_mode = false;
             bool escape_mode = false;
             bool line_comment_mode = false;
             bool block_comment_mode = false;
@@ -276,7 +398,7 @@ namespace rebar {
 
                     escape_mode = character == '\\';
                     ++scan_index;
-                } else if (character == '/') {
+                } else if (character == '/' && scan_index + 1 < a_string.size() && (a_string[scan_index + 1] == '/' || a_string[scan_index + 1] == '*')) {
                     if (a_string[scan_index + 1] == '/') {
                         line_comment_mode = true;
                         scan_index += 2;
@@ -336,9 +458,9 @@ namespace rebar {
                     string_start_index = ++scan_index;
                 } else {
                     // Check if any separators (operators) are present.
-                    std::optional<std::pair<std::string_view, symbol_mapping>> next_token = m_map.next(a_string.substr(scan_index));
+                    const symbol_trie::entry* next_token = m_trie.match(a_string.substr(scan_index));
 
-                    if (next_token.has_value()) {
+                    if (next_token != nullptr) {
                         if (next_token->first == "-" && is_number_string(a_string.substr(scan_index + 1, 1))) {
                             identifier_start_index = scan_index;
                             identifier_mode = true;
@@ -346,6 +468,14 @@ namespace rebar {
                             continue;
                         }
 
+                        // Word symbols only match whole words: "format" is an identifier, not "for" and "mat".
+                        if (!identifier_mode && !next_token->second.interrupter && continues_word(a_string, scan_index + next_token->first.size())) {
+                            identifier_start_index = scan_index;
+                            identifier_mode = true;
+                            scan_index += next_token->first.size();
+                            continue;
+                        }
+
                         // Check if identifier is being parsed.
                         if (identifier_mode) {
                             if (!next_token->second.interrupter) {
@@ -378,7 +508,10 @@ namespace rebar {
                             }
                         }
 
-                        unit.add_token({ 0, 0 }, next_token->second.replaced);
+                        if (next_token->second.replaced != separator::space) {
+                            unit.add_token({ 0, 0 }, next_token->second.replaced);
+                        }
+
                         scan_index += next_token->first.size();
                     } else {
                         identifier_start_index = identifier_mode ? identifier_start_index : scan_index;
@@ -404,22 +537,19 @@ namespace rebar {
                 }
             }
 
-            std::vector<token>& tokens = unit.tokens();
-            std::vector<source_position>& source_positions = unit.source_positions();
-
-            // There is a better, more optimized way to do this.
-            // TODO: Optimize this.
-            // TODO: Refactor with zip.
-            for (int i = 0; i < tokens.size(); i++) {
-                if (tokens[i] == separator::space) {
-                    tokens.erase(tokens.begin() + i);
-                    source_positions.erase(source_positions.begin() + i);
+            return unit;
+        }
 
-                    --i;
-                }
+    private:
+        // Whether the character at a_index extends the word before it, i.e. does not start a string, a comment
+        // or an interrupting symbol.
+        [[nodiscard]] bool continues_word(const std::string_view a_string, const size_t a_index) const noexcept {
+            if (a_index >= a_string.size() || a_string[a_index] == '"') {
+                return false;
             }
 
-            return unit;
+            const symbol_trie::entry* following = m_trie.match(a_string.substr(a_index));
+            return following == nullptr || !following->second.interrupter;
         }
     };
 }
@@ -0,0 +1,91 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_LRU_CACHE_HPP
+#define REBAR_LRU_CACHE_HPP
+
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "string.hpp"
+
+namespace rebar {
+    // Values keyed by source text, holding at most m_capacity entries. Inserting into a full cache evicts the
+    // least recently used entry. A capacity of zero disables the cache. Not synchronized.
+    template <typename t_value>
+    class lru_cache {
+    public:
+        explicit lru_cache(const size_t a_capacity) noexcept : m_capacity(a_capacity) {}
+
+        lru_cache(const lru_cache&) = delete;
+        lru_cache& operator = (const lru_cache&) = delete;
+
+        // Value stored under a_key, or nullptr. A hit makes the entry the most recently used.
+        [[nodiscard]] t_value* find(const std::string_view a_key) {
+            auto found = m_index.find(a_key);
+
+            if (found == m_index.end()) {
+                return nullptr;
+            }
+
+            m_entries.splice(m_entries.begin(), m_entries, found->second);
+            return &found->second->second;
+        }
+
+        // Stores a_value under a_key, which must not be present yet.
+        void insert(std::string a_key, t_value a_value) {
+            if (m_capacity == 0) {
+                return;
+            }
+
+            if (m_entries.size() == m_capacity) {
+                evict();
+            }
+
+            m_entries.emplace_front(std::move(a_key), std::move(a_value));
+            m_index.emplace(m_entries.front().first, m_entries.begin());
+        }
+
+        [[nodiscard]] size_t size() const noexcept {
+            return m_entries.size();
+        }
+
+        [[nodiscard]] size_t capacity() const noexcept {
+            return m_capacity;
+        }
+
+        // Evicts the least recently used entries beyond a_capacity.
+        void set_capacity(const size_t a_capacity) {
+            m_capacity = a_capacity;
+
+            while (m_entries.size() > m_capacity) {
+                evict();
+            }
+        }
+
+        void clear() noexcept {
+            m_index.clear();
+            m_entries.clear();
+        }
+
+    private:
+        using entry_list = std::list<std::pair<std::string, t_value>>;
+
+        size_t m_capacity;
+
+        // Most recently used first. Index keys view the key strings of the list, whose nodes never move.
+        entry_list m_entries;
+        std::unordered_map<std::string_view, typename entry_list::iterator, xxh_string_view_hash> m_index;
+
+        void evict() {
+            m_index.erase(m_entries.back().first);
+            m_entries.pop_back();
+        }
+    };
+}
+
+#endif //REBAR_LRU_CACHE_HPP
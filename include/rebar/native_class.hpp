@@ -0,0 +1,144 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_NATIVE_CLASS_HPP
+#define REBAR_NATIVE_CLASS_HPP
+
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "environment.hpp"
+#include "native_function.hpp"
+#include "native_object_impl.hpp"
+#include "object.hpp"
+
+namespace rebar {
+    template <typename t_method>
+    struct member_function_traits;
+
+    template <typename t_return, typename t_class, typename... t_args>
+    struct member_function_traits<t_return (t_class::*)(t_args...)> {
+        using return_type = t_return;
+        using class_type = t_class;
+        using arguments = std::tuple<t_args...>;
+    };
+
+    template <typename t_return, typename t_class, typename... t_args>
+    struct member_function_traits<t_return (t_class::*)(t_args...) const> : member_function_traits<t_return (t_class::*)(t_args...)> {};
+
+    template <typename t_return, typename t_class, typename... t_args>
+    struct member_function_traits<t_return (t_class::*)(t_args...) noexcept> : member_function_traits<t_return (t_class::*)(t_args...)> {};
+
+    template <typename t_return, typename t_class, typename... t_args>
+    struct member_function_traits<t_return (t_class::*)(t_args...) const noexcept> : member_function_traits<t_return (t_class::*)(t_args...)> {};
+
+    template <typename t_field>
+    struct member_field_traits;
+
+    template <typename t_type, typename t_class>
+    struct member_field_traits<t_type t_class::*> {
+        using type = t_type;
+        using class_type = t_class;
+    };
+
+    // Describes the constructor, methods and fields of t_object to be bound by environment::register_native_class.
+    // Each member is bound through a function generated for it at compile time, which unboxes its arguments as
+    // environment::bind<v_function>() does.
+    //
+    //     env.register_native_class("Point", native_class<point>()
+    //             .constructor<integer, integer>()
+    //             .method<&point::length>("Length")
+    //             .field<&point::x>("X"));
+    //
+    // Methods receive the native object as their first argument, as with methods bound by hand. Fields are read
+    // by selecting them; fields holding an object may also be assigned.
+    template <typename t_object>
+    class native_class {
+    public:
+        // Makes "new" construct t_object from arguments of types t_args.
+        template <typename... t_args>
+        native_class& constructor() {
+            m_constructor = [](environment* a_environment, native_object a_class) -> object {
+                virtual_table& table = a_class.get_virtual_table();
+
+                return detail::invoke_native<0, t_args...>(*a_environment, [&table](auto&&... a_args) -> object {
+                    return native_object::create<t_object>(table, std::in_place_type<t_object>, std::forward<decltype(a_args)>(a_args)...);
+                }, std::index_sequence_for<t_args...>{});
+            };
+
+            return *this;
+        }
+
+        // v_method is a member function of t_object, or a free function taking the native object as its first
+        // parameter.
+        template <auto v_method>
+        native_class& method(std::string a_identifier) {
+            if constexpr (std::is_member_function_pointer_v<decltype(v_method)>) {
+                using traits = member_function_traits<decltype(v_method)>;
+                static_assert(std::is_base_of_v<typename traits::class_type, t_object>, "Methods must be members of the bound class.");
+
+                m_methods.emplace_back(std::move(a_identifier), [](environment* a_environment) -> object {
+                    t_object& self = native_argument<t_object&>(*a_environment, 0);
+
+                    return detail::invoke_native<1>(*a_environment, [&self](auto&&... a_args) -> decltype(auto) {
+                        return (self.*v_method)(std::forward<decltype(a_args)>(a_args)...);
+                    }, static_cast<typename traits::arguments*>(nullptr));
+                });
+            } else {
+                m_methods.emplace_back(std::move(a_identifier), native_thunk<v_method>);
+            }
+
+            return *this;
+        }
+
+        template <auto v_field>
+        native_class& field(std::string a_identifier) {
+            using traits = member_field_traits<decltype(v_field)>;
+            static_assert(std::is_base_of_v<typename traits::class_type, t_object>, "Fields must be members of the bound class.");
+
+            virtual_table::field_accessor accessor{
+                [](environment* a_environment, native_object a_object) -> object {
+                    return native_result(*a_environment, a_object.get_object<t_object>().*v_field);
+                },
+                nullptr
+            };
+
+            if constexpr (std::is_same_v<typename traits::type, object>) {
+                accessor.m_reference = [](native_object a_object) -> object& {
+                    return a_object.get_object<t_object>().*v_field;
+                };
+            }
+
+            m_fields.emplace_back(std::move(a_identifier), accessor);
+
+            return *this;
+        }
+
+        // Adds the described members to a_table.
+        void install(environment& a_environment, virtual_table& a_table) const {
+            if (m_constructor != nullptr) {
+                a_table.overload_new = m_constructor;
+            }
+
+            for (const auto& [identifier, method] : m_methods) {
+                a_table[a_environment.str(identifier)] = a_environment.bind(method);
+            }
+
+            for (const auto& [identifier, accessor] : m_fields) {
+                a_table.m_fields.insert_or_assign(a_environment.str(identifier), accessor);
+            }
+        }
+
+    private:
+        virtual_table::operation_function<0> m_constructor = nullptr;
+        std::vector<std::pair<std::string, callable>> m_methods;
+        std::vector<std::pair<std::string, virtual_table::field_accessor>> m_fields;
+    };
+}
+
+#endif //REBAR_NATIVE_CLASS_HPP
@@ -0,0 +1,186 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_NATIVE_FUNCTION_HPP
+#define REBAR_NATIVE_FUNCTION_HPP
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "environment.hpp"
+#include "object.hpp"
+
+namespace rebar {
+    template <typename t_function>
+    struct function_traits;
+
+    template <typename t_return, typename... t_args>
+    struct function_traits<t_return (*)(t_args...)> {
+        using return_type = t_return;
+        using arguments = std::tuple<t_args...>;
+    };
+
+    template <typename t_return, typename... t_args>
+    struct function_traits<t_return (*)(t_args...) noexcept> : function_traits<t_return (*)(t_args...)> {};
+
+    template <typename t_type>
+    inline constexpr bool dependent_false = false;
+
+    namespace detail {
+        template <typename t_type>
+        using native_parameter = std::remove_cv_t<std::remove_reference_t<t_type>>;
+
+        // Parameters of type environment& receive the calling environment rather than an argument.
+        template <typename t_type>
+        inline constexpr bool native_takes_argument = !std::is_same_v<native_parameter<t_type>, environment>;
+
+        // Position on the argument stack of each parameter, the first argument-taking one being at v_first.
+        template <size_t v_first, typename... t_args>
+        [[nodiscard]] constexpr std::array<size_t, sizeof...(t_args) + 1> native_argument_positions() noexcept {
+            constexpr bool takes[] = { native_takes_argument<t_args>..., false };
+
+            std::array<size_t, sizeof...(t_args) + 1> positions{};
+            size_t position = v_first;
+
+            for (size_t i = 0; i < sizeof...(t_args); ++i) {
+                positions[i] = position;
+                position += takes[i];
+            }
+
+            return positions;
+        }
+
+        [[noreturn]] inline void throw_native_argument_error(const size_t a_position, const char* a_expected) {
+            throw std::runtime_error("Argument " + std::to_string(a_position) + " passed to native function was not " + a_expected + ".");
+        }
+
+        inline void check_native_argument(const object a_object, const object::type a_type, const size_t a_position, const char* a_expected) {
+            if (!a_object.is_type(a_type)) {
+                throw_native_argument_error(a_position, a_expected);
+            }
+        }
+    }
+
+    // Unboxes the argument at a_position to a parameter of type t_type, throwing std::runtime_error if the
+    // argument is of another type. Numbers also accept integers; object takes any value, including the null of
+    // an argument that was not passed, and span<object> takes the remaining arguments. Parameters of any other
+    // class type refer to the data of a native object.
+    //
+    // The remaining arguments are copied out of the argument stack, which a call back into script may reallocate;
+    // the span views the copy for the duration of the native call.
+    template <typename t_type>
+    [[nodiscard]] decltype(auto) native_argument(environment& a_environment, const size_t a_position) {
+        using parameter_type = detail::native_parameter<t_type>;
+
+        if constexpr (std::is_same_v<parameter_type, environment>) {
+            return (a_environment);
+        } else if constexpr (std::is_same_v<parameter_type, span<object>>) {
+            const span<object> arguments = a_environment.get_args();
+            const object* end = arguments.data() + arguments.size();
+            return std::vector<object>(arguments.data() + std::min(a_position, arguments.size()), end);
+        } else {
+            object argument = a_environment.arg(a_position);
+
+            if constexpr (std::is_same_v<parameter_type, object>) {
+                return argument;
+            } else if constexpr (std::is_same_v<parameter_type, bool>) {
+                detail::check_native_argument(argument, object::type::boolean, a_position, "a boolean");
+                return argument.get_boolean();
+            } else if constexpr (std::is_integral_v<parameter_type>) {
+                detail::check_native_argument(argument, object::type::integer, a_position, "an integer");
+                return static_cast<parameter_type>(argument.get_integer());
+            } else if constexpr (std::is_floating_point_v<parameter_type>) {
+                if (argument.is_integer()) {
+                    return static_cast<parameter_type>(argument.get_integer());
+                }
+
+                detail::check_native_argument(argument, object::type::number, a_position, "a number");
+                return static_cast<parameter_type>(argument.get_number());
+            } else if constexpr (std::is_same_v<parameter_type, string>) {
+                detail::check_native_argument(argument, object::type::string, a_position, "a string");
+                return argument.get_string();
+            } else if constexpr (std::is_same_v<parameter_type, std::string_view>) {
+                detail::check_native_argument(argument, object::type::string, a_position, "a string");
+                return argument.get_string().to_string_view();
+            } else if constexpr (std::is_same_v<parameter_type, std::string>) {
+                detail::check_native_argument(argument, object::type::string, a_position, "a string");
+                return std::string(argument.get_string().to_string_view());
+            } else if constexpr (std::is_same_v<parameter_type, function>) {
+                detail::check_native_argument(argument, object::type::function, a_position, "a function");
+                return argument.get_function(a_environment);
+            } else if constexpr (std::is_same_v<parameter_type, table>) {
+                detail::check_native_argument(argument, object::type::table, a_position, "a table");
+                return argument.get_table();
+            } else if constexpr (std::is_same_v<parameter_type, array>) {
+                detail::check_native_argument(argument, object::type::array, a_position, "an array");
+                return argument.get_array();
+            } else if constexpr (std::is_same_v<parameter_type, native_object>) {
+                detail::check_native_argument(argument, object::type::native_object, a_position, "a native object");
+                return argument.get_native_object();
+            } else {
+                detail::check_native_argument(argument, object::type::native_object, a_position, "a native object");
+                return argument.get_native_object().template get_object<parameter_type>();
+            }
+        }
+    }
+
+    // Boxes the result of a native function.
+    template <typename t_type>
+    [[nodiscard]] object native_result(environment& a_environment, t_type&& a_value) {
+        using parameter_type = detail::native_parameter<t_type>;
+
+        if constexpr (std::is_same_v<parameter_type, object> || std::is_same_v<parameter_type, native_object> || std::is_same_v<parameter_type, string> || std::is_same_v<parameter_type, function> || std::is_same_v<parameter_type, array>) {
+            return a_value;
+        } else if constexpr (std::is_same_v<parameter_type, bool>) {
+            return object(a_value);
+        } else if constexpr (std::is_integral_v<parameter_type>) {
+            return static_cast<integer>(a_value);
+        } else if constexpr (std::is_floating_point_v<parameter_type>) {
+            return static_cast<number>(a_value);
+        } else if constexpr (std::is_convertible_v<const parameter_type&, std::string_view>) {
+            return a_environment.str(a_value);
+        } else {
+            static_assert(dependent_false<parameter_type>, "Native functions may only return objects, booleans, arithmetic types and strings.");
+        }
+    }
+
+    namespace detail {
+        // Calls a_function with the arguments of the current call, the first argument-taking parameter reading
+        // the argument at v_first, and boxes its result.
+        template <size_t v_first, typename... t_args, typename t_function, size_t... v_indices>
+        [[nodiscard]] object invoke_native(environment& a_environment, t_function&& a_function, std::index_sequence<v_indices...>) {
+            constexpr auto positions = native_argument_positions<v_first, t_args...>();
+
+            if constexpr (std::is_void_v<decltype(a_function(native_argument<t_args>(a_environment, positions[v_indices])...))>) {
+                a_function(native_argument<t_args>(a_environment, positions[v_indices])...);
+                return null;
+            } else {
+                return native_result(a_environment, a_function(native_argument<t_args>(a_environment, positions[v_indices])...));
+            }
+        }
+
+        template <size_t v_first, typename t_function, typename... t_args>
+        [[nodiscard]] object invoke_native(environment& a_environment, t_function&& a_function, std::tuple<t_args...>*) {
+            return invoke_native<v_first, t_args...>(a_environment, std::forward<t_function>(a_function), std::index_sequence_for<t_args...>{});
+        }
+    }
+
+    // Callable generated for environment::bind<v_function>(). Unboxing and boxing are resolved at compile time,
+    // so the compiler can inline them into the call of v_function.
+    template <auto v_function>
+    object native_thunk(environment* a_environment) {
+        using arguments = typename function_traits<decltype(v_function)>::arguments;
+
+        return detail::invoke_native<0>(*a_environment, v_function, static_cast<arguments*>(nullptr));
+    }
+}
+
+#endif //REBAR_NATIVE_FUNCTION_HPP
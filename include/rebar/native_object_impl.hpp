@@ -5,6 +5,8 @@
 #ifndef REBAR_NATIVE_OBJECT_IMPL_HPP
 #define REBAR_NATIVE_OBJECT_IMPL_HPP
 
+#include <unordered_map>
+
 #include "native_object.hpp"
 
 #include "object.hpp"
@@ -26,6 +28,14 @@ namespace rebar {
 
         using index_function = object& (*)(environment*, native_object, object);
 
+        using field_getter = object (*)(environment*, native_object);
+        using field_reference = object& (*)(native_object);
+
+        struct field_accessor {
+            field_getter m_get;
+            field_reference m_reference; // Null unless the field holds an object, which makes it assignable.
+        };
+
         // TODO: Throw exceptions in null functions.
         constexpr static const assignment_operation_function<0> null_aof_0 = [](environment*, native_object) {};
         constexpr static const assignment_operation_function<1> null_aof_1 = [](environment*, native_object, object) {};
@@ -35,7 +45,8 @@ namespace rebar {
         constexpr static const operation_function<1> null_of_1 = [](environment*, native_object, object) -> object { return null; };
         constexpr static const operation_function<2> null_of_2 = [](environment*, native_object, object, object) -> object { return null; };
 
-        constexpr static const index_function null_idx = [](environment*, native_object, object) -> object& { static object temp; return temp; };
+        // Thread-local, so environments on different threads do not write to the same object.
+        constexpr static const index_function null_idx = [](environment*, native_object, object) -> object& { thread_local object temp; return temp; };
 
         assignment_operation_function<1> overload_assignment                  = null_aof_1;
         operation_function<1>            overload_addition                    = null_of_1;
@@ -80,6 +91,10 @@ namespace rebar {
         operation_function<2>            overload_operation_ranged_select     = null_of_2;
         operation_function<0>            overload_operation_call              = null_of_0;
         operation_function<0>            overload_new                         = null_of_0;
+
+        // Fields of classes bound through native_class, by identifier. Selecting a member looks here after the
+        // select overload and before the table's own entries.
+        std::unordered_map<object, field_accessor> m_fields;
     };
 
     // NATIVE OBJECT OVERLOAD FUNCTIONS
@@ -5,6 +5,8 @@
 #ifndef REBAR_OBJECT_HPP
 #define REBAR_OBJECT_HPP
 
+#include <cstring>
+
 #include "definitions.hpp"
 #include "string.hpp"
 #include "array.hpp"
@@ -14,7 +16,20 @@
 namespace rebar {
     class table;
 
-    struct alignas(sizeof(size_t) * 2) object {
+#ifdef REBAR_NAN_BOXING
+    static_assert(sizeof(void*) == 8, "NaN-boxed objects require a 64-bit target.");
+
+    // Compact layout: every object is a single 64-bit word. Numbers are stored as-is; every other type lives in
+    // the payload of a negative quiet NaN, with the type in bits 48-50 and a 48-bit payload below it. Integers
+    // are therefore limited to 48 bits and wrap around on overflow. NaN numbers are canonicalized so that they
+    // never collide with a boxed value.
+    inline constexpr size_t object_alignment = sizeof(uint64_t);
+#else
+    // Default layout: a type tag followed by a full machine word of payload.
+    inline constexpr size_t object_alignment = sizeof(size_t) * 2;
+#endif
+
+    struct alignas(object_alignment) object {
         enum class type : enum_base {
             // Simple Types / Simply Comparable:
             null = 0,
@@ -36,162 +51,271 @@ namespace rebar {
         static constexpr type simply_comparable_end_boundary = type::string;
 
     private:
+#ifdef REBAR_NAN_BOXING
+        static constexpr uint64_t box_prefix = 0xFFF8'0000'0000'0000;
+        static constexpr uint64_t complex_prefix = 0xFFFC'0000'0000'0000;
+        static constexpr uint64_t payload_mask = 0x0000'FFFF'FFFF'FFFF;
+        static constexpr uint64_t exponent_mask = 0x7FF0'0000'0000'0000;
+        static constexpr uint64_t mantissa_mask = 0x000F'FFFF'FFFF'FFFF;
+        static constexpr uint64_t canonical_nan = 0x7FF8'0000'0000'0000;
+        static constexpr int tag_shift = 48;
+
+        uint64_t m_bits;
+
+        // Numbers have no box tag, so the remaining eight types map onto the three tag bits.
+        [[nodiscard]] static constexpr uint64_t box(const type a_type, const size_t a_data) noexcept {
+            if (a_type == type::number) {
+                const bool nan = (a_data & exponent_mask) == exponent_mask && (a_data & mantissa_mask) != 0;
+                return nan ? canonical_nan : a_data;
+            }
+
+            const auto tag = static_cast<uint64_t>(a_type) - (a_type > type::number ? 1 : 0);
+            return box_prefix | (tag << tag_shift) | (a_data & payload_mask);
+        }
+
+        void copy_representation(const object& a_object) noexcept {
+            m_bits = a_object.m_bits;
+        }
+#else
         type m_type;
         size_t m_data;
 
-    public:
-        constexpr object(const type a_type, const size_t a_data) noexcept : m_type(a_type), m_data(a_data) {}
+        void copy_representation(const object& a_object) noexcept {
+            m_type = a_object.m_type;
+            m_data = a_object.m_data;
+        }
+#endif
+
+        template <typename t_value>
+        [[nodiscard]] static size_t bits_of(const t_value a_value) noexcept {
+            static_assert(sizeof(t_value) == sizeof(size_t));
 
-        constexpr object() noexcept : m_type(type::null), m_data(0) {}
-        object(const integer a_integer) noexcept : m_type(type::integer), m_data(*reinterpret_cast<const size_t*>(&a_integer)) {}
-        object(const int a_integer) noexcept : m_type(type::integer), m_data(0) {
-            reinterpret_cast<integer&>(m_data) = static_cast<integer>(a_integer);
+            size_t bits;
+            std::memcpy(&bits, &a_value, sizeof(bits));
+            return bits;
         }
-        explicit object(const bool a_boolean) noexcept : m_type(type::boolean), m_data(*reinterpret_cast<const size_t*>(&a_boolean)) {}
-        object(const function a_function) noexcept : m_type(type::function), m_data(reinterpret_cast<size_t>(a_function.m_data)) {}
-        object(const number a_number) noexcept : m_type(type::number), m_data(*reinterpret_cast<const size_t*>(&a_number)) {}
-        object(string a_string) noexcept : m_type(type::string), m_data(reinterpret_cast<size_t>(a_string.data())) {
+
+    public:
+#ifdef REBAR_NAN_BOXING
+        constexpr object(const type a_type, const size_t a_data) noexcept : m_bits(box(a_type, a_data)) {}
+#else
+        constexpr object(const type a_type, const size_t a_data) noexcept : m_type(a_type), m_data(a_data) {}
+#endif
+
+        constexpr object() noexcept : object(type::null, 0) {}
+        object(const integer a_integer) noexcept : object(type::integer, static_cast<size_t>(a_integer)) {}
+        object(const int a_integer) noexcept : object(type::integer, static_cast<size_t>(static_cast<integer>(a_integer))) {}
+        explicit object(const bool a_boolean) noexcept : object(type::boolean, static_cast<size_t>(a_boolean)) {}
+        object(const function a_function) noexcept : object(type::function, reinterpret_cast<size_t>(a_function.m_data)) {}
+        object(const number a_number) noexcept : object(type::number, bits_of(a_number)) {}
+        object(string a_string) noexcept : object(type::string, reinterpret_cast<size_t>(a_string.data())) {
             a_string.reference();
         }
 
-        object(array a_array) noexcept : m_type(type::array), m_data(*reinterpret_cast<size_t*>(&a_array)) {
+        object(array a_array) noexcept : object(type::array, bits_of(a_array)) {
             a_array.reference();
         }
 
-        object(table* a_table) noexcept : m_type(type::table), m_data(reinterpret_cast<size_t>(a_table)) {
+        object(table* a_table) noexcept : object(type::table, reinterpret_cast<size_t>(a_table)) {
             reference(*this);
         }
 
-        object(native_object a_object) noexcept : m_type(type::native_object), m_data(reinterpret_cast<size_t>(a_object.data())) {
+        object(native_object a_object) noexcept : object(type::native_object, reinterpret_cast<size_t>(a_object.data())) {
             a_object.reference();
         }
 
         // TODO: Generate casts/constructors for other types.
 
-        object(const object& a_object) noexcept : m_type(a_object.m_type), m_data(a_object.m_data) {
-            reference(*this);
+        object(const object& a_object) noexcept {
+            copy_representation(a_object);
+
+            if (is_complex_type()) {
+                reference(*this);
+            }
         };
 
-        object(object&& a_object) noexcept : m_type(a_object.m_type), m_data(a_object.m_data) {
-            reference(*this);
+        object(object&& a_object) noexcept {
+            copy_representation(a_object);
+
+            if (is_complex_type()) {
+                reference(*this);
+            }
         };
 
         ~object() noexcept {
-            dereference(*this);
+            if (is_complex_type()) {
+                dereference(*this);
+            }
         }
 
         object& operator = (const object& a_object) noexcept {
-            dereference(*this);
+            if (is_complex_type()) {
+                dereference(*this);
+            }
 
-            m_type = a_object.m_type;
-            m_data = a_object.m_data;
+            copy_representation(a_object);
 
-            reference(*this);
+            if (is_complex_type()) {
+                reference(*this);
+            }
 
             return *this;
         }
 
         object& operator = (object&& a_object) noexcept {
-            dereference(*this);
+            if (is_complex_type()) {
+                dereference(*this);
+            }
 
-            m_type = a_object.m_type;
-            m_data = a_object.m_data;
+            copy_representation(a_object);
 
-            reference(*this);
+            if (is_complex_type()) {
+                reference(*this);
+            }
 
             return *this;
         }
 
+#ifdef REBAR_NAN_BOXING
+        [[nodiscard]] constexpr type object_type() const noexcept {
+            if ((m_bits & box_prefix) != box_prefix) {
+                return type::number;
+            }
+
+            const auto tag = static_cast<enum_base>((m_bits >> tag_shift) & 0x7);
+            return static_cast<type>(tag < static_cast<enum_base>(type::number) ? tag : tag + 1);
+        }
+
+        [[nodiscard]] constexpr size_t data() const noexcept {
+            if ((m_bits & box_prefix) != box_prefix) {
+                return m_bits;
+            }
+
+            // Integers are sign-extended from 48 bits; everything else is a zero-extended payload.
+            if (object_type() == type::integer) {
+                return static_cast<size_t>(static_cast<int64_t>(m_bits << 16) >> 16);
+            }
+
+            return m_bits & payload_mask;
+        }
+
+        [[nodiscard]] constexpr bool is_complex_type() const noexcept {
+            return (m_bits & complex_prefix) == complex_prefix;
+        }
+
+        // Checks a single type without decoding the tag.
+        [[nodiscard]] constexpr bool is_type(const type a_type) const noexcept {
+            if (a_type == type::number) {
+                return (m_bits & box_prefix) != box_prefix;
+            }
+
+            return (m_bits >> tag_shift) == (box(a_type, 0) >> tag_shift);
+        }
+
+        [[nodiscard]] constexpr integer get_integer() const noexcept {
+            return static_cast<integer>(m_bits << 16) >> 16;
+        }
+#else
         [[nodiscard]] constexpr type object_type() const noexcept {
             return m_type;
         }
 
+        [[nodiscard]] constexpr size_t data() const noexcept {
+            return m_data;
+        }
+
+        [[nodiscard]] constexpr bool is_complex_type() const noexcept {
+            return static_cast<size_t>(m_type) > static_cast<size_t>(simple_type_end_boundary);
+        }
+
+        [[nodiscard]] constexpr bool is_type(const type a_type) const noexcept {
+            return m_type == a_type;
+        }
+
+        [[nodiscard]] inline integer get_integer() const noexcept {
+            return static_cast<integer>(m_data);
+        }
+#endif
+
         [[nodiscard]] constexpr bool is_null() const noexcept {
-            return m_type == type::null;
+            return is_type(type::null);
         }
 
         [[nodiscard]] constexpr bool is_boolean() const noexcept {
-            return m_type == type::boolean;
+            return is_type(type::boolean);
         }
 
         [[nodiscard]] constexpr bool is_integer() const noexcept {
-            return m_type == type::integer;
+            return is_type(type::integer);
         }
 
         [[nodiscard]] constexpr bool is_function() const noexcept {
-            return m_type == type::function;
+            return is_type(type::function);
         }
 
         [[nodiscard]] constexpr bool is_number() const noexcept {
-            return m_type == type::number;
+            return is_type(type::number);
         }
 
         [[nodiscard]] constexpr bool is_string() const noexcept {
-            return m_type == type::string;
+            return is_type(type::string);
         }
 
         [[nodiscard]] constexpr bool is_table() const noexcept {
-            return m_type == type::table;
+            return is_type(type::table);
         }
 
         [[nodiscard]] constexpr bool is_array() const noexcept {
-            return m_type == type::table;
+            return is_type(type::array);
         }
 
         [[nodiscard]] constexpr bool is_native_object() const noexcept {
-            return m_type == type::native_object;
+            return is_type(type::native_object);
         }
 
         [[nodiscard]] constexpr bool is_simple_type() const noexcept {
-            return static_cast<size_t>(m_type) <= static_cast<size_t>(simple_type_end_boundary);
-        }
-
-        [[nodiscard]] constexpr bool is_complex_type() const noexcept {
-            return static_cast<size_t>(m_type) > static_cast<size_t>(simple_type_end_boundary);
+            return !is_complex_type();
         }
 
         [[nodiscard]] constexpr bool is_simply_comparable() const noexcept {
-            return static_cast<size_t>(m_type) <= static_cast<size_t>(simply_comparable_end_boundary);
+            return static_cast<size_t>(object_type()) <= static_cast<size_t>(simply_comparable_end_boundary);
         }
 
         [[nodiscard]] constexpr bool is_complexly_comparable() const noexcept {
-            return static_cast<size_t>(m_type) > static_cast<size_t>(simply_comparable_end_boundary);
-        }
-
-        [[nodiscard]] constexpr size_t data() const noexcept {
-            return m_data;
+            return static_cast<size_t>(object_type()) > static_cast<size_t>(simply_comparable_end_boundary);
         }
 
         [[nodiscard]] constexpr bool get_boolean() const noexcept {
-            return m_data != 0;
-        }
-
-        [[nodiscard]] inline integer get_integer() const noexcept {
-            return *reinterpret_cast<const integer*>(&m_data);
+            return data() != 0;
         }
 
         [[nodiscard]] function get_function(environment& a_environment) const noexcept {
-            return { a_environment, reinterpret_cast<const void*>(m_data) };
+            return { a_environment, reinterpret_cast<const void*>(data()) };
         }
 
         [[nodiscard]] number get_number() const noexcept {
-            return *reinterpret_cast<const number*>(&m_data);
+            const size_t bits = data();
+
+            number value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
         }
 
         [[nodiscard]] string get_string() const noexcept {
-            return string(reinterpret_cast<void*>(m_data));
+            return string(reinterpret_cast<void*>(data()));
         }
 
         [[nodiscard]] table& get_table() const noexcept {
-            return *reinterpret_cast<table*>(m_data);
+            return *reinterpret_cast<table*>(data());
         }
 
         [[nodiscard]] native_object get_native_object() noexcept {
-            return native_object{ reinterpret_cast<void*>(m_data) };
+            return native_object{ reinterpret_cast<void*>(data()) };
         }
 
         [[nodiscard]] array get_array() noexcept {
-            return *reinterpret_cast<array*>(&m_data);
+            const size_t root = data();
+            return *reinterpret_cast<const array*>(&root);
         }
 
         // TODO: Add functions for getting arrays.
@@ -200,7 +324,7 @@ namespace rebar {
         // Implementation may differ from get_boolean in the future;
         // make sure to use the proper version.
         [[nodiscard]] constexpr bool boolean_evaluate() const noexcept {
-            return m_data != 0;
+            return data() != 0;
         }
 
         [[nodiscard]] object length(environment& a_environment) noexcept;
@@ -209,10 +333,16 @@ namespace rebar {
         object call(environment& a_environment, t_objects&&... a_objects);
         object call(environment& a_environment, span<object> a_objects);
 
+        // Calls the object with the arguments of the environment's current frame (see argument_frame).
+        object invoke(environment& a_environment);
+
         template <typename... t_objects>
         object new_object(environment& a_environment, t_objects&&... a_objects);
         object new_object(environment& a_environment, span<object> a_objects);
 
+        // Constructs an instance of the object with the arguments of the environment's current frame.
+        object invoke_new(environment& a_environment);
+
         [[nodiscard]] object& index(environment& a_environment, const object rhs);
         [[nodiscard]] object select(environment& a_environment, const object rhs);
         [[nodiscard]] object select(environment& a_environment, const object rhs1, const object rhs2);
@@ -220,7 +350,7 @@ namespace rebar {
         [[nodiscard]] std::string to_string() noexcept;
 
         bool operator == (const type rhs) const noexcept {
-            return m_type == rhs;
+            return object_type() == rhs;
         }
 
         // TODO: Implement addition operations for remaining types.
@@ -287,7 +417,7 @@ namespace rebar {
         static object lesser_than_equal_to(environment& a_environment, object lhs, const object rhs);
 
         friend std::ostream& operator << (std::ostream& lhs, object rhs) noexcept {
-            switch (rhs.m_type) {
+            switch (rhs.object_type()) {
                 case type::null:
                     return (lhs << "null");
                 case type::boolean:
@@ -316,12 +446,12 @@ namespace rebar {
         void reference(object& a_object);
 
         [[nodiscard]] bool operator == (const object rhs) const noexcept {
-            if (m_type != rhs.m_type) {
+            if (object_type() != rhs.object_type()) {
                 return false;
             }
 
             if (is_simply_comparable()) {
-                return m_data == rhs.m_data;
+                return data() == rhs.data();
             }
 
             return false;
@@ -330,7 +460,7 @@ namespace rebar {
 
     using type = object::type;
 
-    inline object null { type::null, 0 };
+    inline const object null { type::null, 0 };
 }
 
 template <>
@@ -5,6 +5,8 @@
 #ifndef REBAR_OBJECT_IMPL_HPP
 #define REBAR_OBJECT_IMPL_HPP
 
+#include <functional>
+
 #include "object.hpp"
 
 #include "environment.hpp"
@@ -13,43 +15,24 @@
 namespace rebar {
     template <typename... t_objects>
     object object::call(environment& a_environment, t_objects&&... a_objects) {
-        switch (m_type) {
-            case type::function:
-                return get_function(a_environment).call(std::forward<t_objects>(a_objects)...);
-            case type::native_object: {
-                std::array<object, 16> temp = a_environment.get_args();
-
-                if constexpr (sizeof...(a_objects) > 0) {
-                    std::vector<object> args{ { std::forward<t_objects>(a_objects)... } };
-                    a_environment.set_args(args);
-                }
-
-                object result = get_native_object().overload_call(a_environment);
+        argument_frame frame(a_environment);
+        (frame.push(std::forward<t_objects>(a_objects)), ...);
+        frame.enter();
 
-                a_environment.set_args(temp);
-
-                return result;
-            }
-            default:
-                return {};
-        }
+        return invoke(a_environment);
     }
 
     object object::call(environment& a_environment, const span<object> a_objects) {
-        switch (m_type) {
-            case type::function:
-                return get_function(a_environment).call(a_objects);
-            case type::native_object: {
-                std::array<object, 16> temp = a_environment.get_args();
-
-                a_environment.set_args(a_objects);
-
-                object result = get_native_object().overload_call(a_environment);
-
-                a_environment.set_args(temp);
+        argument_frame frame(a_environment, a_objects);
+        return invoke(a_environment);
+    }
 
-                return result;
-            }
+    object object::invoke(environment& a_environment) {
+        switch (object_type()) {
+            case type::function:
+                return get_function(a_environment).invoke();
+            case type::native_object:
+                return get_native_object().overload_call(a_environment);
             default:
                 return {};
         }
@@ -57,52 +40,35 @@ namespace rebar {
 
     template <typename... t_objects>
     object object::new_object(environment& a_environment, t_objects&&... a_objects) {
-        switch (m_type) {
-            case type::native_object: {
-                std::array<object, 16> temp = a_environment.get_args();
+        argument_frame frame(a_environment);
+        (frame.push(std::forward<t_objects>(a_objects)), ...);
+        frame.enter();
 
-                if constexpr (sizeof...(a_objects) > 0) {
-                    std::vector<object> args{ { std::forward<t_objects>(a_objects)... } };
-                    a_environment.set_args(args);
-                }
-
-                object result = get_native_object().overload_new(a_environment);
-
-                a_environment.set_args(temp);
-
-                return result;
-            }
-            default:
-                return {};
-        }
+        return invoke_new(a_environment);
     }
 
     object object::new_object(environment& a_environment, const span<rebar::object> a_objects) {
-        switch (m_type) {
-            case type::native_object: {
-                std::array<object, 16> temp = a_environment.get_args();
-
-                a_environment.set_args(a_objects);
-
-                object result = get_native_object().overload_new(a_environment);
-
-                a_environment.set_args(temp);
+        argument_frame frame(a_environment, a_objects);
+        return invoke_new(a_environment);
+    }
 
-                return result;
-            }
+    object object::invoke_new(environment& a_environment) {
+        switch (object_type()) {
+            case type::native_object:
+                return get_native_object().overload_new(a_environment);
             default:
                 return {};
         }
     }
 
     std::string object::to_string() noexcept {
-        switch (m_type) {
+        switch (object_type()) {
             case type::null:
                 return "null";
             case type::boolean:
-                return m_data != 0 ? "true" : "false";
+                return data() != 0 ? "true" : "false";
             case type::integer:
-                return std::to_string(static_cast<integer>(m_data));
+                return std::to_string(static_cast<integer>(data()));
             case type::number:
                 return std::to_string(get_number());
             case type::string:
@@ -112,12 +78,12 @@ namespace rebar {
             case type::native_object:
                 return "NATIVE_OBJECT";
             default:
-                return std::to_string(m_data);
+                return std::to_string(data());
         }
     }
 
     object object::add(environment& a_environment, object lhs, object rhs) {
-        switch (lhs.m_type) {
+        switch (lhs.object_type()) {
             case type::null:
                 if (rhs.is_string()) {
                     std::string result{ "null" };
@@ -141,7 +107,7 @@ namespace rebar {
                     return lhs;
                 }
             case type::integer:
-                switch (rhs.m_type) {
+                switch (rhs.object_type()) {
                     case type::null:
                         return null;
                     case type::boolean:
@@ -165,7 +131,7 @@ namespace rebar {
             case type::function:
                 return null;
             case type::number:
-                switch (rhs.m_type) {
+                switch (rhs.object_type()) {
                     case type::null:
                         return null;
                     case type::boolean:
@@ -207,7 +173,7 @@ namespace rebar {
     }
 
     object object::multiply(environment& a_environment, object lhs, const object rhs) {
-        switch (lhs.m_type) {
+        switch (lhs.object_type()) {
             case type::null:
                 return null;
             case type::boolean:
@@ -217,7 +183,7 @@ namespace rebar {
                     return null;
                 }
             case type::integer:
-                switch (rhs.m_type) {
+                switch (rhs.object_type()) {
                     case type::null:
                         return null;
                     case type::boolean:
@@ -237,7 +203,7 @@ namespace rebar {
             case type::function:
                 return null;
             case type::number:
-                switch (rhs.m_type) {
+                switch (rhs.object_type()) {
                     case type::null:
                         return null;
                     case type::boolean:
@@ -281,7 +247,7 @@ namespace rebar {
     }
 
     object object::subtract(environment& a_environment, object lhs, const object rhs) {
-        switch (lhs.m_type) {
+        switch (lhs.object_type()) {
             case type::null:
                 return null;
             case type::boolean:
@@ -291,7 +257,7 @@ namespace rebar {
                     return null;
                 }
             case type::integer:
-                switch (rhs.m_type) {
+                switch (rhs.object_type()) {
                     case type::null:
                         return null;
                     case type::boolean:
@@ -311,7 +277,7 @@ namespace rebar {
             case type::function:
                 return null;
             case type::number:
-                switch (rhs.m_type) {
+                switch (rhs.object_type()) {
                     case type::null:
                         return null;
                     case type::boolean:
@@ -338,12 +304,12 @@ namespace rebar {
     }
 
     object object::divide(environment& a_environment, object lhs, const object rhs) {
-        switch (lhs.m_type) {
+        switch (lhs.object_type()) {
             case type::null:
             case type::boolean:
                 return null;
             case type::integer:
-                switch (rhs.m_type) {
+                switch (rhs.object_type()) {
                     case type::null:
                     case type::boolean:
                         return null;
@@ -362,7 +328,7 @@ namespace rebar {
             case type::function:
                 return {};
             case type::number:
-                switch (rhs.m_type) {
+                switch (rhs.object_type()) {
                     case type::null:
                     case type::boolean:
                         return null;
@@ -388,7 +354,7 @@ namespace rebar {
     }
 
     object object::modulus(environment& a_environment, object lhs, const object rhs) {
-        switch (lhs.m_type) {
+        switch (lhs.object_type()) {
             case type::null:
             case type::boolean:
             case type::integer:
@@ -415,13 +381,13 @@ namespace rebar {
     }
 
     object object::exponentiate(environment& a_environment, object lhs, const object rhs) {
-        switch (lhs.m_type) {
+        switch (lhs.object_type()) {
             case type::null:
                 return null;
             case type::boolean:
                 return null;
             case type::integer:
-                switch (rhs.m_type) {
+                switch (rhs.object_type()) {
                     case type::null:
                     case type::boolean:
                         return null;
@@ -440,7 +406,7 @@ namespace rebar {
             case type::function:
                 return null;
             case type::number:
-                switch (rhs.m_type) {
+                switch (rhs.object_type()) {
                     case type::null:
                     case type::boolean:
                         return null;
@@ -466,14 +432,14 @@ namespace rebar {
     }
 
     object object::equals(environment& a_environment, object lhs, const object rhs) {
-        if (lhs.m_type != rhs.m_type) {
+        if (lhs.object_type() != rhs.object_type()) {
             return false;
         }
 
         if (lhs.is_simply_comparable()) {
-            return lhs.m_data == rhs.m_data;
+            return lhs.data() == rhs.data();
         } else {
-            switch (lhs.m_type) {
+            switch (lhs.object_type()) {
                 case type::native_object:
                     return lhs.get_native_object().overload_equality(a_environment, rhs);
             }
@@ -485,14 +451,14 @@ namespace rebar {
     }
 
     object object::not_equals(environment& a_environment, object lhs, const object rhs) {
-        if (lhs.m_type != rhs.m_type) {
+        if (lhs.object_type() != rhs.object_type()) {
             return true;
         }
 
         if (lhs.is_simply_comparable()) {
-            return lhs.m_data != rhs.m_data;
+            return lhs.data() != rhs.data();
         } else {
-            switch (lhs.m_type) {
+            switch (lhs.object_type()) {
                 case type::native_object:
                     return lhs.get_native_object().overload_inverse_equality(a_environment, rhs);
             }
@@ -505,7 +471,7 @@ namespace rebar {
 
     object object::shift_left(environment& a_environment, object lhs, const object rhs) {
         if (rhs.is_integer() && (lhs.is_integer() || lhs.is_number())) {
-            return { lhs.m_type, lhs.m_data << rhs.get_integer() };
+            return { lhs.object_type(), lhs.data() << rhs.get_integer() };
         } else {
             if (lhs.is_native_object()) {
                 return lhs.get_native_object().overload_shift_left(a_environment, rhs);
@@ -519,7 +485,7 @@ namespace rebar {
 
     object object::shift_right(environment& a_environment, object lhs, const object rhs) {
         if (rhs.is_integer() && (lhs.is_integer() || lhs.is_number())) {
-            return { lhs.m_type, lhs.m_data >> rhs.get_integer() };
+            return { lhs.object_type(), lhs.data() >> rhs.get_integer() };
         } else {
             if (lhs.is_native_object()) {
                 return lhs.get_native_object().overload_shift_right(a_environment, rhs);
@@ -533,7 +499,7 @@ namespace rebar {
 
     object object::bitwise_xor(environment& a_environment, object lhs, const object rhs) {
         if ((lhs.is_integer() || lhs.is_number()) && (rhs.is_integer() || rhs.is_number())) {
-            return { lhs.m_type, lhs.m_data ^ rhs.m_data };
+            return { lhs.object_type(), lhs.data() ^ rhs.data() };
         } else {
             if (lhs.is_native_object()) {
                 return lhs.get_native_object().overload_bitwise_xor(a_environment, rhs);
@@ -547,7 +513,7 @@ namespace rebar {
 
     object object::bitwise_or(environment& a_environment, object lhs, const object rhs) {
         if ((lhs.is_integer() || lhs.is_number()) && (rhs.is_integer() || rhs.is_number())) {
-            return { lhs.m_type, lhs.m_data | rhs.m_data };
+            return { lhs.object_type(), lhs.data() | rhs.data() };
         } else {
             if (lhs.is_native_object()) {
                 return lhs.get_native_object().overload_bitwise_or(a_environment, rhs);
@@ -561,7 +527,7 @@ namespace rebar {
 
     object object::bitwise_and(environment& a_environment, object lhs, const object rhs) {
         if ((lhs.is_integer() || lhs.is_number()) && (rhs.is_integer() || rhs.is_number())) {
-            return { lhs.m_type, lhs.m_data | rhs.m_data };
+            return { lhs.object_type(), lhs.data() | rhs.data() };
         } else {
             if (lhs.is_native_object()) {
                 return lhs.get_native_object().overload_bitwise_and(a_environment, rhs);
@@ -575,7 +541,7 @@ namespace rebar {
 
     object object::bitwise_not(environment& a_environment, object lhs) {
         if (lhs.is_integer() || lhs.is_number()) {
-            return { lhs.m_type, ~lhs.m_data };
+            return { lhs.object_type(), ~lhs.data() };
         } else {
             if (lhs.is_native_object()) {
                 return lhs.get_native_object().overload_bitwise_not(a_environment);
@@ -611,103 +577,107 @@ namespace rebar {
         }
     }
 
-    object object::greater_than(environment& a_environment, object lhs, const object rhs) {
-        if (lhs.is_integer()) {
-            if (rhs.is_integer()) {
-                return lhs.get_integer() > rhs.get_integer();
-            } else if (rhs.is_number()) {
-                return lhs.get_integer() > rhs.get_number();
-            } else if (rhs.is_string()) {
-                return lhs.get_integer() > rhs.get_string().length();
-            }
-        } else if (lhs.is_number()) {
-            if (rhs.is_integer()) {
-                return lhs.get_number() > rhs.get_integer();
-            } else if (rhs.is_number()) {
-                return lhs.get_number() > rhs.get_number();
-            }
-        } else if (lhs.is_string()) {
-            if (rhs.is_integer()) {
-                return (lhs.get_string().length() > rhs.get_integer());
+    namespace detail {
+        // Orders integers and numbers by value, and strings against integers by length. Comparisons yield the
+        // integers 1 and 0 on every provider; operands that cannot be ordered yield a_unordered.
+        template <typename t_compare>
+        [[nodiscard]] object compare_ordered(const object& lhs, const object& rhs, const object a_unordered, const t_compare a_compare) {
+            const auto result = [&a_compare](const auto a_lhs, const auto a_rhs) {
+                return object(static_cast<integer>(a_compare(a_lhs, a_rhs)));
+            };
+
+            if (lhs.is_integer()) {
+                if (rhs.is_integer()) {
+                    return result(lhs.get_integer(), rhs.get_integer());
+                } else if (rhs.is_number()) {
+                    return result(static_cast<number>(lhs.get_integer()), rhs.get_number());
+                } else if (rhs.is_string()) {
+                    return result(lhs.get_integer(), static_cast<integer>(rhs.get_string().length()));
+                }
+            } else if (lhs.is_number()) {
+                if (rhs.is_integer()) {
+                    return result(lhs.get_number(), static_cast<number>(rhs.get_integer()));
+                } else if (rhs.is_number()) {
+                    return result(lhs.get_number(), rhs.get_number());
+                }
+            } else if (lhs.is_string()) {
+                if (rhs.is_integer()) {
+                    return result(static_cast<integer>(lhs.get_string().length()), rhs.get_integer());
+                }
             }
-        } else if (lhs.is_native_object()) {
+
+            // TODO: Throw invalid operation exception.
+            return a_unordered;
+        }
+    }
+
+    object object::greater_than(environment& a_environment, object lhs, const object rhs) {
+        if (lhs.is_native_object()) {
             return lhs.get_native_object().overload_greater(a_environment, rhs);
         }
 
-        // TODO: Throw invalid operation exception.
-        // TODO: Provide overload for native objects.
-        return null;
+        return detail::compare_ordered(lhs, rhs, null, std::greater<>());
     }
 
     object object::lesser_than(environment& a_environment, object lhs, const object rhs) {
-        if (lhs.is_integer()) {
-            if (rhs.is_integer()) {
-                return lhs.get_integer() < rhs.get_integer();
-            } else if (rhs.is_number()) {
-                return lhs.get_integer() < rhs.get_number();
-            } else if (rhs.is_string()) {
-                return lhs.get_integer() < rhs.get_string().length();
-            }
-        } else if (lhs.is_number()) {
-            if (rhs.is_integer()) {
-                return lhs.get_number() < rhs.get_integer();
-            } else if (rhs.is_number()) {
-                return lhs.get_number() < rhs.get_number();
-            }
-        } else if (lhs.is_string()) {
-            if (rhs.is_integer()) {
-                return (lhs.get_string().length() < rhs.get_integer());
-            }
-        } else if (lhs.is_native_object()) {
+        if (lhs.is_native_object()) {
             return lhs.get_native_object().overload_lesser(a_environment, rhs);
         }
 
-        // TODO: Throw invalid operation exception.
-        // TODO: Provide overload for native objects.
-        return false;
+        return detail::compare_ordered(lhs, rhs, object(static_cast<integer>(0)), std::less<>());
     }
 
     object object::greater_than_equal_to(environment& a_environment, object lhs, const object rhs) {
         if (lhs.is_native_object()) {
             return lhs.get_native_object().overload_greater_equality(a_environment, rhs);
-        } else {
-            return !(rhs < rhs);
         }
+
+        return detail::compare_ordered(lhs, rhs, null, std::greater_equal<>());
     }
 
     object object::lesser_than_equal_to(environment& a_environment, object lhs, const object rhs) {
         if (lhs.is_native_object()) {
             return lhs.get_native_object().overload_lesser_equality(a_environment, rhs);
-        } else {
-            return !(rhs > rhs);
         }
+
+        return detail::compare_ordered(lhs, rhs, null, std::less_equal<>());
     }
 
     object& object::index(environment& a_environment, const object rhs) {
-        switch (m_type) {
+        switch (object_type()) {
             case type::null:
                 std::cout << "NULL INDEX" << std::endl;
-                return null;
+                return a_environment.null_slot();
             case type::array:
                 if (rhs.is_integer()) {
                     return get_array()[static_cast<size_t>(rhs.get_integer())];
                 } else {
                     // TODO: Throw invalid operand exception.
-                    return null;
+                    return a_environment.null_slot();
                 }
             case type::table:
                 return get_table()[rhs];
-            case type::native_object:
-                return get_native_object().overload_index(a_environment, rhs);
+            case type::native_object: {
+                native_object native = get_native_object();
+                virtual_table& methods = native.get_virtual_table();
+
+                if (methods.overload_operation_index == virtual_table::null_idx && !methods.m_fields.empty()) {
+                    if (auto found = methods.m_fields.find(rhs); found != methods.m_fields.cend() && found->second.m_reference != nullptr) {
+                        return found->second.m_reference(native);
+                    }
+                }
+
+                return native.overload_index(a_environment, rhs);
+            }
             default:
                 // TODO: Throw invalid operation exception.
                 // TODO: Implement overload for native objects.
-                return null;
+                return a_environment.null_slot();
         }
     }
 
     object object::select(environment& a_environment, const object rhs) {
-        switch (m_type) {
+        switch (object_type()) {
             case type::string:
                 if (rhs.is_integer()) {
                     return static_cast<integer>(get_string().c_str()[static_cast<size_t>(rhs.get_integer())]);
@@ -727,8 +697,22 @@ namespace rebar {
                     return null;
                 }
             case type::native_object: {
-                object obj = get_native_object().overload_select(a_environment, rhs);
-                return obj ? obj : get_native_object().get_virtual_table().index(rhs);
+                native_object native = get_native_object();
+                object obj = native.overload_select(a_environment, rhs);
+
+                if (obj) {
+                    return obj;
+                }
+
+                virtual_table& methods = native.get_virtual_table();
+
+                if (!methods.m_fields.empty()) {
+                    if (auto found = methods.m_fields.find(rhs); found != methods.m_fields.cend()) {
+                        return found->second.m_get(&a_environment, native);
+                    }
+                }
+
+                return methods.index(rhs);
             }
             default:
                 // TODO: Throw invalid operation exception.
@@ -738,7 +722,7 @@ namespace rebar {
     }
 
     object object::select(environment& a_environment, const object rhs1, const object rhs2) {
-        switch (m_type) {
+        switch (object_type()) {
             case type::string:
                 if (rhs1.is_integer() && rhs2.is_integer()) {
                     auto target_string = get_string().to_string_view();
@@ -789,7 +773,7 @@ namespace rebar {
     }
 
     object object::length(environment& a_environment) noexcept {
-        switch (m_type) {
+        switch (object_type()) {
             case type::string:
                 return static_cast<integer>(get_string().length());
             case type::array:
@@ -802,7 +786,7 @@ namespace rebar {
     }
 
     void object::dereference(object& a_object) {
-        switch (a_object.m_type) {
+        switch (a_object.object_type()) {
             case type::string:
                 a_object.get_string().dereference();
                 break;
@@ -824,7 +808,7 @@ namespace rebar {
     }
 
     void object::reference(object& a_object) {
-        switch (a_object.m_type) {
+        switch (a_object.object_type()) {
             case type::string:
                 a_object.get_string().reference();
                 break;
@@ -26,13 +26,13 @@ namespace rebar {
                 separator_info(0,  false), // "SPACE"sv,
                 separator_info(1,  false), // "ASSIGNMENT"sv,
                 separator_info(5,  false), // "ADDITION"sv,
-                separator_info(2,  false), // "ADDITION ASSIGNMENT"sv,
+                separator_info(1,  false), // "ADDITION ASSIGNMENT"sv,
                 separator_info(6,  false), // "MULTIPLICATION"sv,
                 separator_info(1,  false), // "MULTIPLICATION ASSIGNMENT"sv,
                 separator_info(6,  false), // "DIVISION"sv,
-                separator_info(2,  false), // "DIVISION ASSIGNMENT"sv,
+                separator_info(1,  false), // "DIVISION ASSIGNMENT"sv,
                 separator_info(5,  false), // "SUBTRACTION"sv,
-                separator_info(2,  false), // "SUBTRACTION ASSIGNMENT"sv,
+                separator_info(1,  false), // "SUBTRACTION ASSIGNMENT"sv,
                 separator_info(9,  true),  // "INCREMENT"sv,
                 separator_info(9,  true),  // "DECREMENT"sv,
                 separator_info(10, false), // "OPEN GROUP"sv,
@@ -79,6 +79,28 @@ namespace rebar {
 
         return separator_infos[static_cast<size_t>(a_separator)];
     }
+
+    // Assignments and the ternary operator group to the right, so "a = b = c" assigns c to b, then to a.
+    [[nodiscard]] constexpr bool is_right_associative(const separator a_separator) noexcept {
+        switch (a_separator) {
+            case separator::assignment:
+            case separator::addition_assignment:
+            case separator::multiplication_assignment:
+            case separator::division_assignment:
+            case separator::subtraction_assignment:
+            case separator::bitwise_or_assignment:
+            case separator::bitwise_xor_assignment:
+            case separator::bitwise_and_assignment:
+            case separator::shift_right_assignment:
+            case separator::shift_left_assignment:
+            case separator::exponent_assignment:
+            case separator::modulus_assignment:
+            case separator::ternary:
+                return true;
+            default:
+                return false;
+        }
+    }
 }
 
 #endif //REBAR_OPERATOR_PRECEDENCE_HPP
@@ -5,6 +5,12 @@
 #ifndef REBAR_PARSER_HPP
 #define REBAR_PARSER_HPP
 
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 #include <variant>
 
@@ -50,12 +56,36 @@ namespace rebar {
             }
 
             abstract_syntax_tree(separator a_operation, node lhs, node rhs) noexcept : m_operation(a_operation) {
-                m_operands.emplace_back(lhs);
-                m_operands.emplace_back(rhs);
+                m_operands.emplace_back(std::move(lhs));
+                m_operands.emplace_back(std::move(rhs));
             }
 
             explicit abstract_syntax_tree(const separator a_operation) noexcept : m_operation(a_operation) {}
 
+            abstract_syntax_tree(const abstract_syntax_tree& a_tree) = default;
+            abstract_syntax_tree(abstract_syntax_tree&& a_tree) noexcept = default;
+
+            abstract_syntax_tree& operator=(const abstract_syntax_tree& a_tree) = default;
+            abstract_syntax_tree& operator=(abstract_syntax_tree&& a_tree) noexcept = default;
+
+            // Nested expressions are emptied into a work list first, so that long operator chains are not
+            // destroyed recursively.
+            ~abstract_syntax_tree() {
+                std::vector<node> pending;
+
+                while (!m_operands.empty()) {
+                    for (node& operand : m_operands) {
+                        if (auto* nested = std::get_if<abstract_syntax_tree>(&operand.m_data)) {
+                            std::move(nested->m_operands.begin(), nested->m_operands.end(), std::back_inserter(pending));
+                            nested->m_operands.clear();
+                        }
+                    }
+
+                    m_operands.clear();
+                    m_operands.swap(pending);
+                }
+            }
+
             [[nodiscard]] bool empty() const noexcept {
                 return m_operands.empty();
             }
@@ -722,822 +752,647 @@ namespace rebar {
     }
     */
 
-    [[nodiscard]] node::group parse_group(const span<token> a_tokens) noexcept;
-
-    [[nodiscard]] node::argument_list parse_arguments(const span<token> a_tokens) noexcept {
-        std::vector<node::group> groups;
-
-        span<token>::iterator last_token = a_tokens.begin();
-
-        for (size_t i = 0; i < a_tokens.size(); ++i) {
-            span<token>::iterator next_token = find_next(a_tokens.subspan(i), separator::list, separator::group_open, separator::group_close);
+    // Single-pass recursive-descent parser. Brackets are matched as they are reached rather than located ahead of
+    // time, and binary operators are folded by precedence climbing over operator_precedence.hpp, so every token is
+    // visited once. Operators of equal precedence associate to the left, apart from assignments and the ternary
+    // operator (see is_right_associative). Prefix and postfix operators apply to a whole member/call chain, and
+    // member access, calls and indexing fold left to right.
+    class parser {
+        // Result of parsing an operand or (sub)expression. m_single marks an expression made of a single node,
+        // which is stored as the only operand of m_expression and used as-is wherever it is nested.
+        struct operand {
+            node::expression m_expression;
+            bool m_single = false;
+        };
 
-            if (next_token == a_tokens.end()) {
-                groups.emplace_back(parse_group(a_tokens.subspan(i)));
-                break;
-            }
+        span<token> m_tokens;
+        size_t m_index = 0;
 
-            span<token>::iterator::difference_type difference = std::distance(next_token, last_token);
+        // Set inside selectors and ternary branches, where ':' closes an expression instead of being an operator.
+        bool m_seek_closes = false;
 
-            groups.emplace_back(parse_group(a_tokens.subspan(i, difference)));
+        // Set while parsing a function identifier, which ends at its parameter list.
+        bool m_group_closes = false;
 
-            i += difference;
+        // Statements, bracketed expressions, prefix operators and right-associative operands nest by recursion.
+        // Past max_nesting the rest of the tokens is skipped and too_deep() is set.
+        size_t m_nesting = 0;
+        bool m_too_deep = false;
 
-            last_token = next_token + 1;
-        }
+        // Counts one level of nesting for as long as it lives.
+        class nesting_guard {
+            parser& m_parser;
 
-        return groups;
-    }
-
-    [[nodiscard]] node::abstract_syntax_tree parse_ast(const span<node>& a_nodes) {
-        if (a_nodes.empty()) {
-            return {};
-        } else if (a_nodes.size() == 1) {
-            return node::abstract_syntax_tree{ { a_nodes[0] } };
-        } else if (a_nodes.size() == 2) {
-            if (a_nodes[0].is_token()) {
-                const auto &first_operand = a_nodes[0].get_token();
-
-                if (first_operand.is_separator()) {
-                    switch (first_operand.get_separator()) {
-                        case separator::increment: {
-                            node::abstract_syntax_tree ast{ separator::operation_prefix_increment };
-                            ast.add_operand(a_nodes[1]);
-                            return ast;
-                        }
-                        case separator::decrement: {
-                            node::abstract_syntax_tree ast{ separator::operation_prefix_decrement };
-                            ast.add_operand(a_nodes[1]);
-                            return ast;
-                        }
-                        case separator::logical_not: {
-                            node::abstract_syntax_tree ast{ separator::logical_not };
-                            ast.add_operand(a_nodes[1]);
-                            return ast;
-                        }
-                        case separator::bitwise_not: {
-                            node::abstract_syntax_tree ast{ separator::bitwise_not };
-                            ast.add_operand(a_nodes[1]);
-                            return ast;
-                        }
-                        case separator::new_object: {
-                            node::abstract_syntax_tree ast{ separator::new_object };
-                            ast.add_operand(a_nodes[1]);
-                            return ast;
-                        }
-                        default:
-                            break;
-                    }
+        public:
+            explicit nesting_guard(parser& a_parser) noexcept : m_parser(a_parser) {
+                if (++m_parser.m_nesting > max_nesting) {
+                    m_parser.m_too_deep = true;
+                    m_parser.m_index = m_parser.m_tokens.size();
                 }
             }
 
-            if (a_nodes[1].is_token()) {
-                const auto &second_operand = a_nodes[1].get_token();
-
-                if (second_operand.is_separator()) {
-                    switch (second_operand.get_separator()) {
-                        case separator::increment: {
-                            node::abstract_syntax_tree ast{ separator::operation_postfix_increment };
-                            ast.add_operand(a_nodes[0]);
-                            return ast;
-                        }
-                        case separator::decrement: {
-                            node::abstract_syntax_tree ast{ separator::operation_postfix_decrement };
-                            ast.add_operand(a_nodes[0]);
-                            return ast;
-                        }
-                        default:
-                            break;
-                    }
-                }
-            } else if (a_nodes[1].is_group()) {
-                return {
-                        separator::operation_call,
-                        a_nodes[0],
-                        a_nodes[1]
-                };
-            } else if (a_nodes[1].is_argument_list()) {
-                node::abstract_syntax_tree ast{ separator::operation_call };
-                ast.add_operand(a_nodes[0]);
-
-                for (const auto& arg : a_nodes[1].get_argument_list()) {
-                    ast.add_operand({ node::type::expression, arg });
-                }
+            nesting_guard(const nesting_guard&) = delete;
+            nesting_guard& operator=(const nesting_guard&) = delete;
 
-                return ast;
-            } else if (a_nodes[1].is_selector()) {
-                return {
-                        separator::operation_index,
-                        a_nodes[0],
-                        { node::type::expression, a_nodes[1].get_selector() }
-                };
-            } else if (a_nodes[1].is_ranged_selector()) {
-                node::abstract_syntax_tree ast{ separator::operation_index };
-                ast.add_operand(a_nodes[0]);
-
-                const auto& ranged = a_nodes[1].get_ranged_selector();
-
-                ast.add_operand({ node::type::expression, ranged.first });
-                ast.add_operand({ node::type::expression, ranged.second });
-
-                return ast;
+            ~nesting_guard() {
+                --m_parser.m_nesting;
             }
-        }
-
-        const auto found = std::find_if(a_nodes.begin(), a_nodes.end(), [](const node& a_node) noexcept -> bool {
-            return a_node.is_token() && a_node.get_token().is_separator();
-        });
+        };
 
-        if (found == a_nodes.cend()) {
-            bool flags = true;
+    public:
+        static constexpr size_t max_nesting = 256;
 
-            for (auto it = a_nodes.begin(); it != a_nodes.cend() - 1; ++it) {
-                if (it->is_token()) {
-                    const auto& tok = it->get_token();
+        explicit parser(const span<token> a_tokens) noexcept : m_tokens(a_tokens) {}
 
-                    if (tok.is_keyword()) {
-                        const auto kw = tok.get_keyword();
+        // Whether nesting went past max_nesting, leaving the tokens after that point unparsed.
+        [[nodiscard]] bool too_deep() const noexcept {
+            return m_too_deep;
+        }
 
-                        if (kw != keyword::local && kw != keyword::constant && kw != keyword::function) {
-                            flags = false;
-                            break;
-                        }
-                    }
-                }
-            }
+        [[nodiscard]] node::block parse_block() noexcept {
+            node::block nodes;
 
-            if (flags) {
-                node::abstract_syntax_tree ast{ separator::space };
+            while (true) {
+                parse_statements(nodes);
 
-                for (const auto& n : a_nodes) {
-                    ast.add_operand(n);
+                if (at_end()) {
+                    break;
                 }
 
-                return ast;
+                // Unmatched closing brace.
+                ++m_index;
             }
 
-            // TODO: Throw error--invalid expression.
+            return nodes;
         }
 
-        size_t min_precedence = get_separator_info(found->get_token().get_separator()).precedence();
-        auto min_separator_it = found;
-
-        for (auto it = min_separator_it; it != a_nodes.cend(); ++it) {
-            if (it->is_token()) {
-                const auto &tok = it->get_token();
-
-                if (tok.is_separator()) {
-                    separator_info info = get_separator_info(tok.get_separator());
-                    min_precedence = std::min(min_precedence, info.precedence());
+        [[nodiscard]] node::expression parse_expression() noexcept {
+            const nesting_guard guard(*this);
+            return to_expression(parse_binary(1));
+        }
 
-                    if (info.precedence() == min_precedence) {
-                        min_separator_it = it;
-                    }
-                }
-            }
+    private:
+        [[nodiscard]] bool at_end() const noexcept {
+            return m_index >= m_tokens.size();
         }
 
-        separator sep = min_separator_it->get_token().get_separator();
-        separator_info info = get_separator_info(sep);
+        [[nodiscard]] bool is(const separator a_separator) const noexcept {
+            return !at_end() && m_tokens[m_index] == a_separator;
+        }
 
-        const auto& begin_node = *a_nodes.begin();
-        const auto& end_node = *(a_nodes.end() - 1);
+        [[nodiscard]] bool is(const keyword a_keyword) const noexcept {
+            return !at_end() && m_tokens[m_index] == a_keyword;
+        }
 
-        if (info.has_single_operand()) {
-            node::abstract_syntax_tree ast{ sep };
+        [[nodiscard]] bool next_is(const separator a_separator) const noexcept {
+            return m_index + 1 < m_tokens.size() && m_tokens[m_index + 1] == a_separator;
+        }
 
-            if (begin_node.is_token() && begin_node.get_token() == sep) {
-                ast.add_operand(a_nodes.size() == 2 ? end_node : node{ node::type::expression, parse_ast(a_nodes.subspan(1)) });
-            } else if (end_node.is_token() && end_node.get_token() == sep) {
-                ast.add_operand(a_nodes.size() == 2 ? begin_node : node{ node::type::expression, parse_ast(a_nodes.subspan(0, a_nodes.size() - 1)) });
+        void skip(const separator a_separator) noexcept {
+            if (is(a_separator)) {
+                ++m_index;
             }
-
-            return ast;
         }
 
-        if ((end_node.is_group() || end_node.is_selector() || end_node.is_ranged_selector() || end_node.is_expression() || end_node.is_argument_list()) && !((a_nodes.end() - 2)->is_token() && (a_nodes.end() - 2)->get_token().is_separator())) {
-            if (min_precedence >= get_separator_info(separator::group_open).precedence()) {
-                span<node> lhs_nodes(a_nodes.begin(), a_nodes.end() - 1);
-                node lhs = (lhs_nodes.size() == 1) ? lhs_nodes[0] : node(node::type::expression, parse_ast(lhs_nodes));
-
-                if (end_node.is_group()) {
-                    return {
-                            separator::operation_call,
-                            lhs,
-                            end_node
-                    };
-                } else if (end_node.is_argument_list()) {
-                    const auto& args = end_node.get_argument_list();
+        [[nodiscard]] static operand single(node a_node) noexcept {
+            operand result{ {}, true };
+            result.m_expression.add_operand(std::move(a_node));
 
-                    node::abstract_syntax_tree ast{ separator::operation_call };
-
-                    ast.add_operand(lhs);
+            return result;
+        }
 
-                    for (const auto& arg : args) {
-                        ast.add_operand({ node::type::expression, arg });
-                    }
+        [[nodiscard]] static node to_node(operand a_operand) noexcept {
+            if (a_operand.m_single) {
+                return std::move(a_operand.m_expression.m_operands.front());
+            }
 
-                    return ast;
-                } else if (end_node.is_selector()) {
-                    return {
-                            separator::operation_index,
-                            lhs,
-                            end_node
-                    };
-                } else if (end_node.is_ranged_selector()) {
-                    const auto& ranged = end_node.get_ranged_selector();
+            return { node::type::expression, std::move(a_operand.m_expression) };
+        }
 
-                    node::abstract_syntax_tree ast{ separator::operation_index };
+        [[nodiscard]] static node::expression to_expression(operand a_operand) noexcept {
+            return std::move(a_operand.m_expression);
+        }
 
-                    ast.add_operand(lhs);
-                    ast.add_operand({ node::type::expression, ranged.first });
-                    ast.add_operand({ node::type::expression, ranged.second });
+        // STATEMENTS
 
-                    return ast;
-                }
+        // Parses statements up to the end of the tokens or a closing brace, which is left unconsumed.
+        void parse_statements(node::block& a_nodes) noexcept {
+            while (!at_end() && !is(separator::scope_close)) {
+                parse_statement(a_nodes);
             }
         }
 
-        span<node> lhs_nodes(a_nodes.begin(), min_separator_it);
-        span<node> rhs_nodes(min_separator_it + 1, a_nodes.end());
-
-        node lhs = lhs_nodes.size() == 1 ? lhs_nodes[0] : node{ node::type::expression, parse_ast(lhs_nodes) };
-
-        if (sep == separator::ternary) {
-            node::abstract_syntax_tree ast{ sep };
+        // Body of a control statement: a braced block or a single statement.
+        [[nodiscard]] node::block parse_body() noexcept {
+            node::block body;
 
-            ast.add_operand(lhs);
-
-            span<node>::iterator ternary_break_find = find_next(rhs_nodes, [](const node& a_node) noexcept -> bool {
-                return a_node.is_token() && a_node.get_token() == separator::seek;
-            }, [](const node& a_node) noexcept -> find_next_exclude {
-                if (a_node.is_token()) {
-                    const auto& tok = a_node.get_token();
-
-                    if (tok == separator::ternary) {
-                        return find_next_exclude::open;
-                    } else if (tok == separator::seek) {
-                        return find_next_exclude::close;
-                    }
-                }
-            });
-
-            span<node> ternary_lhs_nodes(min_separator_it + 1, ternary_break_find);
-            span<node> ternary_rhs_nodes(ternary_break_find + 1, rhs_nodes.end());
-
-            node lhs = ternary_lhs_nodes.size() == 1 ? ternary_lhs_nodes[0] : node{ node::type::expression, parse_ast(ternary_lhs_nodes) };
-            node rhs = ternary_rhs_nodes.size() == 1 ? ternary_rhs_nodes[0] : node{ node::type::expression, parse_ast(ternary_rhs_nodes) };
-
-            ast.add_operand(lhs);
-            ast.add_operand(rhs);
+            if (is(separator::scope_open)) {
+                ++m_index;
+                parse_statements(body);
+                skip(separator::scope_close);
+            } else if (!at_end() && !is(separator::scope_close)) {
+                parse_statement(body);
+            }
 
-            return ast;
+            return body;
         }
 
-        node rhs = rhs_nodes.size() == 1 ? rhs_nodes[0] : node{ node::type::expression, parse_ast(rhs_nodes) };
+        // Parenthesized condition of an if/else if/while statement.
+        [[nodiscard]] node::group parse_condition() noexcept {
+            skip(separator::group_open);
+            node::group conditional = parse_enclosed();
+            skip(separator::group_close);
 
-        return { sep, lhs, rhs };
-    }
-
-    // Routine to parse groups.
-    [[nodiscard]] node::group parse_group(const span<token> a_tokens) noexcept {
-        std::vector<node> nodes;
-
-        for (size_t i = 0; i < a_tokens.size(); ++i) {
-            const token& tok = a_tokens[i];
+            return conditional;
+        }
 
-            if (tok == separator::group_open) {
-                // Parsing group.
+        void parse_statement(node::block& a_nodes) noexcept {
+            const nesting_guard guard(*this);
 
-                span<token>::iterator end_group = find_next(a_tokens.subspan(i + 1), separator::group_close, separator::group_open, separator::group_close);
+            if (at_end()) {
+                return;
+            }
 
-                span<token> captured_tokens(a_tokens.begin() + i + 1, end_group);
+            const size_t statement_start = m_index;
+            const token& tok = m_tokens[m_index];
 
-                span<token>::iterator arg_list_token = find_next(captured_tokens, separator::list, [](const token& a_token) noexcept -> find_next_exclude {
-                    if (a_token == separator::group_open || a_token == separator::selector_open || a_token == separator::scope_open) {
-                        return find_next_exclude::open;
-                    } else if (a_token == separator::group_close || a_token == separator::selector_close || a_token == separator::scope_close) {
-                        return find_next_exclude::close;
-                    } else {
-                        return find_next_exclude::none;
-                    }
-                });
+            if (tok == keyword::if_statement && next_is(separator::group_open)) {
+                ++m_index;
+                node::group conditional = parse_condition();
+                a_nodes.emplace_back(node::type::if_declaration, node::if_declaration(std::move(conditional), parse_body()));
+            } else if (tok == keyword::else_statement) {
+                ++m_index;
 
-                if (arg_list_token != captured_tokens.cend()) {
-                    nodes.emplace_back(node::type::argument_list, parse_arguments(captured_tokens));
+                if (is(keyword::if_statement) && next_is(separator::group_open)) {
+                    ++m_index;
+                    node::group conditional = parse_condition();
+                    a_nodes.emplace_back(node::type::else_if_declaration, node::else_if_declaration(std::move(conditional), parse_body()));
                 } else {
-                    nodes.emplace_back(node::type::group, parse_group(captured_tokens));
+                    a_nodes.emplace_back(node::type::else_declaration, parse_body());
+                }
+            } else if (tok == keyword::while_loop && next_is(separator::group_open)) {
+                ++m_index;
+                node::group conditional = parse_condition();
+                a_nodes.emplace_back(node::type::while_declaration, node::while_declaration(std::move(conditional), parse_body()));
+            } else if (tok == keyword::for_loop && next_is(separator::group_open)) {
+                m_index += 2;
+
+                node::group initialization = parse_enclosed();
+                skip(separator::end_statement);
+                node::group conditional = parse_enclosed();
+                skip(separator::end_statement);
+                node::group iteration = parse_enclosed();
+                skip(separator::group_close);
+
+                a_nodes.emplace_back(node::type::for_declaration, node::for_declaration(std::move(initialization), std::move(conditional), std::move(iteration), parse_body()));
+            } else if (tok == keyword::local || tok == keyword::constant || tok == keyword::function) {
+                bool flag_local = false;
+                bool flag_constant = false;
+
+                for (; is(keyword::local) || is(keyword::constant); ++m_index) {
+                    flag_local |= is(keyword::local);
+                    flag_constant |= is(keyword::constant);
                 }
 
-                i += std::distance(end_group, a_tokens.begin() + i);
-            } else if (tok == separator::selector_open) {
-                // Parsing selector.
-
-                span<token>::iterator end_selector_token = find_next(a_tokens.subspan(i + 1), separator::selector_close, separator::selector_open, separator::selector_close);
-
-                span<token> captured_tokens(a_tokens.begin() + i + 1, end_selector_token);
-
-                const auto find_next_entry = [](const span<token> a_tokens) noexcept -> span<token>::iterator {
-                    return find_next(a_tokens, separator::list, [](const token& a_token) -> find_next_exclude {
-                        if (a_token == separator::group_open || a_token == separator::selector_open || a_token == separator::scope_open) {
-                            return find_next_exclude::open;
-                        } else if (a_token == separator::group_close || a_token == separator::selector_close || a_token == separator::scope_close) {
-                            return find_next_exclude::close;
-                        } else {
-                            return find_next_exclude::none;
-                        }
-                    });
-                };
-
-                span<token>::iterator array_list_token = find_next_entry(captured_tokens);
-
-                if (array_list_token != captured_tokens.cend()) {
-                    // Immediate array.
-
-                    std::vector<node> array;
-
-                    span<token>::iterator last_entry = a_tokens.begin() + i + 1;
-                    span<token>::iterator entry_end = find_next_entry(span<token>(last_entry, end_selector_token));
-
-                    do {
-                        span<token> entry_tokens = span<token>(last_entry, entry_end);
-
-                        if (!entry_tokens.empty()) {
-                            if (entry_tokens.size() == 1) {
-                                array.emplace_back(node::type::token, &entry_tokens[0]);
-                            } else {
-                                array.emplace_back(node::type::expression, parse_group(entry_tokens));
-                            }
-                        }
-
-                        last_entry = entry_end + 1;
-
-                        if (last_entry >= end_selector_token) {
-                            break;
-                        }
-
-                        entry_end = find_next_entry(span<token>(last_entry, end_selector_token));
-                    } while (entry_end != last_entry);
+                if (is(keyword::function)) {
+                    const function_tags tags = (flag_local && flag_constant) ? function_tags::constant
+                                                                             : (flag_constant ? function_tags::global_constant
+                                                                                              : (flag_local ? function_tags::basic
+                                                                                                            : function_tags::global));
 
-                    nodes.emplace_back(node::type::immediate_array, std::move(array));
+                    // The identifier includes the local/constant flags.
+                    m_index = statement_start;
+                    parse_function(a_nodes, tags);
                 } else {
-                    // Selector.
-
-                    span<token>::iterator selector_seek = find_next(captured_tokens, separator::seek, separator::selector_open, separator::selector_close);
-
-                    if (selector_seek != captured_tokens.cend()) {
-                        nodes.emplace_back(node::type::ranged_selector, node::ranged_selector(
-                                parse_group(span<token>(a_tokens.begin() + i + 1, selector_seek)),
-                                parse_group(span<token>(selector_seek + 1, end_selector_token))
-                        ));
-                    } else {
-                        nodes.emplace_back(node::type::selector, parse_group(captured_tokens));
-                    }
+                    m_index = statement_start;
+                    parse_expression_statement(a_nodes);
+                }
+            } else if (tok == keyword::do_loop || tok == keyword::switch_statement || tok == keyword::class_declaration) {
+                // TODO: Parse do-while loops, switch statements and classes.
+                ++m_index;
+            } else if (tok == keyword::function_return) {
+                ++m_index;
+                a_nodes.emplace_back(node::type::return_statement, parse_expression());
+                skip(separator::end_statement);
+            } else if (tok == keyword::break_statement || tok == keyword::continue_statement) {
+                ++m_index;
+
+                if (is(separator::end_statement)) {
+                    a_nodes.emplace_back(tok == keyword::break_statement ? node::type::break_statement : node::type::continue_statement, std::nullptr_t{});
+                } else {
+                    // TODO: Throw malformed break/continue statement error.
                 }
-
-                i += std::distance(end_selector_token, a_tokens.begin() + i);
             } else if (tok == separator::scope_open) {
-                // Parsing immediate table.
-
-                span<token>::iterator end_scope_token = find_next(a_tokens.subspan(i + 1), separator::scope_close, separator::scope_open, separator::scope_close);
-
-                const auto find_next_entry = [](const span<token> a_tokens) noexcept -> span<token>::iterator {
-                    return find_next(a_tokens, separator::list, [](const token& a_token) -> find_next_exclude {
-                        if (a_token == separator::scope_open || a_token == separator::group_open) {
-                            return find_next_exclude::open;
-                        } else if (a_token == separator::scope_close || a_token == separator::group_close) {
-                            return find_next_exclude::close;
-                        } else {
-                            return find_next_exclude::none;
-                        }
-                    });
-                };
-
-                const auto find_assignment = [](const span<token> a_tokens) noexcept -> span<token>::iterator {
-                    return find_next(a_tokens, separator::assignment, [](const token& a_token) -> find_next_exclude {
-                        if (a_token == separator::scope_open || a_token == separator::selector_open || a_token == separator::group_open) {
-                            return find_next_exclude::open;
-                        } else if (a_token == separator::scope_close || a_token == separator::selector_close || a_token == separator::group_close) {
-                            return find_next_exclude::close;
-                        } else {
-                            return find_next_exclude::none;
-                        }
-                    });
-                };
-
-                node::immediate_table tbl;
-
-                span<token>::iterator last_entry = a_tokens.begin() + i + 1;
-                span<token>::iterator entry_end = find_next_entry(span<token>(last_entry, end_scope_token));
+                ++m_index;
 
-                do {
-                    span<token> entry_tokens = span<token>(last_entry, entry_end);
+                node::block block;
+                parse_statements(block);
+                skip(separator::scope_close);
 
-                    if (!entry_tokens.empty()) {
-                        span<token>::iterator assignment_token = find_assignment(entry_tokens);
-
-                        if (std::distance(assignment_token, last_entry) == 1) {
-                            tbl.m_entries.emplace_back(
-                                    node(node::type::token, &*last_entry),
-                                    parse_group(span<token>(assignment_token + 1, entry_tokens.end()))
-                            );
-                        } else if (entry_tokens[0] == separator::selector_open) {
-                            span<token>::iterator key_expression_end = find_next(entry_tokens, separator::selector_close, separator::selector_open, separator::selector_close);
-
-                            if (key_expression_end != entry_tokens.cend()) {
-                                tbl.m_entries.emplace_back(
-                                        node(node::type::expression, parse_group(span<token>(assignment_token + 1, entry_tokens.end()))),
-                                        parse_group(span<token>(assignment_token + 1, entry_tokens.end()))
-                                );
-                            } else {
-                                // Malformed key expression for immediate table.
-
-                                // TODO: Throw malformed immediate table entry expression.
-                            }
-                        }
-                    }
-
-                    last_entry = entry_end + 1;
-
-                    if (last_entry >= end_scope_token) {
-                        break;
-                    }
+                a_nodes.emplace_back(node::type::block, std::move(block));
+            } else {
+                parse_expression_statement(a_nodes);
+            }
+        }
 
-                    entry_end = find_next_entry(span<token>(last_entry, end_scope_token));
-                } while (entry_end != last_entry);
+        void parse_expression_statement(node::block& a_nodes) noexcept {
+            const size_t statement_start = m_index;
+            node::expression expression = parse_expression();
 
-                nodes.emplace_back(node::type::immediate_table, tbl);
-                i += std::distance(end_scope_token, a_tokens.begin() + 1);
+            if (m_index != statement_start || is(separator::end_statement)) {
+                a_nodes.emplace_back(node::type::expression, std::move(expression));
+                skip(separator::end_statement);
             } else {
-                nodes.emplace_back(node::type::token, &tok);
+                // Stray token that cannot start an expression.
+                // TODO: Throw unexpected token error.
+                ++m_index;
             }
         }
 
-        return parse_ast(nodes);
-    }
+        void parse_function(node::block& a_nodes, const function_tags a_tags) noexcept {
+            m_group_closes = true;
+            node::group identifier = parse_expression();
+            m_group_closes = false;
 
-    // Routine to parse a block.
-    [[nodiscard]] node::block parse_block(const span<token> a_tokens) noexcept {
-        std::vector<node> nodes;
+            node::argument_list parameters;
 
-        bool flag_constant = false;
-        bool flag_local = false;
+            skip(separator::group_open);
 
-        for (size_t i = 0; i < a_tokens.size(); ++i) {
-            const token& tok = a_tokens[i];
+            while (!at_end() && !is(separator::group_close)) {
+                parameters.push_back(parse_expression());
 
-            if (tok == keyword::if_statement && a_tokens[i + 1] == separator::group_open) {
-                // "If" parsing routine.
+                if (!is(separator::list)) {
+                    break;
+                }
 
-                span<token>::iterator group_close_find = find_next(a_tokens.subspan(i + 2), separator::group_close, separator::group_open, separator::group_close);
+                ++m_index;
+            }
 
-                // Ensure conditional is closed.
-                if (group_close_find != a_tokens.cend()) {
-                    span<token> conditional_tokens{ a_tokens.begin() + i + 2, group_close_find };
+            skip(separator::group_close);
 
-                    if (*(group_close_find + 1) == separator::scope_open) {
-                        // Regular "if" with postceding block.
+            if (identifier.get_operation() == separator::dot) {
+                const static token this_token{ token::type::identifier, "this" };
 
-                        span<token>::iterator block_end_find = find_next(span<token>(group_close_find + 2, a_tokens.end()), separator::scope_close, separator::scope_open, separator::scope_close);
+                node::abstract_syntax_tree ast{ separator::space };
+                ast.add_operand({ node::type::token, &this_token });
 
-                        // Ensure block is closed.
-                        if (block_end_find != a_tokens.cend()) {
-                            // Block bounds located.
+                parameters.insert(parameters.begin(), std::move(ast));
+            }
 
-                            nodes.emplace_back(node::type::if_declaration, node::if_declaration(parse_group(conditional_tokens), parse_block(span<token>(group_close_find + 2, block_end_find))));
+            a_nodes.emplace_back(node::type::function_declaration, node::function_declaration(std::move(identifier), a_tags, std::move(parameters), parse_body()));
+        }
 
-                            i += std::distance(block_end_find, a_tokens.begin() + i);
-                        } else {
-                            // Malformed block postceding "if" statement.
+        // EXPRESSIONS
 
-                            // TODO: Throw incomplete block syntax error.
-                        }
-                    } else {
-                        // Single statement "if" with postceding statement.
+        // Expression directly inside brackets or parentheses, where the outer ':' and '(' rules do not apply.
+        [[nodiscard]] node::expression parse_enclosed(const bool a_seek_closes = false) noexcept {
+            const bool seek_closes = std::exchange(m_seek_closes, a_seek_closes);
+            const bool group_closes = std::exchange(m_group_closes, false);
 
-                        span<token>::iterator statement_end = find_next(span<token>(group_close_find + 2, a_tokens.end()), separator::end_statement, separator::scope_open, separator::scope_close);
+            node::expression expression = parse_expression();
 
-                        // Ensure statement has an end.
-                        if (statement_end != a_tokens.cend()) {
-                            // Statement bounds located.
+            m_seek_closes = seek_closes;
+            m_group_closes = group_closes;
 
-                            nodes.emplace_back(node::type::if_declaration, node::if_declaration(parse_group(conditional_tokens), { { node::type::expression, parse_group(span<token>(group_close_find + 2, statement_end)) } }));
+            return expression;
+        }
 
-                            i += std::distance(statement_end, a_tokens.begin() + i);
-                        } else {
-                            // Malformed statement.
+        // Binary operators of at least a_precedence, folded to the left. The right operand of a right-associative
+        // operator takes further operators of its own precedence.
+        [[nodiscard]] operand parse_binary(const size_t a_precedence) noexcept {
+            operand lhs = parse_unary();
 
-                            // TODO: Throw incomplete statement syntax error.
-                        }
-                    }
-                } else {
-                    // Malformed "if" conditional.
+            while (!at_end() && m_tokens[m_index].is_separator()) {
+                const separator sep = m_tokens[m_index].get_separator();
+                const separator_info info = get_separator_info(sep);
 
-                    // TODO: Throw incomplete "if" syntax error.
+                if (info.has_single_operand() || info.precedence() == 0 || info.precedence() >= 10 || info.precedence() < a_precedence) {
+                    break;
                 }
-            } else if (tok == keyword::else_statement) {
-                // Else statement parsing routine.
 
-                if (a_tokens[i + 1] == keyword::if_statement) {
-                    // "Else if" block.
+                ++m_index;
 
-                    // Ensure there's a conditional.
-                    if (a_tokens[i + 2] == separator::group_open) {
-                        span<token>::iterator group_close_find = find_next(a_tokens.subspan(i + 3), separator::group_close, separator::group_open, separator::group_close);
+                node::abstract_syntax_tree ast{ sep };
+                ast.add_operand(to_node(std::move(lhs)));
 
-                        // Ensure the conditional is closed.
-                        if (group_close_find != a_tokens.cend()) {
-                            span<token> conditional_tokens{ a_tokens.begin() + i + 3, group_close_find };
+                const size_t rhs_precedence = is_right_associative(sep) ? info.precedence() : info.precedence() + 1;
 
-                            if (*(group_close_find + 1) == separator::scope_open) {
-                                // Regular "else if" with postceding block.
+                if (sep == separator::ternary) {
+                    const nesting_guard guard(*this);
+                    const bool seek_closes = std::exchange(m_seek_closes, true);
+                    operand when_true = parse_binary(1);
+                    m_seek_closes = seek_closes;
 
-                                span<token>::iterator block_end_find = find_next(span<token>(group_close_find + 2, a_tokens.end()), separator::scope_close, separator::scope_open, separator::scope_close);
+                    skip(separator::seek);
 
-                                // Ensure block is closed.
-                                if (block_end_find != a_tokens.cend()) {
-                                    // Block bounds located.
+                    ast.add_operand(to_node(std::move(when_true)));
+                    ast.add_operand(to_node(parse_binary(rhs_precedence)));
+                } else if (is_right_associative(sep)) {
+                    const nesting_guard guard(*this);
+                    ast.add_operand(to_node(parse_binary(rhs_precedence)));
+                } else {
+                    ast.add_operand(to_node(parse_binary(rhs_precedence)));
+                }
 
-                                    nodes.emplace_back(node::type::else_if_declaration, node::else_if_declaration(parse_group(conditional_tokens), parse_block(span<token>(group_close_find + 2, block_end_find))));
+                lhs = { std::move(ast), false };
+            }
 
-                                    i += std::distance(block_end_find, a_tokens.begin() + i);
-                                } else {
-                                    // Malformed block postceding "else if" statement.
+            return lhs;
+        }
 
-                                    // TODO: Throw incomplete block syntax error.
-                                }
-                            } else {
-                                // Single statement "else if" with postceding statement.
+        // Prefix and postfix operators. They bind looser than member access and calls but tighter than any binary
+        // operator. Applied to a single node, increments and decrements become their prefix/postfix operations.
+        [[nodiscard]] operand parse_unary() noexcept {
+            if (!at_end() && m_tokens[m_index].is_separator() && get_separator_info(m_tokens[m_index].get_separator()).has_single_operand()) {
+                const separator sep = m_tokens[m_index++].get_separator();
+                const nesting_guard guard(*this);
+                operand inner = parse_unary();
 
-                                span<token>::iterator statement_end = find_next(span<token>(group_close_find + 2, a_tokens.end()), separator::end_statement, separator::scope_open, separator::scope_close);
+                if (inner.m_single && sep == separator::increment) {
+                    return apply_unary(separator::operation_prefix_increment, std::move(inner));
+                } else if (inner.m_single && sep == separator::decrement) {
+                    return apply_unary(separator::operation_prefix_decrement, std::move(inner));
+                }
 
-                                // Ensure expression has an end.
-                                if (statement_end != a_tokens.cend()) {
-                                    // Statement bounds located.
+                return apply_unary(sep, std::move(inner));
+            }
 
-                                    nodes.emplace_back(node::type::else_if_declaration, node::else_if_declaration(parse_group(conditional_tokens), { { node::type::expression, parse_group(span<token>(group_close_find + 2, statement_end)) } }));
+            operand chain = parse_chain();
 
-                                    i += std::distance(statement_end, a_tokens.begin() + i);
-                                } else {
-                                    // Malformed statement.
+            if (is(separator::increment) || is(separator::decrement)) {
+                const separator sep = m_tokens[m_index++].get_separator();
 
-                                    // TODO: Throw incomplete expression syntax error.
-                                }
-                            }
+                if (chain.m_single) {
+                    return apply_unary(sep == separator::increment ? separator::operation_postfix_increment : separator::operation_postfix_decrement, std::move(chain));
+                }
 
-                        } else {
-                            // Malformed "else if" conditional.
+                return apply_unary(sep, std::move(chain));
+            }
 
-                            // TODO: Throw incomplete "else if" syntax error.
-                        }
-                    } else {
-                        // Malformed "else if" conditional.
+            return chain;
+        }
 
-                        // TODO: Throw incomplete "else if" syntax error.
-                    }
-                } else if (a_tokens[i + 1] == separator::scope_open) {
-                    // Regular "else" block.
+        [[nodiscard]] static operand apply_unary(const separator a_operation, operand a_operand) noexcept {
+            node::abstract_syntax_tree ast{ a_operation };
+            ast.add_operand(to_node(std::move(a_operand)));
+
+            return { std::move(ast), false };
+        }
 
-                    span<token>::iterator scope_close_find = find_next(a_tokens.subspan(i + 2), separator::scope_close, separator::scope_open, separator::scope_close);
+        // Operators that bind like member access: '.', '->', '::' and, outside of selectors and ternary branches, ':'.
+        [[nodiscard]] bool at_member_operator() const noexcept {
+            if (at_end() || !m_tokens[m_index].is_separator()) {
+                return false;
+            }
 
-                    if (scope_close_find != a_tokens.cend()) {
-                        nodes.emplace_back(node::type::else_declaration, parse_block(span<token>(a_tokens.begin() + i + 2, scope_close_find)));
+            switch (m_tokens[m_index].get_separator()) {
+                case separator::direct:
+                case separator::dot:
+                case separator::namespace_index:
+                    return true;
+                case separator::seek:
+                    return !m_seek_closes;
+                default:
+                    return false;
+            }
+        }
 
-                        i += std::distance(scope_close_find, a_tokens.begin() + i);
-                    } else {
-                        // Malformed block postceding "else" statement.
+        // An operand followed by any number of member accesses, calls and indexes.
+        [[nodiscard]] operand parse_chain() noexcept {
+            operand chain = parse_juxtaposition();
 
-                        // TODO: Throw incomplete "else" syntax error.
-                    }
-                } else {
-                    span<token>::iterator statement_end_find = find_next(a_tokens.subspan(i + 1), separator::end_statement, separator::scope_open, separator::scope_close);
+            while (!at_end()) {
+                if (is(separator::group_open) && !m_group_closes) {
+                    chain = apply_call(std::move(chain), parse_parenthesized());
+                } else if (is(separator::selector_open)) {
+                    node bracket = parse_bracket();
 
-                    if (statement_end_find != a_tokens.cend()) {
-                        nodes.emplace_back(node::type::else_declaration, parse_block(span<token>(a_tokens.begin() + i, statement_end_find)));
+                    if (bracket.is_immediate_array()) {
+                        node::abstract_syntax_tree ast{ separator::space };
+                        ast.add_operand(to_node(std::move(chain)));
+                        ast.add_operand(std::move(bracket));
 
-                        i += std::distance(statement_end_find, a_tokens.begin() + i);
+                        chain = { std::move(ast), false };
                     } else {
-                        // Malformed block postceding "else" statement.
-
-                        // TODO: Throw incomplete "else" syntax error.
+                        chain = apply_index(std::move(chain), std::move(bracket));
                     }
-                }
-            } else if (tok == keyword::for_loop && a_tokens[i + 1] == separator::group_open) {
-                // For-loop parsing routine.
-
-                span<token>::iterator group_end = find_next(a_tokens.subspan(i + 2), separator::group_close, separator::group_open, separator::group_close);
-                span<token> group_tokens(a_tokens.begin() + i + 2, group_end);
-
-                span<token>::iterator initialization_end = find_next(group_tokens, separator::end_statement, separator::scope_open, separator::scope_close);
-                span<token> initialization_tokens(group_tokens.begin(), initialization_end);
-
-                span<token>::iterator condition_end = find_next(span<token>(initialization_end + 1, group_end), separator::end_statement, separator::scope_open, separator::scope_close);
-                span<token> condition_tokens(initialization_end + 1, condition_end);
-
-                span<token> iteration_tokens(condition_end + 1, group_end);
-
-                if (*(group_end + 1) == separator::scope_open) {
-                    // For-loop with postceding block.
-
-                    span<token>::iterator block_end = find_next(span<token>(group_end + 2, a_tokens.end()), separator::scope_close, separator::scope_open, separator::scope_close);
-                    span<token> body_tokens(group_end + 2, block_end);
+                } else if (at_member_operator()) {
+                    node::abstract_syntax_tree ast{ m_tokens[m_index++].get_separator() };
+                    ast.add_operand(to_node(std::move(chain)));
+                    ast.add_operand(to_node(parse_juxtaposition()));
 
-                    nodes.emplace_back(node::type::for_declaration, node::for_declaration(
-                            parse_group(initialization_tokens),
-                            parse_group(condition_tokens),
-                            parse_group(iteration_tokens),
-                            parse_block(body_tokens)
-                    ));
-
-                    i += std::distance(block_end, a_tokens.begin() + i);
+                    chain = { std::move(ast), false };
                 } else {
-                    // For-loop with postceding statement.
-
-                    span<token>::iterator statement_end = find_next(span<token>(group_end + 1, a_tokens.end()), separator::end_statement, separator::scope_open, separator::scope_close);
-                    span<token> body_tokens(group_end + 1, statement_end);
+                    break;
+                }
+            }
 
-                    nodes.emplace_back(node::type::for_declaration, node::for_declaration(
-                            parse_group(initialization_tokens),
-                            parse_group(condition_tokens),
-                            parse_group(iteration_tokens),
-                            parse_block(body_tokens)
-                    ));
+            return chain;
+        }
 
-                    i += std::distance(statement_end, a_tokens.begin() + i);
-                }
-            } else if (tok == keyword::function) {
-                // Function parsing routine.
+        // A primary operand, possibly followed by further tokens with no operator in between, as in "local x".
+        // Several such nodes form a space operation.
+        [[nodiscard]] operand parse_juxtaposition() noexcept {
+            std::optional<node> first = parse_primary();
 
-                function_tags tags = (flag_local && flag_constant) ? function_tags::constant
-                                                                   : (flag_constant ? function_tags::global_constant
-                                                                                    : (flag_local ? function_tags::basic
-                                                                                                  : function_tags::global));
+            if (!first.has_value()) {
+                return {};
+            }
 
-                // Includes local/constant flags.
-                size_t flag_correction_offset = static_cast<size_t>(flag_constant) + static_cast<size_t>(flag_local);
-                flag_local = false;
-                flag_constant = false;
+            if (at_end() || (m_tokens[m_index].is_separator() && !is(separator::scope_open) && !is(separator::ellipsis))) {
+                return single(std::move(*first));
+            }
 
-                span<token>::iterator group_open_find = find_next(a_tokens.subspan(i + 1), separator::group_open);
+            node::abstract_syntax_tree ast{ separator::space };
+            ast.add_operand(std::move(*first));
 
-                span<token> identifier_tokens(a_tokens.begin() + i - flag_correction_offset, group_open_find);
+            while (!at_end() && (!m_tokens[m_index].is_separator() || is(separator::scope_open) || is(separator::ellipsis))) {
+                ast.add_operand(*parse_primary());
+            }
 
-                span<token>::iterator group_close_find = find_next(span<token>(group_open_find + 1, a_tokens.end()), separator::group_close, separator::group_open, separator::group_open);
+            return { std::move(ast), false };
+        }
 
-                span<token> argument_tokens(group_open_find + 1, group_close_find);
+        // A token, group, selector or immediate array/table in operand position. Empty if the current token
+        // cannot start an operand.
+        [[nodiscard]] std::optional<node> parse_primary() noexcept {
+            if (at_end()) {
+                return std::nullopt;
+            }
 
-                const auto func_identifier = parse_group(identifier_tokens);
-                auto func_args = parse_arguments(argument_tokens);
+            const token& tok = m_tokens[m_index];
 
-                if (func_identifier.get_operation() == separator::dot) {
-                    const static token this_token{ token::type::identifier, "this" };
+            if (tok == separator::group_open) {
+                return parse_parenthesized();
+            } else if (tok == separator::selector_open) {
+                return parse_bracket();
+            } else if (tok == separator::scope_open) {
+                return parse_table();
+            } else if (!tok.is_separator() || tok == separator::ellipsis) {
+                ++m_index;
+                return node(node::type::token, &tok);
+            }
 
-                    node::abstract_syntax_tree ast{ separator::space };
+            return std::nullopt;
+        }
 
-                    ast.add_operand({ node::type::token, &this_token });
+        [[nodiscard]] static operand apply_call(operand a_callee, node a_arguments) noexcept {
+            node::abstract_syntax_tree ast{ separator::operation_call };
+            ast.add_operand(to_node(std::move(a_callee)));
 
-                    func_args.insert(func_args.begin(), ast);
+            if (a_arguments.is_argument_list()) {
+                for (auto& argument : a_arguments.get_argument_list()) {
+                    ast.add_operand({ node::type::expression, std::move(argument) });
                 }
+            } else {
+                ast.add_operand({ node::type::expression, std::move(a_arguments.get_expression()) });
+            }
 
-                if (*(group_close_find + 1) == separator::scope_open) {
-                    // Block postceding function.
+            return { std::move(ast), false };
+        }
 
-                    span<token>::iterator scope_end_find = find_next(span<token>(group_close_find + 2, a_tokens.end()), separator::scope_close, separator::scope_open, separator::scope_close);
+        [[nodiscard]] static operand apply_index(operand a_indexed, node a_selector) noexcept {
+            const bool single_indexed = a_indexed.m_single;
 
-                    nodes.emplace_back(node::type::function_declaration, node::function_declaration(func_identifier, tags, func_args, parse_block(span<token>(group_close_find + 2, scope_end_find))));
+            node::abstract_syntax_tree ast{ separator::operation_index };
+            ast.add_operand(to_node(std::move(a_indexed)));
 
-                    i += std::distance(scope_end_find, a_tokens.begin() + i);
-                } else {
-                    // Statement/expression postceding function.
+            if (a_selector.is_ranged_selector()) {
+                auto& range = a_selector.get_ranged_selector();
 
-                    span<token>::iterator end_statement_find = find_next(span<token>(group_close_find + 1, a_tokens.end()), separator::end_statement, separator::scope_open, separator::scope_close);
+                ast.add_operand({ node::type::expression, std::move(range.first) });
+                ast.add_operand({ node::type::expression, std::move(range.second) });
+            } else if (single_indexed) {
+                ast.add_operand({ node::type::expression, std::move(a_selector.get_selector()) });
+            } else {
+                ast.add_operand(std::move(a_selector));
+            }
 
-                    nodes.emplace_back(node::type::function_declaration, node::function_declaration(func_identifier, tags, func_args, parse_block(span<token>(group_close_find + 2, end_statement_find))));
+            return { std::move(ast), false };
+        }
 
-                    i += std::distance(end_statement_find, a_tokens.begin() + i);
-                }
-            } else if (tok == keyword::while_loop) {
-                // While-loop parsing routine.
+        // "( ... )": a group, or an argument list if it holds several comma-separated expressions.
+        [[nodiscard]] node parse_parenthesized() noexcept {
+            ++m_index;
 
-                span<token>::iterator group_close_find = find_next(a_tokens.subspan(i + 2), separator::group_close, separator::group_open, separator::group_close);
+            node::expression first = parse_enclosed();
 
-                // Ensure conditional is closed.
-                if (group_close_find != a_tokens.cend()) {
-                    span<token> conditional_tokens{ a_tokens.begin() + i + 2, group_close_find };
+            if (!is(separator::list)) {
+                skip(separator::group_close);
+                return { node::type::group, std::move(first) };
+            }
 
-                    if (*(group_close_find + 1) == separator::scope_open) {
-                        // Regular while-loop with postceding block.
+            node::argument_list arguments;
+            arguments.push_back(std::move(first));
 
-                        span<token>::iterator block_end_find = find_next(span<token>(group_close_find + 2, a_tokens.end()), separator::scope_close, separator::scope_open, separator::scope_close);
+            while (is(separator::list)) {
+                ++m_index;
 
-                        // Ensure block is closed.
-                        if (block_end_find != a_tokens.cend()) {
-                            // Block bounds located.
+                if (at_end() || is(separator::group_close)) {
+                    break;
+                }
 
-                            nodes.emplace_back(node::type::while_declaration, node::while_declaration(parse_group(conditional_tokens), parse_block(span<token>(group_close_find + 2, block_end_find))));
+                arguments.push_back(parse_enclosed());
+            }
 
-                            i += std::distance(block_end_find, a_tokens.begin() + i);
-                        } else {
-                            // Malformed block postceding while-loop.
+            skip(separator::group_close);
+            return { node::type::argument_list, std::move(arguments) };
+        }
 
-                            // TODO: Throw incomplete block syntax error.
-                        }
-                    } else {
-                        // Single statement while-loop with postceding statement.
+        // "[ ... ]": a selector, a ranged selector "[a:b]" or, if it holds several comma-separated entries, an
+        // immediate array. Array entries of a single token are stored as that token.
+        [[nodiscard]] node parse_bracket() noexcept {
+            ++m_index;
 
-                        span<token>::iterator statement_end = find_next(span<token>(group_close_find + 2, a_tokens.end()), separator::end_statement, separator::scope_open, separator::scope_close);
+            size_t entry_start = m_index;
+            node::expression first = parse_enclosed(true);
 
-                        // Ensure statement has an end.
-                        if (statement_end != a_tokens.cend()) {
-                            // Statement bounds located.
+            if (is(separator::seek)) {
+                ++m_index;
 
-                            nodes.emplace_back(node::type::while_declaration, node::while_declaration(parse_group(conditional_tokens), { { node::type::expression, parse_group(span<token>(group_close_find + 2, statement_end)) } }));
+                node::expression last = parse_enclosed();
+                skip(separator::selector_close);
 
-                            i += std::distance(statement_end, a_tokens.begin() + i);
-                        } else {
-                            // Malformed statement.
+                return { node::type::ranged_selector, node::ranged_selector(std::move(first), std::move(last)) };
+            }
 
-                            // TODO: Throw incomplete statement syntax error.
-                        }
-                    }
-                } else {
-                    // Malformed while-loop conditional.
+            if (!is(separator::list)) {
+                skip(separator::selector_close);
+                return { node::type::selector, std::move(first) };
+            }
 
-                    // TODO: Throw incomplete while-loop syntax error.
-                }
-            } else if (tok == keyword::do_loop) {
-                // Do-while-loop parsing routine.
+            node::immediate_array entries;
+            node::expression entry = std::move(first);
 
+            while (true) {
+                if (m_index - entry_start == 1) {
+                    entries.emplace_back(node::type::token, &m_tokens[entry_start]);
+                } else if (m_index != entry_start) {
+                    entries.emplace_back(node::type::expression, std::move(entry));
+                }
 
-            } else if (tok == keyword::switch_statement) {
-                // Switch statement parsing routine.
+                if (!is(separator::list)) {
+                    break;
+                }
 
+                entry_start = ++m_index;
+                entry = parse_enclosed();
+            }
 
-            } else if (tok == keyword::class_declaration) {
-                // Class declaration parsing routine.
+            skip(separator::selector_close);
+            return { node::type::immediate_array, std::move(entries) };
+        }
 
-                class_tags tags = flag_local ? class_tags::basic : class_tags::global;
+        // "{ key = value, [key_expression] = value, ... }". Entries of any other form are skipped.
+        [[nodiscard]] node parse_table() noexcept {
+            ++m_index;
 
+            node::immediate_table table;
 
-            } else if (tok == keyword::function_return) {
-                // Function return statement parsing routine.
+            while (!at_end() && !is(separator::scope_close)) {
+                const size_t entry_start = m_index;
 
-                span<token>::iterator end_statement_find = find_next(a_tokens.subspan(i + 1), separator::end_statement, separator::scope_open, separator::scope_close);
+                if (!m_tokens[m_index].is_separator() && next_is(separator::assignment)) {
+                    m_index += 2;
+                    table.m_entries.emplace_back(node(node::type::token, &m_tokens[entry_start]), parse_enclosed());
+                } else if (is(separator::selector_open)) {
+                    ++m_index;
 
-                nodes.emplace_back(node::type::return_statement, parse_group(span<token>(a_tokens.begin() + i + 1, end_statement_find)));
+                    node::expression key = parse_enclosed();
+                    skip(separator::selector_close);
+                    skip(separator::assignment);
 
-                i += std::distance(end_statement_find, a_tokens.begin() + i);
-            } else if (tok == keyword::break_statement) {
-                if (a_tokens[i + 1] == separator::end_statement) {
-                    nodes.emplace_back(node::type::break_statement, std::nullptr_t{});
+                    table.m_entries.emplace_back(node(node::type::expression, std::move(key)), parse_enclosed());
                 } else {
-                    // Malformed break statement.
-                    // TODO: Throw malformed break statement error.
+                    // TODO: Throw malformed immediate table entry error.
+                    static_cast<void>(parse_enclosed());
                 }
-            } else if (tok == keyword::continue_statement) {
-                if (a_tokens[i + 1] == separator::end_statement) {
-                    nodes.emplace_back(node::type::continue_statement, std::nullptr_t{});
-                } else {
-                    // Malformed break statement.
-                    // TODO: Throw malformed break statement error.
-                }
-            } else if (tok == keyword::local) {
-                // Local definition declared.
 
-                flag_local = true;
-            } else if (tok == keyword::constant) {
-                // Constant definition declared.
-
-                flag_constant = true;
-            } else if (tok == separator::scope_open) {
-                // Block parsing.
-
-                span<token>::iterator block_end = find_next(a_tokens.subspan(i + 1), separator::scope_close, separator::scope_open, separator::scope_close);
-
-                if (block_end != a_tokens.cend()) {
-                    nodes.emplace_back(node::type::block, parse_block(span<token>(a_tokens.begin() + i + 1, block_end)));
-                    i += std::distance(block_end, a_tokens.begin() + i);
-                } else {
-                    // Malformed block.
-                    // TODO: Throw malformed block error.
+                if (is(separator::list)) {
+                    ++m_index;
+                } else if (m_index == entry_start) {
+                    ++m_index;
                 }
-            } else {
-                // Statement parsing routine.
+            }
 
-                span<token>::iterator end_statement_find = find_next(a_tokens.subspan(i), separator::end_statement, separator::scope_open, separator::scope_close);
+            skip(separator::scope_close);
+            return { node::type::immediate_table, std::move(table) };
+        }
+    };
 
-                // Includes local/constant flags.
-                size_t flag_correction_offset = static_cast<size_t>(flag_constant) + static_cast<size_t>(flag_local);
-                flag_local = false;
-                flag_constant = false;
+    [[nodiscard]] node::group parse_group(const span<token> a_tokens) noexcept {
+        return parser(a_tokens).parse_expression();
+    }
 
-                nodes.emplace_back(node::type::expression, parse_group(span<token>(a_tokens.begin() + i - flag_correction_offset, end_statement_find)));
+    [[nodiscard]] node::block parse_block(const span<token> a_tokens) {
+        parser block_parser(a_tokens);
+        node::block block = block_parser.parse_block();
 
-                i += std::distance(end_statement_find, a_tokens.begin() + i);
-            }
+        if (block_parser.too_deep()) {
+            throw std::runtime_error("Rebar code nested deeper than " + std::to_string(parser::max_nesting) + " levels.");
         }
 
-        return nodes;
+        return block;
     }
 }
 
@@ -6,6 +6,7 @@
 #define REBAR_PREPROCESS_HPP
 
 #include "definitions.hpp"
+#include "flat_ast.hpp"
 #include "lexer.hpp"
 #include "parser.hpp"
 
@@ -13,7 +14,7 @@ namespace rebar {
     struct parse_unit {
         std::string m_plaintext;
         lex_unit m_lex_unit;
-        node::block m_block;
+        flat_ast m_ast;
 
         parse_unit() noexcept = default;
 
@@ -21,19 +22,19 @@ namespace rebar {
         parse_unit(parse_unit&& a_unit) noexcept :
                 m_plaintext(std::move(a_unit.m_plaintext)),
                 m_lex_unit(std::move(a_unit.m_lex_unit)),
-                m_block(std::move(a_unit.m_block)) {}
+                m_ast(std::move(a_unit.m_ast)) {}
 
         parse_unit& operator=(const parse_unit&) = delete;
         parse_unit& operator=(parse_unit&& a_unit) noexcept {
             m_plaintext = std::move(a_unit.m_plaintext);
             m_lex_unit = std::move(a_unit.m_lex_unit);
-            m_block = std::move(a_unit.m_block);
+            m_ast = std::move(a_unit.m_ast);
         }
 
         [[maybe_unused]] [[nodiscard]] std::string string_representation() const noexcept {
             std::string string;
 
-            for (const auto& n : m_block) {
+            for (const flat_node n : m_ast.statements()) {
                 string += n.to_string();
             }
 
@@ -41,11 +42,14 @@ namespace rebar {
         }
     };
 
-    [[nodiscard]] parse_unit parse(lexer& a_lexer, std::string a_string) noexcept {
+    // Throws std::runtime_error if the code nests deeper than parser::max_nesting.
+    [[nodiscard]] parse_unit parse(lexer& a_lexer, std::string a_string) {
         parse_unit unit;
         unit.m_plaintext = std::move(a_string);
         unit.m_lex_unit = std::move(a_lexer.lex(unit.m_plaintext));
-        unit.m_block = parse_block(span<token>(unit.m_lex_unit.tokens()));
+
+        const span<token> tokens(unit.m_lex_unit.tokens());
+        unit.m_ast = flat_ast(tokens, parse_block(tokens));
 
         return std::move(unit);
     }
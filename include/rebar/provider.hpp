@@ -5,6 +5,8 @@
 #ifndef REBAR_PROVIDER_HPP
 #define REBAR_PROVIDER_HPP
 
+#include <memory>
+
 #include "definitions.hpp"
 #include "function.hpp"
 #include "object.hpp"
@@ -12,7 +14,10 @@
 
 namespace rebar {
     struct provider {
-        [[nodiscard]] virtual function compile(parse_unit a_unit) = 0;
+        virtual ~provider() = default;
+
+        // Parse units may be shared with other environments and must not be modified.
+        [[nodiscard]] virtual function compile(std::shared_ptr<const parse_unit> a_unit) = 0;
         [[nodiscard]] virtual function bind(callable a_function) = 0;
         [[nodiscard]] virtual object call(const void* a_data) = 0;
     };
@@ -0,0 +1,115 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_SHAPE_HPP
+#define REBAR_SHAPE_HPP
+
+#include <memory>
+#include <vector>
+
+#include "object.hpp"
+
+#include <skarupke_map.hpp>
+
+namespace rebar {
+    // Hidden class of a record-like table: the ordered list of string keys it holds. Tables that receive the
+    // same keys in the same order share a shape, and each key maps to a fixed index in the table's slot vector.
+    // Shapes form a transition tree rooted at the environment's root shape and are never freed before it, so the
+    // tree is bounded: once it is full, tables that would need a new shape switch to dictionary mode instead.
+    class shape {
+    public:
+        // Keys a shape may hold before its tables switch to dictionary mode.
+        static constexpr size_t max_properties = 64;
+
+        // Transitions leaving a single shape. Tables that add keys computed at run time (e.g. t["k" .. i]) fan out
+        // of one shape and quickly reach this.
+        static constexpr size_t max_transitions = 32;
+
+        // Shapes in a transition tree, the root included.
+        static constexpr size_t max_tree_size = 4096;
+
+        // Shapes with more keys than this look keys up through a hash index instead of scanning.
+        static constexpr size_t linear_lookup_limit = 8;
+
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        shape() noexcept : m_root(this) {}
+
+        shape(const shape&) = delete;
+        shape(shape&&) = delete;
+
+        shape& operator = (const shape&) = delete;
+        shape& operator = (shape&&) = delete;
+
+        [[nodiscard]] size_t size() const noexcept {
+            return m_keys.size();
+        }
+
+        [[nodiscard]] const std::vector<object>& keys() const noexcept {
+            return m_keys;
+        }
+
+        // Slot index of a_key, or npos if the shape does not contain it. Keys are interned strings, so
+        // comparing payloads is enough.
+        [[nodiscard]] size_t find(const object& a_key) const noexcept {
+            if (m_keys.size() <= linear_lookup_limit) {
+                for (size_t i = 0; i < m_keys.size(); ++i) {
+                    if (m_keys[i].data() == a_key.data()) {
+                        return i;
+                    }
+                }
+
+                return npos;
+            }
+
+            auto found = m_index.find(a_key);
+            return found == m_index.end() ? npos : found->second;
+        }
+
+        // Shapes in the tree this shape belongs to.
+        [[nodiscard]] size_t tree_size() const noexcept {
+            return m_root->m_tree_size;
+        }
+
+        // The shape of a table holding this shape's keys followed by a_key, or nullptr if it does not exist and
+        // there is no room left to create it.
+        [[nodiscard]] shape* transition(const object& a_key) {
+            for (auto& [key, child] : m_transitions) {
+                if (key.data() == a_key.data()) {
+                    return child.get();
+                }
+            }
+
+            if (m_transitions.size() >= max_transitions || m_root->m_tree_size >= max_tree_size) {
+                return nullptr;
+            }
+
+            auto child = std::make_unique<shape>();
+            child->m_root = m_root;
+            ++m_root->m_tree_size;
+
+            child->m_keys.reserve(m_keys.size() + 1);
+            child->m_keys = m_keys;
+            child->m_keys.push_back(a_key);
+
+            if (child->m_keys.size() > linear_lookup_limit) {
+                for (size_t i = 0; i < child->m_keys.size(); ++i) {
+                    child->m_index.emplace(child->m_keys[i], i);
+                }
+            }
+
+            m_transitions.emplace_back(a_key, std::move(child));
+            return m_transitions.back().second.get();
+        }
+
+    private:
+        shape* m_root;
+        size_t m_tree_size = 1;
+        std::vector<object> m_keys;
+        ska::flat_hash_map<object, size_t> m_index;
+        std::vector<std::pair<object, std::unique_ptr<shape>>> m_transitions;
+    };
+}
+
+#endif //REBAR_SHAPE_HPP
@@ -109,7 +109,7 @@ namespace rebar {
             }
 
             [[nodiscard]] friend constexpr iterator::difference_type operator-(iterator lhs, iterator rhs) {
-                return rhs.m_ptr - lhs.m_ptr;
+                return lhs.m_ptr - rhs.m_ptr;
             }
         };
 
@@ -132,7 +132,7 @@ namespace rebar {
         template <typename t_container, typename = std::enable_if<span_convertible<t_container>::value>>
         constexpr span(const t_container& a_container) noexcept(noexcept(a_container.size() && a_container.data())) : m_data(a_container.data()), m_size(a_container.size()) {}
 
-        constexpr span(const iterator a_begin, const iterator a_end) : m_data(a_begin.m_ptr), m_size(std::distance(a_end, a_begin)) {}
+        constexpr span(const iterator a_begin, const iterator a_end) : m_data(a_begin.m_ptr), m_size(std::distance(a_begin, a_end)) {}
 
         constexpr span(const span& a_span) noexcept = default;
         constexpr span(span&& a_span) noexcept = default;
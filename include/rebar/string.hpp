@@ -7,22 +7,56 @@
 
 #include "utility.hpp"
 
+#include <limits>
+
 #include <xxhash.hpp>
 
 namespace rebar {
     class environment;
 
+    struct xxh_string_view_hash {
+        size_t operator()(const std::string_view a_string) const noexcept {
+            return xxh::xxhash3<rebar::cpu_bit_architecture()>(a_string);
+        }
+    };
+
+    // Text looked up in a string table, hashed once for both the lookup and the string created from it.
+    struct hashed_string_view {
+        std::string_view m_text;
+        size_t m_hash;
+
+        explicit hashed_string_view(const std::string_view a_text) noexcept : m_text(a_text), m_hash(xxh_string_view_hash()(a_text)) {}
+
+        hashed_string_view(const std::string_view a_text, const size_t a_hash) noexcept : m_text(a_text), m_hash(a_hash) {}
+
+        [[nodiscard]] bool operator==(const hashed_string_view& rhs) const noexcept {
+            return m_hash == rhs.m_hash && m_text == rhs.m_text;
+        }
+    };
+
+    struct hashed_string_view_hash {
+        size_t operator()(const hashed_string_view& a_view) const noexcept {
+            return a_view.m_hash;
+        }
+    };
+
     class string {
-        // Stores size (size_t), reference count (size_t),
+        // Stores size (size_t), reference count (size_t), hash (size_t),
         // and string contents (char[]) in contiguous block of memory.
         //
         // Similar to Pascal strings. Optimized for Rebar object storage.
 
-        // [size_t size][size_t reference count][char[] data]
+        // [size_t size][size_t reference count][size_t hash][char[] data]
 
         void* m_root_pointer;
 
+        static constexpr size_t header_size = sizeof(size_t) * 3;
+
     public:
+        // Reference count of strings owned by a string_interner. Such strings are never freed and their count is
+        // never written, so threads may copy them concurrently.
+        static constexpr size_t immortal_reference_count = std::numeric_limits<size_t>::max();
+
         explicit string(void* a_root_pointer) noexcept : m_root_pointer(a_root_pointer) {
             reference();
         }
@@ -38,7 +72,7 @@ namespace rebar {
         }
 
         [[nodiscard]] const char* c_str() const noexcept {
-            return reinterpret_cast<char*>(m_root_pointer) + (sizeof(size_t) * 2);
+            return reinterpret_cast<char*>(m_root_pointer) + header_size;
         }
 
         [[nodiscard]] size_t length() const noexcept {
@@ -49,6 +83,11 @@ namespace rebar {
             return reinterpret_cast<size_t*>(m_root_pointer)[1];
         }
 
+        // xxhash of the contents, computed when the string was created; equal to xxh_string_view_hash of to_string_view().
+        [[nodiscard]] size_t hash() const noexcept {
+            return reinterpret_cast<size_t*>(m_root_pointer)[2];
+        }
+
         [[nodiscard]] size_t size() const noexcept {
             return length() + sizeof(size_t);
         }
@@ -74,7 +113,10 @@ namespace rebar {
         }
 
     private:
-        explicit string(const std::string_view a_string) noexcept : m_root_pointer(reinterpret_cast<size_t*>(std::malloc((sizeof(size_t) * 2) + a_string.size() + 1))) {
+        explicit string(const std::string_view a_string) noexcept : string(a_string, xxh_string_view_hash()(a_string)) {}
+
+        // a_hash must be the xxh_string_view_hash of a_string, e.g. one already computed to look the string up.
+        string(const std::string_view a_string, const size_t a_hash) noexcept : m_root_pointer(reinterpret_cast<size_t*>(std::malloc(header_size + a_string.size() + 1))) {
             auto* root_pointer = reinterpret_cast<size_t*>(m_root_pointer);
 
             // String size/length.
@@ -83,9 +125,12 @@ namespace rebar {
             // String reference counter.
             root_pointer[1] = 1;
 
+            // String hash.
+            root_pointer[2] = a_hash;
+
             // String data.
-            memcpy(reinterpret_cast<char*>(m_root_pointer) + (sizeof(size_t) * 2), a_string.data(), a_string.size());
-            *(reinterpret_cast<char*>(m_root_pointer) + a_string.size() + (sizeof(size_t) * 2)) = 0;
+            memcpy(reinterpret_cast<char*>(m_root_pointer) + header_size, a_string.data(), a_string.size());
+            *(reinterpret_cast<char*>(m_root_pointer) + a_string.size() + header_size) = 0;
         }
 
         void deallocate() {
@@ -98,11 +143,23 @@ namespace rebar {
         }
 
         size_t reference(const size_t a_increment = 1) noexcept {
-            return reinterpret_cast<size_t*>(m_root_pointer)[1] += a_increment;
+            size_t& count = reinterpret_cast<size_t*>(m_root_pointer)[1];
+
+            if (count == immortal_reference_count) {
+                return count;
+            }
+
+            return count += a_increment;
         }
 
         size_t dereference(const size_t a_decrement = 1) noexcept {
-            size_t ref_count = (reinterpret_cast<size_t*>(m_root_pointer)[1] -= a_decrement);
+            size_t& count = reinterpret_cast<size_t*>(m_root_pointer)[1];
+
+            if (count == immortal_reference_count) {
+                return count;
+            }
+
+            const size_t ref_count = (count -= a_decrement);
 
             if (ref_count == 0) {
                 deallocate();
@@ -112,21 +169,16 @@ namespace rebar {
         }
 
         friend class environment;
+        friend class string_interner;
 
         friend struct object;
     };
-
-    struct xxh_string_view_hash {
-        size_t operator()(const std::string_view a_string) const noexcept {
-            return xxh::xxhash3<rebar::cpu_bit_architecture()>(a_string);
-        }
-    };
 }
 
 template <>
 struct std::hash <rebar::string> {
     size_t operator()(const rebar::string a_string) const noexcept {
-        return xxh::xxhash3<rebar::cpu_bit_architecture()>(a_string.to_string_view());
+        return a_string.hash();
     }
 };
 
@@ -0,0 +1,179 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_STRING_INTERNER_HPP
+#define REBAR_STRING_INTERNER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include "string.hpp"
+
+namespace rebar {
+    // Strings shared by the environments using the interner (see environment::set_string_interner). Strings are
+    // compared by identity, so environments sharing an interner may pass strings to each other. Interned strings
+    // are immortal: their reference counts are never written, and they live as long as the interner, which the
+    // environments using it keep alive. Every distinct string a script creates stays interned for good, so
+    // environments building many unique strings at run time are better off with their own string table.
+    //
+    // Lookups take no lock. Strings are spread over shards by hash, each an open-addressed array of root pointers,
+    // and an insert locks one shard. A full shard publishes a larger array; the arrays it replaced are kept for
+    // lookups still probing them until the interner is destroyed.
+    class string_interner {
+    public:
+        string_interner() = default;
+
+        string_interner(const string_interner&) = delete;
+        string_interner& operator = (const string_interner&) = delete;
+
+        ~string_interner() {
+            for (shard& current : m_shards) {
+                const slot_array* slots = current.m_slots.load(std::memory_order_relaxed);
+
+                if (slots == nullptr) {
+                    continue;
+                }
+
+                // Older arrays hold a subset of the current one. Interned strings are allocated like any other.
+                for (size_t i = 0; i < slots->m_capacity; ++i) {
+                    std::free(slots->m_slots[i].load(std::memory_order_relaxed));
+                }
+            }
+        }
+
+        [[nodiscard]] string intern(const std::string_view a_string) {
+            const size_t hash = xxh_string_view_hash()(a_string);
+            shard& target = m_shards[hash & (shard_count - 1)];
+
+            if (void* found = find(target.m_slots.load(std::memory_order_acquire), hash, a_string)) {
+                return string(found);
+            }
+
+            return insert(target, hash, a_string);
+        }
+
+        [[nodiscard]] size_t size() const {
+            size_t total = 0;
+
+            for (const shard& current : m_shards) {
+                std::lock_guard<std::mutex> lock(current.m_mutex);
+                total += current.m_count;
+            }
+
+            return total;
+        }
+
+    private:
+        static constexpr size_t shard_bits = 6;
+        static constexpr size_t shard_count = size_t(1) << shard_bits;
+        static constexpr size_t initial_capacity = 16;
+
+        struct slot_array {
+            size_t m_capacity;
+            std::unique_ptr<std::atomic<void*>[]> m_slots;
+
+            explicit slot_array(const size_t a_capacity) : m_capacity(a_capacity), m_slots(new std::atomic<void*>[a_capacity]) {
+                for (size_t i = 0; i < a_capacity; ++i) {
+                    m_slots[i].store(nullptr, std::memory_order_relaxed);
+                }
+            }
+        };
+
+        struct alignas(64) shard {
+            mutable std::mutex m_mutex;
+            std::atomic<slot_array*> m_slots{ nullptr };
+            size_t m_count = 0;
+
+            // The current array and those it replaced.
+            std::vector<std::unique_ptr<slot_array>> m_arrays;
+        };
+
+        std::array<shard, shard_count> m_shards;
+
+        [[nodiscard]] static void* find(const slot_array* a_slots, const size_t a_hash, const std::string_view a_string) noexcept {
+            if (a_slots == nullptr) {
+                return nullptr;
+            }
+
+            const size_t mask = a_slots->m_capacity - 1;
+
+            for (size_t i = a_hash >> shard_bits;; ++i) {
+                void* root = a_slots->m_slots[i & mask].load(std::memory_order_acquire);
+
+                if (root == nullptr) {
+                    return nullptr;
+                }
+
+                const string candidate(root);
+
+                if (candidate.hash() == a_hash && candidate.to_string_view() == a_string) {
+                    return root;
+                }
+            }
+        }
+
+        // Stores a_root in the first free slot of its probe sequence. Arrays are never more than half full.
+        static void place(slot_array& a_slots, const size_t a_hash, void* a_root) noexcept {
+            const size_t mask = a_slots.m_capacity - 1;
+
+            for (size_t i = a_hash >> shard_bits;; ++i) {
+                std::atomic<void*>& slot = a_slots.m_slots[i & mask];
+
+                if (slot.load(std::memory_order_relaxed) == nullptr) {
+                    slot.store(a_root, std::memory_order_release);
+                    return;
+                }
+            }
+        }
+
+        string insert(shard& a_shard, const size_t a_hash, const std::string_view a_string) {
+            std::lock_guard<std::mutex> lock(a_shard.m_mutex);
+
+            slot_array* slots = a_shard.m_slots.load(std::memory_order_relaxed);
+
+            // Another thread may have interned the string since the lookup.
+            if (void* found = find(slots, a_hash, a_string)) {
+                return string(found);
+            }
+
+            if (slots == nullptr || (a_shard.m_count + 1) * 2 > slots->m_capacity) {
+                slots = grow(a_shard, slots);
+            }
+
+            string created(a_string, a_hash);
+            created.set_reference_count(string::immortal_reference_count);
+
+            place(*slots, a_hash, created.m_root_pointer);
+            ++a_shard.m_count;
+
+            return created;
+        }
+
+        // Publishes an array of twice the capacity holding the strings of a_slots.
+        static slot_array* grow(shard& a_shard, const slot_array* a_slots) {
+            auto grown = std::make_unique<slot_array>(a_slots == nullptr ? initial_capacity : a_slots->m_capacity * 2);
+
+            if (a_slots != nullptr) {
+                for (size_t i = 0; i < a_slots->m_capacity; ++i) {
+                    if (void* root = a_slots->m_slots[i].load(std::memory_order_relaxed)) {
+                        place(*grown, string(root).hash(), root);
+                    }
+                }
+            }
+
+            slot_array* published = grown.get();
+            a_shard.m_arrays.push_back(std::move(grown));
+            a_shard.m_slots.store(published, std::memory_order_release);
+
+            return published;
+        }
+    };
+}
+
+#endif //REBAR_STRING_INTERNER_HPP
@@ -5,12 +5,28 @@
 #ifndef REBAR_TABLE_HPP
 #define REBAR_TABLE_HPP
 
+#include "collector.hpp"
 #include "object.hpp"
+#include "shape.hpp"
 
 #include <skarupke_map.hpp>
 
+#include <limits>
+#include <vector>
+
 namespace rebar {
-    struct table : public ska::detailv3::sherwood_v3_table<
+    // Script tables have two representations. A table created with a root shape starts in shape mode: its
+    // string keys are described by a shared shape and its values live densely in m_slots, in key insertion
+    // order. The first non-string key, a key beyond shape::max_properties, a key the shape tree has no room for
+    // or an erase switches the table to dictionary mode, a general hash map, for good. Tables created without a
+    // shape are dictionaries from the start.
+    //
+    // In either mode, the values of the integer keys 0 to n - 1 are kept in order in an array part, m_array, so
+    // tables used as lists are indexed and iterated without hashing. Assigning key n appends to the array part
+    // and moves any keys that have thereby become contiguous out of the dictionary. Other integer keys live in the
+    // dictionary.
+    struct table {
+        using dictionary = ska::detailv3::sherwood_v3_table<
             std::pair<object, object>,
             object,
             std::hash<object>,
@@ -19,87 +35,300 @@ namespace rebar {
             ska::detailv3::KeyOrValueEquality<object, std::pair<object, object>, std::equal_to<object>>,
             std::allocator<std::pair<object, object>>,
             typename std::allocator_traits<std::allocator<std::pair<object, object>>>::template rebind_alloc<ska::detailv3::sherwood_v3_entry<std::pair<object, object>>>
-    > {
-    size_t m_reference_count = 0;
+        >;
+
+    private:
+        shape* m_shape = nullptr;
+        std::vector<object> m_slots;
+        std::vector<object> m_array;
+        dictionary m_dictionary;
+        size_t m_layout_version = 0;
+        collector_link m_collector_link;
+
+        friend class cycle_collector;
+
+    public:
+        static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+        size_t m_reference_count = 0;
 
-    [[nodiscard]] inline object& operator[](const object a_key) {
-        return emplace(a_key, object()).first->second;
-    }
+        table() = default;
+
+        explicit table(shape& a_root_shape) noexcept : m_shape(&a_root_shape) {}
+
+        table(const table&) = default;
+        table& operator = (const table&) = default;
+
+        ~table();
+
+        [[nodiscard]] bool is_dictionary() const noexcept {
+            return m_shape == nullptr;
+        }
 
-    [[nodiscard]] object& at(const object a_key) {
-        auto found = this->find(a_key);
+        // Null in dictionary mode.
+        [[nodiscard]] const shape* get_shape() const noexcept {
+            return m_shape;
+        }
 
-        if (found == this->cend()) {
-            throw std::out_of_range("Argument passed to at() was not in the map.");
+        // Value storage of a shape-mode table, indexed by shape slot.
+        [[nodiscard]] object& slot(const size_t a_index) noexcept {
+            return m_slots[a_index];
         }
 
-        return found->second;
-    }
+        // Position of a_key in the array part if it is a non-negative integer, else npos.
+        [[nodiscard]] static size_t array_index(const object& a_key) noexcept {
+            return a_key.is_integer() && a_key.get_integer() >= 0 ? static_cast<size_t>(a_key.get_integer()) : npos;
+        }
 
-    [[nodiscard]] const object& at(const object a_key) const {
-        auto found = this->find(a_key);
+        // Changes whenever dictionary or array entries may have moved, invalidating pointers obtained from find().
+        [[nodiscard]] size_t layout_version() const noexcept {
+            return m_layout_version;
+        }
 
-        if (found == this->cend()) {
-            throw std::out_of_range("Argument passed to at() was not in the map.");
+        [[nodiscard]] size_t size() const noexcept {
+            return (is_dictionary() ? m_dictionary.size() : m_slots.size()) + m_array.size();
         }
 
-        return found->second;
-    }
+        [[nodiscard]] object& operator[](const object a_key) {
+            const size_t array_position = array_index(a_key);
 
-    [[nodiscard]] object index(const object a_key) const {
-        auto found = this->find(a_key);
+            if (array_position < m_array.size()) {
+                return m_array[array_position];
+            }
+
+            if (array_position == m_array.size()) {
+                return append_array();
+            }
+
+            if (!is_dictionary()) {
+                if (a_key.is_string()) {
+                    const size_t index = m_shape->find(a_key);
+
+                    if (index != shape::npos) {
+                        return m_slots[index];
+                    }
+
+                    if (m_shape->size() < shape::max_properties) {
+                        if (shape* next = m_shape->transition(a_key)) {
+                            m_shape = next;
+                            return m_slots.emplace_back();
+                        }
+                    }
+                }
+
+                convert_to_dictionary();
+            }
 
-        if (found == this->cend()) {
-            return {};
+            auto [position, inserted] = m_dictionary.emplace(a_key, object());
+
+            if (inserted) {
+                ++m_layout_version;
+            }
+
+            return position->second;
         }
 
-        return found->second;
-    }
+        // Pointer to the value stored under a_key, or nullptr.
+        [[nodiscard]] object* find(const object& a_key) noexcept {
+            const size_t array_position = array_index(a_key);
+
+            if (array_position < m_array.size()) {
+                return &m_array[array_position];
+            }
+
+            if (!is_dictionary()) {
+                if (!a_key.is_string()) {
+                    return nullptr;
+                }
 
-    void add(const table& a_table) {
-        for (const std::pair<object, object>& pair : a_table) {
-            emplace(pair);
+                const size_t index = m_shape->find(a_key);
+                return index == shape::npos ? nullptr : &m_slots[index];
+            }
+
+            auto found = m_dictionary.find(a_key);
+            return found == m_dictionary.end() ? nullptr : &found->second;
         }
-    }
 
-    public:
+        [[nodiscard]] const object* find(const object& a_key) const noexcept {
+            return const_cast<table*>(this)->find(a_key);
+        }
+
+        [[nodiscard]] object& at(const object a_key) {
+            object* found = find(a_key);
 
-    [[nodiscard]] friend bool operator==(const table& lhs, const table& rhs) {
-        if (lhs.size() != rhs.size()) {
-            return false;
+            if (found == nullptr) {
+                throw std::out_of_range("Argument passed to at() was not in the map.");
+            }
+
+            return *found;
+        }
+
+        [[nodiscard]] const object& at(const object a_key) const {
+            const object* found = find(a_key);
+
+            if (found == nullptr) {
+                throw std::out_of_range("Argument passed to at() was not in the map.");
+            }
+
+            return *found;
         }
 
-        for (const std::pair<object, object>& value : lhs) {
-            auto found = rhs.find(value.first);
+        [[nodiscard]] object index(const object a_key) const {
+            const object* found = find(a_key);
+            return found == nullptr ? object() : *found;
+        }
 
-            if (found == rhs.end() || value.second != found->second){
+        // Inserts a_value under a_key unless the key is already present. Returns whether it was inserted.
+        bool emplace(const object a_key, const object a_value) {
+            if (find(a_key) != nullptr) {
                 return false;
             }
+
+            (*this)[a_key] = a_value;
+            return true;
         }
 
-        return true;
-    }
+        // Erasing from the array part moves the keys after a_key to the dictionary.
+        void erase(const object a_key) {
+            convert_to_dictionary();
 
-    [[nodiscard]] friend bool operator!=(const table& lhs, const table& rhs) {
-        return !(lhs == rhs);
-    }
+            const size_t array_position = array_index(a_key);
 
-    // TODO: Add "add" and "add assignment" operator.
+            if (array_position < m_array.size()) {
+                for (size_t i = array_position + 1; i < m_array.size(); ++i) {
+                    m_dictionary.emplace(static_cast<integer>(i), std::move(m_array[i]));
+                }
 
-    [[nodiscard]] friend object index(const table* a_table, const object& a_key) {
-        auto found = a_table->find(a_key);
+                m_array.resize(array_position);
+                ++m_layout_version;
 
-        if (found == a_table->end()) {
-            return object();
+                return;
+            }
+
+            if (m_dictionary.erase(a_key) != 0) {
+                ++m_layout_version;
+            }
+        }
+
+        // Releases every entry. The table is left an empty dictionary.
+        void clear() noexcept {
+            std::vector<object> slots;
+            std::vector<object> elements;
+            dictionary entries;
+
+            slots.swap(m_slots);
+            elements.swap(m_array);
+            entries.swap(m_dictionary);
+            m_shape = nullptr;
+            ++m_layout_version;
+        }
+
+        // Calls a_function with every key and value: the array part in order, then the remaining keys, in insertion
+        // order for shape-mode tables.
+        template <typename t_function>
+        void for_each(t_function&& a_function) const {
+            for (size_t i = 0; i < m_array.size(); ++i) {
+                a_function(object(static_cast<integer>(i)), m_array[i]);
+            }
+
+            if (is_dictionary()) {
+                for (const std::pair<object, object>& pair : m_dictionary) {
+                    a_function(pair.first, pair.second);
+                }
+            } else {
+                const std::vector<object>& keys = m_shape->keys();
+
+                for (size_t i = 0; i < m_slots.size(); ++i) {
+                    a_function(keys[i], m_slots[i]);
+                }
+            }
+        }
+
+        void add(const table& a_table) {
+            a_table.for_each([this](const object& a_key, const object& a_value) {
+                emplace(a_key, a_value);
+            });
+        }
+
+        [[nodiscard]] friend bool operator==(const table& lhs, const table& rhs) {
+            if (lhs.size() != rhs.size()) {
+                return false;
+            }
+
+            bool equal = true;
+
+            lhs.for_each([&rhs, &equal](const object& a_key, const object& a_value) {
+                const object* found = rhs.find(a_key);
+
+                if (found == nullptr || a_value != *found) {
+                    equal = false;
+                }
+            });
+
+            return equal;
         }
 
-        return found->second;
-    }
+        [[nodiscard]] friend bool operator!=(const table& lhs, const table& rhs) {
+            return !(lhs == rhs);
+        }
+
+        // TODO: Add "add" and "add assignment" operator.
+
+        [[nodiscard]] friend object index(const table* a_table, const object& a_key) {
+            return a_table->index(a_key);
+        }
+
+        friend void emplace(table* a_table, const object a_key, const object a_value) {
+            a_table->emplace(a_key, a_value);
+        }
+
+    private:
+        // Adds the key m_array.size() to the array part, taking its value and those of the keys that follow it from
+        // the dictionary.
+        object& append_array() {
+            const object* const previous_data = m_array.data();
+            const size_t position = m_array.size();
+            m_array.emplace_back();
+
+            if (is_dictionary() && !m_dictionary.empty()) {
+                for (size_t i = position + 1;; ++i) {
+                    auto found = m_dictionary.find(static_cast<integer>(i));
+
+                    if (found == m_dictionary.end()) {
+                        break;
+                    }
+
+                    m_array.emplace_back(std::move(found->second));
+                    m_dictionary.erase(found);
+                    ++m_layout_version;
+                }
+            }
 
-    friend void emplace(table* a_table, const object a_key, const object a_value) {
-        a_table->emplace(a_key, a_value);
-    }
-};
+            if (m_array.data() != previous_data) {
+                ++m_layout_version;
+            }
+
+            return m_array[position];
+        }
+
+        void convert_to_dictionary() {
+            if (is_dictionary()) {
+                return;
+            }
+
+            const std::vector<object>& keys = m_shape->keys();
+            m_dictionary.reserve(m_slots.size());
+
+            for (size_t i = 0; i < m_slots.size(); ++i) {
+                m_dictionary.emplace(keys[i], std::move(m_slots[i]));
+            }
+
+            m_shape = nullptr;
+            ++m_layout_version;
+            m_slots.clear();
+            m_slots.shrink_to_fit();
+        }
+    };
 }
 
 #endif //REBAR_TABLE_HPP
@@ -0,0 +1,630 @@
+//
+// Created by maxng on 6/21/2022.
+//
+
+#ifndef REBAR_TYPED_ARRAY_HPP
+#define REBAR_TYPED_ARRAY_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "definitions.hpp"
+
+#if defined(__AVX2__)
+    #define REBAR_AVX2
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(REBAR_AVX2)
+    #define REBAR_SSE2
+#endif
+
+#if defined(REBAR_AVX2)
+    #include <immintrin.h>
+#elif defined(REBAR_SSE2)
+    #include <emmintrin.h>
+#endif
+
+namespace rebar {
+    namespace detail {
+        // Adds or multiplies in unsigned arithmetic for integers, so overflow wraps instead of being undefined.
+        template <typename t_value>
+        [[nodiscard]] t_value wrapping_add(const t_value a_lhs, const t_value a_rhs) noexcept {
+            if constexpr (std::is_integral_v<t_value>) {
+                using unsigned_value = std::make_unsigned_t<t_value>;
+                return static_cast<t_value>(static_cast<unsigned_value>(static_cast<unsigned_value>(a_lhs) + static_cast<unsigned_value>(a_rhs)));
+            } else {
+                return a_lhs + a_rhs;
+            }
+        }
+
+        template <typename t_value>
+        [[nodiscard]] t_value wrapping_multiply(const t_value a_lhs, const t_value a_rhs) noexcept {
+            if constexpr (std::is_integral_v<t_value>) {
+                // Promote to at least unsigned int, as unsigned short/char would otherwise be multiplied as int.
+                using unsigned_value = std::common_type_t<std::make_unsigned_t<t_value>, unsigned int>;
+                return static_cast<t_value>(static_cast<unsigned_value>(a_lhs) * static_cast<unsigned_value>(a_rhs));
+            } else {
+                return a_lhs * a_rhs;
+            }
+        }
+
+        template <typename t_sum, typename t_value>
+        [[nodiscard]] t_sum wrapping_sum(const t_value* a_values, const size_t a_size) noexcept {
+            t_sum total = 0;
+
+            for (size_t i = 0; i < a_size; ++i) {
+                total = wrapping_add(total, static_cast<t_sum>(a_values[i]));
+            }
+
+            return total;
+        }
+
+        // Portable bulk operations, used for element types and instruction sets without vector_traits.
+        template <typename t_element>
+        struct scalar_kernels {
+            static void add(t_element* a_elements, const t_element* a_operands, const size_t a_size) noexcept {
+                for (size_t i = 0; i < a_size; ++i) {
+                    a_elements[i] = wrapping_add(a_elements[i], a_operands[i]);
+                }
+            }
+
+            static void add(t_element* a_elements, const t_element a_operand, const size_t a_size) noexcept {
+                for (size_t i = 0; i < a_size; ++i) {
+                    a_elements[i] = wrapping_add(a_elements[i], a_operand);
+                }
+            }
+
+            static void multiply(t_element* a_elements, const t_element* a_operands, const size_t a_size) noexcept {
+                for (size_t i = 0; i < a_size; ++i) {
+                    a_elements[i] = wrapping_multiply(a_elements[i], a_operands[i]);
+                }
+            }
+
+            static void multiply(t_element* a_elements, const t_element a_operand, const size_t a_size) noexcept {
+                for (size_t i = 0; i < a_size; ++i) {
+                    a_elements[i] = wrapping_multiply(a_elements[i], a_operand);
+                }
+            }
+
+            template <typename t_sum>
+            [[nodiscard]] static t_sum sum(const t_element* a_elements, const size_t a_size) noexcept {
+                return wrapping_sum<t_sum>(a_elements, a_size);
+            }
+
+            // a_size must not be 0.
+            [[nodiscard]] static t_element min(const t_element* a_elements, const size_t a_size) noexcept {
+                return *std::min_element(a_elements, a_elements + a_size);
+            }
+
+            [[nodiscard]] static t_element max(const t_element* a_elements, const size_t a_size) noexcept {
+                return *std::max_element(a_elements, a_elements + a_size);
+            }
+
+            // Comparisons write 1 to a_results where they hold and 0 elsewhere. a_operand is either an element or a
+            // pointer to as many elements.
+            template <typename t_operand>
+            static void equal(const t_element* a_elements, const t_operand a_operand, uint8_t* a_results, const size_t a_size) noexcept {
+                for (size_t i = 0; i < a_size; ++i) {
+                    a_results[i] = a_elements[i] == operand_at(a_operand, i);
+                }
+            }
+
+            template <typename t_operand>
+            static void less(const t_element* a_elements, const t_operand a_operand, uint8_t* a_results, const size_t a_size) noexcept {
+                for (size_t i = 0; i < a_size; ++i) {
+                    a_results[i] = a_elements[i] < operand_at(a_operand, i);
+                }
+            }
+
+            template <typename t_operand>
+            static void greater(const t_element* a_elements, const t_operand a_operand, uint8_t* a_results, const size_t a_size) noexcept {
+                for (size_t i = 0; i < a_size; ++i) {
+                    a_results[i] = a_elements[i] > operand_at(a_operand, i);
+                }
+            }
+
+            template <typename t_operand>
+            [[nodiscard]] static t_element operand_at(const t_operand a_operand, const size_t a_index) noexcept {
+                if constexpr (std::is_pointer_v<t_operand>) {
+                    return a_operand[a_index];
+                } else {
+                    return a_operand;
+                }
+            }
+        };
+
+        // Register operations for an element type: width elements per vector, has_multiply and has_order (min,
+        // max, less and greater) for the optional operations. accumulate() folds a vector into an accumulator of
+        // sum_lane lanes, and store_mask() writes a comparison result as 0/1 bytes.
+        template <typename t_element>
+        struct vector_traits;
+
+#if defined(REBAR_AVX2)
+        template <>
+        struct vector_traits<int64_t> {
+            using vector = __m256i;
+            using sum_lane = int64_t;
+
+            static constexpr size_t width = 4;
+            static constexpr bool has_multiply = false;
+            static constexpr bool has_order = true;
+
+            [[nodiscard]] static vector load(const int64_t* a_source) noexcept { return _mm256_loadu_si256(reinterpret_cast<const vector*>(a_source)); }
+            static void store(int64_t* a_target, const vector a_value) noexcept { _mm256_storeu_si256(reinterpret_cast<vector*>(a_target), a_value); }
+            [[nodiscard]] static vector broadcast(const int64_t a_value) noexcept { return _mm256_set1_epi64x(a_value); }
+            [[nodiscard]] static vector zero() noexcept { return _mm256_setzero_si256(); }
+            [[nodiscard]] static vector add(const vector a_lhs, const vector a_rhs) noexcept { return _mm256_add_epi64(a_lhs, a_rhs); }
+            [[nodiscard]] static vector accumulate(const vector a_total, const vector a_value) noexcept { return _mm256_add_epi64(a_total, a_value); }
+            [[nodiscard]] static vector min(const vector a_lhs, const vector a_rhs) noexcept { return _mm256_blendv_epi8(a_lhs, a_rhs, _mm256_cmpgt_epi64(a_lhs, a_rhs)); }
+            [[nodiscard]] static vector max(const vector a_lhs, const vector a_rhs) noexcept { return _mm256_blendv_epi8(a_rhs, a_lhs, _mm256_cmpgt_epi64(a_lhs, a_rhs)); }
+            [[nodiscard]] static vector equal(const vector a_lhs, const vector a_rhs) noexcept { return _mm256_cmpeq_epi64(a_lhs, a_rhs); }
+            [[nodiscard]] static vector less(const vector a_lhs, const vector a_rhs) noexcept { return _mm256_cmpgt_epi64(a_rhs, a_lhs); }
+            [[nodiscard]] static vector greater(const vector a_lhs, const vector a_rhs) noexcept { return _mm256_cmpgt_epi64(a_lhs, a_rhs); }
+
+            static void store_mask(uint8_t* a_target, const vector a_mask) noexcept {
+                const int bits = _mm256_movemask_pd(_mm256_castsi256_pd(a_mask));
+
+                for (size_t lane = 0; lane < width; ++lane) {
+                    a_target[lane] = static_cast<uint8_t>((bits >> lane) & 1);
+                }
+            }
+        };
+
+        template <>
+        struct vector_traits<double> {
+            using vector = __m256d;
+            using sum_lane = double;
+
+            static constexpr size_t width = 4;
+            static constexpr bool has_multiply = true;
+            static constexpr bool has_order = true;
+
+            [[nodiscard]] static vector load(const double* a_source) noexcept { return _mm256_loadu_pd(a_source); }
+            static void store(double* a_target, const vector a_value) noexcept { _mm256_storeu_pd(a_target, a_value); }
+            [[nodiscard]] static vector broadcast(const double a_value) noexcept { return _mm256_set1_pd(a_value); }
+            [[nodiscard]] static vector zero() noexcept { return _mm256_setzero_pd(); }
+            [[nodiscard]] static vector add(const vector a_lhs, const vector a_rhs) noexcept { return _mm256_add_pd(a_lhs, a_rhs); }
+            [[nodiscard]] static vector multiply(const vector a_lhs, const vector a_rhs) noexcept { return _mm256_mul_pd(a_lhs, a_rhs); }
+            [[nodiscard]] static vector accumulate(const vector a_total, const vector a_value) noexcept { return _mm256_add_pd(a_total, a_value); }
+            [[nodiscard]] static vector min(const vector a_lhs, const vector a_rhs) noexcept { return _mm256_min_pd(a_lhs, a_rhs); }
+            [[nodiscard]] static vector max(const vector a_lhs, const vector a_rhs) noexcept { return _mm256_max_pd(a_lhs, a_rhs); }
+            [[nodiscard]] static vector equal(const vector a_lhs, const vector a_rhs) noexcept { return _mm256_cmp_pd(a_lhs, a_rhs, _CMP_EQ_OQ); }
+            [[nodiscard]] static vector less(const vector a_lhs, const vector a_rhs) noexcept { return _mm256_cmp_pd(a_lhs, a_rhs, _CMP_LT_OQ); }
+            [[nodiscard]] static vector greater(const vector a_lhs, const vector a_rhs) noexcept { return _mm256_cmp_pd(a_lhs, a_rhs, _CMP_GT_OQ); }
+
+            static void store_mask(uint8_t* a_target, const vector a_mask) noexcept {
+                const int bits = _mm256_movemask_pd(a_mask);
+
+                for (size_t lane = 0; lane < width; ++lane) {
+                    a_target[lane] = static_cast<uint8_t>((bits >> lane) & 1);
+                }
+            }
+        };
+
+        template <>
+        struct vector_traits<uint8_t> {
+            using vector = __m256i;
+            using sum_lane = int64_t;
+
+            static constexpr size_t width = 32;
+            static constexpr bool has_multiply = false;
+            static constexpr bool has_order = true;
+
+            [[nodiscard]] static vector load(const uint8_t* a_source) noexcept { return _mm256_loadu_si256(reinterpret_cast<const vector*>(a_source)); }
+            static void store(uint8_t* a_target, const vector a_value) noexcept { _mm256_storeu_si256(reinterpret_cast<vector*>(a_target), a_value); }
+            [[nodiscard]] static vector broadcast(const uint8_t a_value) noexcept { return _mm256_set1_epi8(static_cast<char>(a_value)); }
+            [[nodiscard]] static vector zero() noexcept { return _mm256_setzero_si256(); }
+            [[nodiscard]] static vector add(const vector a_lhs, const vector a_rhs) noexcept { return _mm256_add_epi8(a_lhs, a_rhs); }
+            [[nodiscard]] static vector accumulate(const vector a_total, const vector a_value) noexcept { return _mm256_add_epi64(a_total, _mm256_sad_epu8(a_value, zero())); }
+            [[nodiscard]] static vector min(const vector a_lhs, const vector a_rhs) noexcept { return _mm256_min_epu8(a_lhs, a_rhs); }
+            [[nodiscard]] static vector max(const vector a_lhs, const vector a_rhs) noexcept { return _mm256_max_epu8(a_lhs, a_rhs); }
+            [[nodiscard]] static vector equal(const vector a_lhs, const vector a_rhs) noexcept { return _mm256_cmpeq_epi8(a_lhs, a_rhs); }
+            [[nodiscard]] static vector less(const vector a_lhs, const vector a_rhs) noexcept { return greater(a_rhs, a_lhs); }
+
+            // Unsigned: lhs > rhs where max(lhs, rhs) is lhs and they differ.
+            [[nodiscard]] static vector greater(const vector a_lhs, const vector a_rhs) noexcept {
+                return _mm256_andnot_si256(_mm256_cmpeq_epi8(a_lhs, a_rhs), _mm256_cmpeq_epi8(_mm256_max_epu8(a_lhs, a_rhs), a_lhs));
+            }
+
+            static void store_mask(uint8_t* a_target, const vector a_mask) noexcept {
+                store(a_target, _mm256_and_si256(a_mask, broadcast(1)));
+            }
+        };
+#elif defined(REBAR_SSE2)
+        // SSE2 has no 64-bit ordered comparison, so integer min, max, less and greater stay portable.
+        template <>
+        struct vector_traits<int64_t> {
+            using vector = __m128i;
+            using sum_lane = int64_t;
+
+            static constexpr size_t width = 2;
+            static constexpr bool has_multiply = false;
+            static constexpr bool has_order = false;
+
+            [[nodiscard]] static vector load(const int64_t* a_source) noexcept { return _mm_loadu_si128(reinterpret_cast<const vector*>(a_source)); }
+            static void store(int64_t* a_target, const vector a_value) noexcept { _mm_storeu_si128(reinterpret_cast<vector*>(a_target), a_value); }
+            [[nodiscard]] static vector broadcast(const int64_t a_value) noexcept { return _mm_set1_epi64x(a_value); }
+            [[nodiscard]] static vector zero() noexcept { return _mm_setzero_si128(); }
+            [[nodiscard]] static vector add(const vector a_lhs, const vector a_rhs) noexcept { return _mm_add_epi64(a_lhs, a_rhs); }
+            [[nodiscard]] static vector accumulate(const vector a_total, const vector a_value) noexcept { return _mm_add_epi64(a_total, a_value); }
+
+            // Both 32-bit halves equal.
+            [[nodiscard]] static vector equal(const vector a_lhs, const vector a_rhs) noexcept {
+                const vector halves = _mm_cmpeq_epi32(a_lhs, a_rhs);
+                return _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+            }
+
+            static void store_mask(uint8_t* a_target, const vector a_mask) noexcept {
+                const int bits = _mm_movemask_pd(_mm_castsi128_pd(a_mask));
+
+                a_target[0] = static_cast<uint8_t>(bits & 1);
+                a_target[1] = static_cast<uint8_t>((bits >> 1) & 1);
+            }
+        };
+
+        template <>
+        struct vector_traits<double> {
+            using vector = __m128d;
+            using sum_lane = double;
+
+            static constexpr size_t width = 2;
+            static constexpr bool has_multiply = true;
+            static constexpr bool has_order = true;
+
+            [[nodiscard]] static vector load(const double* a_source) noexcept { return _mm_loadu_pd(a_source); }
+            static void store(double* a_target, const vector a_value) noexcept { _mm_storeu_pd(a_target, a_value); }
+            [[nodiscard]] static vector broadcast(const double a_value) noexcept { return _mm_set1_pd(a_value); }
+            [[nodiscard]] static vector zero() noexcept { return _mm_setzero_pd(); }
+            [[nodiscard]] static vector add(const vector a_lhs, const vector a_rhs) noexcept { return _mm_add_pd(a_lhs, a_rhs); }
+            [[nodiscard]] static vector multiply(const vector a_lhs, const vector a_rhs) noexcept { return _mm_mul_pd(a_lhs, a_rhs); }
+            [[nodiscard]] static vector accumulate(const vector a_total, const vector a_value) noexcept { return _mm_add_pd(a_total, a_value); }
+            [[nodiscard]] static vector min(const vector a_lhs, const vector a_rhs) noexcept { return _mm_min_pd(a_lhs, a_rhs); }
+            [[nodiscard]] static vector max(const vector a_lhs, const vector a_rhs) noexcept { return _mm_max_pd(a_lhs, a_rhs); }
+            [[nodiscard]] static vector equal(const vector a_lhs, const vector a_rhs) noexcept { return _mm_cmpeq_pd(a_lhs, a_rhs); }
+            [[nodiscard]] static vector less(const vector a_lhs, const vector a_rhs) noexcept { return _mm_cmplt_pd(a_lhs, a_rhs); }
+            [[nodiscard]] static vector greater(const vector a_lhs, const vector a_rhs) noexcept { return _mm_cmpgt_pd(a_lhs, a_rhs); }
+
+            static void store_mask(uint8_t* a_target, const vector a_mask) noexcept {
+                const int bits = _mm_movemask_pd(a_mask);
+
+                a_target[0] = static_cast<uint8_t>(bits & 1);
+                a_target[1] = static_cast<uint8_t>((bits >> 1) & 1);
+            }
+        };
+
+        template <>
+        struct vector_traits<uint8_t> {
+            using vector = __m128i;
+            using sum_lane = int64_t;
+
+            static constexpr size_t width = 16;
+            static constexpr bool has_multiply = false;
+            static constexpr bool has_order = true;
+
+            [[nodiscard]] static vector load(const uint8_t* a_source) noexcept { return _mm_loadu_si128(reinterpret_cast<const vector*>(a_source)); }
+            static void store(uint8_t* a_target, const vector a_value) noexcept { _mm_storeu_si128(reinterpret_cast<vector*>(a_target), a_value); }
+            [[nodiscard]] static vector broadcast(const uint8_t a_value) noexcept { return _mm_set1_epi8(static_cast<char>(a_value)); }
+            [[nodiscard]] static vector zero() noexcept { return _mm_setzero_si128(); }
+            [[nodiscard]] static vector add(const vector a_lhs, const vector a_rhs) noexcept { return _mm_add_epi8(a_lhs, a_rhs); }
+            [[nodiscard]] static vector accumulate(const vector a_total, const vector a_value) noexcept { return _mm_add_epi64(a_total, _mm_sad_epu8(a_value, zero())); }
+            [[nodiscard]] static vector min(const vector a_lhs, const vector a_rhs) noexcept { return _mm_min_epu8(a_lhs, a_rhs); }
+            [[nodiscard]] static vector max(const vector a_lhs, const vector a_rhs) noexcept { return _mm_max_epu8(a_lhs, a_rhs); }
+            [[nodiscard]] static vector equal(const vector a_lhs, const vector a_rhs) noexcept { return _mm_cmpeq_epi8(a_lhs, a_rhs); }
+            [[nodiscard]] static vector less(const vector a_lhs, const vector a_rhs) noexcept { return greater(a_rhs, a_lhs); }
+
+            // Unsigned: lhs > rhs where max(lhs, rhs) is lhs and they differ.
+            [[nodiscard]] static vector greater(const vector a_lhs, const vector a_rhs) noexcept {
+                return _mm_andnot_si128(_mm_cmpeq_epi8(a_lhs, a_rhs), _mm_cmpeq_epi8(_mm_max_epu8(a_lhs, a_rhs), a_lhs));
+            }
+
+            static void store_mask(uint8_t* a_target, const vector a_mask) noexcept {
+                store(a_target, _mm_and_si128(a_mask, broadcast(1)));
+            }
+        };
+#endif
+
+        template <typename t_element, typename = void>
+        struct typed_array_kernels : scalar_kernels<t_element> {};
+
+        // Processes whole vectors of traits::width elements and leaves the remainder to the portable loops. Sums
+        // of numbers are accumulated per lane, so they may round differently from a sequential sum.
+        template <typename t_element>
+        struct typed_array_kernels<t_element, std::void_t<decltype(vector_traits<t_element>::width)>> : scalar_kernels<t_element> {
+            using traits = vector_traits<t_element>;
+            using scalar = scalar_kernels<t_element>;
+            using vector = typename traits::vector;
+
+            static constexpr size_t width = traits::width;
+
+            static void add(t_element* a_elements, const t_element* a_operands, const size_t a_size) noexcept {
+                size_t i = 0;
+
+                for (; i + width <= a_size; i += width) {
+                    traits::store(a_elements + i, traits::add(traits::load(a_elements + i), traits::load(a_operands + i)));
+                }
+
+                scalar::add(a_elements + i, a_operands + i, a_size - i);
+            }
+
+            static void add(t_element* a_elements, const t_element a_operand, const size_t a_size) noexcept {
+                const vector operand = traits::broadcast(a_operand);
+                size_t i = 0;
+
+                for (; i + width <= a_size; i += width) {
+                    traits::store(a_elements + i, traits::add(traits::load(a_elements + i), operand));
+                }
+
+                scalar::add(a_elements + i, a_operand, a_size - i);
+            }
+
+            template <typename t_operand>
+            static void multiply(t_element* a_elements, const t_operand a_operand, const size_t a_size) noexcept {
+                size_t i = 0;
+
+                if constexpr (traits::has_multiply) {
+                    for (; i + width <= a_size; i += width) {
+                        traits::store(a_elements + i, traits::multiply(traits::load(a_elements + i), load_operand(a_operand, i)));
+                    }
+                }
+
+                scalar::multiply(a_elements + i, offset_operand(a_operand, i), a_size - i);
+            }
+
+            template <typename t_sum>
+            [[nodiscard]] static t_sum sum(const t_element* a_elements, const size_t a_size) noexcept {
+                vector total = traits::zero();
+                size_t i = 0;
+
+                for (; i + width <= a_size; i += width) {
+                    total = traits::accumulate(total, traits::load(a_elements + i));
+                }
+
+                typename traits::sum_lane lanes[sizeof(vector) / sizeof(typename traits::sum_lane)];
+                std::memcpy(lanes, &total, sizeof(vector));
+
+                return wrapping_add(wrapping_sum<t_sum>(lanes, std::size(lanes)), scalar::template sum<t_sum>(a_elements + i, a_size - i));
+            }
+
+            [[nodiscard]] static t_element min(const t_element* a_elements, const size_t a_size) noexcept {
+                if constexpr (traits::has_order) {
+                    return extreme(a_elements, a_size, [](const vector a_lhs, const vector a_rhs) { return traits::min(a_lhs, a_rhs); }, scalar::min);
+                } else {
+                    return scalar::min(a_elements, a_size);
+                }
+            }
+
+            [[nodiscard]] static t_element max(const t_element* a_elements, const size_t a_size) noexcept {
+                if constexpr (traits::has_order) {
+                    return extreme(a_elements, a_size, [](const vector a_lhs, const vector a_rhs) { return traits::max(a_lhs, a_rhs); }, scalar::max);
+                } else {
+                    return scalar::max(a_elements, a_size);
+                }
+            }
+
+            template <typename t_operand>
+            static void equal(const t_element* a_elements, const t_operand a_operand, uint8_t* a_results, const size_t a_size) noexcept {
+                const size_t i = compare(a_elements, a_operand, a_results, a_size, [](const vector a_lhs, const vector a_rhs) { return traits::equal(a_lhs, a_rhs); });
+                scalar::equal(a_elements + i, offset_operand(a_operand, i), a_results + i, a_size - i);
+            }
+
+            template <typename t_operand>
+            static void less(const t_element* a_elements, const t_operand a_operand, uint8_t* a_results, const size_t a_size) noexcept {
+                size_t i = 0;
+
+                if constexpr (traits::has_order) {
+                    i = compare(a_elements, a_operand, a_results, a_size, [](const vector a_lhs, const vector a_rhs) { return traits::less(a_lhs, a_rhs); });
+                }
+
+                scalar::less(a_elements + i, offset_operand(a_operand, i), a_results + i, a_size - i);
+            }
+
+            template <typename t_operand>
+            static void greater(const t_element* a_elements, const t_operand a_operand, uint8_t* a_results, const size_t a_size) noexcept {
+                size_t i = 0;
+
+                if constexpr (traits::has_order) {
+                    i = compare(a_elements, a_operand, a_results, a_size, [](const vector a_lhs, const vector a_rhs) { return traits::greater(a_lhs, a_rhs); });
+                }
+
+                scalar::greater(a_elements + i, offset_operand(a_operand, i), a_results + i, a_size - i);
+            }
+
+        private:
+            template <typename t_operand>
+            [[nodiscard]] static vector load_operand(const t_operand a_operand, const size_t a_index) noexcept {
+                if constexpr (std::is_pointer_v<t_operand>) {
+                    return traits::load(a_operand + a_index);
+                } else {
+                    return traits::broadcast(a_operand);
+                }
+            }
+
+            template <typename t_operand>
+            [[nodiscard]] static t_operand offset_operand(const t_operand a_operand, const size_t a_index) noexcept {
+                if constexpr (std::is_pointer_v<t_operand>) {
+                    return a_operand + a_index;
+                } else {
+                    return a_operand;
+                }
+            }
+
+            // Reduces whole vectors with a_select, then the lanes and the remainder with a_reduce.
+            template <typename t_select, typename t_reduce>
+            [[nodiscard]] static t_element extreme(const t_element* a_elements, const size_t a_size, t_select&& a_select, t_reduce&& a_reduce) noexcept {
+                if (a_size < width) {
+                    return a_reduce(a_elements, a_size);
+                }
+
+                vector result = traits::load(a_elements);
+                size_t i = width;
+
+                for (; i + width <= a_size; i += width) {
+                    result = a_select(result, traits::load(a_elements + i));
+                }
+
+                t_element lanes[width + 1];
+                traits::store(lanes, result);
+                lanes[width] = i < a_size ? a_reduce(a_elements + i, a_size - i) : lanes[0];
+
+                return a_reduce(lanes, width + 1);
+            }
+
+            // Compares whole vectors; returns the number of elements compared.
+            template <typename t_operand, typename t_compare>
+            [[nodiscard]] static size_t compare(const t_element* a_elements, const t_operand a_operand, uint8_t* a_results, const size_t a_size, t_compare&& a_compare) noexcept {
+                size_t i = 0;
+
+                for (; i + width <= a_size; i += width) {
+                    traits::store_mask(a_results + i, a_compare(traits::load(a_elements + i), load_operand(a_operand, i)));
+                }
+
+                return i;
+            }
+        };
+    }
+
+    // Array of unboxed integers, numbers or bytes. Bulk operations run over the raw elements, vectorized with
+    // SSE2, or AVX2 where the compiler targets it. Exposed to scripts by the standard TypedArray library.
+    template <typename t_element>
+    class typed_array {
+        using kernels = detail::typed_array_kernels<t_element>;
+
+    public:
+        using element_type = t_element;
+
+        typed_array() = default;
+
+        explicit typed_array(const size_t a_size, const t_element a_value = t_element()) : m_elements(a_size, a_value) {}
+
+        [[nodiscard]] size_t size() const noexcept {
+            return m_elements.size();
+        }
+
+        [[nodiscard]] t_element* data() noexcept {
+            return m_elements.data();
+        }
+
+        [[nodiscard]] const t_element* data() const noexcept {
+            return m_elements.data();
+        }
+
+        [[nodiscard]] t_element get(const size_t a_index) const {
+            return m_elements.at(a_index);
+        }
+
+        void set(const size_t a_index, const t_element a_value) {
+            m_elements.at(a_index) = a_value;
+        }
+
+        void push(const t_element a_value) {
+            m_elements.push_back(a_value);
+        }
+
+        void resize(const size_t a_size) {
+            m_elements.resize(a_size);
+        }
+
+        void fill(const t_element a_value) noexcept {
+            std::fill(m_elements.begin(), m_elements.end(), a_value);
+        }
+
+        // Element-wise; operand arrays must be of the same size.
+        void add(const typed_array& a_operands) {
+            kernels::add(data(), check_size(a_operands).data(), size());
+        }
+
+        void add(const t_element a_operand) noexcept {
+            kernels::add(data(), a_operand, size());
+        }
+
+        void multiply(const typed_array& a_operands) {
+            kernels::multiply(data(), check_size(a_operands).data(), size());
+        }
+
+        void multiply(const t_element a_operand) noexcept {
+            kernels::multiply(data(), a_operand, size());
+        }
+
+        // Integer sums wrap on overflow.
+        template <typename t_sum = std::conditional_t<std::is_floating_point_v<t_element>, t_element, integer>>
+        [[nodiscard]] t_sum sum() const noexcept {
+            return kernels::template sum<t_sum>(data(), size());
+        }
+
+        // Throw std::out_of_range for empty arrays.
+        [[nodiscard]] t_element min() const {
+            return kernels::min(check_not_empty().data(), size());
+        }
+
+        [[nodiscard]] t_element max() const {
+            return kernels::max(check_not_empty().data(), size());
+        }
+
+        // Element-wise comparisons, yielding 1 where they hold and 0 elsewhere.
+        [[nodiscard]] typed_array<uint8_t> equal(const typed_array& a_operands) const {
+            typed_array<uint8_t> results(size());
+            kernels::equal(data(), check_size(a_operands).data(), results.data(), size());
+            return results;
+        }
+
+        [[nodiscard]] typed_array<uint8_t> equal(const t_element a_operand) const {
+            typed_array<uint8_t> results(size());
+            kernels::equal(data(), a_operand, results.data(), size());
+            return results;
+        }
+
+        [[nodiscard]] typed_array<uint8_t> less(const typed_array& a_operands) const {
+            typed_array<uint8_t> results(size());
+            kernels::less(data(), check_size(a_operands).data(), results.data(), size());
+            return results;
+        }
+
+        [[nodiscard]] typed_array<uint8_t> less(const t_element a_operand) const {
+            typed_array<uint8_t> results(size());
+            kernels::less(data(), a_operand, results.data(), size());
+            return results;
+        }
+
+        [[nodiscard]] typed_array<uint8_t> greater(const typed_array& a_operands) const {
+            typed_array<uint8_t> results(size());
+            kernels::greater(data(), check_size(a_operands).data(), results.data(), size());
+            return results;
+        }
+
+        [[nodiscard]] typed_array<uint8_t> greater(const t_element a_operand) const {
+            typed_array<uint8_t> results(size());
+            kernels::greater(data(), a_operand, results.data(), size());
+            return results;
+        }
+
+    private:
+        std::vector<t_element> m_elements;
+
+        const typed_array& check_size(const typed_array& a_operands) const {
+            if (a_operands.size() != size()) {
+                throw std::out_of_range("Typed arrays passed to an element-wise operation differ in size.");
+            }
+
+            return a_operands;
+        }
+
+        const typed_array& check_not_empty() const {
+            if (m_elements.empty()) {
+                throw std::out_of_range("Typed array is empty.");
+            }
+
+            return *this;
+        }
+    };
+
+    using integer_array = typed_array<integer>;
+    using number_array = typed_array<number>;
+    using byte_array = typed_array<uint8_t>;
+}
+
+#endif //REBAR_TYPED_ARRAY_HPP
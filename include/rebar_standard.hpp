@@ -16,23 +16,43 @@ namespace rebar::standard {
         virtual object load(environment&) = 0;
     };
 
+    // Libraries of the standard library, by identifier. Filled during static initialization and only read
+    // afterwards. Libraries keep no state of their own; each environment loads its own exports through
+    // environment::load_library.
     std::map<std::string_view, library*> registry;
 
+    // Registers the library it holds, which lives as long as the definition.
     template <const char* v_identifier, class t_library>
     struct define_library {
+        t_library m_library;
+
         define_library() {
-            registry[v_identifier] = new t_library;
+            registry[v_identifier] = &m_library;
         }
     };
 
+    // Defines a_identifier in a_environment from the standard registry unless the environment already defines it,
+    // then loads it.
     object load_library(environment& a_environment, const std::string_view a_identifier) {
-        return registry[a_identifier]->load(a_environment);
+        if (!a_environment.has_library(a_identifier)) {
+            auto found = registry.find(a_identifier);
+
+            if (found != registry.cend()) {
+                library* const defined = found->second;
+
+                a_environment.define_library(a_identifier, [defined](environment& a_loading) {
+                    return defined->load(a_loading);
+                });
+            }
+        }
+
+        return a_environment.load_library(a_identifier);
     }
 
     void load_implicit_libraries(environment& a_environment) {
         for (auto& lib : registry) {
             if (lib.second->include == usage::implicit_include) {
-                lib.second->load(a_environment);
+                load_library(a_environment, lib.first);
             }
         }
     }
@@ -43,6 +63,7 @@ namespace rebar::standard {
         static rebar::object PrintLn(rebar::environment* env) {
             if (env->arg_count() == 0) {
                 std::cout << '\n';
+                return rebar::null;
             }
 
             std::cout << env->arg(0);
@@ -104,10 +125,7 @@ namespace rebar::standard {
             return null;
         }
 
-        static object EndsWith(environment* a_environment) {
-            std::string_view self = a_environment->arg(0).get_string().to_string_view();
-            std::string_view compare = a_environment->arg(1).get_string().to_string_view();
-
+        static bool EndsWith(const std::string_view self, const std::string_view compare) {
             if (compare.length() > self.length()) {
                 return false;
             }
@@ -115,10 +133,7 @@ namespace rebar::standard {
             return self.substr(self.length() - compare.length(), compare.length()) == compare;
         }
 
-        static object EqualsIgnoreCase(environment* a_environment) {
-            std::string_view self = a_environment->arg(0).get_string().to_string_view();
-            std::string_view compare = a_environment->arg(1).get_string().to_string_view();
-
+        static bool EqualsIgnoreCase(const std::string_view self, const std::string_view compare) {
             if (self.length() != compare.length()) {
                 return false;
             }
@@ -144,8 +159,8 @@ namespace rebar::standard {
             return null;
         }
 
-        static object Length(environment* a_environment) {
-            return static_cast<integer>(a_environment->arg(0).get_string().length());
+        static integer Length(const string self) {
+            return static_cast<integer>(self.length());
         }
 
         static object Matches(environment* a_environment) {
@@ -160,10 +175,7 @@ namespace rebar::standard {
             return null;
         }
 
-        static object StartsWith(environment* a_environment) {
-            std::string_view self = a_environment->arg(0).get_string().to_string_view();
-            std::string_view compare = a_environment->arg(1).get_string().to_string_view();
-
+        static bool StartsWith(const std::string_view self, const std::string_view compare) {
             if (compare.length() > self.length()) {
                 return false;
             }
@@ -175,31 +187,29 @@ namespace rebar::standard {
             return null;
         }
 
-        static object ToLowerCase(environment* a_environment) {
-            std::string_view self = a_environment->arg(0).get_string().to_string_view();
-
+        static std::string ToLowerCase(const std::string_view self) {
             std::string output;
-            output.reserve(self.length());
+            output.resize(self.length());
 
-            std::transform(self.begin(), self.end(), output.begin(), std::tolower);
+            std::transform(self.begin(), self.end(), output.begin(), [](const char ch) noexcept -> char {
+                return static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+            });
 
-            return a_environment->str(output);
+            return output;
         }
 
-        static object ToUpperCase(environment* a_environment) {
-            std::string_view self = a_environment->arg(0).get_string().to_string_view();
-
+        static std::string ToUpperCase(const std::string_view self) {
             std::string output;
-            output.reserve(self.length());
+            output.resize(self.length());
 
-            std::transform(self.begin(), self.end(), output.begin(), std::toupper);
+            std::transform(self.begin(), self.end(), output.begin(), [](const char ch) noexcept -> char {
+                return static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+            });
 
-            return a_environment->str(output);
+            return output;
         }
 
-        static object Trim(environment* a_environment) {
-            std::string_view self = a_environment->arg(0).get_string().to_string_view();
-
+        static std::string_view Trim(const std::string_view self) {
             auto begin_it = std::find_if(self.begin(), self.end(), [](const auto ch) noexcept -> bool {
                 return !std::isspace(ch);
             });
@@ -211,53 +221,49 @@ namespace rebar::standard {
             const auto begin_difference = begin_it - self.cbegin();
             const auto end_difference = end_it - self.crbegin();
 
-            return a_environment->str(self.substr(begin_difference, self.length() - (begin_difference + end_difference)));
+            return self.substr(begin_difference, self.length() - (begin_difference + end_difference));
         }
 
-        static object TrimLeft(environment* a_environment) {
-            std::string_view self = a_environment->arg(0).get_string().to_string_view();
-
+        static std::string_view TrimLeft(const std::string_view self) {
             auto begin_it = std::find_if(self.begin(), self.end(), [](const auto ch) noexcept -> bool {
                 return !std::isspace(ch);
             });
 
-            return a_environment->str(self.substr(begin_it - self.begin()));
+            return self.substr(begin_it - self.begin());
         }
 
-        static object TrimRight(environment* a_environment) {
-            std::string_view self = a_environment->arg(0).get_string().to_string_view();
-
+        static std::string_view TrimRight(const std::string_view self) {
             auto end_it = std::find_if(self.rbegin(), self.rend(), [](const auto ch) noexcept -> bool {
                 return !std::isspace(ch);
             });
 
-            return a_environment->str(self.substr(0, self.length() - (end_it - self.rbegin())));
+            return self.substr(0, self.length() - (end_it - self.rbegin()));
         }
 
         object load(environment& a_environment) override {
             auto& string_table = a_environment.get_string_virtual_table();
 
-            const auto define_string_function = [&a_environment, &string_table](const std::string_view a_identifier, callable a_function) noexcept {
-                string_table[a_environment.str(a_identifier)] = a_environment.bind(a_function);
+            const auto define_string_function = [&a_environment, &string_table](const std::string_view a_identifier, const object a_function) {
+                string_table[a_environment.str(a_identifier)] = a_function;
             };
 
-            define_string_function("Contains",         Contains);
-            define_string_function("EndsWith",         EndsWith);
-            define_string_function("EqualsIgnoreCase", EqualsIgnoreCase);
-            define_string_function("IndexOf",          IndexOf);
-            define_string_function("IsEmpty",          IsEmpty);
-            define_string_function("LastIndexOf",      LastIndexOf);
-            define_string_function("Length",           Length);
-            define_string_function("Matches",          Matches);
-            define_string_function("Replace",          Replace);
-            define_string_function("Split",            Split);
-            define_string_function("StartsWith",       StartsWith);
-            define_string_function("ToCharArray",      ToCharArray);
-            define_string_function("ToLowerCase",      ToLowerCase);
-            define_string_function("ToUpperCase",      ToUpperCase);
-            define_string_function("Trim",             Trim);
-            define_string_function("TrimLeft",         TrimLeft);
-            define_string_function("TrimRight",        TrimRight);
+            define_string_function("Contains",         a_environment.bind(Contains));
+            define_string_function("EndsWith",         a_environment.bind<EndsWith>());
+            define_string_function("EqualsIgnoreCase", a_environment.bind<EqualsIgnoreCase>());
+            define_string_function("IndexOf",          a_environment.bind(IndexOf));
+            define_string_function("IsEmpty",          a_environment.bind(IsEmpty));
+            define_string_function("LastIndexOf",      a_environment.bind(LastIndexOf));
+            define_string_function("Length",           a_environment.bind<Length>());
+            define_string_function("Matches",          a_environment.bind(Matches));
+            define_string_function("Replace",          a_environment.bind(Replace));
+            define_string_function("Split",            a_environment.bind(Split));
+            define_string_function("StartsWith",       a_environment.bind<StartsWith>());
+            define_string_function("ToCharArray",      a_environment.bind(ToCharArray));
+            define_string_function("ToLowerCase",      a_environment.bind<ToLowerCase>());
+            define_string_function("ToUpperCase",      a_environment.bind<ToUpperCase>());
+            define_string_function("Trim",             a_environment.bind<Trim>());
+            define_string_function("TrimLeft",         a_environment.bind<TrimLeft>());
+            define_string_function("TrimRight",        a_environment.bind<TrimRight>());
 
             return null;
         }
@@ -313,7 +319,7 @@ namespace rebar::standard {
 
             native_object n_obj = a_environment.create_native_object<std::vector<std::string>>(string_builder_virtual_table);
 
-            table* tbl = new table;
+            table* tbl = a_environment.create_table();
 
             (*tbl)[a_environment.str("StringBuilder")] = n_obj;
 
@@ -323,4 +329,96 @@ namespace rebar::standard {
 
     const char library_string_utility[] = "StringUtility";
     define_library<library_string_utility, string_utility> d_string_utility;
+
+    struct typed_array_utility : public library {
+        typed_array_utility() : library(usage::explicit_include) {}
+
+        // Applies a_operation to the array and either another array of the same class or an element.
+        template <typename t_element, typename t_operation>
+        static decltype(auto) with_operand(environment& a_environment, native_object self, object operand, t_operation&& a_operation) {
+            auto& elements = self.get_object<typed_array<t_element>>();
+
+            if (operand.is_native_object() && &operand.get_native_object().get_virtual_table() == &self.get_virtual_table()) {
+                return a_operation(elements, operand.get_native_object().get_object<typed_array<t_element>>());
+            }
+
+            return a_operation(elements, native_argument<t_element>(a_environment, 1));
+        }
+
+        static object wrap_mask(environment& a_environment, byte_array a_mask) {
+            return a_environment.create_native_object("REBAR::STD::BYTE_ARRAY", std::move(a_mask));
+        }
+
+        template <typename t_element>
+        static void Add(environment& a_environment, native_object self, object operand) {
+            with_operand<t_element>(a_environment, self, operand, [](auto& a_elements, const auto& a_operand) {
+                a_elements.add(a_operand);
+            });
+        }
+
+        template <typename t_element>
+        static void Multiply(environment& a_environment, native_object self, object operand) {
+            with_operand<t_element>(a_environment, self, operand, [](auto& a_elements, const auto& a_operand) {
+                a_elements.multiply(a_operand);
+            });
+        }
+
+        template <typename t_element>
+        static object Equal(environment& a_environment, native_object self, object operand) {
+            return wrap_mask(a_environment, with_operand<t_element>(a_environment, self, operand, [](auto& a_elements, const auto& a_operand) {
+                return a_elements.equal(a_operand);
+            }));
+        }
+
+        template <typename t_element>
+        static object Less(environment& a_environment, native_object self, object operand) {
+            return wrap_mask(a_environment, with_operand<t_element>(a_environment, self, operand, [](auto& a_elements, const auto& a_operand) {
+                return a_elements.less(a_operand);
+            }));
+        }
+
+        template <typename t_element>
+        static object Greater(environment& a_environment, native_object self, object operand) {
+            return wrap_mask(a_environment, with_operand<t_element>(a_environment, self, operand, [](auto& a_elements, const auto& a_operand) {
+                return a_elements.greater(a_operand);
+            }));
+        }
+
+        template <typename t_element>
+        static native_object define_typed_array(environment& a_environment, const std::string_view a_identifier) {
+            using array_type = typed_array<t_element>;
+
+            virtual_table& typed_array_virtual_table = a_environment.register_native_class(a_identifier, native_class<array_type>()
+                    .template constructor<size_t>()
+                    .template method<&array_type::size>("Size")
+                    .template method<&array_type::get>("Get")
+                    .template method<&array_type::set>("Set")
+                    .template method<&array_type::push>("Push")
+                    .template method<&array_type::resize>("Resize")
+                    .template method<&array_type::fill>("Fill")
+                    .template method<&array_type::template sum<>>("Sum")
+                    .template method<&array_type::min>("Min")
+                    .template method<&array_type::max>("Max")
+                    .template method<Add<t_element>>("Add")
+                    .template method<Multiply<t_element>>("Multiply")
+                    .template method<Equal<t_element>>("Equal")
+                    .template method<Less<t_element>>("Less")
+                    .template method<Greater<t_element>>("Greater"));
+
+            return a_environment.create_native_object<array_type>(typed_array_virtual_table);
+        }
+
+        object load(environment& a_environment) override {
+            table* tbl = a_environment.create_table();
+
+            (*tbl)[a_environment.str("IntArray")]    = define_typed_array<integer>(a_environment, "REBAR::STD::INT_ARRAY");
+            (*tbl)[a_environment.str("NumberArray")] = define_typed_array<number>(a_environment, "REBAR::STD::NUMBER_ARRAY");
+            (*tbl)[a_environment.str("ByteArray")]   = define_typed_array<uint8_t>(a_environment, "REBAR::STD::BYTE_ARRAY");
+
+            return tbl;
+        }
+    };
+
+    const char library_typed_array[] = "TypedArray";
+    define_library<library_typed_array, typed_array_utility> d_typed_array;
 }
\ No newline at end of file
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <rebar.hpp>
+#include <rebar_standard.hpp>
+
+// Runs one environment per thread, each on its own core, and checks that every environment computes the same
+// result. Usage: stress [threads] [rounds]. Environments only share a compile cache, which exercises the one
+// structure meant to be shared between threads. A second pass leases the environments from an environment_pool,
+// interning their strings in a shared string_interner, and reports how long acquiring one takes next to how long
+// cloning one takes.
+
+namespace {
+    constexpr rebar::integer expected_result = 46413;
+
+    const char* const script = R"(
+        local StringUtility = Include("StringUtility");
+        local TypedArray = Include("TypedArray");
+
+        local t = {};
+        local sum = 0;
+
+        for (local i = 0; i < 200; i++) {
+            t[i] = i * 2;
+        }
+
+        for (local i = 0; i < 200; i++) {
+            sum += t[i];
+        }
+
+        local elements = new TypedArray::IntArray(1000);
+        elements.Fill(3);
+        elements.Add(elements);
+        sum += elements.Sum();
+
+        local sb = new StringUtility::StringBuilder;
+        sb += "x";
+        sb.Append("yz");
+        sum += sb.ToString().ToUpperCase().Length();
+
+        function Fibonacci(n) {
+            if (n < 2) {
+                return n;
+            }
+
+            return Fibonacci(n - 1) + Fibonacci(n - 2);
+        }
+
+        return sum + Fibonacci(15);
+    )";
+
+    std::unique_ptr<rebar::environment> make_environment(const size_t a_index) {
+        switch (a_index % 3) {
+            case 0:
+                return std::make_unique<rebar::environment>(rebar::use_provider<rebar::interpreter>);
+            case 1:
+                return std::make_unique<rebar::environment>(rebar::use_provider<rebar::bytecode_provider>);
+            default:
+                return std::make_unique<rebar::environment>(rebar::use_provider<rebar::jit_provider>);
+        }
+    }
+
+    // Runs a_rounds fresh environments on each of a_threads threads. Returns the number of wrong results.
+    size_t run(const size_t a_threads, const size_t a_rounds, const std::shared_ptr<rebar::compile_cache>& a_cache) {
+        std::atomic<size_t> failures{ 0 };
+        std::vector<std::thread> threads;
+
+        for (size_t t = 0; t < a_threads; ++t) {
+            threads.emplace_back([t, a_rounds, &a_cache, &failures]() {
+                for (size_t round = 0; round < a_rounds; ++round) {
+                    std::unique_ptr<rebar::environment> env = make_environment(t + round);
+                    env->set_compile_cache(a_cache);
+                    rebar::standard::load_implicit_libraries(*env);
+
+                    rebar::object result = env->compile_string(script)();
+
+                    if (!result.is_integer() || result.get_integer() != expected_result) {
+                        std::cerr << "thread " << t << ", round " << round << ": expected " << expected_result << ", got " << result << '\n';
+                        ++failures;
+                    }
+                }
+            });
+        }
+
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        return failures;
+    }
+
+    // Like run(), with every round leasing a pre-warmed environment. Records how long each acquire() took.
+    size_t run_pooled(const size_t a_threads, const size_t a_rounds, rebar::environment_pool& a_pool, std::vector<double>& a_acquire_microseconds) {
+        std::atomic<size_t> failures{ 0 };
+        std::vector<std::thread> threads;
+
+        a_acquire_microseconds.assign(a_threads * a_rounds, 0.0);
+
+        for (size_t t = 0; t < a_threads; ++t) {
+            threads.emplace_back([t, a_rounds, &a_pool, &failures, &a_acquire_microseconds]() {
+                for (size_t round = 0; round < a_rounds; ++round) {
+                    const auto start = std::chrono::steady_clock::now();
+                    rebar::environment_pool::lease env = a_pool.acquire();
+                    a_acquire_microseconds[t * a_rounds + round] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+                    rebar::object result = env->compile_string(script)();
+
+                    if (!result.is_integer() || result.get_integer() != expected_result) {
+                        std::cerr << "pooled thread " << t << ", round " << round << ": expected " << expected_result << ", got " << result << '\n';
+                        ++failures;
+                    }
+                }
+            });
+        }
+
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        return failures;
+    }
+}
+
+int main(int argc, char** argv) {
+    const size_t hardware_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    const size_t thread_count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : hardware_threads;
+    const size_t rounds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20;
+
+    const auto cache = std::make_shared<rebar::compile_cache>();
+
+    const auto timed_run = [&cache, rounds](const size_t a_threads, size_t& a_failures) {
+        const auto start = std::chrono::steady_clock::now();
+        a_failures += run(a_threads, rounds, cache);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    size_t failures = 0;
+
+    const double single = timed_run(1, failures);
+    const double parallel = timed_run(thread_count, failures);
+
+    // Each thread does the work of the single-threaded run; perfect scaling keeps the time constant.
+    std::cout << "1 thread: " << single << " s, " << thread_count << " threads: " << parallel << " s, scaling "
+              << (single * static_cast<double>(thread_count) / parallel) << "x\n";
+
+    auto snapshot = std::make_shared<rebar::environment_snapshot>(rebar::use_provider<rebar::bytecode_provider>);
+    snapshot->add_initializer(rebar::standard::load_implicit_libraries);
+    snapshot->set_string_interner(std::make_shared<rebar::string_interner>());
+
+    const auto median = [](std::vector<double>& a_values) {
+        std::sort(a_values.begin(), a_values.end());
+        return a_values.empty() ? 0.0 : a_values[a_values.size() / 2];
+    };
+
+    std::vector<double> clone_microseconds;
+
+    for (size_t round = 0; round < rounds; ++round) {
+        const auto start = std::chrono::steady_clock::now();
+        std::unique_ptr<rebar::environment> cloned = snapshot->clone();
+        clone_microseconds.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    {
+        rebar::environment_pool pool(snapshot, thread_count * 2);
+        pool.wait_until_ready(thread_count * 2);
+
+        std::vector<double> acquire_microseconds;
+        failures += run_pooled(thread_count, rounds, pool, acquire_microseconds);
+
+        // Acquisitions that found the pool empty cloned on demand. Those that did not may still have waited for
+        // the warming thread when it had no core of its own.
+        std::cout << "pooled: median clone " << median(clone_microseconds) << " us, median acquisition " << median(acquire_microseconds) << " us, "
+                  << pool.miss_count() << " of " << (thread_count * rounds) << " cloned on demand, "
+                  << snapshot->get_string_interner()->size() << " strings interned\n";
+
+        // Strings of a shared interner are identical across environments.
+        rebar::environment_pool::lease first = pool.acquire();
+        rebar::environment_pool::lease second = pool.acquire();
+
+        if (first->str("Fibonacci") != second->str("Fibonacci")) {
+            std::cerr << "environments sharing a string interner interned the same string twice\n";
+            ++failures;
+        }
+    }
+
+    if (failures != 0) {
+        std::cerr << failures << " environments computed a wrong result.\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include "unit.hpp"
+
+#include "unit/bytecode.hpp"
+#include "unit/locals.hpp"
+#include "unit/interning.hpp"
+#include "unit/jit.hpp"
+#include "unit/object_layout.hpp"
+#include "unit/shapes.hpp"
+#include "unit/inline_caches.hpp"
+#include "unit/collector.hpp"
+#include "unit/lexer.hpp"
+#include "unit/parser.hpp"
+#include "unit/flat_ast.hpp"
+#include "unit/compile_cache.hpp"
+#include "unit/image.hpp"
+#include "unit/arguments.hpp"
+#include "unit/native_calls.hpp"
+#include "unit/native_classes.hpp"
+#include "unit/typed_natives.hpp"
+#include "unit/array_part.hpp"
+#include "unit/typed_arrays.hpp"
+#include "unit/environment_pool.hpp"
+#include "unit/global_scope.hpp"
+#include "unit/string_interner.hpp"
+#include "unit/string_hash.hpp"
+
+// Usage: unit [suite...]. Runs the named suites, or every suite, and fails if any check failed.
+int main(int argc, char** argv) {
+    const auto& suites = rebar::test::suites();
+
+    if (argc == 1) {
+        for (const auto& [name, run] : suites) {
+            run();
+        }
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        auto found = suites.find(argv[i]);
+
+        if (found == suites.cend()) {
+            std::cerr << "unknown suite " << argv[i] << '\n';
+            return 1;
+        }
+
+        found->second();
+    }
+
+    const size_t failures = rebar::test::failure_count();
+
+    if (failures != 0) {
+        std::cerr << failures << " checks failed.\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,168 @@
+#ifndef REBAR_TEST_UNIT_HPP
+#define REBAR_TEST_UNIT_HPP
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <rebar.hpp>
+#include <rebar_standard.hpp>
+
+// Behavior tests, grouped in suites that each run as their own ctest entry (unit <suite>). Every suite lives in a
+// header under test/unit/ included by test/unit.cpp: the library defines non-inline functions in its headers, so
+// all suites share one translation unit.
+
+namespace rebar::test {
+    using suite_function = void (*)();
+
+    inline std::map<std::string, suite_function>& suites() {
+        static std::map<std::string, suite_function> registered;
+        return registered;
+    }
+
+    struct suite_registration {
+        suite_registration(const char* a_name, const suite_function a_function) {
+            suites()[a_name] = a_function;
+        }
+    };
+
+    inline size_t& failure_count() {
+        static size_t failures = 0;
+        return failures;
+    }
+
+    inline void report_failure(const std::string& a_message, const char* a_file, const int a_line) {
+        std::cerr << a_file << ':' << a_line << ": " << a_message << '\n';
+        ++failure_count();
+    }
+
+    inline const char* type_name(const object::type a_type) noexcept {
+        switch (a_type) {
+            case object::type::null:
+                return "null";
+            case object::type::boolean:
+                return "boolean";
+            case object::type::integer:
+                return "integer";
+            case object::type::number:
+                return "number";
+            case object::type::function:
+                return "function";
+            case object::type::string:
+                return "string";
+            case object::type::table:
+                return "table";
+            case object::type::array:
+                return "array";
+            default:
+                return "native_object";
+        }
+    }
+
+    // Type and value of an object, e.g. "integer 1", so that 1 and true tell apart.
+    inline std::string describe(const object& a_object) {
+        std::ostringstream stream;
+        stream << type_name(a_object.object_type());
+
+        if (!a_object.is_null() && !a_object.is_function() && !a_object.is_table()) {
+            stream << ' ' << a_object;
+        }
+
+        return stream.str();
+    }
+
+    enum class provider_kind {
+        interpreter,
+        bytecode,
+        jit
+    };
+
+    inline constexpr provider_kind all_providers[] = { provider_kind::interpreter, provider_kind::bytecode, provider_kind::jit };
+
+    inline const char* provider_name(const provider_kind a_kind) noexcept {
+        switch (a_kind) {
+            case provider_kind::interpreter:
+                return "interpreter";
+            case provider_kind::bytecode:
+                return "bytecode";
+            default:
+                return "jit";
+        }
+    }
+
+    // An environment with the implicit standard libraries loaded, interning its strings in a_interner if given.
+    inline std::unique_ptr<environment> make_environment(const provider_kind a_kind, std::shared_ptr<string_interner> a_interner = nullptr) {
+        std::unique_ptr<environment> created;
+
+        switch (a_kind) {
+            case provider_kind::interpreter:
+                created = std::make_unique<environment>(use_provider<interpreter>);
+                break;
+            case provider_kind::bytecode:
+                created = std::make_unique<environment>(use_provider<bytecode_provider>);
+                break;
+            default:
+                created = std::make_unique<environment>(use_provider<jit_provider>);
+                break;
+        }
+
+        created->set_string_interner(std::move(a_interner));
+        standard::load_implicit_libraries(*created);
+
+        return created;
+    }
+
+    // Description of the result of a_script, or of the exception it threw.
+    inline std::string run_script(const provider_kind a_kind, const std::string& a_script) {
+        std::unique_ptr<environment> env = make_environment(a_kind);
+
+        try {
+            return describe(env->compile_string(a_script)());
+        } catch (const std::exception& e) {
+            return std::string("exception ") + e.what();
+        }
+    }
+
+    // Runs a_script on every provider, reporting a failure unless each yields a_expected.
+    inline void check_script(const std::string& a_script, const std::string& a_expected, const char* a_file, const int a_line) {
+        for (const provider_kind kind : all_providers) {
+            const std::string result = run_script(kind, a_script);
+
+            if (result != a_expected) {
+                report_failure(std::string(provider_name(kind)) + " returned \"" + result + "\", expected \"" + a_expected + "\" from:\n" + a_script, a_file, a_line);
+            }
+        }
+    }
+}
+
+#define REBAR_SUITE(a_name)                                                                                  \
+    static void a_name##_suite();                                                                            \
+    static const rebar::test::suite_registration a_name##_registration(#a_name, &a_name##_suite);           \
+    static void a_name##_suite()
+
+#define REBAR_CHECK(a_condition)                                                                             \
+    do {                                                                                                     \
+        if (!(a_condition)) {                                                                                \
+            rebar::test::report_failure("check failed: " #a_condition, __FILE__, __LINE__);                  \
+        }                                                                                                    \
+    } while (false)
+
+#define REBAR_CHECK_THROWS(a_expression)                                                                     \
+    do {                                                                                                     \
+        bool threw = false;                                                                                  \
+        try {                                                                                                \
+            static_cast<void>(a_expression);                                                                 \
+        } catch (const std::exception&) {                                                                    \
+            threw = true;                                                                                    \
+        }                                                                                                    \
+        if (!threw) {                                                                                        \
+            rebar::test::report_failure("expected an exception from " #a_expression, __FILE__, __LINE__);   \
+        }                                                                                                    \
+    } while (false)
+
+#define REBAR_CHECK_SCRIPT(a_script, a_expected) rebar::test::check_script(a_script, a_expected, __FILE__, __LINE__)
+
+#endif //REBAR_TEST_UNIT_HPP
@@ -0,0 +1,106 @@
+#ifndef REBAR_TEST_UNIT_ARGUMENTS_HPP
+#define REBAR_TEST_UNIT_ARGUMENTS_HPP
+
+#include <string>
+
+#include "../unit.hpp"
+
+// Call arguments live on the environment's argument stack: each call sees its own, whatever the calls it makes.
+
+namespace rebar::test {
+    inline object native_sum(environment* a_environment) {
+        integer sum = 0;
+
+        for (size_t i = 0; i < a_environment->arg_count(); ++i) {
+            sum += a_environment->arg(i).get_integer();
+        }
+
+        return sum;
+    }
+
+    inline object native_count(environment* a_environment) {
+        return static_cast<integer>(a_environment->arg_count());
+    }
+
+    // Calls its first argument with 1, 2 and 3, then reads its own second argument again.
+    inline object native_call_then_read(environment* a_environment) {
+        const object result = a_environment->arg(0).get_function(*a_environment).call(object(integer(1)), object(integer(2)), object(integer(3)));
+        return static_cast<integer>(result.get_integer() * 100 + a_environment->arg(1).get_integer());
+    }
+
+    inline std::unique_ptr<environment> make_argument_environment(const provider_kind a_kind) {
+        std::unique_ptr<environment> created = make_environment(a_kind);
+        created->global_table()[created->str("Sum")] = created->bind(&native_sum);
+        created->global_table()[created->str("Count")] = created->bind(&native_count);
+        created->global_table()[created->str("CallThenRead")] = created->bind(&native_call_then_read);
+        return created;
+    }
+
+    inline std::string run_argument_script(const provider_kind a_kind, const std::string& a_script) {
+        std::unique_ptr<environment> env = make_argument_environment(a_kind);
+
+        try {
+            return describe(env->compile_string(a_script)());
+        } catch (const std::exception& e) {
+            return std::string("exception ") + e.what();
+        }
+    }
+
+    // Comma-separated integers from 0 to a_count - 1.
+    inline std::string integer_list(const int a_count) {
+        std::string list;
+
+        for (int i = 0; i < a_count; ++i) {
+            list += (i == 0 ? "" : ", ") + std::to_string(i);
+        }
+
+        return list;
+    }
+}
+
+#define REBAR_CHECK_ARGUMENT_SCRIPT(a_script, a_expected)                                                    \
+    for (const auto kind : rebar::test::all_providers) {                                                     \
+        REBAR_CHECK(rebar::test::run_argument_script(kind, a_script) == (a_expected));                      \
+    }
+
+REBAR_SUITE(arguments_frames) {
+    REBAR_CHECK_ARGUMENT_SCRIPT("return Sum(1, 2, 3);", "integer 6");
+    REBAR_CHECK_ARGUMENT_SCRIPT("return Sum(Sum(1, 2), Sum(3, 4), 5);", "integer 15");
+    REBAR_CHECK_ARGUMENT_SCRIPT("return Count();", "integer 0");
+
+    // The native's own arguments are intact after it called back into script.
+    REBAR_CHECK_ARGUMENT_SCRIPT("function F(a, b, c) { return Sum(a, b, c) + Count(a, b); } return CallThenRead(F, 7);", "integer 807");
+    REBAR_CHECK_ARGUMENT_SCRIPT("function F(a, b, c) { return CallThenRead(G, 1); } function G(a, b, c) { return a + b + c; } return CallThenRead(F, 2);", "integer 60102");
+    REBAR_CHECK_ARGUMENT_SCRIPT("function F(a, b) { return Count(a, b) * 10 + Count(b); } return F(1);", "integer 21");
+}
+
+REBAR_SUITE(arguments_limits) {
+    using rebar::test::integer_list;
+
+    // Far more than the 16 arguments calls were once limited to.
+    REBAR_CHECK_ARGUMENT_SCRIPT("return Count(" + integer_list(300) + ");", "integer 300");
+    REBAR_CHECK_ARGUMENT_SCRIPT("return Sum(" + integer_list(1000) + ");", "integer 499500");
+
+    std::string parameters;
+
+    for (int i = 0; i < 300; ++i) {
+        parameters += (i == 0 ? "p" : ", p") + std::to_string(i);
+    }
+
+    REBAR_CHECK_ARGUMENT_SCRIPT("function F(" + parameters + ") { return p0 + p150 + p299; } return F(" + integer_list(300) + ");", "integer 449");
+
+    // Exceeding the configured limit throws instead of growing without bound.
+    for (const auto kind : rebar::test::all_providers) {
+        auto env = rebar::test::make_argument_environment(kind);
+        env->set_argument_stack_options({ 16, 64 });
+
+        REBAR_CHECK(env->compile_string("return Count(" + integer_list(64) + ");")().get_integer() == 64);
+        REBAR_CHECK_THROWS(env->compile_string("return Count(" + integer_list(65) + ");")());
+        REBAR_CHECK_THROWS(env->compile_string("function R(a, b, c, d) { return R(a, b, c, d); } return R(1, 2, 3, 4);")());
+
+        // The environment stays usable after the exception.
+        REBAR_CHECK(env->compile_string("return Sum(1, 2);")().get_integer() == 3);
+    }
+}
+
+#endif //REBAR_TEST_UNIT_ARGUMENTS_HPP
@@ -0,0 +1,136 @@
+#ifndef REBAR_TEST_UNIT_ARRAY_PART_HPP
+#define REBAR_TEST_UNIT_ARRAY_PART_HPP
+
+#include <string>
+
+#include "../unit.hpp"
+
+// The integer keys 0 to n - 1 of a table live in its array part, next to the shape slots or dictionary that hold
+// every other key.
+
+namespace rebar::test {
+    // Keys of a_table in iteration order, separated by commas.
+    inline std::string key_order(const table& a_table) {
+        std::string keys;
+
+        a_table.for_each([&keys](const object& a_key, const object&) {
+            if (!keys.empty()) {
+                keys += ", ";
+            }
+
+            keys += describe(a_key);
+        });
+
+        return keys;
+    }
+}
+
+REBAR_SUITE(array_part_layout) {
+    using rebar::object;
+    using rebar::integer;
+
+    auto env = rebar::test::make_environment(rebar::test::provider_kind::interpreter);
+
+    // Array keys next to shape-mode string keys, iterated first and in order.
+    {
+        rebar::table t(env->root_shape());
+        t[env->str("x")] = object(integer(10));
+
+        for (integer i = 0; i < 4; ++i) {
+            t[object(i)] = object(i * 2);
+        }
+
+        REBAR_CHECK(!t.is_dictionary() && t.get_shape()->size() == 1);
+        REBAR_CHECK(t.size() == 5);
+        REBAR_CHECK(rebar::test::key_order(t) == "integer 0, integer 1, integer 2, integer 3, string x");
+        REBAR_CHECK(t.index(object(integer(3))).get_integer() == 6);
+        REBAR_CHECK(t.index(env->str("x")).get_integer() == 10);
+    }
+
+    // Negative and sparse integer keys stay out of the array part.
+    {
+        rebar::table t;
+        t[object(integer(-1))] = object(integer(1));
+        t[object(integer(5))] = object(integer(2));
+        t[object(integer(0))] = object(integer(3));
+
+        REBAR_CHECK(t.size() == 3);
+        REBAR_CHECK(rebar::test::key_order(t).rfind("integer 0, ", 0) == 0);
+        REBAR_CHECK(t.index(object(integer(-1))).get_integer() == 1);
+        REBAR_CHECK(t.index(object(integer(5))).get_integer() == 2);
+        REBAR_CHECK(t.find(object(integer(1))) == nullptr);
+    }
+
+    // Assigning key n takes the keys that follow it out of the dictionary.
+    {
+        rebar::table t;
+
+        for (integer i = 3; i > 0; --i) {
+            t[object(i)] = object(i * 10);
+        }
+
+        t[object(integer(6))] = object(integer(60));
+        t[object(integer(0))] = object(integer(0));
+
+        REBAR_CHECK(t.size() == 5);
+        REBAR_CHECK(rebar::test::key_order(t) == "integer 0, integer 1, integer 2, integer 3, integer 6");
+
+        for (integer i = 0; i < 4; ++i) {
+            REBAR_CHECK(t.index(object(i)).get_integer() == i * 10);
+        }
+    }
+
+    // Erasing an array key moves the keys after it back to the dictionary, and refilling the gap absorbs them again.
+    {
+        rebar::table t(env->root_shape());
+
+        for (integer i = 0; i < 6; ++i) {
+            t[object(i)] = object(i + 100);
+        }
+
+        t.erase(object(integer(2)));
+
+        REBAR_CHECK(t.is_dictionary());
+        REBAR_CHECK(t.size() == 5);
+        REBAR_CHECK(t.find(object(integer(2))) == nullptr);
+        REBAR_CHECK(rebar::test::key_order(t).rfind("integer 0, integer 1, ", 0) == 0);
+
+        for (integer i = 3; i < 6; ++i) {
+            const object* found = t.find(object(i));
+            REBAR_CHECK(found != nullptr && found->get_integer() == i + 100);
+        }
+
+        t[object(integer(2))] = object(integer(102));
+
+        REBAR_CHECK(t.size() == 6);
+        REBAR_CHECK(rebar::test::key_order(t) == "integer 0, integer 1, integer 2, integer 3, integer 4, integer 5");
+    }
+
+    // Growing the array part changes the layout version, so cached pointers are dropped.
+    {
+        rebar::table t;
+        const size_t version = t.layout_version();
+
+        for (integer i = 0; i < 100; ++i) {
+            t[object(i)] = object(i);
+        }
+
+        REBAR_CHECK(t.layout_version() != version);
+
+        const size_t grown = t.layout_version();
+        t[object(integer(50))] = object(integer(-50));
+
+        REBAR_CHECK(t.layout_version() == grown);
+        REBAR_CHECK(t.index(object(integer(50))).get_integer() == -50);
+    }
+}
+
+REBAR_SUITE(array_part_scripts) {
+    REBAR_CHECK_SCRIPT("local t = {}; for (local i = 0; i < 100; i++) { t[i] = i * 2; } local s = 0; for (local i = 0; i < 100; i++) { s += t[i]; } return s;", "integer 9900");
+    REBAR_CHECK_SCRIPT("local t = { a = 1 }; t[1] = 10; t[0] = 5; t.b = 2; return t[0] + t[1] + t.a + t.b;", "integer 18");
+    REBAR_CHECK_SCRIPT("local t = {}; t[-1] = 3; t[0] = 4; t[2] = 5; return t[-1] * 100 + t[0] * 10 + t[2];", "integer 345");
+    REBAR_CHECK_SCRIPT("local t = {}; t[0] = 1; t[1] = 2; t[0] = 7; return t[0] * 10 + t[1];", "integer 72");
+    REBAR_CHECK_SCRIPT("local t = {}; t[0] = 1; return t[1];", "null");
+}
+
+#endif //REBAR_TEST_UNIT_ARRAY_PART_HPP
@@ -0,0 +1,82 @@
+#ifndef REBAR_TEST_UNIT_BYTECODE_HPP
+#define REBAR_TEST_UNIT_BYTECODE_HPP
+
+#include "../unit.hpp"
+
+// The bytecode and JIT providers yield what the interpreter yields.
+
+REBAR_SUITE(bytecode_arithmetic) {
+    REBAR_CHECK_SCRIPT("return 1 + 2 * 3;", "integer 7");
+    REBAR_CHECK_SCRIPT("return (1 + 2) * 3 - 4;", "integer 5");
+    REBAR_CHECK_SCRIPT("return 7 % 3;", "integer 1");
+    REBAR_CHECK_SCRIPT("return 7 / 2;", "number 3.5");
+    REBAR_CHECK_SCRIPT("return 1.5 + 2;", "number 3.5");
+    REBAR_CHECK_SCRIPT("return 2 * 0.25;", "number 0.5");
+    REBAR_CHECK_SCRIPT("local a = 6; local b = 4; return a - b * 2;", "integer -2");
+    REBAR_CHECK_SCRIPT("local a = 5; a += 3; a -= 1; a *= 2; return a;", "integer 14");
+    REBAR_CHECK_SCRIPT("local a = 5; local b = a++; return a * 10 + b;", "integer 65");
+    REBAR_CHECK_SCRIPT("local a = 5; local b = --a; return a * 10 + b;", "integer 44");
+    REBAR_CHECK_SCRIPT("return 6 | 1;", "integer 7");
+    REBAR_CHECK_SCRIPT("return 1 << 4;", "integer 16");
+    REBAR_CHECK_SCRIPT("return \"ab\" + \"cd\";", "string abcd");
+    REBAR_CHECK_SCRIPT("return \"x\" + 5;", "string x5");
+}
+
+REBAR_SUITE(bytecode_comparisons) {
+    // Comparisons yield the integers 1 and 0, whatever the operand types.
+    REBAR_CHECK_SCRIPT("return 1 < 2;", "integer 1");
+    REBAR_CHECK_SCRIPT("return 2 < 1;", "integer 0");
+    REBAR_CHECK_SCRIPT("return 1 > 2;", "integer 0");
+    REBAR_CHECK_SCRIPT("return 1.5 < 2;", "integer 1");
+    REBAR_CHECK_SCRIPT("return 2 > 1.5;", "integer 1");
+    REBAR_CHECK_SCRIPT("return 2.5 > 3.5;", "integer 0");
+    REBAR_CHECK_SCRIPT("local a = 1; local b = 2; return a >= b;", "integer 0");
+    REBAR_CHECK_SCRIPT("local a = 2; local b = 2; return a >= b;", "integer 1");
+    REBAR_CHECK_SCRIPT("local a = 3; local b = 2; return a <= b;", "integer 0");
+    REBAR_CHECK_SCRIPT("local a = 2; local b = 2; return a <= b;", "integer 1");
+    REBAR_CHECK_SCRIPT("return 1.5 >= 2;", "integer 0");
+    REBAR_CHECK_SCRIPT("return 2 <= 2.0;", "integer 1");
+    REBAR_CHECK_SCRIPT("return \"abc\" > 2;", "integer 1");
+    REBAR_CHECK_SCRIPT("return 1 == 1;", "integer 1");
+    REBAR_CHECK_SCRIPT("return 1 == 2;", "integer 0");
+    REBAR_CHECK_SCRIPT("return 1 != 2;", "integer 1");
+    REBAR_CHECK_SCRIPT("return 1 == 1.0;", "integer 0");
+    REBAR_CHECK_SCRIPT("return \"a\" == \"a\";", "integer 1");
+    REBAR_CHECK_SCRIPT("return !0;", "integer 1");
+    REBAR_CHECK_SCRIPT("return !5;", "integer 0");
+    REBAR_CHECK_SCRIPT("return 0 && 1;", "boolean false");
+    REBAR_CHECK_SCRIPT("return 2 && 3;", "integer 3");
+    REBAR_CHECK_SCRIPT("return 0 || 4;", "integer 4");
+    REBAR_CHECK_SCRIPT("return true;", "boolean true");
+}
+
+REBAR_SUITE(bytecode_control_flow) {
+    REBAR_CHECK_SCRIPT("local a = 3; if (a > 2) { return 1; } else { return 2; }", "integer 1");
+    REBAR_CHECK_SCRIPT("local a = 1; if (a > 2) { return 1; } else if (a == 1) { return 3; } else { return 2; }", "integer 3");
+    REBAR_CHECK_SCRIPT("local s = 0; for (local i = 0; i < 10; i++) { s += i; } return s;", "integer 45");
+    REBAR_CHECK_SCRIPT("local s = 0; local i = 0; while (i < 5) { s += i * i; i++; } return s;", "integer 30");
+    REBAR_CHECK_SCRIPT("local i = 5; while (--i) { if (i == 2) { break; } } return i;", "integer 2");
+    REBAR_CHECK_SCRIPT("local s = 0; for (local i = 0; i < 10; i++) { if (i % 2 == 0) { continue; } s += i; } return s;", "integer 25");
+    REBAR_CHECK_SCRIPT("local s = 0.0; for (local i = 0; i < 4; i++) { s += 0.5; } return s;", "number 2");
+    REBAR_CHECK_SCRIPT("function F(n) { if (n < 2) { return n; } return F(n - 1) + F(n - 2); } return F(15);", "integer 610");
+    REBAR_CHECK_SCRIPT("function Add(a, b) { return a + b; } return Add(2, 3) * Add(1, 1);", "integer 10");
+    REBAR_CHECK_SCRIPT("function Missing(a, b) { return b; } return Missing(1);", "null");
+    REBAR_CHECK_SCRIPT("local t = { a = 1, b = 2 }; t.c = t.a + t.b; return t.c;", "integer 3");
+    REBAR_CHECK_SCRIPT("local t = {}; t[\"k\"] = 4; return t.k;", "integer 4");
+    REBAR_CHECK_SCRIPT("G = 2; function Twice() { G *= 2; } Twice(); Twice(); return G;", "integer 8");
+    REBAR_CHECK_SCRIPT("return \"Hello\".Length();", "integer 5");
+    REBAR_CHECK_SCRIPT("return \"Hello, world!\"[0:4];", "string Hello");
+}
+
+// Members and elements of objects that have none resolve to the environment's null slot, which stays null.
+REBAR_SUITE(bytecode_unassignable_targets) {
+    REBAR_CHECK_SCRIPT("local n = 5; n.a = 3; return n;", "integer 5");
+    REBAR_CHECK_SCRIPT("local n = 5; return n.a = 3;", "integer 3");
+    REBAR_CHECK_SCRIPT("local n = 5; n.a = 7; return n.b;", "null");
+    REBAR_CHECK_SCRIPT("local n = 5; return n.a += 1;", "null");
+    REBAR_CHECK_SCRIPT("local n = 5; n[0] += 2; return n;", "integer 5");
+    REBAR_CHECK_SCRIPT("local n = 5; n.a++; return n.a;", "null");
+    REBAR_CHECK_SCRIPT("local n = 5; n.a += 1; local t = {}; return t.b;", "null");
+}
+
+#endif //REBAR_TEST_UNIT_BYTECODE_HPP
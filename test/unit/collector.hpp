@@ -0,0 +1,50 @@
+#ifndef REBAR_TEST_UNIT_COLLECTOR_HPP
+#define REBAR_TEST_UNIT_COLLECTOR_HPP
+
+#include "../unit.hpp"
+
+// The cycle collector frees unreachable cycles and nothing that is still reachable.
+
+REBAR_SUITE(collector_cycles) {
+    for (const auto kind : rebar::test::all_providers) {
+        auto env = rebar::test::make_environment(kind);
+        rebar::cycle_collector& collector = env->collector();
+
+        collector.set_threshold(0);
+        static_cast<void>(collector.collect());
+        const size_t baseline = collector.tracked_count();
+
+        env->compile_string("local a = {}; local b = {}; a.b = b; b.a = a;")();
+        REBAR_CHECK(collector.tracked_count() == baseline + 2);
+        REBAR_CHECK(collector.collect() == 2);
+        REBAR_CHECK(collector.tracked_count() == baseline);
+
+        env->compile_string("local a = [ 0, 1 ]; a[0] = a; local t = { list = a }; a[1] = t;")();
+        REBAR_CHECK(collector.collect() == 2);
+        REBAR_CHECK(collector.tracked_count() == baseline);
+
+        // Cycles reachable from a global survive, and so does everything they refer to.
+        env->compile_string("Root = { inner = { value = 7 } }; Root.inner.parent = Root;")();
+        REBAR_CHECK(collector.collect() == 0);
+        REBAR_CHECK(env->compile_string("return Root.inner.parent.inner.value;")().get_integer() == 7);
+
+        env->compile_string("Root = null;")();
+        REBAR_CHECK(collector.collect() == 2);
+        REBAR_CHECK(collector.tracked_count() == baseline);
+    }
+}
+
+REBAR_SUITE(collector_threshold) {
+    for (const auto kind : rebar::test::all_providers) {
+        auto env = rebar::test::make_environment(kind);
+        rebar::cycle_collector& collector = env->collector();
+
+        collector.set_threshold(256);
+        env->compile_string("for (local i = 0; i < 20000; i++) { local a = { i = i }; a.self = a; }")();
+
+        // Automatic collections keep garbage cycles from piling up.
+        REBAR_CHECK(collector.tracked_count() < 1024);
+    }
+}
+
+#endif //REBAR_TEST_UNIT_COLLECTOR_HPP
@@ -0,0 +1,85 @@
+#ifndef REBAR_TEST_UNIT_COMPILE_CACHE_HPP
+#define REBAR_TEST_UNIT_COMPILE_CACHE_HPP
+
+#include <memory>
+#include <string>
+
+#include "../unit.hpp"
+
+// Compiled sources and shared parse units are cached up to a capacity, least recently used first out.
+
+namespace rebar::test {
+    inline size_t function_identity(const function a_function) {
+        return object(a_function).data();
+    }
+}
+
+REBAR_SUITE(compile_cache_lru) {
+    rebar::lru_cache<int> cache(2);
+
+    cache.insert("a", 1);
+    cache.insert("b", 2);
+    REBAR_CHECK(cache.find("a") != nullptr && *cache.find("a") == 1);
+
+    // "b" is now the least recently used entry.
+    cache.insert("c", 3);
+    REBAR_CHECK(cache.size() == 2);
+    REBAR_CHECK(cache.find("b") == nullptr);
+    REBAR_CHECK(cache.find("a") != nullptr && cache.find("c") != nullptr);
+
+    cache.set_capacity(1);
+    REBAR_CHECK(cache.size() == 1 && cache.find("c") != nullptr);
+
+    cache.set_capacity(0);
+    cache.insert("d", 4);
+    REBAR_CHECK(cache.size() == 0 && cache.find("d") == nullptr);
+}
+
+REBAR_SUITE(compile_cache_sources) {
+    using rebar::test::function_identity;
+
+    for (const auto kind : rebar::test::all_providers) {
+        auto env = rebar::test::make_environment(kind);
+
+        REBAR_CHECK(env->compiled_source_capacity() == rebar::environment::default_compiled_source_capacity);
+        REBAR_CHECK(function_identity(env->compile_string("return 1;")) == function_identity(env->compile_string("return 1;")));
+
+        env->set_compiled_source_capacity(2);
+        const size_t a = function_identity(env->compile_string("return \"a\";"));
+        const size_t b = function_identity(env->compile_string("return \"b\";"));
+        REBAR_CHECK(function_identity(env->compile_string("return \"a\";")) == a);
+
+        // Evicts "b", the least recently compiled source.
+        static_cast<void>(env->compile_string("return \"c\";"));
+        REBAR_CHECK(function_identity(env->compile_string("return \"a\";")) == a);
+        REBAR_CHECK(function_identity(env->compile_string("return \"b\";")) != b);
+
+        env->set_compiled_source_capacity(0);
+        REBAR_CHECK(function_identity(env->compile_string("return 2;")) != function_identity(env->compile_string("return 2;")));
+        REBAR_CHECK(env->compile_string("return 2;")().get_integer() == 2);
+    }
+}
+
+REBAR_SUITE(compile_cache_shared) {
+    auto cache = std::make_shared<rebar::compile_cache>(4);
+
+    auto first = rebar::test::make_environment(rebar::test::provider_kind::interpreter);
+    auto second = rebar::test::make_environment(rebar::test::provider_kind::bytecode);
+    first->set_compile_cache(cache);
+    second->set_compile_cache(cache);
+
+    REBAR_CHECK(first->compile_string("return 6 * 7;")().get_integer() == 42);
+    REBAR_CHECK(second->compile_string("return 6 * 7;")().get_integer() == 42);
+    REBAR_CHECK(cache->size() == 1);
+
+    for (int i = 0; i < 16; ++i) {
+        REBAR_CHECK(first->compile_string("return " + std::to_string(i) + ";")().get_integer() == i);
+    }
+
+    REBAR_CHECK(cache->size() == 4);
+
+    cache->set_capacity(1);
+    REBAR_CHECK(cache->size() == 1);
+}
+
+#endif //REBAR_TEST_UNIT_COMPILE_CACHE_HPP
@@ -0,0 +1,83 @@
+#ifndef REBAR_TEST_UNIT_ENVIRONMENT_POOL_HPP
+#define REBAR_TEST_UNIT_ENVIRONMENT_POOL_HPP
+
+#include <memory>
+#include <stdexcept>
+
+#include "../unit.hpp"
+
+// Clones of a snapshot replay its steps on fresh environments, and a pool hands them out.
+
+namespace rebar::test {
+    inline std::shared_ptr<environment_snapshot> make_answer_snapshot() {
+        auto snapshot = std::make_shared<environment_snapshot>(use_provider<bytecode_provider>);
+        snapshot->add_initializer(standard::load_implicit_libraries);
+        snapshot->add_script("Answer = 42; function Twice(x) { return x * 2; }");
+
+        return snapshot;
+    }
+}
+
+REBAR_SUITE(environment_pool_snapshots) {
+    using rebar::object;
+
+    auto snapshot = rebar::test::make_answer_snapshot();
+    snapshot->prepare();
+
+    std::unique_ptr<rebar::environment> first = snapshot->clone();
+    std::unique_ptr<rebar::environment> second = snapshot->clone();
+
+    REBAR_CHECK(rebar::test::describe(first->compile_string("return Twice(Answer);")()) == "integer 84");
+
+    // Clones are separate environments, not views of one.
+    first->compile_string("Answer = 1;")();
+
+    REBAR_CHECK(rebar::test::describe(first->compile_string("return Answer;")()) == "integer 1");
+    REBAR_CHECK(rebar::test::describe(second->compile_string("return Answer;")()) == "integer 42");
+
+    // Startup scripts are parsed once, into the shared compile cache.
+    REBAR_CHECK(first->get_compile_cache() == snapshot->get_compile_cache());
+    REBAR_CHECK(second->get_compile_cache() == snapshot->get_compile_cache());
+
+    // Steps that fail do so while the snapshot is prepared, before any pool hands out a clone.
+    auto failing = std::make_shared<rebar::environment_snapshot>();
+    failing->add_initializer([](rebar::environment&) { throw std::runtime_error("Startup failed."); });
+
+    REBAR_CHECK_THROWS(failing->prepare());
+    REBAR_CHECK_THROWS(rebar::environment_pool(failing, 1));
+}
+
+REBAR_SUITE(environment_pool_leases) {
+    rebar::environment_pool pool(rebar::test::make_answer_snapshot(), 2);
+    pool.wait_until_ready(2);
+
+    REBAR_CHECK(pool.ready_count() == 2);
+
+    {
+        rebar::environment_pool::lease first = pool.acquire();
+        rebar::environment_pool::lease second = pool.acquire();
+
+        REBAR_CHECK(pool.miss_count() == 0 && pool.leased_count() == 2);
+        REBAR_CHECK(&first.get() != &second.get());
+
+        first->compile_string("Answer = 7;")();
+        REBAR_CHECK(rebar::test::describe(second->compile_string("return Answer;")()) == "integer 42");
+
+        first.release();
+        REBAR_CHECK(pool.leased_count() == 1);
+    }
+
+    REBAR_CHECK(pool.leased_count() == 0);
+
+    // A pool without capacity clones on every acquisition.
+    rebar::environment_pool empty(rebar::test::make_answer_snapshot(), 0);
+
+    for (size_t i = 0; i < 3; ++i) {
+        rebar::environment_pool::lease leased = empty.acquire();
+        REBAR_CHECK(rebar::test::describe(leased->compile_string("return Answer;")()) == "integer 42");
+    }
+
+    REBAR_CHECK(empty.miss_count() == 3 && empty.ready_count() == 0);
+}
+
+#endif //REBAR_TEST_UNIT_ENVIRONMENT_POOL_HPP
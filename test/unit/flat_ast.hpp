@@ -0,0 +1,54 @@
+#ifndef REBAR_TEST_UNIT_FLAT_AST_HPP
+#define REBAR_TEST_UNIT_FLAT_AST_HPP
+
+#include <utility>
+
+#include "../unit.hpp"
+
+// Parse units keep their syntax tree in one flat buffer that refers to tokens by index.
+
+REBAR_SUITE(flat_ast_layout) {
+    using rebar::node;
+
+    rebar::lexer code_lexer;
+    rebar::parse_unit unit = rebar::parse(code_lexer, "local a = 1; if (a) { a = 2; a++; } function F(x, y) { return x + y; }");
+
+    const rebar::flat_range statements = unit.m_ast.statements();
+    REBAR_CHECK(statements.size() == 3);
+
+    if (statements.size() == 3) {
+        REBAR_CHECK(statements[0].is_expression());
+        REBAR_CHECK(statements[1].get_type() == node::type::if_declaration);
+        REBAR_CHECK(statements[1].get_body().size() == 2);
+
+        const rebar::flat_node declaration = statements[2];
+        REBAR_CHECK(declaration.get_type() == node::type::function_declaration);
+        REBAR_CHECK(declaration.get_parameters().size() == 2);
+        REBAR_CHECK(declaration.get_body().size() == 1);
+        REBAR_CHECK(declaration.get_body()[0].get_type() == node::type::return_statement);
+    }
+
+    // Moving a unit moves its token buffer, which the tree refers to by index only.
+    const std::string before = unit.string_representation();
+    rebar::parse_unit moved(std::move(unit));
+    REBAR_CHECK(moved.string_representation() == before);
+
+    const rebar::flat_ast& ast = moved.m_ast;
+
+    for (size_t i = 0; i < ast.size(); ++i) {
+        const rebar::flat_entry& entry = ast.at(static_cast<rebar::flat_ast::index>(i));
+
+        // Children always follow their parent.
+        if (entry.m_type != static_cast<uint8_t>(node::type::token) && entry.m_count != 0) {
+            REBAR_CHECK(entry.m_first > i && entry.m_first + entry.m_count <= ast.size());
+        }
+    }
+}
+
+REBAR_SUITE(flat_ast_qualifiers) {
+    REBAR_CHECK_SCRIPT("local const c = 5; return c;", "integer 5");
+    REBAR_CHECK_SCRIPT("const G = 2; function F() { return G; } return F();", "integer 2");
+    REBAR_CHECK_SCRIPT("local a = 1; { local a = 3; } local b = a; return b;", "integer 1");
+}
+
+#endif //REBAR_TEST_UNIT_FLAT_AST_HPP
@@ -0,0 +1,81 @@
+#ifndef REBAR_TEST_UNIT_GLOBAL_SCOPE_HPP
+#define REBAR_TEST_UNIT_GLOBAL_SCOPE_HPP
+
+#include <memory>
+
+#include "../unit.hpp"
+
+// Globals are layered over the bindings frozen at initialization, and reset() discards everything since.
+
+REBAR_SUITE(global_scope_layers) {
+    using rebar::object;
+    using rebar::integer;
+
+    auto env = rebar::test::make_environment(rebar::test::provider_kind::interpreter);
+    rebar::global_scope globals;
+
+    const object answer = env->str("Answer");
+    const object extra = env->str("Extra");
+
+    globals[answer] = object(integer(42));
+    globals.freeze();
+
+    REBAR_CHECK(globals.base().size() == 1 && globals.overlay().size() == 0);
+
+    // Reads never copy into the overlay.
+    REBAR_CHECK(globals.index(answer).get_integer() == 42);
+    REBAR_CHECK(globals.index(extra).is_null());
+    REBAR_CHECK(globals.find(extra) == nullptr);
+    REBAR_CHECK(globals.overlay().size() == 0);
+
+    // Assignments land in the overlay, shadowing the base.
+    globals[answer] = object(integer(1));
+    globals[extra] = object(integer(5));
+
+    REBAR_CHECK(globals.index(answer).get_integer() == 1);
+    REBAR_CHECK(globals.base().index(answer).get_integer() == 42);
+    REBAR_CHECK(globals.overlay().size() == 2);
+
+    globals.reset();
+
+    REBAR_CHECK(globals.index(answer).get_integer() == 42);
+    REBAR_CHECK(globals.find(extra) == nullptr);
+
+    // Freezing again folds the overlay into the base.
+    globals[extra] = object(integer(6));
+    globals.freeze();
+    globals.reset();
+
+    REBAR_CHECK(globals.index(extra).get_integer() == 6 && globals.base().size() == 2);
+}
+
+REBAR_SUITE(global_scope_reset) {
+    rebar::environment_snapshot snapshot(rebar::use_provider<rebar::bytecode_provider>);
+    snapshot.add_initializer(rebar::standard::load_implicit_libraries);
+    snapshot.add_script("Answer = 42; Config = { limit = 3 }; function Bump() { Answer += 1; return Answer; }");
+
+    std::unique_ptr<rebar::environment> env = snapshot.clone();
+    std::unique_ptr<rebar::environment> other = snapshot.clone();
+
+    const auto run = [](rebar::environment& a_environment, const char* a_script) {
+        return rebar::test::describe(a_environment.compile_string(a_script)());
+    };
+
+    REBAR_CHECK(run(*env, "Bump(); return Bump();") == "integer 44");
+    REBAR_CHECK(run(*env, "Extra = 5; Config.limit = 9; return Extra;") == "integer 5");
+
+    env->global_table().reset();
+
+    REBAR_CHECK(run(*env, "return Answer;") == "integer 42");
+    REBAR_CHECK(run(*env, "return Extra;") == "null");
+    REBAR_CHECK(run(*env, "return Bump();") == "integer 43");
+
+    // Only bindings are restored: the table Config is bound to keeps its changed entry.
+    REBAR_CHECK(run(*env, "return Config.limit;") == "integer 9");
+
+    // Each clone has a base of its own, so no change reaches another clone.
+    REBAR_CHECK(run(*other, "return Answer * 10 + Config.limit;") == "integer 423");
+    REBAR_CHECK(&env->global_table().base() != &other->global_table().base());
+}
+
+#endif //REBAR_TEST_UNIT_GLOBAL_SCOPE_HPP
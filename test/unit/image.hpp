@@ -0,0 +1,163 @@
+#ifndef REBAR_TEST_UNIT_IMAGE_HPP
+#define REBAR_TEST_UNIT_IMAGE_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../unit.hpp"
+
+// Parse units survive a round trip through an image, and damaged images are rejected instead of read.
+
+namespace rebar::test {
+    inline constexpr const char* image_source =
+        "function Fib(n) { if (n < 2) { return n; } return Fib(n - 1) + Fib(n - 2); }"
+        "local t = { name = \"image\", values = [ 1.5, 2, 3 ] };"
+        "local s = 0; for (local i = 0; i < 3; i++) { s += (t.values)[i]; }"
+        "return t.name + \":\" + (Fib(10) + s);";
+
+    inline std::string image_of(const std::string& a_source) {
+        lexer code_lexer;
+        return write_image(parse(code_lexer, a_source));
+    }
+
+    // a_image with its AST entries changed by a_change.
+    template <typename t_change>
+    std::string with_entries(std::string a_image, t_change&& a_change) {
+        image_header header;
+        std::memcpy(&header, a_image.data(), sizeof(image_header));
+
+        std::vector<flat_ast::entry> entries(static_cast<size_t>(header.m_entry_count));
+        std::memcpy(entries.data(), a_image.data() + sizeof(image_header), entries.size() * sizeof(flat_ast::entry));
+
+        a_change(entries);
+
+        std::memcpy(a_image.data() + sizeof(image_header), entries.data(), entries.size() * sizeof(flat_ast::entry));
+        return a_image;
+    }
+
+    // The first entry a_predicate accepts. A missing entry fails the calling suite, and the change goes to a
+    // scratch entry instead.
+    template <typename t_predicate>
+    flat_ast::entry& first_entry_where(std::vector<flat_ast::entry>& a_entries, t_predicate&& a_predicate) {
+        const auto found = std::find_if(a_entries.begin(), a_entries.end(), a_predicate);
+
+        if (found == a_entries.end()) {
+            static flat_ast::entry scratch;
+            report_failure("no such node in the image", __FILE__, __LINE__);
+
+            return scratch;
+        }
+
+        return *found;
+    }
+
+    inline flat_ast::entry& first_entry(std::vector<flat_ast::entry>& a_entries, const node::type a_type) {
+        return first_entry_where(a_entries, [a_type](const flat_ast::entry& a_entry) {
+            return a_entry.m_type == static_cast<uint8_t>(a_type);
+        });
+    }
+
+    // The first node other than a token with the operation a_operation.
+    inline flat_ast::entry& first_entry(std::vector<flat_ast::entry>& a_entries, const separator a_operation) {
+        return first_entry_where(a_entries, [a_operation](const flat_ast::entry& a_entry) {
+            return a_entry.m_type != static_cast<uint8_t>(node::type::token) && a_entry.m_operation == static_cast<uint8_t>(a_operation);
+        });
+    }
+}
+
+REBAR_SUITE(image_round_trip) {
+    rebar::lexer code_lexer;
+    const rebar::parse_unit unit = rebar::parse(code_lexer, rebar::test::image_source);
+    const std::string image = rebar::write_image(unit);
+
+    const rebar::parse_unit restored = rebar::read_image(image);
+    REBAR_CHECK(restored.m_plaintext == unit.m_plaintext);
+    REBAR_CHECK(restored.string_representation() == unit.string_representation());
+    REBAR_CHECK(restored.m_lex_unit.token_count() == unit.m_lex_unit.token_count());
+
+    for (const auto kind : rebar::test::all_providers) {
+        auto env = rebar::test::make_environment(kind);
+        const std::string expected = rebar::test::run_script(kind, rebar::test::image_source);
+
+        REBAR_CHECK(expected == "string image:61.500000");
+        REBAR_CHECK(rebar::test::describe(env->compile_image(image)()) == expected);
+    }
+}
+
+REBAR_SUITE(image_damaged) {
+    rebar::lexer code_lexer;
+    const std::string image = rebar::write_image(rebar::parse(code_lexer, rebar::test::image_source));
+
+    // Every truncation, down to an empty image.
+    for (size_t length = 0; length < image.size(); ++length) {
+        REBAR_CHECK_THROWS(rebar::read_image(std::string_view(image).substr(0, length)));
+    }
+
+    std::string bad_magic = image;
+    bad_magic[0] = static_cast<char>(~bad_magic[0]);
+    REBAR_CHECK_THROWS(rebar::read_image(bad_magic));
+
+    auto env = rebar::test::make_environment(rebar::test::provider_kind::bytecode);
+    REBAR_CHECK_THROWS(env->compile_image("return 1;"));
+}
+
+REBAR_SUITE(image_malformed_nodes) {
+    using rebar::flat_ast;
+    using rebar::node;
+    using rebar::separator;
+    using entries = std::vector<flat_ast::entry>;
+
+    const std::string sources[] = {
+        "return 1 + 2;",
+        "return 0 ? 2 : 3;",
+        "local x = 1; if (x) { return 2; } return 3;",
+        "local s = 0; for (local i = 0; i < 3; i++) { s += i; } return s;",
+        "function F(a) { return a * 2; } return F(4);",
+        "return [1:3];",
+        "local t = { a = 1, b = 2 }; return t.a + t.b;",
+    };
+
+    // Untouched, each image loads and runs like its source.
+    for (const std::string& source : sources) {
+        auto env = rebar::test::make_environment(rebar::test::provider_kind::bytecode);
+        const std::string expected = rebar::test::run_script(rebar::test::provider_kind::bytecode, source);
+
+        REBAR_CHECK(rebar::test::describe(env->compile_image(rebar::test::image_of(source))()) == expected);
+    }
+
+    const auto damaged = [](const std::string& a_source, auto&& a_change) {
+        return rebar::test::with_entries(rebar::test::image_of(a_source), a_change);
+    };
+
+    // Operators short of operands, and operations that do not exist.
+    REBAR_CHECK_THROWS(rebar::read_image(damaged(sources[0], [](entries& e) { rebar::test::first_entry(e, separator::addition).m_count = 1; })));
+    REBAR_CHECK_THROWS(rebar::read_image(damaged(sources[1], [](entries& e) { rebar::test::first_entry(e, separator::ternary).m_count = 2; })));
+    REBAR_CHECK_THROWS(rebar::read_image(damaged(sources[0], [](entries& e) { rebar::test::first_entry(e, separator::addition).m_operation = 0xFF; })));
+
+    // Declarations without their conditional, loop expressions, identifier or parameters, or with a statement
+    // in place of them.
+    REBAR_CHECK_THROWS(rebar::read_image(damaged(sources[2], [](entries& e) { rebar::test::first_entry(e, node::type::if_declaration).m_count = 0; })));
+    REBAR_CHECK_THROWS(rebar::read_image(damaged(sources[2], [](entries& e) {
+        flat_ast::entry& declaration = rebar::test::first_entry(e, node::type::if_declaration);
+        ++declaration.m_first;
+        --declaration.m_count;
+    })));
+    REBAR_CHECK_THROWS(rebar::read_image(damaged(sources[3], [](entries& e) { rebar::test::first_entry(e, node::type::for_declaration).m_count = 2; })));
+    REBAR_CHECK_THROWS(rebar::read_image(damaged(sources[4], [](entries& e) { rebar::test::first_entry(e, node::type::function_declaration).m_count = 1; })));
+    REBAR_CHECK_THROWS(rebar::read_image(damaged(sources[4], [](entries& e) {
+        flat_ast::entry& declaration = rebar::test::first_entry(e, node::type::function_declaration);
+        ++declaration.m_first;
+        --declaration.m_count;
+    })));
+
+    // Parameters that are not expressions, a range with one bound and a table entry without its value.
+    REBAR_CHECK_THROWS(rebar::read_image(damaged(sources[4], [](entries& e) {
+        e[rebar::test::first_entry(e, node::type::argument_list).m_first].m_type = static_cast<uint8_t>(node::type::block);
+    })));
+    REBAR_CHECK_THROWS(rebar::read_image(damaged(sources[5], [](entries& e) { rebar::test::first_entry(e, node::type::ranged_selector).m_count = 1; })));
+    REBAR_CHECK_THROWS(rebar::read_image(damaged(sources[6], [](entries& e) { rebar::test::first_entry(e, node::type::immediate_table).m_count = 3; })));
+}
+
+#endif //REBAR_TEST_UNIT_IMAGE_HPP
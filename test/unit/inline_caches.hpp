@@ -0,0 +1,47 @@
+#ifndef REBAR_TEST_UNIT_INLINE_CACHES_HPP
+#define REBAR_TEST_UNIT_INLINE_CACHES_HPP
+
+#include "../unit.hpp"
+
+// Member accesses and method calls must see the current contents of a receiver, whatever a site has cached.
+
+REBAR_SUITE(inline_caches_members) {
+    // One site reading x from more receiver shapes than a cache holds.
+    REBAR_CHECK_SCRIPT(
+        "function X(t) { return t.x; }"
+        "local ts = [ { x = 1 }, { a = 0, x = 2 }, { b = 0, x = 3 }, { c = 0, x = 4 }, { d = 0, x = 5 }, { e = 0, x = 6 } ];"
+        "local s = 0; for (local r = 0; r < 3; r++) { for (local i = 0; i < 6; i++) { s += X(ts[i]); } } return s;",
+        "integer 63");
+
+    // The cached shape changes under the site when the receiver gains a key.
+    REBAR_CHECK_SCRIPT(
+        "function X(t) { return t.x; } local t = { y = 1 }; local a = X(t); t.x = 4; return a == null && X(t) == 4;",
+        "integer 1");
+
+    // A receiver switching to dictionary mode after its slot was cached.
+    REBAR_CHECK_SCRIPT(
+        "function X(t) { return t.x; } local t = { x = 1 }; local a = X(t);"
+        "for (local i = 0; i < 100; i++) { t[\"k\" + i] = i; } t.x = 2; return a * 10 + X(t);",
+        "integer 12");
+
+    // Stores through a cached site.
+    REBAR_CHECK_SCRIPT(
+        "function Set(t, v) { t.x = v; } local a = { x = 0 }; local b = { y = 0, x = 0 };"
+        "for (local i = 0; i < 10; i++) { Set(a, i); Set(b, i * 2); } return a.x * 100 + b.x;",
+        "integer 918");
+}
+
+REBAR_SUITE(inline_caches_methods) {
+    REBAR_CHECK_SCRIPT(
+        "function L(s) { return s.Length(); } local n = 0; local words = [ \"a\", \"bb\", \"ccc\" ];"
+        "for (local r = 0; r < 4; r++) { for (local i = 0; i < 3; i++) { n += L(words[i]); } } return n;",
+        "integer 24");
+
+    REBAR_CHECK_SCRIPT(
+        "function One() { return 1; } function Two() { return 2; } function Call(t) { return t.F(); }"
+        "local a = { F = One }; local b = { G = 0, F = Two };"
+        "local s = 0; for (local i = 0; i < 4; i++) { s += Call(a) * 10 + Call(b); } return s;",
+        "integer 48");
+}
+
+#endif //REBAR_TEST_UNIT_INLINE_CACHES_HPP
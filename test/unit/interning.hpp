@@ -0,0 +1,41 @@
+#ifndef REBAR_TEST_UNIT_INTERNING_HPP
+#define REBAR_TEST_UNIT_INTERNING_HPP
+
+#include "../unit.hpp"
+
+// Identifiers and string literals are interned when a script is compiled, so they are the very strings
+// environment::str yields for the same text.
+
+REBAR_SUITE(interning_literals) {
+    for (const auto kind : rebar::test::all_providers) {
+        auto env = rebar::test::make_environment(kind);
+
+        const rebar::object literal = env->compile_string("return \"hello\";")();
+        REBAR_CHECK(literal.is_string());
+        REBAR_CHECK(literal.data() == rebar::object(env->str("hello")).data());
+
+        // Running a function twice yields the same string, not a copy.
+        rebar::function twice = env->compile_string("return \"again\";");
+        REBAR_CHECK(twice().data() == twice().data());
+    }
+}
+
+REBAR_SUITE(interning_identifiers) {
+    for (const auto kind : rebar::test::all_providers) {
+        auto env = rebar::test::make_environment(kind);
+
+        const rebar::object result = env->compile_string("Global = 3; return { field = 4 };")();
+        REBAR_CHECK(result.is_table());
+
+        const rebar::object* field = result.get_table().find(env->str("field"));
+        REBAR_CHECK(field != nullptr && field->is_integer() && field->get_integer() == 4);
+
+        const rebar::object* global = env->global_table().find(env->str("Global"));
+        REBAR_CHECK(global != nullptr && global->is_integer() && global->get_integer() == 3);
+    }
+
+    REBAR_CHECK_SCRIPT("local t = {}; t.key = 1; t[\"key\"] += 1; return t.key;", "integer 2");
+    REBAR_CHECK_SCRIPT("local t = { [\"a\" + \"b\"] = 5 }; return t.ab;", "integer 5");
+}
+
+#endif //REBAR_TEST_UNIT_INTERNING_HPP
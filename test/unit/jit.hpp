@@ -0,0 +1,64 @@
+#ifndef REBAR_TEST_UNIT_JIT_HPP
+#define REBAR_TEST_UNIT_JIT_HPP
+
+#include "../unit.hpp"
+
+// Compiled code yields what the virtual machine yields: results must not change once a function is hot.
+
+namespace rebar::test {
+    // Calls the function a_script returns past the JIT's call threshold, checking each result against the
+    // result of the interpreter.
+    template <typename... t_args>
+    void check_tier_up(const std::string& a_script, const std::string& a_expected, const char* a_file, const int a_line, const t_args... a_args) {
+        auto reference = make_environment(provider_kind::interpreter);
+        auto tiered = make_environment(provider_kind::jit);
+
+        function reference_function = reference->compile_string(a_script)().get_function(*reference);
+        function tiered_function = tiered->compile_string(a_script)().get_function(*tiered);
+
+        const std::string expected = describe(reference_function.call(object(a_args)...));
+
+        if (expected != a_expected) {
+            report_failure("interpreter returned \"" + expected + "\", expected \"" + a_expected + "\" from:\n" + a_script, a_file, a_line);
+            return;
+        }
+
+        for (uint32_t i = 0; i < 3 * jit_provider::call_threshold; ++i) {
+            const std::string result = describe(tiered_function.call(object(a_args)...));
+
+            if (result != expected) {
+                report_failure("jit returned \"" + result + "\" on call " + std::to_string(i) + ", expected \"" + expected + "\" from:\n" + a_script, a_file, a_line);
+                return;
+            }
+        }
+    }
+}
+
+#define REBAR_CHECK_TIER_UP(a_script, a_expected, ...) rebar::test::check_tier_up(a_script, a_expected, __FILE__, __LINE__, __VA_ARGS__)
+
+REBAR_SUITE(jit_tier_up) {
+    using rebar::integer;
+    using rebar::number;
+
+    REBAR_CHECK_TIER_UP("function F(x) { return x < 10; } return F;", "integer 1", number(2.5));
+    REBAR_CHECK_TIER_UP("function F(x) { return x > 10; } return F;", "integer 0", number(2.5));
+    REBAR_CHECK_TIER_UP("function F(x, y) { return x < y; } return F;", "integer 1", integer(1), integer(2));
+    REBAR_CHECK_TIER_UP("function F(x, y) { return x >= y; } return F;", "integer 0", integer(1), integer(2));
+    REBAR_CHECK_TIER_UP("function F(x, y) { return x <= y; } return F;", "integer 1", integer(2), integer(2));
+    REBAR_CHECK_TIER_UP("function F(x, y) { return x == y; } return F;", "integer 1", integer(3), integer(3));
+    REBAR_CHECK_TIER_UP("function F(x, y) { return x != y; } return F;", "integer 1", integer(3), number(3));
+    REBAR_CHECK_TIER_UP("function F(x) { return !x; } return F;", "integer 1", integer(0));
+    REBAR_CHECK_TIER_UP("function F(x) { return (x < 10) + (x > 1); } return F;", "integer 2", integer(5));
+    REBAR_CHECK_TIER_UP("function F(x) { return x * 2.5 + 1; } return F;", "number 11", integer(4));
+    REBAR_CHECK_TIER_UP("function F(x) { local s = 0; for (local i = 0; i < x; i++) { s += i; } return s; } return F;", "integer 45", integer(10));
+}
+
+REBAR_SUITE(jit_hot_loops) {
+    // Loops hot enough to be compiled from their back-edge.
+    REBAR_CHECK_SCRIPT("local c = 0; for (local i = 0; i < 5000; i++) { c += (i < 2500); } return c;", "integer 2500");
+    REBAR_CHECK_SCRIPT("local c = 0; for (local i = 0; i < 5000; i++) { c += (i * 0.5 >= 1000); } return c;", "integer 3000");
+    REBAR_CHECK_SCRIPT("local c = 0; for (local i = 0; i < 5000; i++) { c += !(i % 2); } return c;", "integer 2500");
+    REBAR_CHECK_SCRIPT("local r; for (local i = 0; i < 5000; i++) { r = i == 4999; } return r;", "integer 1");
+}
+
+#endif //REBAR_TEST_UNIT_JIT_HPP
@@ -0,0 +1,88 @@
+#ifndef REBAR_TEST_UNIT_LEXER_HPP
+#define REBAR_TEST_UNIT_LEXER_HPP
+
+#include <vector>
+
+#include "../unit.hpp"
+
+// The lexer matches the longest symbol at each position, as a scan of the symbol map would.
+
+namespace rebar::test {
+    inline bool is_separator(const token& a_token, const separator a_separator) {
+        return a_token.is_separator() && a_token.get_separator() == a_separator;
+    }
+
+    // Tokens of a_source other than spaces.
+    inline std::vector<token> significant_tokens(const std::string_view a_source) {
+        lexer code_lexer;
+        lex_unit unit = code_lexer.lex(a_source);
+
+        std::vector<token> tokens;
+
+        for (token& current : unit.tokens()) {
+            if (!is_separator(current, separator::space)) {
+                tokens.push_back(current);
+            }
+        }
+
+        return tokens;
+    }
+}
+
+REBAR_SUITE(lexer_symbol_trie) {
+    const rebar::symbol_map map = rebar::symbol_map::get_default();
+    const rebar::symbol_trie trie(map);
+
+    // Every pair of symbols, so that each prefix of one symbol is tried against the start of another.
+    for (const auto& [first, first_mapping] : map) {
+        for (const auto& [second, second_mapping] : map) {
+            const std::string text = std::string(first) + std::string(second) + "x";
+
+            const auto expected = map.next(text);
+            const rebar::symbol_trie::entry* found = trie.match(text);
+
+            REBAR_CHECK(expected.has_value() == (found != nullptr));
+
+            if (expected.has_value() && found != nullptr) {
+                REBAR_CHECK(expected->first == found->first);
+            }
+        }
+    }
+
+    REBAR_CHECK(trie.match("identifier") == nullptr);
+    REBAR_CHECK(trie.match("") == nullptr);
+}
+
+REBAR_SUITE(lexer_tokens) {
+    using rebar::separator;
+    using rebar::test::is_separator;
+
+    const auto compare = rebar::test::significant_tokens("a<=b<<=c<d");
+    REBAR_CHECK(compare.size() == 7);
+
+    if (compare.size() == 7) {
+        REBAR_CHECK(compare[0].is_identifier() && compare[0].get_identifier() == "a");
+        REBAR_CHECK(is_separator(compare[1], separator::lesser_equality));
+        REBAR_CHECK(is_separator(compare[3], separator::shift_left_assignment));
+        REBAR_CHECK(is_separator(compare[5], separator::lesser));
+        REBAR_CHECK(compare[6].is_identifier() && compare[6].get_identifier() == "d");
+    }
+
+    const auto declaration = rebar::test::significant_tokens("local x = 1.5; local s = \"a<=b\"; x++;");
+    REBAR_CHECK(declaration.size() == 13);
+
+    if (declaration.size() == 13) {
+        REBAR_CHECK(declaration[0].is_keyword() && declaration[0].get_keyword() == rebar::keyword::local);
+        REBAR_CHECK(is_separator(declaration[2], separator::assignment));
+        REBAR_CHECK(declaration[3].is_number_literal() && declaration[3].get_number_literal() == 1.5);
+        REBAR_CHECK(is_separator(declaration[4], separator::end_statement));
+        REBAR_CHECK(declaration[8].is_string_literal() && declaration[8].get_string_literal() == "a<=b");
+        REBAR_CHECK(is_separator(declaration[11], separator::increment));
+    }
+
+    // Keywords only match whole words.
+    const auto words = rebar::test::significant_tokens("locals = iffy;");
+    REBAR_CHECK(words.size() == 4 && words[0].is_identifier() && words[2].is_identifier());
+}
+
+#endif //REBAR_TEST_UNIT_LEXER_HPP
@@ -0,0 +1,27 @@
+#ifndef REBAR_TEST_UNIT_LOCALS_HPP
+#define REBAR_TEST_UNIT_LOCALS_HPP
+
+#include "../unit.hpp"
+
+// Locals resolve to frame slots at compile time; these pin down the scoping rules the slots must preserve.
+
+REBAR_SUITE(locals_scoping) {
+    REBAR_CHECK_SCRIPT("local a = 1; { local a = 2; } return a;", "integer 1");
+    REBAR_CHECK_SCRIPT("local a = 1; { a = 2; } return a;", "integer 2");
+    REBAR_CHECK_SCRIPT("local a = 1; { local b = 2; a += b; } { local c = 5; a += c; } return a;", "integer 8");
+    REBAR_CHECK_SCRIPT("local a = 1; { local a = 2; { local a = 3; } } return a;", "integer 1");
+    REBAR_CHECK_SCRIPT("local s = 0; for (local i = 0; i < 3; i++) { local x = i * 2; s += x; } return s;", "integer 6");
+    REBAR_CHECK_SCRIPT("local i = 10; for (local i = 0; i < 3; i++) {} return i;", "integer 10");
+    REBAR_CHECK_SCRIPT("local a = 4; if (a > 1) { local a = 9; } return a;", "integer 4");
+    REBAR_CHECK_SCRIPT("local a; return a;", "null");
+}
+
+REBAR_SUITE(locals_functions) {
+    // Parameters and locals of a function live in its own frame.
+    REBAR_CHECK_SCRIPT("local a = 1; function F(a) { a = 5; return a; } return F(2) * 10 + a;", "integer 51");
+    REBAR_CHECK_SCRIPT("function F(n) { local x = n; if (n > 0) { F(n - 1); } return x; } return F(5);", "integer 5");
+    REBAR_CHECK_SCRIPT("function F() { local v = 3; return v; } local v = 7; return F() + v;", "integer 10");
+    REBAR_CHECK_SCRIPT("G = 1; function F() { local G = 2; return G; } return F() * 10 + G;", "integer 21");
+}
+
+#endif //REBAR_TEST_UNIT_LOCALS_HPP
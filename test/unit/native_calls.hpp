@@ -0,0 +1,66 @@
+#ifndef REBAR_TEST_UNIT_NATIVE_CALLS_HPP
+#define REBAR_TEST_UNIT_NATIVE_CALLS_HPP
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../unit.hpp"
+
+// Bound natives are called directly, without the provider, from C++ and from script alike.
+
+namespace rebar::test {
+    inline object native_double(environment* a_environment) {
+        return static_cast<integer>(a_environment->arg(0).get_integer() * 2);
+    }
+
+    inline object native_throw(environment*) {
+        throw std::runtime_error("native failure");
+    }
+}
+
+REBAR_SUITE(native_calls_direct) {
+    for (const auto kind : rebar::test::all_providers) {
+        auto env = rebar::test::make_environment(kind);
+
+        const rebar::object bound = env->bind(&rebar::test::native_double);
+        REBAR_CHECK(bound.is_function());
+        REBAR_CHECK(bound.get_function(*env).is_native());
+        REBAR_CHECK(!env->compile_string("return 1;").is_native());
+
+        REBAR_CHECK(bound.get_function(*env).call(rebar::object(rebar::integer(21))).get_integer() == 42);
+
+        env->global_table()[env->str("Double")] = bound;
+        env->global_table()[env->str("Throw")] = env->bind(&rebar::test::native_throw);
+
+        REBAR_CHECK(env->compile_string("local s = 0; for (local i = 0; i < 100; i++) { s += Double(i); } return s;")().get_integer() == 9900);
+        REBAR_CHECK(env->compile_string("function Apply(f, x) { return f(x); } return Apply(Double, Apply(Double, 3));")().get_integer() == 12);
+
+        // Exceptions thrown by a native reach the caller of the script.
+        REBAR_CHECK_THROWS(env->compile_string("return Double(Throw());")());
+        REBAR_CHECK(env->compile_string("return Double(4);")().get_integer() == 8);
+    }
+}
+
+REBAR_SUITE(native_calls_many_bindings) {
+    for (const auto kind : rebar::test::all_providers) {
+        auto env = rebar::test::make_environment(kind);
+
+        // Bound callables must keep their addresses while more are bound.
+        std::vector<rebar::object> bound;
+
+        for (int i = 0; i < 5000; ++i) {
+            bound.push_back(env->bind(&rebar::test::native_double));
+        }
+
+        rebar::integer sum = 0;
+
+        for (const rebar::object& current : bound) {
+            sum += current.get_function(*env).call(rebar::object(rebar::integer(1))).get_integer();
+        }
+
+        REBAR_CHECK(sum == 10000);
+    }
+}
+
+#endif //REBAR_TEST_UNIT_NATIVE_CALLS_HPP
@@ -0,0 +1,97 @@
+#ifndef REBAR_TEST_UNIT_NATIVE_CLASSES_HPP
+#define REBAR_TEST_UNIT_NATIVE_CLASSES_HPP
+
+#include <string>
+
+#include "../unit.hpp"
+
+// Classes bound through native_class: construction, methods and fields, reached from script.
+
+namespace rebar::test {
+    struct point {
+        integer x;
+        integer y;
+        object tag;
+
+        point(const integer a_x, const integer a_y) noexcept : x(a_x), y(a_y) {}
+
+        [[nodiscard]] integer length_squared() const noexcept {
+            return x * x + y * y;
+        }
+
+        void translate(const integer a_dx, const integer a_dy) noexcept {
+            x += a_dx;
+            y += a_dy;
+        }
+
+        [[nodiscard]] std::string describe() const {
+            return std::to_string(x) + "," + std::to_string(y);
+        }
+    };
+
+    inline integer point_sum(point& a_point) noexcept {
+        return a_point.x + a_point.y;
+    }
+
+    inline std::unique_ptr<environment> make_point_environment(const provider_kind a_kind) {
+        std::unique_ptr<environment> created = make_environment(a_kind);
+
+        virtual_table& point_class = created->register_native_class("Point", native_class<point>()
+                .constructor<integer, integer>()
+                .method<&point::length_squared>("LengthSquared")
+                .method<&point::translate>("Translate")
+                .method<&point::describe>("Describe")
+                .method<&point_sum>("Sum")
+                .field<&point::x>("X")
+                .field<&point::tag>("Tag"));
+
+        // Scripts construct points with "new Point(x, y)", which calls the constructor of this prototype.
+        created->global_table()[created->str("Point")] = created->create_native_object(point_class, std::in_place_type<point>, integer(0), integer(0));
+
+        return created;
+    }
+
+    inline std::string run_point_script(const provider_kind a_kind, const std::string& a_script) {
+        std::unique_ptr<environment> env = make_point_environment(a_kind);
+
+        try {
+            return describe(env->compile_string(a_script)());
+        } catch (const std::exception& e) {
+            return std::string("exception ") + e.what();
+        }
+    }
+}
+
+#define REBAR_CHECK_POINT_SCRIPT(a_script, a_expected)                                                       \
+    for (const auto kind : rebar::test::all_providers) {                                                     \
+        REBAR_CHECK(rebar::test::run_point_script(kind, a_script) == (a_expected));                         \
+    }
+
+REBAR_SUITE(native_classes_members) {
+    REBAR_CHECK_POINT_SCRIPT("local p = new Point(3, 4); return p.LengthSquared();", "integer 25");
+    REBAR_CHECK_POINT_SCRIPT("local p = new Point(3, 4); p.Translate(1, -1); return p.Describe();", "string 4,3");
+    REBAR_CHECK_POINT_SCRIPT("local p = new Point(3, 4); return p.Sum() + p.X;", "integer 10");
+    REBAR_CHECK_POINT_SCRIPT("local p = new Point(1, 2); p.Tag = \"t\"; return p.Tag;", "string t");
+    REBAR_CHECK_POINT_SCRIPT("local p = new Point(1, 2); return p.Tag;", "null");
+}
+
+REBAR_SUITE(native_classes_errors) {
+    using rebar::test::run_point_script;
+
+    for (const auto kind : rebar::test::all_providers) {
+        REBAR_CHECK(run_point_script(kind, "local p = new Point(\"a\", 2); return p;").rfind("exception", 0) == 0);
+        REBAR_CHECK(run_point_script(kind, "local p = new Point(1, 2); p.Translate(1.5, 0); return p.X;").rfind("exception", 0) == 0);
+    }
+
+    // The data of each native object is its own.
+    for (const auto kind : rebar::test::all_providers) {
+        auto env = rebar::test::make_point_environment(kind);
+        rebar::object result = env->compile_string("local a = new Point(1, 1); local b = new Point(5, 5); a.Translate(1, 1); return b;")();
+
+        REBAR_CHECK(result.is_native_object());
+        const rebar::test::point& data = result.get_native_object().get_object<rebar::test::point>();
+        REBAR_CHECK(data.x == 5 && data.y == 5);
+    }
+}
+
+#endif //REBAR_TEST_UNIT_NATIVE_CLASSES_HPP
@@ -0,0 +1,72 @@
+#ifndef REBAR_TEST_UNIT_OBJECT_LAYOUT_HPP
+#define REBAR_TEST_UNIT_OBJECT_LAYOUT_HPP
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "../unit.hpp"
+
+// Objects keep their type and value in either layout. The suites run in both the unit executable and
+// unit_nan_boxing, which is built with REBAR_NAN_BOXING.
+
+REBAR_SUITE(object_layout_round_trip) {
+    using rebar::object;
+    using rebar::integer;
+    using rebar::number;
+
+#ifdef REBAR_NAN_BOXING
+    REBAR_CHECK(sizeof(object) == 8);
+    constexpr integer largest = (integer(1) << 47) - 1;
+#else
+    REBAR_CHECK(sizeof(object) == 2 * sizeof(size_t));
+    constexpr integer largest = std::numeric_limits<integer>::max();
+#endif
+
+    REBAR_CHECK(object().is_null());
+    REBAR_CHECK(object(true).is_boolean() && object(true).get_boolean());
+    REBAR_CHECK(object(false).is_boolean() && !object(false).get_boolean());
+
+    for (const integer value : { integer(0), integer(1), integer(-1), integer(123456789), -largest, largest }) {
+        const object boxed(value);
+        REBAR_CHECK(boxed.is_integer() && boxed.get_integer() == value);
+    }
+
+    for (const number value : { 0.0, -0.0, 1.5, -2.25, 1e300, -1e-300, std::numeric_limits<number>::infinity(), -std::numeric_limits<number>::infinity() }) {
+        const object boxed(value);
+        REBAR_CHECK(boxed.is_number() && boxed.get_number() == value && std::signbit(boxed.get_number()) == std::signbit(value));
+    }
+
+    // Every NaN, including those whose bits look like a boxed value, stays a number.
+    const object nan(std::numeric_limits<number>::quiet_NaN());
+    REBAR_CHECK(nan.is_number() && std::isnan(nan.get_number()));
+
+    number negative_nan;
+    const uint64_t negative_nan_bits = 0xFFFA'0000'0000'1234;
+    std::memcpy(&negative_nan, &negative_nan_bits, sizeof(negative_nan));
+    const object boxed_nan(negative_nan);
+    REBAR_CHECK(boxed_nan.is_number() && std::isnan(boxed_nan.get_number()));
+}
+
+REBAR_SUITE(object_layout_references) {
+    rebar::environment env;
+
+    const rebar::object text = env.str("payload");
+    REBAR_CHECK(text.is_string() && text.get_string().to_string_view() == "payload");
+
+    rebar::object copy = text;
+    REBAR_CHECK(copy.data() == text.data());
+
+    const rebar::object created = env.create_table();
+    REBAR_CHECK(created.is_table());
+
+    created.get_table()[env.str("key")] = rebar::integer(7);
+    const rebar::object* found = created.get_table().find(env.str("key"));
+    REBAR_CHECK(found != nullptr && found->get_integer() == 7);
+
+    REBAR_CHECK_SCRIPT("local a = 1.5; local b = -3; return a * b;", "number -4.5");
+    REBAR_CHECK_SCRIPT("return 140737488355327;", "integer 140737488355327");
+    REBAR_CHECK_SCRIPT("return -140737488355327 - 1;", "integer -140737488355328");
+}
+
+#endif //REBAR_TEST_UNIT_OBJECT_LAYOUT_HPP
@@ -0,0 +1,135 @@
+#ifndef REBAR_TEST_UNIT_PARSER_HPP
+#define REBAR_TEST_UNIT_PARSER_HPP
+
+#include <string>
+
+#include "../unit.hpp"
+
+// Precedence, associativity and nesting as parsed by the recursive-descent parser.
+
+REBAR_SUITE(parser_precedence) {
+    REBAR_CHECK_SCRIPT("return 2 + 3 * 4 - 1;", "integer 13");
+    REBAR_CHECK_SCRIPT("return 20 - 5 - 3;", "integer 12");
+    REBAR_CHECK_SCRIPT("return 64 / 4 / 2;", "number 8");
+    REBAR_CHECK_SCRIPT("return 2 * (3 + 4) % 5;", "integer 4");
+    REBAR_CHECK_SCRIPT("return 1 + 2 < 4;", "integer 1");
+    REBAR_CHECK_SCRIPT("return 1 < 2 == 1;", "integer 1");
+    REBAR_CHECK_SCRIPT("return 0 || 1 && 2;", "integer 2");
+    REBAR_CHECK_SCRIPT("return -2 * 3;", "integer -6");
+    REBAR_CHECK_SCRIPT("return !0 + 1;", "integer 2");
+    REBAR_CHECK_SCRIPT("local t = { a = { b = [ 1, 2, 3 ] } }; return (t.a.b)[1] * 2;", "integer 4");
+    REBAR_CHECK_SCRIPT("local t = { a = { b = 4 } }; return t[\"a\"].b;", "integer 4");
+    REBAR_CHECK_SCRIPT("function F(a, b) { return a - b; } return F(F(10, 3), F(2, 1));", "integer 6");
+}
+
+REBAR_SUITE(parser_associativity) {
+    // Assignments and the ternary operator group to the right, everything else to the left.
+    REBAR_CHECK_SCRIPT("local a = 0; local b = 0; a = b = 3; return a;", "integer 3");
+    REBAR_CHECK_SCRIPT("local a = 0; local b = 0; a = b = 3; return b;", "integer 3");
+    REBAR_CHECK_SCRIPT("local a = 0; local b = 0; local c = 0; a = b = c = 7; return a + b + c;", "integer 21");
+    REBAR_CHECK_SCRIPT("local t = {}; local x = 0; t.v = x = 4; return t.v + x;", "integer 8");
+    REBAR_CHECK_SCRIPT("local a = 1; local b = 2; a += b += 3; return a * 10 + b;", "integer 65");
+    REBAR_CHECK_SCRIPT("local a = 5; local b = 0; b = a -= 2; return b * 10 + a;", "integer 33");
+    REBAR_CHECK_SCRIPT("local a = 1; local b = 0; a += b = 4; return a * 10 + b;", "integer 54");
+    REBAR_CHECK_SCRIPT("local a = 3; local b = 2; a *= b *= 5; return a;", "integer 30");
+    REBAR_CHECK_SCRIPT("return 1 ? 2 : 0 ? 3 : 4;", "integer 2");
+    REBAR_CHECK_SCRIPT("return 0 ? 2 : 1 ? 3 : 4;", "integer 3");
+    REBAR_CHECK_SCRIPT("return 0 ? 2 : 0 ? 3 : 4;", "integer 4");
+    REBAR_CHECK_SCRIPT("local a = 0; a = 0 ? 5 : 6; return a;", "integer 6");
+    REBAR_CHECK_SCRIPT("return 20 - 5 - 3;", "integer 12");
+    REBAR_CHECK_SCRIPT("return 2 ^ 3 ^ 2;", "number 64");
+}
+
+REBAR_SUITE(parser_nesting) {
+    // Deep nesting stays linear: parentheses, blocks and calls.
+    std::string parenthesized;
+
+    for (int i = 0; i < 200; ++i) {
+        parenthesized += "(";
+    }
+
+    parenthesized += "1";
+
+    for (int i = 0; i < 200; ++i) {
+        parenthesized += " + 1)";
+    }
+
+    REBAR_CHECK_SCRIPT("return " + parenthesized + ";", "integer 201");
+
+    std::string blocks = "local a = 0;";
+
+    for (int i = 0; i < 100; ++i) {
+        blocks += " if (a >= 0) { a++;";
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        blocks += " }";
+    }
+
+    REBAR_CHECK_SCRIPT(blocks + " return a;", "integer 100");
+
+    std::string sum = "return 0";
+
+    for (int i = 1; i <= 2000; ++i) {
+        sum += " + " + std::to_string(i);
+    }
+
+    REBAR_CHECK_SCRIPT(sum + ";", "integer 2001000");
+
+    // Left-nested chains are parsed, flattened, compiled and evaluated in loops, whatever their length.
+    std::string chain = "local x = 1; return x";
+
+    for (int i = 0; i < 60000; ++i) {
+        chain += i % 3 == 2 ? " - x" : " + x";
+    }
+
+    REBAR_CHECK_SCRIPT(chain + ";", "integer 20001");
+}
+
+REBAR_SUITE(parser_nesting_limit) {
+    const auto nested = [](const size_t a_depth, const char* a_open, const char* a_close) {
+        std::string script = "return ";
+
+        for (size_t i = 0; i < a_depth; ++i) {
+            script += a_open;
+        }
+
+        script += "1";
+
+        for (size_t i = 0; i < a_depth; ++i) {
+            script += a_close;
+        }
+
+        return script + ";";
+    };
+
+    // Right-nested groups recurse; up to the limit they evaluate, past it compiling throws instead of
+    // overflowing the native stack.
+    REBAR_CHECK_SCRIPT(nested(rebar::parser::max_nesting - 2, "1 + (", ")"), "integer " + std::to_string(rebar::parser::max_nesting - 1));
+
+    for (const rebar::test::provider_kind provider : rebar::test::all_providers) {
+        auto env = rebar::test::make_environment(provider);
+
+        REBAR_CHECK_THROWS(static_cast<void>(env->compile_string(nested(rebar::parser::max_nesting + 1, "1 + (", ")"))));
+        REBAR_CHECK_THROWS(static_cast<void>(env->compile_string(nested(100000, "(", ")"))));
+        REBAR_CHECK_THROWS(static_cast<void>(env->compile_string(nested(100000, "-", ""))));
+
+        std::string assignments = "local a = 0; a";
+
+        for (size_t i = 0; i < 100000; ++i) {
+            assignments += " = a";
+        }
+
+        REBAR_CHECK_THROWS(static_cast<void>(env->compile_string(assignments + ";")));
+
+        std::string blocks;
+
+        for (size_t i = 0; i < 100000; ++i) {
+            blocks += "if (1) { ";
+        }
+
+        REBAR_CHECK_THROWS(static_cast<void>(env->compile_string(blocks)));
+    }
+}
+
+#endif //REBAR_TEST_UNIT_PARSER_HPP
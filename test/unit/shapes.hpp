@@ -0,0 +1,53 @@
+#ifndef REBAR_TEST_UNIT_SHAPES_HPP
+#define REBAR_TEST_UNIT_SHAPES_HPP
+
+#include "../unit.hpp"
+
+// Record-like tables share shapes, and the shape tree of an environment stays bounded.
+
+REBAR_SUITE(shapes_sharing) {
+    for (const auto kind : rebar::test::all_providers) {
+        auto env = rebar::test::make_environment(kind);
+
+        const rebar::object pair = env->compile_string(
+            "function Point(x, y) { local p = {}; p.x = x; p.y = y; return p; }"
+            "return { a = Point(1, 2), b = Point(3, 4), c = { y = 1, x = 2 } };")();
+
+        rebar::table& tables = pair.get_table();
+        const rebar::table& a = tables[env->str("a")].get_table();
+        const rebar::table& b = tables[env->str("b")].get_table();
+        const rebar::table& c = tables[env->str("c")].get_table();
+
+        REBAR_CHECK(!a.is_dictionary() && a.get_shape() == b.get_shape());
+        REBAR_CHECK(a.get_shape() != c.get_shape());
+        REBAR_CHECK(a.get_shape()->size() == 2);
+    }
+
+    REBAR_CHECK_SCRIPT("local t = { a = 1 }; t.b = 2; t.a = 3; return t.a * 10 + t.b;", "integer 32");
+    REBAR_CHECK_SCRIPT("local t = { a = 1, b = 2 }; t[0] = 5; t.c = 3; return t.a + t.b + t.c + t[0];", "integer 11");
+}
+
+REBAR_SUITE(shapes_computed_keys) {
+    using rebar::shape;
+
+    for (const auto kind : rebar::test::all_providers) {
+        auto env = rebar::test::make_environment(kind);
+
+        // Every table gets a key of its own, fanning out of the root shape.
+        const rebar::object sum = env->compile_string(
+            "local s = 0; for (local i = 0; i < 5000; i++) { local t = {}; t[\"k\" + i] = i; s += t[\"k\" + i]; } return s;")();
+
+        REBAR_CHECK(sum.is_integer() && sum.get_integer() == 4999 * 5000 / 2);
+        REBAR_CHECK(env->root_shape().tree_size() <= shape::max_transitions + 1);
+
+        // A single table growing by computed keys, repeated with distinct prefixes.
+        const rebar::object count = env->compile_string(
+            "local c = 0; for (local j = 0; j < 200; j++) { local t = {}; for (local i = 0; i < 100; i++) { t[\"p\" + j + \"_\" + i] = 1; }"
+            " for (local i = 0; i < 100; i++) { c += t[\"p\" + j + \"_\" + i]; } } return c;")();
+
+        REBAR_CHECK(count.is_integer() && count.get_integer() == 200 * 100);
+        REBAR_CHECK(env->root_shape().tree_size() <= shape::max_tree_size);
+    }
+}
+
+#endif //REBAR_TEST_UNIT_SHAPES_HPP
@@ -0,0 +1,105 @@
+#ifndef REBAR_TEST_UNIT_STRING_HASH_HPP
+#define REBAR_TEST_UNIT_STRING_HASH_HPP
+
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "../unit.hpp"
+
+// Every string carries the xxhash of its contents in its header, however it was created, and the string table
+// and the interner find strings by that hash.
+
+namespace rebar::test {
+    [[nodiscard]] inline bool has_content_hash(const string& a_string) {
+        const size_t expected = xxh_string_view_hash()(a_string.to_string_view());
+        return a_string.hash() == expected && std::hash<string>()(a_string) == expected;
+    }
+
+    // Whether a_result is a string with the contents a_expected, the hash of its contents, and which
+    // a_environment yields again for those contents.
+    [[nodiscard]] inline bool is_hashed_string(environment& a_environment, const object& a_result, const std::string_view a_expected) {
+        if (!a_result.is_string()) {
+            return false;
+        }
+
+        const string result = a_result.get_string();
+        return result.to_string_view() == a_expected && has_content_hash(result) && a_environment.str(a_expected) == result;
+    }
+}
+
+REBAR_SUITE(string_hash_creation) {
+    const std::string long_text(300, 'q');
+    const std::string_view texts[] = { "", "a", "hello", std::string_view("nul\0inside", 10), long_text };
+
+    auto interner = std::make_shared<rebar::string_interner>();
+
+    rebar::environment table_strings;
+    rebar::environment interned_strings;
+    interned_strings.set_string_interner(interner);
+
+    for (const std::string_view text : texts) {
+        const size_t expected = rebar::xxh_string_view_hash()(text);
+
+        // The environment's own table, first creating the string and then finding it.
+        const rebar::string created = table_strings.str(text);
+        REBAR_CHECK(created.to_string_view() == text && rebar::test::has_content_hash(created));
+        REBAR_CHECK(rebar::hashed_string_view(text).m_hash == created.hash());
+        REBAR_CHECK(table_strings.str(text) == created);
+
+        // The interner, directly and through an environment sharing it.
+        const rebar::string interned = interner->intern(text);
+        REBAR_CHECK(interned.to_string_view() == text && interned.hash() == expected);
+        REBAR_CHECK(interned_strings.str(text) == interned);
+        REBAR_CHECK(rebar::test::has_content_hash(interned_strings.str(text)));
+
+        // Both paths agree, so a table and an interner never disagree on where a text lives.
+        REBAR_CHECK(created.hash() == interned.hash());
+    }
+
+    REBAR_CHECK(table_strings.str("") != table_strings.str("a"));
+    REBAR_CHECK(interner->size() == std::size(texts));
+}
+
+REBAR_SUITE(string_hash_scripts) {
+    // Strings built at run time by the operators and the standard library, with and without an interner.
+    const std::pair<const char*, const char*> scripts[] = {
+        { "return \"ab\" + \"cd\";", "abcd" },
+        { "return \"\" + \"\";", "" },
+        { "return \"x\" + 5;", "x5" },
+        { "local s = \"\"; for (local i = 0; i < 5; i++) { s = s + i; } return s;", "01234" },
+        { "return \"Hello, world!\"[0:4];", "Hello" },
+        { "return \"MiXed\".ToLowerCase() + \"MiXed\".ToUpperCase();", "mixedMIXED" },
+        { "return \"   \".Trim();", "" },
+        { "return \"  pad \".TrimLeft();", "pad " },
+        {
+            "local StringUtility = Include(\"StringUtility\"); local sb = new StringUtility::StringBuilder;"
+            "sb += \"x\"; sb.Append(\"yz\"); sb.Append(4); return sb.ToString();", "xyz4"
+        },
+        { "local StringUtility = Include(\"StringUtility\"); return (new StringUtility::StringBuilder).ToString();", "" },
+    };
+
+    auto interner = std::make_shared<rebar::string_interner>();
+
+    for (const rebar::test::provider_kind kind : rebar::test::all_providers) {
+        auto table_strings = rebar::test::make_environment(kind);
+        auto interned_strings = rebar::test::make_environment(kind, interner);
+
+        for (const auto& [script, expected] : scripts) {
+            const rebar::object from_table = table_strings->compile_string(script)();
+            const rebar::object from_interner = interned_strings->compile_string(script)();
+
+            if (!rebar::test::is_hashed_string(*table_strings, from_table, expected)) {
+                rebar::test::report_failure(std::string(rebar::test::provider_name(kind)) + " built a string without the hash of its contents: " + script, __FILE__, __LINE__);
+            }
+
+            if (!rebar::test::is_hashed_string(*interned_strings, from_interner, expected)) {
+                rebar::test::report_failure(std::string(rebar::test::provider_name(kind)) + " interned a string without the hash of its contents: " + script, __FILE__, __LINE__);
+            }
+        }
+    }
+}
+
+#endif //REBAR_TEST_UNIT_STRING_HASH_HPP
@@ -0,0 +1,141 @@
+#ifndef REBAR_TEST_UNIT_STRING_INTERNER_HPP
+#define REBAR_TEST_UNIT_STRING_INTERNER_HPP
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../unit.hpp"
+
+// A string_interner yields one immortal string per text, whichever thread or environment asks for it.
+
+REBAR_SUITE(string_interner_threads) {
+    constexpr size_t thread_count = 8;
+    constexpr size_t string_count = 4000;
+
+    rebar::string_interner interner;
+
+    // Every thread interns the same texts, starting at a different one, and keeps what it got.
+    std::vector<std::vector<const void*>> results(thread_count, std::vector<const void*>(string_count));
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&interner, &results, t]() {
+            for (size_t i = 0; i < string_count; ++i) {
+                const size_t index = (i + t * string_count / thread_count) % string_count;
+                results[t][index] = interner.intern("shared " + std::to_string(index)).data();
+            }
+        });
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    REBAR_CHECK(interner.size() == string_count);
+
+    for (size_t t = 1; t < thread_count; ++t) {
+        REBAR_CHECK(results[t] == results[0]);
+    }
+
+    REBAR_CHECK(interner.intern("shared 17").data() == results[0][17]);
+    REBAR_CHECK(interner.intern("shared 17").to_string_view() == "shared 17");
+}
+
+REBAR_SUITE(string_interner_growth) {
+    // Far more strings than the shards start with, so that every shard grows past half full several times.
+    constexpr size_t string_count = 20000;
+
+    rebar::string_interner interner;
+    std::vector<const void*> first(string_count);
+
+    for (size_t i = 0; i < string_count; ++i) {
+        first[i] = interner.intern(std::to_string(i)).data();
+    }
+
+    REBAR_CHECK(interner.size() == string_count);
+
+    // Strings interned before a shard grew are found, unmoved, in the arrays that replaced it.
+    bool same = true;
+
+    for (size_t i = 0; i < string_count; ++i) {
+        const rebar::string again = interner.intern(std::to_string(i));
+        same &= again.data() == first[i] && again.to_string_view() == std::to_string(i);
+    }
+
+    REBAR_CHECK(same);
+    REBAR_CHECK(interner.size() == string_count);
+
+    std::sort(first.begin(), first.end());
+    REBAR_CHECK(std::adjacent_find(first.begin(), first.end()) == first.end());
+
+    // The immortal sentinel survives copies and destruction of every handle.
+    const rebar::string interned = interner.intern("immortal");
+    REBAR_CHECK(interned.reference_count() == rebar::string::immortal_reference_count);
+
+    {
+        const rebar::string copy = interned;
+        const rebar::object boxed(copy);
+        REBAR_CHECK(copy.reference_count() == rebar::string::immortal_reference_count);
+    }
+
+    REBAR_CHECK(interned.reference_count() == rebar::string::immortal_reference_count);
+    REBAR_CHECK(interner.intern("immortal").data() == interned.data());
+}
+
+REBAR_SUITE(string_interner_environments) {
+    using rebar::object;
+
+    auto interner = std::make_shared<rebar::string_interner>();
+
+    auto first = rebar::test::make_environment(rebar::test::provider_kind::interpreter, interner);
+    auto second = rebar::test::make_environment(rebar::test::provider_kind::bytecode, interner);
+
+    // Strings, literals and identifiers are the same objects in both environments.
+    REBAR_CHECK(first->str("name") == second->str("name"));
+    REBAR_CHECK(first->str("name") == interner->intern("name"));
+    REBAR_CHECK(first->compile_string("return \"literal\";")().data() == second->compile_string("return \"literal\";")().data());
+
+    const object table = first->compile_string("return { field = 4 };")();
+    const object* field = table.get_table().find(second->str("field"));
+    REBAR_CHECK(field != nullptr && field->get_integer() == 4);
+
+    // Clones of a snapshot share the interner it was given.
+    rebar::environment_snapshot snapshot(rebar::use_provider<rebar::bytecode_provider>);
+    snapshot.set_string_interner(interner);
+    snapshot.add_script("Answer = \"forty-two\";");
+
+    std::unique_ptr<rebar::environment> clone = snapshot.clone();
+    REBAR_CHECK(clone->get_string_interner() == interner);
+    REBAR_CHECK(clone->compile_string("return Answer;")().data() == object(first->str("forty-two")).data());
+}
+
+REBAR_SUITE(string_interner_late) {
+    auto interner = std::make_shared<rebar::string_interner>();
+
+    // An environment's strings live in its table or in an interner, never both. Loading the libraries
+    // creates strings.
+    auto table_strings = rebar::test::make_environment(rebar::test::provider_kind::interpreter);
+    REBAR_CHECK_THROWS(table_strings->set_string_interner(interner));
+
+    auto interned_strings = rebar::test::make_environment(rebar::test::provider_kind::interpreter, interner);
+    REBAR_CHECK_THROWS(interned_strings->set_string_interner(std::make_shared<rebar::string_interner>()));
+    REBAR_CHECK_THROWS(interned_strings->set_string_interner(nullptr));
+    REBAR_CHECK(interned_strings->get_string_interner() == interner);
+
+    // Before any string, the interner may still be replaced.
+    auto fresh = std::make_unique<rebar::environment>();
+    fresh->set_string_interner(std::make_shared<rebar::string_interner>());
+    fresh->set_string_interner(interner);
+    REBAR_CHECK(fresh->str("created") == interner->intern("created"));
+
+    // Once a snapshot has been cloned, its clones must all keep the strings they started with.
+    rebar::environment_snapshot snapshot;
+    snapshot.prepare();
+    REBAR_CHECK_THROWS(snapshot.set_string_interner(interner));
+    REBAR_CHECK(snapshot.get_string_interner() == nullptr);
+}
+
+#endif //REBAR_TEST_UNIT_STRING_INTERNER_HPP
@@ -0,0 +1,231 @@
+#ifndef REBAR_TEST_UNIT_TYPED_ARRAYS_HPP
+#define REBAR_TEST_UNIT_TYPED_ARRAYS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../unit.hpp"
+
+// The vectorized kernels of typed arrays agree with plain loops over the same elements, for sizes that leave
+// remainders after whole vectors.
+
+namespace rebar::test {
+    // Deterministic elements spread over the range of t_element: integers near the limits so arithmetic wraps,
+    // bytes above 127 so comparisons must be unsigned, and numbers in halves so their sums are exact.
+    template <typename t_element>
+    std::vector<t_element> kernel_elements(const size_t a_size, uint64_t a_seed) {
+        std::vector<t_element> elements(a_size);
+
+        for (t_element& element : elements) {
+            a_seed = a_seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            const uint64_t bits = a_seed >> 16;
+
+            if constexpr (std::is_floating_point_v<t_element>) {
+                element = static_cast<t_element>(static_cast<int64_t>(bits % 2001) - 1000) / 2;
+            } else if constexpr (std::is_same_v<t_element, uint8_t>) {
+                element = static_cast<uint8_t>(bits);
+            } else {
+                element = (bits & 1) != 0 ? static_cast<t_element>(bits << 20) : static_cast<t_element>(bits % 201) - 100;
+            }
+        }
+
+        return elements;
+    }
+
+    template <typename t_element>
+    t_element reference_add(const t_element a_lhs, const t_element a_rhs) {
+        if constexpr (std::is_floating_point_v<t_element>) {
+            return a_lhs + a_rhs;
+        } else {
+            return static_cast<t_element>(static_cast<uint64_t>(a_lhs) + static_cast<uint64_t>(a_rhs));
+        }
+    }
+
+    template <typename t_element>
+    t_element reference_multiply(const t_element a_lhs, const t_element a_rhs) {
+        if constexpr (std::is_floating_point_v<t_element>) {
+            return a_lhs * a_rhs;
+        } else {
+            return static_cast<t_element>(static_cast<uint64_t>(a_lhs) * static_cast<uint64_t>(a_rhs));
+        }
+    }
+
+    template <typename t_element>
+    bool same_elements(const typed_array<t_element>& a_array, const std::vector<t_element>& a_expected) {
+        return a_array.size() == a_expected.size() && std::equal(a_expected.begin(), a_expected.end(), a_array.data());
+    }
+
+    template <typename t_element, typename t_compare>
+    bool same_mask(const byte_array& a_mask, const std::vector<t_element>& a_lhs, const std::vector<t_element>& a_rhs, t_compare&& a_compare) {
+        if (a_mask.size() != a_lhs.size()) {
+            return false;
+        }
+
+        for (size_t i = 0; i < a_lhs.size(); ++i) {
+            if (a_mask.get(i) != (a_compare(a_lhs[i], a_rhs[i]) ? 1 : 0)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Runs every kernel of typed_array<t_element> over a_size elements against its plain loop.
+    template <typename t_element>
+    void check_kernels(const size_t a_size, const char* a_file, const int a_line) {
+        using array_type = typed_array<t_element>;
+
+        const std::vector<t_element> lhs = kernel_elements<t_element>(a_size, a_size * 2 + 1);
+        const std::vector<t_element> rhs = kernel_elements<t_element>(a_size, a_size * 2 + 2);
+        const t_element scalar = a_size == 0 ? t_element() : lhs[a_size / 2];
+
+        array_type lhs_array;
+        array_type rhs_array;
+
+        for (size_t i = 0; i < a_size; ++i) {
+            lhs_array.push(lhs[i]);
+            rhs_array.push(rhs[i]);
+        }
+
+        const std::string where = "typed array kernels over " + std::to_string(a_size) + " elements of size " + std::to_string(sizeof(t_element));
+
+        auto check = [&](const bool a_condition, const char* a_kernel) {
+            if (!a_condition) {
+                report_failure(where + ": " + a_kernel + " differs from the plain loop", a_file, a_line);
+            }
+        };
+
+        // Sums, wrapping for integers.
+        {
+            using sum_type = std::conditional_t<std::is_floating_point_v<t_element>, t_element, integer>;
+            sum_type expected = 0;
+
+            for (const t_element element : lhs) {
+                if constexpr (std::is_floating_point_v<t_element>) {
+                    expected += element;
+                } else {
+                    expected = static_cast<integer>(static_cast<uint64_t>(expected) + static_cast<uint64_t>(element));
+                }
+            }
+
+            check(lhs_array.sum() == expected, "sum");
+        }
+
+        if (a_size == 0) {
+            REBAR_CHECK_THROWS(static_cast<void>(lhs_array.min()));
+            REBAR_CHECK_THROWS(static_cast<void>(lhs_array.max()));
+        } else {
+            check(lhs_array.min() == *std::min_element(lhs.begin(), lhs.end()), "min");
+            check(lhs_array.max() == *std::max_element(lhs.begin(), lhs.end()), "max");
+        }
+
+        const std::vector<t_element> scalars(a_size, scalar);
+
+        check(same_mask(lhs_array.equal(rhs_array), lhs, rhs, std::equal_to<>()), "equal");
+        check(same_mask(lhs_array.less(rhs_array), lhs, rhs, std::less<>()), "less");
+        check(same_mask(lhs_array.greater(rhs_array), lhs, rhs, std::greater<>()), "greater");
+        check(same_mask(lhs_array.equal(scalar), lhs, scalars, std::equal_to<>()), "equal to an element");
+        check(same_mask(lhs_array.less(scalar), lhs, scalars, std::less<>()), "less than an element");
+        check(same_mask(lhs_array.greater(scalar), lhs, scalars, std::greater<>()), "greater than an element");
+
+        std::vector<t_element> expected = lhs;
+        array_type result = lhs_array;
+
+        for (size_t i = 0; i < a_size; ++i) {
+            expected[i] = reference_add(expected[i], rhs[i]);
+        }
+
+        result.add(rhs_array);
+        check(same_elements(result, expected), "add");
+
+        for (size_t i = 0; i < a_size; ++i) {
+            expected[i] = reference_add(expected[i], scalar);
+        }
+
+        result.add(scalar);
+        check(same_elements(result, expected), "add of an element");
+
+        expected = lhs;
+        result = lhs_array;
+
+        for (size_t i = 0; i < a_size; ++i) {
+            expected[i] = reference_multiply(expected[i], rhs[i]);
+        }
+
+        result.multiply(rhs_array);
+        check(same_elements(result, expected), "multiply");
+
+        for (size_t i = 0; i < a_size; ++i) {
+            expected[i] = reference_multiply(expected[i], scalar);
+        }
+
+        result.multiply(scalar);
+        check(same_elements(result, expected), "multiply by an element");
+    }
+}
+
+#define REBAR_CHECK_KERNELS(element, size) rebar::test::check_kernels<element>(size, __FILE__, __LINE__)
+
+REBAR_SUITE(typed_arrays_kernels) {
+    // Up to and past whole AVX2 vectors of every element type, with each possible remainder on the way.
+    for (size_t size = 0; size <= 70; ++size) {
+        REBAR_CHECK_KERNELS(rebar::integer, size);
+        REBAR_CHECK_KERNELS(rebar::number, size);
+        REBAR_CHECK_KERNELS(uint8_t, size);
+    }
+
+    for (const size_t size : { 255, 256, 1000, 4099 }) {
+        REBAR_CHECK_KERNELS(rebar::integer, size);
+        REBAR_CHECK_KERNELS(rebar::number, size);
+        REBAR_CHECK_KERNELS(uint8_t, size);
+    }
+
+    // Extremes in the first element and in the remainder.
+    rebar::integer_array integers(37, 5);
+    integers.set(0, std::numeric_limits<rebar::integer>::min());
+    integers.set(36, std::numeric_limits<rebar::integer>::max());
+
+    REBAR_CHECK(integers.min() == std::numeric_limits<rebar::integer>::min());
+    REBAR_CHECK(integers.max() == std::numeric_limits<rebar::integer>::max());
+    REBAR_CHECK(integers.less(0).get(0) == 1 && integers.less(0).get(1) == 0);
+
+    rebar::byte_array bytes(33, 200);
+    bytes.set(32, 0);
+
+    REBAR_CHECK(bytes.sum() == 32 * 200);
+    REBAR_CHECK(bytes.min() == 0 && bytes.max() == 200);
+    REBAR_CHECK(bytes.greater(100).get(0) == 1 && bytes.greater(100).get(32) == 0);
+
+    rebar::integer_array short_operands(3);
+    REBAR_CHECK_THROWS(integers.add(short_operands));
+}
+
+REBAR_SUITE(typed_arrays_scripts) {
+    // Each script computes a kernel both through the array and with a plain loop, and returns 1 if they agree.
+    const std::string prelude =
+        "local TypedArray = Include(\"TypedArray\");"
+        "local a = new TypedArray::IntArray(0); local b = new TypedArray::IntArray(0);"
+        "for (local i = 0; i < 45; i++) { a.Push(i * 7 % 23 - 11); b.Push(i * 5 % 19 - 9); }";
+
+    REBAR_CHECK_SCRIPT(prelude + "local s = 0; for (local i = 0; i < 45; i++) { s += a.Get(i); } return a.Sum() == s;", "integer 1");
+    REBAR_CHECK_SCRIPT(prelude + "local m = a.Get(0); for (local i = 1; i < 45; i++) { if (a.Get(i) < m) { m = a.Get(i); } } return a.Min() == m;", "integer 1");
+    REBAR_CHECK_SCRIPT(prelude + "local m = a.Get(0); for (local i = 1; i < 45; i++) { if (a.Get(i) > m) { m = a.Get(i); } } return a.Max() == m;", "integer 1");
+    REBAR_CHECK_SCRIPT(prelude + "local l = a.Less(b); local c = 0; for (local i = 0; i < 45; i++) { if (l.Get(i) == (a.Get(i) < b.Get(i))) { c++; } } return c;", "integer 45");
+    REBAR_CHECK_SCRIPT(prelude + "local g = a.Greater(0); local c = 0; for (local i = 0; i < 45; i++) { if (g.Get(i) == (a.Get(i) > 0)) { c++; } } return c;", "integer 45");
+    REBAR_CHECK_SCRIPT(prelude + "local e = a.Equal(b); local c = 0; for (local i = 0; i < 45; i++) { if (e.Get(i) == (a.Get(i) == b.Get(i))) { c++; } } return c;", "integer 45");
+    REBAR_CHECK_SCRIPT(prelude + "local s = 0; for (local i = 0; i < 45; i++) { s += (a.Get(i) + b.Get(i)) * 3; } a.Add(b); a.Multiply(3); return a.Sum() == s;", "integer 1");
+    REBAR_CHECK_SCRIPT(
+        "local TypedArray = Include(\"TypedArray\"); local a = new TypedArray::NumberArray(0);"
+        "for (local i = 0; i < 21; i++) { a.Push(i / 2 - 3.5); }"
+        "local s = 0; for (local i = 0; i < 21; i++) { s += a.Get(i) * 2; } a.Multiply(2.0); return a.Sum() == s;", "integer 1");
+    REBAR_CHECK_SCRIPT(
+        "local TypedArray = Include(\"TypedArray\"); local a = new TypedArray::ByteArray(40); a.Fill(250); a.Set(39, 3);"
+        "return a.Sum() * 1000 + a.Min();", "integer 9753003");
+}
+
+#endif //REBAR_TEST_UNIT_TYPED_ARRAYS_HPP
@@ -0,0 +1,94 @@
+#ifndef REBAR_TEST_UNIT_TYPED_NATIVES_HPP
+#define REBAR_TEST_UNIT_TYPED_NATIVES_HPP
+
+#include <string>
+#include <string_view>
+
+#include "../unit.hpp"
+
+// Natives bound with environment::bind<v_function>() unbox their arguments by parameter type.
+
+namespace rebar::test {
+    inline number scale(const number a_value, const integer a_factor) noexcept {
+        return a_value * static_cast<number>(a_factor);
+    }
+
+    inline std::string repeat(const std::string_view a_text, const integer a_count) {
+        std::string repeated;
+
+        for (integer i = 0; i < a_count; ++i) {
+            repeated += a_text;
+        }
+
+        return repeated;
+    }
+
+    inline bool negate(const bool a_value) noexcept {
+        return !a_value;
+    }
+
+    inline integer count_rest(const integer, const span<object> a_rest) noexcept {
+        return static_cast<integer>(a_rest.size());
+    }
+
+    // Calls a_function with the rest arguments, then reads them again: the call grows the argument stack.
+    inline integer apply(environment&, function a_function, const span<object> a_rest) {
+        const object result = a_function.call(a_rest);
+        integer sum = result.get_integer();
+
+        for (const object& argument : a_rest) {
+            sum += argument.get_integer();
+        }
+
+        return sum;
+    }
+
+    inline std::unique_ptr<environment> make_typed_environment(const provider_kind a_kind) {
+        std::unique_ptr<environment> created = make_environment(a_kind);
+        created->global_table()[created->str("Scale")] = created->bind<&scale>();
+        created->global_table()[created->str("Repeat")] = created->bind<&repeat>();
+        created->global_table()[created->str("Negate")] = created->bind<&negate>();
+        created->global_table()[created->str("CountRest")] = created->bind<&count_rest>();
+        created->global_table()[created->str("Apply")] = created->bind<&apply>();
+        return created;
+    }
+
+    inline std::string run_typed_script(const provider_kind a_kind, const std::string& a_script) {
+        std::unique_ptr<environment> env = make_typed_environment(a_kind);
+
+        try {
+            return describe(env->compile_string(a_script)());
+        } catch (const std::exception& e) {
+            return std::string("exception ") + e.what();
+        }
+    }
+}
+
+#define REBAR_CHECK_TYPED_SCRIPT(a_script, a_expected)                                                       \
+    for (const auto kind : rebar::test::all_providers) {                                                     \
+        REBAR_CHECK(rebar::test::run_typed_script(kind, a_script) == (a_expected));                         \
+    }
+
+REBAR_SUITE(typed_natives_unboxing) {
+    REBAR_CHECK_TYPED_SCRIPT("return Scale(1.5, 4);", "number 6");
+    REBAR_CHECK_TYPED_SCRIPT("return Scale(2, 3);", "number 6");
+    REBAR_CHECK_TYPED_SCRIPT("return Repeat(\"ab\", 3);", "string ababab");
+    REBAR_CHECK_TYPED_SCRIPT("return Negate(false);", "boolean true");
+    REBAR_CHECK_TYPED_SCRIPT("return CountRest(1, 2, 3, 4);", "integer 3");
+    REBAR_CHECK_TYPED_SCRIPT("return CountRest(1);", "integer 0");
+
+    REBAR_CHECK_TYPED_SCRIPT("return Scale(\"x\", 1);", "exception Argument 0 passed to native function was not a number.");
+    REBAR_CHECK_TYPED_SCRIPT("return Scale(1, 1.5);", "exception Argument 1 passed to native function was not an integer.");
+    REBAR_CHECK_TYPED_SCRIPT("return Negate(1);", "exception Argument 0 passed to native function was not a boolean.");
+    REBAR_CHECK_TYPED_SCRIPT("return Repeat(null, 1);", "exception Argument 0 passed to native function was not a string.");
+}
+
+REBAR_SUITE(typed_natives_rest_arguments) {
+    // F recurses 400 calls deep with four arguments each, reallocating the argument stack under Apply's rest
+    // arguments, which Apply reads again afterwards.
+    REBAR_CHECK_TYPED_SCRIPT(
+        "function F(a, b, c, d) { if (a <= 0) { return 0; } return F(a - 1, b, c, d) + 1; } return Apply(F, 400, 1, 2, 3);",
+        "integer 806");
+}
+
+#endif //REBAR_TEST_UNIT_TYPED_NATIVES_HPP